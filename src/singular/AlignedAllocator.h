@@ -0,0 +1,187 @@
+#ifndef _SINGULAR_ALIGNED_ALLOCATOR_H
+#define _SINGULAR_ALIGNED_ALLOCATOR_H
+
+#include "singular/singular.h"
+
+#include <cstddef>
+#include <new>
+
+namespace singular {
+
+	/**
+	 * Allocator that aligns memory blocks to `SINGULAR_ALIGNMENT` bytes.
+	 *
+	 * `new double[]` and `std::allocator` guarantee only the alignment of
+	 * `std::max_align_t` which is typically 16 bytes.
+	 * This allocator over-allocates by `ALIGNMENT` bytes through the global
+	 * `operator new`, rounds the address up and keeps the original address
+	 * just before the aligned block.
+	 * Allocations therefore go through a replaced `operator new` as well.
+	 *
+	 * Can be given to standard containers; e.g.,
+	 * `std::vector< double, AlignedAllocator< double > >`.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	class AlignedAllocator {
+	public:
+		/** Type of elements. */
+		typedef T value_type;
+
+		/** Type of a pointer to an element. */
+		typedef T* pointer;
+
+		/** Type of a pointer to an unmodifiable element. */
+		typedef const T* const_pointer;
+
+		/** Type of a reference to an element. */
+		typedef T& reference;
+
+		/** Type of a reference to an unmodifiable element. */
+		typedef const T& const_reference;
+
+		/** Type of the number of elements. */
+		typedef std::size_t size_type;
+
+		/** Type of the distance between elements. */
+		typedef std::ptrdiff_t difference_type;
+
+		/** Alignment in bytes of allocated memory blocks. */
+		static const std::size_t ALIGNMENT = SINGULAR_ALIGNMENT;
+
+		/**
+		 * Allocator for elements of another type.
+		 *
+		 * @tparam U
+		 *     Type of elements.
+		 */
+		template < typename U >
+		struct rebind {
+			/** Allocator for `U`. */
+			typedef AlignedAllocator< U > other;
+		};
+
+		/** Initializes an allocator. */
+		AlignedAllocator() {}
+
+		/**
+		 * Initializes an allocator from an allocator of another type.
+		 *
+		 * Allocators have no state.
+		 */
+		template < typename U >
+		AlignedAllocator(const AlignedAllocator< U >&) {}
+
+		/**
+		 * Allocates a memory block of a given number of elements.
+		 *
+		 * Elements are not initialized.
+		 *
+		 * @param n
+		 *     Number of elements.
+		 * @return
+		 *     Aligned memory block.
+		 *     0 if `n == 0`.
+		 * @throws std::bad_alloc
+		 *     If no memory is available,
+		 *     or if `n` exceeds `max_size()`.
+		 */
+		T* allocate(std::size_t n) {
+			if (n == 0) {
+				return 0;
+			}
+			if (n > this->max_size()) {
+				// n * sizeof(T) + ALIGNMENT would overflow
+				throw std::bad_alloc();
+			}
+			void* pRaw = ::operator new(n * sizeof(T) + ALIGNMENT);
+			// at least one pointer fits before the aligned address because
+			// operator new aligns to a pointer
+			const std::size_t address =
+				(reinterpret_cast< std::size_t >(pRaw) + ALIGNMENT) &
+				~(ALIGNMENT - 1);
+			void** pAligned = reinterpret_cast< void** >(address);
+			pAligned[-1] = pRaw;
+			return reinterpret_cast< T* >(pAligned);
+		}
+
+		/**
+		 * Releases a memory block allocated by `allocate`.
+		 *
+		 * The number of elements in `p` may be given as the second
+		 * argument like `std::allocator`, but is not used.
+		 *
+		 * @param p
+		 *     Memory block to be released.
+		 *     Nothing happens if `p` is 0.
+		 */
+		void deallocate(T* p, std::size_t = 0) {
+			if (p != 0) {
+				::operator delete(reinterpret_cast< void** >(p)[-1]);
+			}
+		}
+
+		/**
+		 * Returns the maximum number of elements that can be allocated.
+		 *
+		 * @return
+		 *     Maximum number of elements.
+		 */
+		std::size_t max_size() const {
+			return (static_cast< std::size_t >(-1) - ALIGNMENT) / sizeof(T);
+		}
+
+		/**
+		 * Constructs an element at a given address.
+		 *
+		 * @param p
+		 *     Address where an element is to be constructed.
+		 * @param value
+		 *     Value to be copied.
+		 */
+		void construct(T* p, const T& value) {
+			new (p) T(value);
+		}
+
+		/**
+		 * Destructs an element at a given address.
+		 *
+		 * @param p
+		 *     Element to be destructed.
+		 */
+		void destroy(T* p) {
+			p->~T();
+		}
+	};
+
+	/**
+	 * Returns whether given two allocators are interchangeable.
+	 *
+	 * @return
+	 *     Always `true`.
+	 */
+	template < typename T, typename U >
+	inline bool operator ==(const AlignedAllocator< T >&,
+							const AlignedAllocator< U >&)
+	{
+		return true;
+	}
+
+	/**
+	 * Returns whether given two allocators are not interchangeable.
+	 *
+	 * @return
+	 *     Always `false`.
+	 */
+	template < typename T, typename U >
+	inline bool operator !=(const AlignedAllocator< T >&,
+							const AlignedAllocator< U >&)
+	{
+		return false;
+	}
+
+}
+
+#endif
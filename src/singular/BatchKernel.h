@@ -0,0 +1,909 @@
+#ifndef _SINGULAR_BATCH_KERNEL_H
+#define _SINGULAR_BATCH_KERNEL_H
+
+#include "singular/Simd.h"
+#include "singular/singular.h"
+
+#include <cmath>
+
+namespace singular {
+
+	/**
+	 * Kernels that orthogonalize columns of interleaved matrices.
+	 *
+	 * `LANES` matrices of the same shape are interleaved element by
+	 * element; the element at the row `i` of a column of the `l`th matrix
+	 * is at `x[i * LANES + l]`.
+	 * A row of a column of every lane thus fills a cache line, and a
+	 * register holds the same element of several matrices.
+	 *
+	 * A kernel applies a one-sided Jacobi rotation to a pair of columns in
+	 * every lane, so that the columns become orthogonal.
+	 * Each lane has its own rotation, but every lane follows the same
+	 * instructions; lanes that are already orthogonal are rotated by the
+	 * identity.
+	 *
+	 * There is a set of kernels for every `SimdLevel`.
+	 * `best` picks the set for the CPU at runtime.
+	 * Only `double` and `float` have SIMD kernels; the other types are
+	 * orthogonalized by portable kernels at every level.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	struct BasicBatchKernel {
+		enum {
+			/** Number of interleaved matrices; a cache line of elements. */
+			LANES = sizeof(T) < 64 ? 64 / sizeof(T) : 1
+		};
+
+		/**
+		 * Kernel that orthogonalizes a pair of columns in every lane.
+		 *
+		 * Let \f$\alpha = x^T x\f$, \f$\beta = y^T y\f$ and
+		 * \f$\gamma = x^T y\f$ in a lane.
+		 * The lane is rotated only if
+		 * \f$|\gamma| > tolerance \sqrt{\alpha} \sqrt{\beta}\f$.
+		 * The same rotation is applied to the columns `vx` and `vy` to
+		 * accumulate right-singular-vectors.
+		 *
+		 * @param[in,out] x
+		 *     First column of the matrices.
+		 * @param[in,out] y
+		 *     Second column of the matrices.
+		 * @param m
+		 *     Number of rows in `x` and `y`.
+		 * @param[in,out] vx
+		 *     First column of the singular vectors.
+		 * @param[in,out] vy
+		 *     Second column of the singular vectors.
+		 * @param n
+		 *     Number of rows in `vx` and `vy`.
+		 *     `vx` and `vy` are not touched if this is 0.
+		 * @param tolerance
+		 *     Cosine between columns regarded as orthogonal.
+		 * @return
+		 *     Whether any lane has been rotated.
+		 */
+		typedef bool (*OrthogonalizeFunction)(
+			T* x, T* y, int m, T* vx, T* vy, int n, T tolerance);
+
+		/** Orthogonalizes a pair of columns in every lane. */
+		OrthogonalizeFunction orthogonalize;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicBatchKernel& best() {
+			static const BasicBatchKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 *     Ignored.
+		 * @return
+		 *     Portable kernels.
+		 */
+		static const BasicBatchKernel& get(SimdLevel level) {
+			static const BasicBatchKernel SCALAR_KERNEL = {
+				&orthogonalizeScalar
+			};
+			return SCALAR_KERNEL;
+		}
+
+		/** Portable `OrthogonalizeFunction`. */
+		static bool orthogonalizeScalar(
+			T* x, T* y, int m, T* vx, T* vy, int n, T tolerance)
+		{
+			bool rotated = false;
+			for (int l = 0; l < LANES; ++l) {
+				T alpha = 0;
+				T beta = 0;
+				T gamma = 0;
+				for (int i = 0; i < m; ++i) {
+					const T xi = x[i * LANES + l];
+					const T yi = y[i * LANES + l];
+					alpha += xi * xi;
+					beta += yi * yi;
+					gamma += xi * yi;
+				}
+				if (!(std::abs(gamma) >
+					  tolerance * std::sqrt(alpha) * std::sqrt(beta)))
+				{
+					continue;
+				}
+				// t is the smaller root of t^2 + 2 * zeta * t - 1 = 0
+				const T zeta = (beta - alpha) / (2 * gamma);
+				const T az = std::abs(zeta);
+				const T big = az > 1 ? az : T(1);
+				const T small = az > 1 ? T(1) : az;
+				const T ratio = small / big;
+				T t = 1 / (az + big * std::sqrt(1 + ratio * ratio));
+				if (zeta < 0) {
+					t = -t;
+				}
+				const T c = 1 / std::sqrt(1 + t * t);
+				const T s = c * t;
+				rotateScalar(x + l, y + l, m, c, s);
+				rotateScalar(vx + l, vy + l, n, c, s);
+				rotated = true;
+			}
+			return rotated;
+		}
+
+		/**
+		 * Rotates a pair of columns in a single lane.
+		 *
+		 * Replaces \f$(x, y)\f$ with \f$(c x - s y, s x + c y)\f$.
+		 *
+		 * @param[in,out] x
+		 *     First column in the lane.
+		 * @param[in,out] y
+		 *     Second column in the lane.
+		 * @param m
+		 *     Number of rows.
+		 * @param c
+		 *     Cosine of the rotation.
+		 * @param s
+		 *     Sine of the rotation.
+		 */
+		static void rotateScalar(T* x, T* y, int m, T c, T s) {
+			for (int i = 0; i < m; ++i) {
+				const T xi = x[i * LANES];
+				const T yi = y[i * LANES];
+				x[i * LANES] = c * xi - s * yi;
+				y[i * LANES] = s * xi + c * yi;
+			}
+		}
+	};
+
+	/**
+	 * Kernels that orthogonalize columns of interleaved `double` matrices.
+	 *
+	 * Works like `BasicBatchKernel` but there is a set of kernels for
+	 * every `SimdLevel`.
+	 * A cache line holds 8 lanes, which take 4 SSE2 registers, 2 AVX2
+	 * registers or 1 AVX-512 register.
+	 */
+	template <>
+	struct BasicBatchKernel< double > {
+		enum {
+			/** Number of interleaved matrices; a cache line of elements. */
+			LANES = 8
+		};
+
+		/** Kernel that orthogonalizes a pair of columns in every lane. */
+		typedef bool (*OrthogonalizeFunction)(
+			double* x,
+			double* y,
+			int m,
+			double* vx,
+			double* vy,
+			int n,
+			double tolerance);
+
+		/** Orthogonalizes a pair of columns in every lane. */
+		OrthogonalizeFunction orthogonalize;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicBatchKernel& best() {
+			static const BasicBatchKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The behavior is undefined if the CPU does not support `level`.
+		 * Levels not compiled in fall back to the highest compiled level
+		 * below them.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 * @return
+		 *     Kernels for `level`.
+		 */
+		static const BasicBatchKernel& get(SimdLevel level) {
+			static const BasicBatchKernel SCALAR_KERNEL = {
+				&orthogonalizeScalar
+			};
+#if SINGULAR_SIMD_SUPPORTED
+			static const BasicBatchKernel SSE2_KERNEL = {
+				&orthogonalizeSse2
+			};
+			static const BasicBatchKernel AVX2_KERNEL = {
+				&orthogonalizeAvx2
+			};
+#if SINGULAR_AVX512_SUPPORTED
+			static const BasicBatchKernel AVX512_KERNEL = {
+				&orthogonalizeAvx512
+			};
+#endif
+			switch (level) {
+#if SINGULAR_AVX512_SUPPORTED
+			case SIMD_AVX512:
+				return AVX512_KERNEL;
+#else
+			case SIMD_AVX512:
+#endif
+			case SIMD_AVX2:
+				return AVX2_KERNEL;
+			case SIMD_SSE2:
+				return SSE2_KERNEL;
+			default:
+				return SCALAR_KERNEL;
+			}
+#else
+			return SCALAR_KERNEL;
+#endif
+		}
+
+		/** Portable `OrthogonalizeFunction`. */
+		static bool orthogonalizeScalar(double* x,
+										double* y,
+										int m,
+										double* vx,
+										double* vy,
+										int n,
+										double tolerance)
+		{
+			bool rotated = false;
+			for (int l = 0; l < LANES; ++l) {
+				double alpha = 0.0;
+				double beta = 0.0;
+				double gamma = 0.0;
+				for (int i = 0; i < m; ++i) {
+					const double xi = x[i * LANES + l];
+					const double yi = y[i * LANES + l];
+					alpha += xi * xi;
+					beta += yi * yi;
+					gamma += xi * yi;
+				}
+				if (!(std::abs(gamma) >
+					  tolerance * std::sqrt(alpha) * std::sqrt(beta)))
+				{
+					continue;
+				}
+				// t is the smaller root of t^2 + 2 * zeta * t - 1 = 0
+				const double zeta = (beta - alpha) / (2.0 * gamma);
+				const double az = std::abs(zeta);
+				const double big = az > 1.0 ? az : 1.0;
+				const double small = az > 1.0 ? 1.0 : az;
+				const double ratio = small / big;
+				double t = 1.0 / (az + big * std::sqrt(1.0 + ratio * ratio));
+				if (zeta < 0.0) {
+					t = -t;
+				}
+				const double c = 1.0 / std::sqrt(1.0 + t * t);
+				const double s = c * t;
+				rotateScalar(x + l, y + l, m, c, s);
+				rotateScalar(vx + l, vy + l, n, c, s);
+				rotated = true;
+			}
+			return rotated;
+		}
+
+		/** Rotates a pair of columns in a single lane. */
+		static void rotateScalar(
+			double* x, double* y, int m, double c, double s)
+		{
+			for (int i = 0; i < m; ++i) {
+				const double xi = x[i * LANES];
+				const double yi = y[i * LANES];
+				x[i * LANES] = c * xi - s * yi;
+				y[i * LANES] = s * xi + c * yi;
+			}
+		}
+#if SINGULAR_SIMD_SUPPORTED
+		/**
+		 * `OrthogonalizeFunction` with SSE2.
+		 *
+		 * Every pair of lanes is orthogonalized in turn.
+		 * SSE2 has no blend, so masks are applied by bitwise operations.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static bool orthogonalizeSse2(double* x,
+									  double* y,
+									  int m,
+									  double* vx,
+									  double* vy,
+									  int n,
+									  double tolerance)
+		{
+			const __m128d zero = _mm_setzero_pd();
+			const __m128d one = _mm_set1_pd(1.0);
+			const __m128d signBit = _mm_set1_pd(-0.0);
+			const __m128d vt = _mm_set1_pd(tolerance);
+			bool rotated = false;
+			for (int l = 0; l < LANES; l += 2) {
+				__m128d alpha = zero;
+				__m128d beta = zero;
+				__m128d gamma = zero;
+				for (int i = 0; i < m; ++i) {
+					const __m128d xi = _mm_loadu_pd(x + i * LANES + l);
+					const __m128d yi = _mm_loadu_pd(y + i * LANES + l);
+					alpha = _mm_add_pd(alpha, _mm_mul_pd(xi, xi));
+					beta = _mm_add_pd(beta, _mm_mul_pd(yi, yi));
+					gamma = _mm_add_pd(gamma, _mm_mul_pd(xi, yi));
+				}
+				const __m128d bound = _mm_mul_pd(vt, _mm_mul_pd(
+					_mm_sqrt_pd(alpha), _mm_sqrt_pd(beta)));
+				const __m128d mask = _mm_cmpgt_pd(
+					_mm_andnot_pd(signBit, gamma), bound);
+				if (_mm_movemask_pd(mask) == 0) {
+					continue;
+				}
+				// t is the smaller root of t^2 + 2 * zeta * t - 1 = 0
+				const __m128d zeta = _mm_div_pd(
+					_mm_sub_pd(beta, alpha), _mm_add_pd(gamma, gamma));
+				const __m128d az = _mm_andnot_pd(signBit, zeta);
+				const __m128d big = _mm_max_pd(az, one);
+				const __m128d ratio = _mm_div_pd(_mm_min_pd(az, one), big);
+				__m128d t = _mm_div_pd(one, _mm_add_pd(az, _mm_mul_pd(big,
+					_mm_sqrt_pd(_mm_add_pd(one, _mm_mul_pd(ratio, ratio))))));
+				t = _mm_or_pd(t, _mm_and_pd(signBit, zeta));
+				__m128d c = _mm_div_pd(
+					one, _mm_sqrt_pd(_mm_add_pd(one, _mm_mul_pd(t, t))));
+				__m128d s = _mm_and_pd(mask, _mm_mul_pd(c, t));
+				c = _mm_or_pd(_mm_and_pd(mask, c), _mm_andnot_pd(mask, one));
+				for (int i = 0; i < m; ++i) {
+					double* px = x + i * LANES + l;
+					double* py = y + i * LANES + l;
+					const __m128d xi = _mm_loadu_pd(px);
+					const __m128d yi = _mm_loadu_pd(py);
+					_mm_storeu_pd(px, _mm_sub_pd(
+						_mm_mul_pd(c, xi), _mm_mul_pd(s, yi)));
+					_mm_storeu_pd(py, _mm_add_pd(
+						_mm_mul_pd(s, xi), _mm_mul_pd(c, yi)));
+				}
+				for (int i = 0; i < n; ++i) {
+					double* px = vx + i * LANES + l;
+					double* py = vy + i * LANES + l;
+					const __m128d xi = _mm_loadu_pd(px);
+					const __m128d yi = _mm_loadu_pd(py);
+					_mm_storeu_pd(px, _mm_sub_pd(
+						_mm_mul_pd(c, xi), _mm_mul_pd(s, yi)));
+					_mm_storeu_pd(py, _mm_add_pd(
+						_mm_mul_pd(s, xi), _mm_mul_pd(c, yi)));
+				}
+				rotated = true;
+			}
+			return rotated;
+		}
+
+		/**
+		 * `OrthogonalizeFunction` with AVX2 and FMA.
+		 *
+		 * Every 4 lanes are orthogonalized in turn.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static bool orthogonalizeAvx2(double* x,
+									  double* y,
+									  int m,
+									  double* vx,
+									  double* vy,
+									  int n,
+									  double tolerance)
+		{
+			const __m256d zero = _mm256_setzero_pd();
+			const __m256d one = _mm256_set1_pd(1.0);
+			const __m256d signBit = _mm256_set1_pd(-0.0);
+			const __m256d vt = _mm256_set1_pd(tolerance);
+			bool rotated = false;
+			for (int l = 0; l < LANES; l += 4) {
+				__m256d alpha = zero;
+				__m256d beta = zero;
+				__m256d gamma = zero;
+				for (int i = 0; i < m; ++i) {
+					const __m256d xi = _mm256_loadu_pd(x + i * LANES + l);
+					const __m256d yi = _mm256_loadu_pd(y + i * LANES + l);
+					alpha = _mm256_fmadd_pd(xi, xi, alpha);
+					beta = _mm256_fmadd_pd(yi, yi, beta);
+					gamma = _mm256_fmadd_pd(xi, yi, gamma);
+				}
+				const __m256d bound = _mm256_mul_pd(vt, _mm256_mul_pd(
+					_mm256_sqrt_pd(alpha), _mm256_sqrt_pd(beta)));
+				const __m256d mask = _mm256_cmp_pd(
+					_mm256_andnot_pd(signBit, gamma), bound, _CMP_GT_OQ);
+				if (_mm256_movemask_pd(mask) == 0) {
+					continue;
+				}
+				// t is the smaller root of t^2 + 2 * zeta * t - 1 = 0
+				const __m256d zeta = _mm256_div_pd(
+					_mm256_sub_pd(beta, alpha), _mm256_add_pd(gamma, gamma));
+				const __m256d az = _mm256_andnot_pd(signBit, zeta);
+				const __m256d big = _mm256_max_pd(az, one);
+				const __m256d ratio =
+					_mm256_div_pd(_mm256_min_pd(az, one), big);
+				__m256d t = _mm256_div_pd(one, _mm256_fmadd_pd(big,
+					_mm256_sqrt_pd(_mm256_fmadd_pd(ratio, ratio, one)), az));
+				t = _mm256_or_pd(t, _mm256_and_pd(signBit, zeta));
+				__m256d c = _mm256_div_pd(
+					one, _mm256_sqrt_pd(_mm256_fmadd_pd(t, t, one)));
+				__m256d s = _mm256_and_pd(mask, _mm256_mul_pd(c, t));
+				c = _mm256_blendv_pd(one, c, mask);
+				for (int i = 0; i < m; ++i) {
+					double* px = x + i * LANES + l;
+					double* py = y + i * LANES + l;
+					const __m256d xi = _mm256_loadu_pd(px);
+					const __m256d yi = _mm256_loadu_pd(py);
+					_mm256_storeu_pd(px,
+						_mm256_fmsub_pd(c, xi, _mm256_mul_pd(s, yi)));
+					_mm256_storeu_pd(py,
+						_mm256_fmadd_pd(s, xi, _mm256_mul_pd(c, yi)));
+				}
+				for (int i = 0; i < n; ++i) {
+					double* px = vx + i * LANES + l;
+					double* py = vy + i * LANES + l;
+					const __m256d xi = _mm256_loadu_pd(px);
+					const __m256d yi = _mm256_loadu_pd(py);
+					_mm256_storeu_pd(px,
+						_mm256_fmsub_pd(c, xi, _mm256_mul_pd(s, yi)));
+					_mm256_storeu_pd(py,
+						_mm256_fmadd_pd(s, xi, _mm256_mul_pd(c, yi)));
+				}
+				rotated = true;
+			}
+			return rotated;
+		}
+#if SINGULAR_AVX512_SUPPORTED
+		/**
+		 * `OrthogonalizeFunction` with AVX-512F.
+		 *
+		 * Every lane fits in a single register.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static bool orthogonalizeAvx512(double* x,
+										double* y,
+										int m,
+										double* vx,
+										double* vy,
+										int n,
+										double tolerance)
+		{
+			const __m512d one = _mm512_set1_pd(1.0);
+			__m512d alpha = _mm512_setzero_pd();
+			__m512d beta = _mm512_setzero_pd();
+			__m512d gamma = _mm512_setzero_pd();
+			for (int i = 0; i < m; ++i) {
+				const __m512d xi = _mm512_loadu_pd(x + i * LANES);
+				const __m512d yi = _mm512_loadu_pd(y + i * LANES);
+				alpha = _mm512_fmadd_pd(xi, xi, alpha);
+				beta = _mm512_fmadd_pd(yi, yi, beta);
+				gamma = _mm512_fmadd_pd(xi, yi, gamma);
+			}
+			const __m512d bound = _mm512_mul_pd(
+				_mm512_set1_pd(tolerance),
+				_mm512_mul_pd(_mm512_sqrt_pd(alpha), _mm512_sqrt_pd(beta)));
+			const __mmask8 mask = _mm512_cmp_pd_mask(
+				_mm512_abs_pd(gamma), bound, _CMP_GT_OQ);
+			if (mask == 0) {
+				return false;
+			}
+			// t is the smaller root of t^2 + 2 * zeta * t - 1 = 0
+			const __m512d zeta = _mm512_div_pd(
+				_mm512_sub_pd(beta, alpha), _mm512_add_pd(gamma, gamma));
+			const __m512d az = _mm512_abs_pd(zeta);
+			const __m512d big = _mm512_max_pd(az, one);
+			const __m512d ratio = _mm512_div_pd(_mm512_min_pd(az, one), big);
+			__m512d t = _mm512_div_pd(one, _mm512_fmadd_pd(big,
+				_mm512_sqrt_pd(_mm512_fmadd_pd(ratio, ratio, one)), az));
+			t = _mm512_mask_sub_pd(t,
+				_mm512_cmp_pd_mask(zeta, _mm512_setzero_pd(), _CMP_LT_OQ),
+				_mm512_setzero_pd(),
+				t);
+			__m512d c = _mm512_div_pd(
+				one, _mm512_sqrt_pd(_mm512_fmadd_pd(t, t, one)));
+			const __m512d s = _mm512_maskz_mul_pd(mask, c, t);
+			c = _mm512_mask_blend_pd(mask, one, c);
+			for (int i = 0; i < m; ++i) {
+				double* px = x + i * LANES;
+				double* py = y + i * LANES;
+				const __m512d xi = _mm512_loadu_pd(px);
+				const __m512d yi = _mm512_loadu_pd(py);
+				_mm512_storeu_pd(px,
+					_mm512_fmsub_pd(c, xi, _mm512_mul_pd(s, yi)));
+				_mm512_storeu_pd(py,
+					_mm512_fmadd_pd(s, xi, _mm512_mul_pd(c, yi)));
+			}
+			for (int i = 0; i < n; ++i) {
+				double* px = vx + i * LANES;
+				double* py = vy + i * LANES;
+				const __m512d xi = _mm512_loadu_pd(px);
+				const __m512d yi = _mm512_loadu_pd(py);
+				_mm512_storeu_pd(px,
+					_mm512_fmsub_pd(c, xi, _mm512_mul_pd(s, yi)));
+				_mm512_storeu_pd(py,
+					_mm512_fmadd_pd(s, xi, _mm512_mul_pd(c, yi)));
+			}
+			return true;
+		}
+#endif
+#endif
+	};
+
+	/**
+	 * Kernels that orthogonalize columns of interleaved `float` matrices.
+	 *
+	 * Works like `BasicBatchKernel< double >` but a cache line holds
+	 * 16 lanes.
+	 */
+	template <>
+	struct BasicBatchKernel< float > {
+		enum {
+			/** Number of interleaved matrices; a cache line of elements. */
+			LANES = 16
+		};
+
+		/** Kernel that orthogonalizes a pair of columns in every lane. */
+		typedef bool (*OrthogonalizeFunction)(
+			float* x,
+			float* y,
+			int m,
+			float* vx,
+			float* vy,
+			int n,
+			float tolerance);
+
+		/** Orthogonalizes a pair of columns in every lane. */
+		OrthogonalizeFunction orthogonalize;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicBatchKernel& best() {
+			static const BasicBatchKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The behavior is undefined if the CPU does not support `level`.
+		 * Levels not compiled in fall back to the highest compiled level
+		 * below them.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 * @return
+		 *     Kernels for `level`.
+		 */
+		static const BasicBatchKernel& get(SimdLevel level) {
+			static const BasicBatchKernel SCALAR_KERNEL = {
+				&orthogonalizeScalar
+			};
+#if SINGULAR_SIMD_SUPPORTED
+			static const BasicBatchKernel SSE2_KERNEL = {
+				&orthogonalizeSse2
+			};
+			static const BasicBatchKernel AVX2_KERNEL = {
+				&orthogonalizeAvx2
+			};
+#if SINGULAR_AVX512_SUPPORTED
+			static const BasicBatchKernel AVX512_KERNEL = {
+				&orthogonalizeAvx512
+			};
+#endif
+			switch (level) {
+#if SINGULAR_AVX512_SUPPORTED
+			case SIMD_AVX512:
+				return AVX512_KERNEL;
+#else
+			case SIMD_AVX512:
+#endif
+			case SIMD_AVX2:
+				return AVX2_KERNEL;
+			case SIMD_SSE2:
+				return SSE2_KERNEL;
+			default:
+				return SCALAR_KERNEL;
+			}
+#else
+			return SCALAR_KERNEL;
+#endif
+		}
+
+		/** Portable `OrthogonalizeFunction`. */
+		static bool orthogonalizeScalar(float* x,
+										float* y,
+										int m,
+										float* vx,
+										float* vy,
+										int n,
+										float tolerance)
+		{
+			bool rotated = false;
+			for (int l = 0; l < LANES; ++l) {
+				float alpha = 0.0f;
+				float beta = 0.0f;
+				float gamma = 0.0f;
+				for (int i = 0; i < m; ++i) {
+					const float xi = x[i * LANES + l];
+					const float yi = y[i * LANES + l];
+					alpha += xi * xi;
+					beta += yi * yi;
+					gamma += xi * yi;
+				}
+				if (!(std::abs(gamma) >
+					  tolerance * std::sqrt(alpha) * std::sqrt(beta)))
+				{
+					continue;
+				}
+				// t is the smaller root of t^2 + 2 * zeta * t - 1 = 0
+				const float zeta = (beta - alpha) / (2.0f * gamma);
+				const float az = std::abs(zeta);
+				const float big = az > 1.0f ? az : 1.0f;
+				const float small = az > 1.0f ? 1.0f : az;
+				const float ratio = small / big;
+				float t = 1.0f / (az + big * std::sqrt(1.0f + ratio * ratio));
+				if (zeta < 0.0f) {
+					t = -t;
+				}
+				const float c = 1.0f / std::sqrt(1.0f + t * t);
+				const float s = c * t;
+				rotateScalar(x + l, y + l, m, c, s);
+				rotateScalar(vx + l, vy + l, n, c, s);
+				rotated = true;
+			}
+			return rotated;
+		}
+
+		/** Rotates a pair of columns in a single lane. */
+		static void rotateScalar(float* x, float* y, int m, float c, float s)
+		{
+			for (int i = 0; i < m; ++i) {
+				const float xi = x[i * LANES];
+				const float yi = y[i * LANES];
+				x[i * LANES] = c * xi - s * yi;
+				y[i * LANES] = s * xi + c * yi;
+			}
+		}
+#if SINGULAR_SIMD_SUPPORTED
+		/**
+		 * `OrthogonalizeFunction` with SSE2.
+		 *
+		 * Every 4 lanes are orthogonalized in turn.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static bool orthogonalizeSse2(float* x,
+									  float* y,
+									  int m,
+									  float* vx,
+									  float* vy,
+									  int n,
+									  float tolerance)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 signBit = _mm_set1_ps(-0.0f);
+			const __m128 vt = _mm_set1_ps(tolerance);
+			bool rotated = false;
+			for (int l = 0; l < LANES; l += 4) {
+				__m128 alpha = zero;
+				__m128 beta = zero;
+				__m128 gamma = zero;
+				for (int i = 0; i < m; ++i) {
+					const __m128 xi = _mm_loadu_ps(x + i * LANES + l);
+					const __m128 yi = _mm_loadu_ps(y + i * LANES + l);
+					alpha = _mm_add_ps(alpha, _mm_mul_ps(xi, xi));
+					beta = _mm_add_ps(beta, _mm_mul_ps(yi, yi));
+					gamma = _mm_add_ps(gamma, _mm_mul_ps(xi, yi));
+				}
+				const __m128 bound = _mm_mul_ps(vt, _mm_mul_ps(
+					_mm_sqrt_ps(alpha), _mm_sqrt_ps(beta)));
+				const __m128 mask = _mm_cmpgt_ps(
+					_mm_andnot_ps(signBit, gamma), bound);
+				if (_mm_movemask_ps(mask) == 0) {
+					continue;
+				}
+				// t is the smaller root of t^2 + 2 * zeta * t - 1 = 0
+				const __m128 zeta = _mm_div_ps(
+					_mm_sub_ps(beta, alpha), _mm_add_ps(gamma, gamma));
+				const __m128 az = _mm_andnot_ps(signBit, zeta);
+				const __m128 big = _mm_max_ps(az, one);
+				const __m128 ratio = _mm_div_ps(_mm_min_ps(az, one), big);
+				__m128 t = _mm_div_ps(one, _mm_add_ps(az, _mm_mul_ps(big,
+					_mm_sqrt_ps(_mm_add_ps(one, _mm_mul_ps(ratio, ratio))))));
+				t = _mm_or_ps(t, _mm_and_ps(signBit, zeta));
+				__m128 c = _mm_div_ps(
+					one, _mm_sqrt_ps(_mm_add_ps(one, _mm_mul_ps(t, t))));
+				__m128 s = _mm_and_ps(mask, _mm_mul_ps(c, t));
+				c = _mm_or_ps(_mm_and_ps(mask, c), _mm_andnot_ps(mask, one));
+				for (int i = 0; i < m; ++i) {
+					float* px = x + i * LANES + l;
+					float* py = y + i * LANES + l;
+					const __m128 xi = _mm_loadu_ps(px);
+					const __m128 yi = _mm_loadu_ps(py);
+					_mm_storeu_ps(px, _mm_sub_ps(
+						_mm_mul_ps(c, xi), _mm_mul_ps(s, yi)));
+					_mm_storeu_ps(py, _mm_add_ps(
+						_mm_mul_ps(s, xi), _mm_mul_ps(c, yi)));
+				}
+				for (int i = 0; i < n; ++i) {
+					float* px = vx + i * LANES + l;
+					float* py = vy + i * LANES + l;
+					const __m128 xi = _mm_loadu_ps(px);
+					const __m128 yi = _mm_loadu_ps(py);
+					_mm_storeu_ps(px, _mm_sub_ps(
+						_mm_mul_ps(c, xi), _mm_mul_ps(s, yi)));
+					_mm_storeu_ps(py, _mm_add_ps(
+						_mm_mul_ps(s, xi), _mm_mul_ps(c, yi)));
+				}
+				rotated = true;
+			}
+			return rotated;
+		}
+
+		/**
+		 * `OrthogonalizeFunction` with AVX2 and FMA.
+		 *
+		 * Every 8 lanes are orthogonalized in turn.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static bool orthogonalizeAvx2(float* x,
+									  float* y,
+									  int m,
+									  float* vx,
+									  float* vy,
+									  int n,
+									  float tolerance)
+		{
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 one = _mm256_set1_ps(1.0f);
+			const __m256 signBit = _mm256_set1_ps(-0.0f);
+			const __m256 vt = _mm256_set1_ps(tolerance);
+			bool rotated = false;
+			for (int l = 0; l < LANES; l += 8) {
+				__m256 alpha = zero;
+				__m256 beta = zero;
+				__m256 gamma = zero;
+				for (int i = 0; i < m; ++i) {
+					const __m256 xi = _mm256_loadu_ps(x + i * LANES + l);
+					const __m256 yi = _mm256_loadu_ps(y + i * LANES + l);
+					alpha = _mm256_fmadd_ps(xi, xi, alpha);
+					beta = _mm256_fmadd_ps(yi, yi, beta);
+					gamma = _mm256_fmadd_ps(xi, yi, gamma);
+				}
+				const __m256 bound = _mm256_mul_ps(vt, _mm256_mul_ps(
+					_mm256_sqrt_ps(alpha), _mm256_sqrt_ps(beta)));
+				const __m256 mask = _mm256_cmp_ps(
+					_mm256_andnot_ps(signBit, gamma), bound, _CMP_GT_OQ);
+				if (_mm256_movemask_ps(mask) == 0) {
+					continue;
+				}
+				// t is the smaller root of t^2 + 2 * zeta * t - 1 = 0
+				const __m256 zeta = _mm256_div_ps(
+					_mm256_sub_ps(beta, alpha), _mm256_add_ps(gamma, gamma));
+				const __m256 az = _mm256_andnot_ps(signBit, zeta);
+				const __m256 big = _mm256_max_ps(az, one);
+				const __m256 ratio =
+					_mm256_div_ps(_mm256_min_ps(az, one), big);
+				__m256 t = _mm256_div_ps(one, _mm256_fmadd_ps(big,
+					_mm256_sqrt_ps(_mm256_fmadd_ps(ratio, ratio, one)), az));
+				t = _mm256_or_ps(t, _mm256_and_ps(signBit, zeta));
+				__m256 c = _mm256_div_ps(
+					one, _mm256_sqrt_ps(_mm256_fmadd_ps(t, t, one)));
+				__m256 s = _mm256_and_ps(mask, _mm256_mul_ps(c, t));
+				c = _mm256_blendv_ps(one, c, mask);
+				for (int i = 0; i < m; ++i) {
+					float* px = x + i * LANES + l;
+					float* py = y + i * LANES + l;
+					const __m256 xi = _mm256_loadu_ps(px);
+					const __m256 yi = _mm256_loadu_ps(py);
+					_mm256_storeu_ps(px,
+						_mm256_fmsub_ps(c, xi, _mm256_mul_ps(s, yi)));
+					_mm256_storeu_ps(py,
+						_mm256_fmadd_ps(s, xi, _mm256_mul_ps(c, yi)));
+				}
+				for (int i = 0; i < n; ++i) {
+					float* px = vx + i * LANES + l;
+					float* py = vy + i * LANES + l;
+					const __m256 xi = _mm256_loadu_ps(px);
+					const __m256 yi = _mm256_loadu_ps(py);
+					_mm256_storeu_ps(px,
+						_mm256_fmsub_ps(c, xi, _mm256_mul_ps(s, yi)));
+					_mm256_storeu_ps(py,
+						_mm256_fmadd_ps(s, xi, _mm256_mul_ps(c, yi)));
+				}
+				rotated = true;
+			}
+			return rotated;
+		}
+#if SINGULAR_AVX512_SUPPORTED
+		/**
+		 * `OrthogonalizeFunction` with AVX-512F.
+		 *
+		 * Every lane fits in a single register.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static bool orthogonalizeAvx512(float* x,
+										float* y,
+										int m,
+										float* vx,
+										float* vy,
+										int n,
+										float tolerance)
+		{
+			const __m512 one = _mm512_set1_ps(1.0f);
+			__m512 alpha = _mm512_setzero_ps();
+			__m512 beta = _mm512_setzero_ps();
+			__m512 gamma = _mm512_setzero_ps();
+			for (int i = 0; i < m; ++i) {
+				const __m512 xi = _mm512_loadu_ps(x + i * LANES);
+				const __m512 yi = _mm512_loadu_ps(y + i * LANES);
+				alpha = _mm512_fmadd_ps(xi, xi, alpha);
+				beta = _mm512_fmadd_ps(yi, yi, beta);
+				gamma = _mm512_fmadd_ps(xi, yi, gamma);
+			}
+			const __m512 bound = _mm512_mul_ps(
+				_mm512_set1_ps(tolerance),
+				_mm512_mul_ps(_mm512_sqrt_ps(alpha), _mm512_sqrt_ps(beta)));
+			const __mmask16 mask = _mm512_cmp_ps_mask(
+				_mm512_abs_ps(gamma), bound, _CMP_GT_OQ);
+			if (mask == 0) {
+				return false;
+			}
+			// t is the smaller root of t^2 + 2 * zeta * t - 1 = 0
+			const __m512 zeta = _mm512_div_ps(
+				_mm512_sub_ps(beta, alpha), _mm512_add_ps(gamma, gamma));
+			const __m512 az = _mm512_abs_ps(zeta);
+			const __m512 big = _mm512_max_ps(az, one);
+			const __m512 ratio = _mm512_div_ps(_mm512_min_ps(az, one), big);
+			__m512 t = _mm512_div_ps(one, _mm512_fmadd_ps(big,
+				_mm512_sqrt_ps(_mm512_fmadd_ps(ratio, ratio, one)), az));
+			t = _mm512_mask_sub_ps(t,
+				_mm512_cmp_ps_mask(zeta, _mm512_setzero_ps(), _CMP_LT_OQ),
+				_mm512_setzero_ps(),
+				t);
+			__m512 c = _mm512_div_ps(
+				one, _mm512_sqrt_ps(_mm512_fmadd_ps(t, t, one)));
+			const __m512 s = _mm512_maskz_mul_ps(mask, c, t);
+			c = _mm512_mask_blend_ps(mask, one, c);
+			for (int i = 0; i < m; ++i) {
+				float* px = x + i * LANES;
+				float* py = y + i * LANES;
+				const __m512 xi = _mm512_loadu_ps(px);
+				const __m512 yi = _mm512_loadu_ps(py);
+				_mm512_storeu_ps(px,
+					_mm512_fmsub_ps(c, xi, _mm512_mul_ps(s, yi)));
+				_mm512_storeu_ps(py,
+					_mm512_fmadd_ps(s, xi, _mm512_mul_ps(c, yi)));
+			}
+			for (int i = 0; i < n; ++i) {
+				float* px = vx + i * LANES;
+				float* py = vy + i * LANES;
+				const __m512 xi = _mm512_loadu_ps(px);
+				const __m512 yi = _mm512_loadu_ps(py);
+				_mm512_storeu_ps(px,
+					_mm512_fmsub_ps(c, xi, _mm512_mul_ps(s, yi)));
+				_mm512_storeu_ps(py,
+					_mm512_fmadd_ps(s, xi, _mm512_mul_ps(c, yi)));
+			}
+			return true;
+		}
+#endif
+#endif
+	};
+
+	/** Kernels for interleaved matrices of `double` elements. */
+	typedef BasicBatchKernel< double > BatchKernel;
+
+}
+
+#endif
@@ -0,0 +1,537 @@
+#ifndef _SINGULAR_BATCH_SVD_H
+#define _SINGULAR_BATCH_SVD_H
+
+#include "singular/AlignedAllocator.h"
+#include "singular/BatchKernel.h"
+#include "singular/MatrixView.h"
+#include "singular/SvdKernel.h"
+#include "singular/ThreadPool.h"
+#include "singular/singular.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace singular {
+
+	/**
+	 * Singular value decomposition of many matrices of the same shape.
+	 *
+	 * Matrices are decomposed `BasicBatchKernel< T >::LANES` at a time.
+	 * They are interleaved element by element so that a SIMD register
+	 * holds the same element of several matrices, and every matrix in a
+	 * group is decomposed by the same instructions.
+	 *
+	 * Francis iterations do not fit that, because every matrix deflates
+	 * its bidiagonal matrix at different points.
+	 * Matrices are instead decomposed by one-sided Jacobi rotations,
+	 * whose sweeps take the same path through every matrix.
+	 * Each sweep rotates every pair of columns until all of them are
+	 * orthogonal in every matrix in a group.
+	 *
+	 * Memory for groups is allocated once per task, and no singular
+	 * vectors are computed unless they are requested.
+	 */
+	struct BatchSvd {
+		/**
+		 * Maximum number of sweeps over a group of matrices.
+		 *
+		 * Small matrices converge in far fewer sweeps.
+		 */
+		static const int MAX_SWEEPS = 30;
+
+		/**
+		 * Number of tasks per thread into which a batch is split.
+		 *
+		 * Matrices converge after different numbers of sweeps, so idle
+		 * threads steal the remaining tasks from busy ones.
+		 */
+		static const int TASKS_PER_THREAD = 8;
+
+		/**
+		 * Decomposes given matrices.
+		 *
+		 * Matrices are given in a single contiguous memory block;
+		 * the `k`th `M` x `N` matrix starts at `a + k * M * N` and is laid
+		 * out in the row-major order like `Matrix< M, N >`.
+		 * Results are stored in the same way.
+		 *  - The `k`th left-singular-vectors start at
+		 *    `u + k * M * M` for `SVD_FULL`, or at
+		 *    `u + k * M * min(M, N)` for `SVD_THIN`.
+		 *  - The `k`th singular values start at `s + k * min(M, N)` and are
+		 *    in descending order.
+		 *  - The `k`th right-singular-vectors start at
+		 *    `v + k * N * N` for `SVD_FULL`, or at
+		 *    `v + k * N * min(M, N)` for `SVD_THIN`.
+		 *
+		 * `u` or `v` is ignored and may be 0 if `jobU` or `jobV` is
+		 * `SVD_NONE`.
+		 *
+		 * If `pPool` is given, groups of matrices are split in halves
+		 * recursively and handed to the pool, so that the work-stealing
+		 * workers of the pool balance groups that take long.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @param M
+		 *     Number of rows in each matrix.
+		 * @param N
+		 *     Number of columns in each matrix.
+		 * @param count
+		 *     Number of matrices.
+		 * @param a
+		 *     Matrices to be decomposed.
+		 *     Not modified.
+		 * @param[out] u
+		 *     Where left-singular-vectors are to be stored.
+		 * @param[out] s
+		 *     Where singular values are to be stored.
+		 * @param[out] v
+		 *     Where right-singular-vectors are to be stored.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 * @param pPool
+		 *     Thread pool on which matrices are decomposed concurrently.
+		 *     Matrices are decomposed on the calling thread if this is 0.
+		 *     Only the tasks of this batch are waited for, and the calling
+		 *     thread decomposes groups meanwhile, so this may be called
+		 *     from a task on `pPool` and concurrently with other users of
+		 *     `pPool`.
+		 */
+		template < typename T >
+		static void decompose(int M,
+							  int N,
+							  int count,
+							  const T a[],
+							  T u[],
+							  T s[],
+							  T v[],
+							  SvdJob jobU = SVD_FULL,
+							  SvdJob jobV = SVD_FULL,
+							  ThreadPool* pPool = 0)
+		{
+			assert(M >= 1 && N >= 1 && count >= 0);
+			const int L = BasicBatchKernel< T >::LANES;
+			const int numGroups = count / L + (count % L != 0 ? 1 : 0);
+			if (pPool == 0 || pPool->size() < 2 || numGroups < 2) {
+				decomposeGroups(
+					M, N, count, a, u, s, v, jobU, jobV, 0, numGroups, 0, 0);
+				return;
+			}
+			const int grain = std::max(
+				1, numGroups / (TASKS_PER_THREAD * pPool->size()));
+			ThreadPool::TaskGroup groups(*pPool);
+			decomposeGroups(M, N, count, a, u, s, v, jobU, jobV,
+							0, numGroups, grain, &groups);
+			groups.wait();
+		}
+
+		/**
+		 * Decomposes a given range of groups of matrices.
+		 *
+		 * Arguments are the same as `decompose` except for `firstGroup`,
+		 * `lastGroup` and `grain`.
+		 * The `g`th group has the matrices from `g * LANES` to
+		 * `(g + 1) * LANES - 1`.
+		 *
+		 * If `pGroups` is given, the upper half of the range is handed to
+		 * it as another task until the range has no more than `grain`
+		 * groups.
+		 * The handed tasks are not waited for.
+		 *
+		 * @param firstGroup
+		 *     Index of the first group.
+		 * @param lastGroup
+		 *     Index next to the last group.
+		 * @param grain
+		 *     Maximum number of groups that are not split.
+		 *     Ignored if `pGroups` is 0.
+		 * @param pGroups
+		 *     Group of tasks to which upper halves are handed.
+		 *     Every group is decomposed on the calling thread if this is 0.
+		 */
+		template < typename T >
+		static void decomposeGroups(int M,
+									int N,
+									int count,
+									const T a[],
+									T u[],
+									T s[],
+									T v[],
+									SvdJob jobU,
+									SvdJob jobV,
+									int firstGroup,
+									int lastGroup,
+									int grain,
+									ThreadPool::TaskGroup* pGroups)
+		{
+			const int L = BasicBatchKernel< T >::LANES;
+			const int Q = std::min(M, N);
+			if (pGroups != 0) {
+				while (lastGroup - firstGroup > grain) {
+					const int middle = firstGroup + (lastGroup - firstGroup) / 2;
+					const int upperLast = lastGroup;
+					pGroups->submit([=]() {
+						decomposeGroups(M, N, count, a, u, s, v, jobU, jobV,
+										middle, upperLast, grain, pGroups);
+					});
+					lastGroup = middle;
+				}
+			}
+			if (firstGroup >= lastGroup) {
+				return;
+			}
+			std::vector< T, AlignedAllocator< T > > work(
+				workSize< T >(M, N, jobU, jobV));
+			for (int g = firstGroup; g < lastGroup; ++g) {
+				// offsets exceed int in a batch of millions of matrices
+				const std::ptrdiff_t first =
+					static_cast< std::ptrdiff_t >(g) * L;
+				const int lanes = static_cast< int >(
+					std::min< std::ptrdiff_t >(L, count - first));
+				decomposeGroup(M,
+							   N,
+							   lanes,
+							   a + first * M * N,
+							   u + first * M * columnsFor(jobU, M, Q),
+							   s + first * Q,
+							   v + first * N * columnsFor(jobV, N, Q),
+							   jobU,
+							   jobV,
+							   work.data());
+			}
+		}
+
+		/**
+		 * Returns the number of elements in a memory block that
+		 * `decomposeGroup` needs.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @param M
+		 *     Number of rows in each matrix.
+		 * @param N
+		 *     Number of columns in each matrix.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 * @return
+		 *     Number of elements.
+		 */
+		template < typename T >
+		static int workSize(int M, int N, SvdJob jobU, SvdJob jobV) {
+			const int L = BasicBatchKernel< T >::LANES;
+			const int P = std::max(M, N);
+			const int Q = std::min(M, N);
+			const bool accumulates = (M >= N ? jobV : jobU) != SVD_NONE;
+			return L * (P * Q + (accumulates ? Q * Q : 0));
+		}
+
+		/**
+		 * Decomposes a group of matrices that fits in the lanes.
+		 *
+		 * Arguments are the same as `decompose` except for `lanes` and
+		 * `pBlock`.
+		 * Lanes beyond `lanes` are filled with zero matrices, which need no
+		 * rotations.
+		 *
+		 * If `M < N`, the transposed matrices are decomposed instead.
+		 *
+		 * @param lanes
+		 *     Number of matrices in the group.
+		 *     At most `BasicBatchKernel< T >::LANES`.
+		 * @param pBlock
+		 *     Memory block for the interleaved matrices.
+		 *     Must have at least `workSize< T >(M, N, jobU, jobV)`
+		 *     elements.
+		 */
+		template < typename T >
+		static void decomposeGroup(int M,
+								   int N,
+								   int lanes,
+								   const T a[],
+								   T u[],
+								   T s[],
+								   T v[],
+								   SvdJob jobU,
+								   SvdJob jobV,
+								   T* pBlock)
+		{
+			const int L = BasicBatchKernel< T >::LANES;
+			assert(lanes >= 1 && lanes <= L);
+			// A^T = V * S^T * U^T
+			const bool transposed = M < N;
+			const int P = transposed ? N : M;
+			const int Q = transposed ? M : N;
+			const SvdJob jobLeft = transposed ? jobV : jobU;
+			const SvdJob jobRight = transposed ? jobU : jobV;
+			T* left = transposed ? v : u;
+			T* right = transposed ? u : v;
+			// interleaves the columns of the matrices
+			// the ith element in the jth column of the lth lane is at
+			// x[(j * P + i) * L + l]
+			// normalizes each matrix by its maximum amplitude so that sums
+			// of squares in rotations neither overflow nor underflow
+			T* x = pBlock;
+			T* w = pBlock + L * P * Q;
+			T scales[BasicBatchKernel< T >::LANES];
+			std::fill(x, x + L * P * Q, T(0));
+			for (int l = 0; l < lanes; ++l) {
+				const T* al = a + l * M * N;
+				T mx = 0;
+				for (int i = 0; i < M * N; ++i) {
+					mx = std::max(std::abs(al[i]), mx);
+				}
+				scales[l] = mx;
+				const T r = mx > 0 ? T(1) / mx : T(1);
+				for (int i = 0; i < M; ++i) {
+					for (int j = 0; j < N; ++j) {
+						const int k = transposed ? (i * P + j) : (j * P + i);
+						x[k * L + l] = al[i * N + j] * r;
+					}
+				}
+			}
+			const int wRows = jobRight != SVD_NONE ? Q : 0;
+			if (wRows > 0) {
+				std::fill(w, w + L * Q * Q, T(0));
+				for (int j = 0; j < Q; ++j) {
+					std::fill(w + (j * Q + j) * L,
+							  w + (j * Q + j + 1) * L,
+							  T(1));
+				}
+			}
+			// sweeps over every pair of columns until they are orthogonal
+			// X stands in for W if W is not accumulated;
+			// no rows of it are rotated then
+			const BasicBatchKernel< T >& kernel =
+				BasicBatchKernel< T >::best();
+			const T tol = std::sqrt(T(P)) * SvdKernel::tolerance< T >();
+			const int wStride = wRows > 0 ? L * Q : 0;
+			T* const wBase = wRows > 0 ? w : x;
+			for (int sweep = 0; sweep < MAX_SWEEPS; ++sweep) {
+				bool rotated = false;
+				for (int p = 0; p + 1 < Q; ++p) {
+					for (int q = p + 1; q < Q; ++q) {
+						rotated |= kernel.orthogonalize(x + L * P * p,
+														x + L * P * q,
+														P,
+														wBase + wStride * p,
+														wBase + wStride * q,
+														wRows,
+														tol);
+					}
+				}
+				if (!rotated) {
+					break;
+				}
+			}
+			// singular values are the norms of the columns
+			// scaled back to the input matrices at last
+			const int leftColumns = columnsFor(jobLeft, P, Q);
+			const int rightColumns = columnsFor(jobRight, Q, Q);
+			for (int l = 0; l < lanes; ++l) {
+				T* sl = s + l * Q;
+				for (int j = 0; j < Q; ++j) {
+					sl[j] = columnNorm(x + j * P * L + l, P, L);
+				}
+				// sorts singular values in descending order
+				// by swapping columns in the lane
+				for (int i = 0; i + 1 < Q; ++i) {
+					int iMax = i;
+					for (int j = i + 1; j < Q; ++j) {
+						if (sl[j] > sl[iMax]) {
+							iMax = j;
+						}
+					}
+					if (iMax != i) {
+						std::swap(sl[i], sl[iMax]);
+						swapColumns(x, P, L, l, i, iMax);
+						swapColumns(w, wRows, L, l, i, iMax);
+					}
+				}
+				if (leftColumns > 0) {
+					BasicMatrixView< T > ul(
+						left + l * P * leftColumns, P, leftColumns);
+					// columns that meet negligible singular values are
+					// rounding errors whose dot products may underflow and
+					// escape orthogonalization, so they are completed
+					const T negligible = std::max(
+						tol * sl[0], std::numeric_limits< T >::min());
+					for (int k = 0; k < leftColumns; ++k) {
+						if (k < Q && sl[k] > negligible) {
+							const T* xk = x + k * P * L + l;
+							for (int i = 0; i < P; ++i) {
+								ul(i, k) = xk[i * L] / sl[k];
+							}
+						} else {
+							completeColumn(ul, k);
+						}
+					}
+				}
+				if (rightColumns > 0) {
+					BasicMatrixView< T > vl(
+						right + l * Q * rightColumns, Q, rightColumns);
+					for (int k = 0; k < rightColumns; ++k) {
+						const T* wk = w + k * Q * L + l;
+						for (int i = 0; i < Q; ++i) {
+							vl(i, k) = wk[i * L];
+						}
+					}
+				}
+				for (int j = 0; j < Q; ++j) {
+					sl[j] *= scales[l];
+				}
+			}
+		}
+
+		/**
+		 * Computes the norm of a column in a single lane of interleaved
+		 * matrices.
+		 *
+		 * Elements are normalized by the maximum amplitude to avoid
+		 * harmful underflow and overflow.
+		 *
+		 * @param x
+		 *     First element of the column in the lane.
+		 * @param rows
+		 *     Number of rows in the column.
+		 * @param L
+		 *     Number of lanes.
+		 * @return
+		 *     Euclidean norm of the column.
+		 */
+		template < typename T >
+		static T columnNorm(const T* x, int rows, int L) {
+			T mx = 0;
+			for (int i = 0; i < rows; ++i) {
+				mx = std::max(std::abs(x[i * L]), mx);
+			}
+			if (!(mx > 0)) {
+				return mx;
+			}
+			T sum = 0;
+			for (int i = 0; i < rows; ++i) {
+				const T xi = x[i * L] / mx;
+				sum += xi * xi;
+			}
+			return std::sqrt(sum) * mx;
+		}
+
+		/**
+		 * Swaps given two columns in a single lane of interleaved
+		 * matrices.
+		 *
+		 * @param[in,out] x
+		 *     Interleaved matrices.
+		 * @param rows
+		 *     Number of rows in each matrix.
+		 *     Nothing happens if this is 0.
+		 * @param L
+		 *     Number of lanes.
+		 * @param l
+		 *     Index of the lane.
+		 * @param j1
+		 *     Index of one column to be swapped.
+		 * @param j2
+		 *     Index of the other column to be swapped.
+		 */
+		template < typename T >
+		static void swapColumns(T* x, int rows, int L, int l, int j1, int j2)
+		{
+			T* x1 = x + j1 * rows * L + l;
+			T* x2 = x + j2 * rows * L + l;
+			for (int i = 0; i < rows; ++i) {
+				std::swap(x1[i * L], x2[i * L]);
+			}
+		}
+
+		/**
+		 * Returns the number of columns in singular vectors to be
+		 * computed.
+		 *
+		 * @param job
+		 *     How much of singular vectors is computed.
+		 * @param full
+		 *     Number of columns for `SVD_FULL`.
+		 * @param thin
+		 *     Number of columns for `SVD_THIN`.
+		 * @return
+		 *     Number of columns.
+		 */
+		static inline int columnsFor(SvdJob job, int full, int thin) {
+			switch (job) {
+			case SVD_NONE:
+				return 0;
+			case SVD_THIN:
+				return thin;
+			default:
+				return full;
+			}
+		}
+
+		/**
+		 * Makes a given column a unit vector orthogonal to the columns on
+		 * its left.
+		 *
+		 * Columns on the left of `k` must be orthonormal.
+		 * Starts from the unit vector least covered by those columns and
+		 * orthogonalizes it twice by Gram-Schmidt.
+		 * Needed for columns that meet singular values of 0 and for the
+		 * columns beyond `min(M, N)` of full singular vectors.
+		 *
+		 * @param[in,out] m
+		 *     Matrix whose column is to be completed.
+		 *     Must have more rows than `k`.
+		 * @param k
+		 *     Index of the column to be completed.
+		 */
+		template < typename T >
+		static void completeColumn(BasicMatrixView< T > m, int k) {
+			const int M = m.rows();
+			assert(k < M);
+			int start = 0;
+			T minCovered = std::numeric_limits< T >::max();
+			for (int i = 0; i < M; ++i) {
+				T covered = 0;
+				for (int j = 0; j < k; ++j) {
+					covered += m(i, j) * m(i, j);
+				}
+				if (covered < minCovered) {
+					minCovered = covered;
+					start = i;
+				}
+			}
+			for (int i = 0; i < M; ++i) {
+				m(i, k) = (i == start) ? T(1) : T(0);
+			}
+			for (int pass = 0; pass < 2; ++pass) {
+				for (int j = 0; j < k; ++j) {
+					T d = 0;
+					for (int i = 0; i < M; ++i) {
+						d += m(i, j) * m(i, k);
+					}
+					for (int i = 0; i < M; ++i) {
+						m(i, k) -= d * m(i, j);
+					}
+				}
+			}
+			T sum = 0;
+			for (int i = 0; i < M; ++i) {
+				sum += m(i, k) * m(i, k);
+			}
+			const T norm = std::sqrt(sum);
+			for (int i = 0; i < M; ++i) {
+				m(i, k) /= norm;
+			}
+		}
+	};
+
+}
+
+#endif
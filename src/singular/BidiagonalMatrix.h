@@ -0,0 +1,385 @@
+#ifndef _SINGULAR_BIDIAGONAL_MATRIX_H
+#define _SINGULAR_BIDIAGONAL_MATRIX_H
+
+#include "singular/Rotator.h"
+#include "singular/singular.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace singular {
+
+	/**
+	 * Square bidiagonal matrix that wraps a given memory block.
+	 *
+	 * The size `L` of a bidiagonal matrix is given at runtime.
+	 * A bidiagonal matrix looks like,
+	 * \f[
+	 * \mathbf{A} = \begin{bmatrix}
+	 *   \beta_1 & \gamma_1 &          &             &              \\
+	 *           & \beta_2  & \gamma_2 &             &              \\
+	 *           &          & \ddots   & \ddots      &              \\
+	 *           &          &          & \beta_{L-1} & \gamma_{L-1} \\
+	 *           &          &          &             & \beta_L
+	 * \end{bmatrix}
+	 * \f]
+	 *
+	 * A bidiagonal matrix does not own the memory block.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	class BasicBidiagonalMatrix {
+	private:
+		/**
+		 * Memory block for the bidiagonal elements.
+		 * The number of elements is `2 * L - 1`.
+		 *
+		 * The ith diagonal element is given by `pBlock[i * 2]`.
+		 * The ith upper-diagonal element is given by `pBlock[i * 2 + 1]`.
+		 */
+		T* pBlock;
+
+		/** Size of this matrix. */
+		int len;
+	public:
+		/**
+		 * Initializes a bidiagonal matrix that wraps a given memory block.
+		 *
+		 * `pBlock` must be valid during this matrix is used.
+		 * It is the caller's responsibility to release `pBlock` when it is no
+		 * longer needed.
+		 * Elements are not initialized.
+		 *
+		 * @param pBlock
+		 *     Memory block for the bidiagonal elements.
+		 *     Must have at least `2 * size - 1` elements.
+		 * @param size
+		 *     Size of the matrix.
+		 *     Must be greater than 0.
+		 */
+		BasicBidiagonalMatrix(T* pBlock, int size)
+			: pBlock(pBlock), len(size)
+		{
+			assert(size > 0);
+		}
+
+		/**
+		 * Returns the size of this matrix.
+		 *
+		 * @return
+		 *     Number of rows and columns in this matrix.
+		 */
+		inline int size() const {
+			return this->len;
+		}
+
+		/**
+		 * Fills this matrix with bidiagonal elements of a given matrix.
+		 *
+		 * **Only bidiagonal elements are taken from `m` whether it is
+		 * bidiagonal or not.**
+		 *
+		 * The behavior is undefined if `m` has less rows or columns than
+		 * this matrix.
+		 *
+		 * @tparam MatrixLike
+		 *     Type of the given matrix.
+		 *     `Matrix` or `MatrixView`.
+		 * @param m
+		 *     Matrix from which bidiagonal elements are to be taken.
+		 */
+		template < typename MatrixLike >
+		void fill(const MatrixLike& m) {
+			assert(m.rows() >= this->len && m.columns() >= this->len);
+			for (int i = 0; i < this->len; ++i) {
+				this->pBlock[i * 2] = m(i, i);
+				if (i < this->len - 1) {
+					this->pBlock[i * 2 + 1] = m(i, i + 1);
+				}
+			}
+		}
+
+		/**
+		 * Returns the element at given row and column.
+		 *
+		 * Values are 0 unless `i == j` or `i == j + 1`.
+		 *
+		 * The behavior is undefined,
+		 *  - if `i < 0` or `i >= L`,
+		 *  - or if `j < 0` or `j >= L`
+		 *
+		 * @param i
+		 *     Index of the row to be obtained.
+		 * @param j
+		 *     Index of the column to be obtained.
+		 * @return
+		 *     Element at the given row and column.
+		 */
+		T operator ()(int i, int j) const {
+			assert(i >= 0 && i < this->len);
+			assert(j >= 0 && j < this->len);
+			if (i == j) {
+				return this->pBlock[2 * i];
+			} else if (i + 1 == j) {
+				return this->pBlock[2 * i + 1];
+			} else {
+				return 0.0;
+			}
+		}
+
+		/**
+		 * Returns a reference to a given diagonal element.
+		 *
+		 * The behavior is undefined if `i < 0` or `i >= L`.
+		 *
+		 * @param i
+		 *     Index of the diagonal element.
+		 * @return
+		 *     Reference to the element at (i, i).
+		 */
+		inline T& diagonal(int i) {
+			assert(i >= 0 && i < this->len);
+			return this->pBlock[2 * i];
+		}
+
+		/**
+		 * Returns a reference to a given upper-diagonal element.
+		 *
+		 * The behavior is undefined if `i < 0` or `i + 1 >= L`.
+		 *
+		 * @param i
+		 *     Index of the row of the upper-diagonal element.
+		 * @return
+		 *     Reference to the element at (i, i + 1).
+		 */
+		inline T& upperDiagonal(int i) {
+			assert(i >= 0 && i + 1 < this->len);
+			return this->pBlock[2 * i + 1];
+		}
+
+		/**
+		 * Applies a given rotator from right-hand-side of this bidiagonal
+		 * matrix at the first time.
+		 *
+		 * Works like the following,
+		 * \f[
+		 * \begin{bmatrix}
+		 *   * & * &   &   &        \\
+		 *     & * & * &   &        \\
+		 *     &   & * & * &        \\
+		 *     &   &   & * & \ddots \\
+		 *     &   &   &   & \ddots
+		 * \end{bmatrix}
+		 * \begin{bmatrix}
+		 *   \mathbf{Q} &            \\
+		 *              & \mathbf{I}
+		 * \end{bmatrix}
+		 * \to
+		 * \begin{bmatrix}
+		 *   * & * &   &   &        \\
+		 *   + & * & * &   &        \\
+		 *     &   & * & * &        \\
+		 *     &   &   & * & \ddots \\
+		 *     &   &   &   & \ddots
+		 * \end{bmatrix}
+		 * \f]
+		 * where
+		 * \f[
+		 * \begin{array}{ccl}
+		 * \mathbf{Q} & : & 2 \times 2 \text{ rotator} \\
+		 * \mathbf{I} & : & (L-2) \times (L-2) \text{ identity matrix} \\
+		 * +          & : & \text{bulge}
+		 * \end{array}
+		 * \f]
+		 *
+		 * If `n > 0`, the rotator is applied at the top of the block that
+		 * starts at the row and column `n` instead of the whole matrix.
+		 * The upper-diagonal element at (n - 1, n) is not touched and
+		 * is supposed to be 0.
+		 *
+		 * The behavior is undefined if `n < 0` or `n + 1 >= L`.
+		 *
+		 * @param r
+		 *     Rotator to be applied from right-hand-side of this bidiagonal
+		 *     matrix.
+		 * @param n
+		 *     Index of the first row and column of the block.
+		 * @return
+		 *     Bulge made at (n + 1, n).
+		 */
+		T applyFirstRotatorFromRight(const BasicRotator< T >& r, int n = 0) {
+			assert(n >= 0 && n + 1 < this->len);
+			T* p = this->pBlock + n * 2;
+			T b1 = p[0];
+			T g1 = p[1];
+			T b2 = p[2];
+			T r11 = r(0, 0);
+			T r12 = r(0, 1);
+			T r21 = r(1, 0);
+			T r22 = r(1, 1);
+			p[0] = b1 * r11 + g1 * r21;
+			p[1] = b1 * r12 + g1 * r22;
+			p[2] = b2 * r22;
+			return b2 * r21;
+		}
+
+		/**
+		 * Applies a given rotator from right-hand-side of this bidiagonal
+		 * matrix.
+		 *
+		 * Works like the following,
+		 * \f[
+		 * \begin{bmatrix}
+		 *   \ddots & \ddots &   &   &   &        \\
+		 *          & *      & * & + &   &        \\
+		 *          &        & * & * &   &        \\
+		 *          &        &   & * & * &        \\
+		 *          &        &   &   & * & \ddots \\
+		 *          &        &   &   &   & \ddots
+		 * \end{bmatrix}
+		 * \begin{bmatrix}
+		 *   \mathbf{I}_1 &            &              \\
+		 *                & \mathbf{Q} &              \\
+		 *                &            & \mathbf{I}_2
+		 * \end{bmatrix}
+		 * \to
+		 * \begin{bmatrix}
+		 *   \ddots & \ddots &   &   &   &        \\
+		 *          & *      & * &   &   &        \\
+		 *          &        & * & * &   &        \\
+		 *          &        & + & * & * &        \\
+		 *          &        &   &   & * & \ddots \\
+		 *          &        &   &   &   & \ddots
+		 * \end{bmatrix}
+		 * \f]
+		 * where
+		 * \f[
+		 * \begin{array}{ccl}
+		 *   \mathbf{Q}   & : & 2 \times 2 \text{ rotator} \\
+		 *   \mathbf{I}_1 & : & n \times n \text{ identity matrix} \\
+		 *   \mathbf{I}_2 & : & (L-n-2) \times (L-n-2) \text{ identity matrix} \\
+		 *   +            & : & \text{bulge}
+		 * \end{array}
+		 * \f]
+		 *
+		 * The behavior is undefined if `n <= 0` or `n + 1 >= L`.
+		 *
+		 * @param r
+		 *     Rotator to be applied from right-hand-side of this bidiagonal
+		 *     matrix.
+		 * @param n
+		 *     Index of the column where a new bulge is to be made.
+		 * @param bulge
+		 *     Bulge at (n - 1, n + 1).
+		 * @return
+		 *     Bulge made at (n + 1, n).
+		 */
+		T applyRotatorFromRight(
+			const BasicRotator< T >& r, int n, T bulge)
+		{
+			T* p = this->pBlock + n * 2;
+			T g0 = p[-1];
+			T b1 = p[0];
+			T g1 = p[1];
+			T b2 = p[2];
+			T r11 = r(0, 0);
+			T r12 = r(0, 1);
+			T r21 = r(1, 0);
+			T r22 = r(1, 1);
+			p[-1] = g0 * r11 + bulge * r21;
+			p[0] = b1 * r11 + g1 * r21;
+			p[1] = b1 * r12 + g1 * r22;
+			p[2] = b2 * r22;
+			return b2 * r21;
+		}
+
+		/**
+		 * Applies a given rotator from left-hand-side of this bidiagonal
+		 * matrix.
+		 *
+		 * Works like the following,
+		 * \f[
+		 * \begin{bmatrix}
+		 *   \mathbf{I}_1 &              &              \\
+		 *                & \mathbf{Q}^T &              \\
+		 *                &              & \mathbf{I}_2
+		 * \end{bmatrix}
+		 * \begin{bmatrix}
+		 *   \ddots & \ddots &   &   &   &        \\
+		 *          & *      & * &   &   &        \\
+		 *          &        & * & * &   &        \\
+		 *          &        & + & * & * &        \\
+		 *          &        &   &   & * & \ddots \\
+		 *          &        &   &   &   & \ddots
+		 * \end{bmatrix}
+		 * \to
+		 * \begin{bmatrix}
+		 *   \ddots & \ddots &   &   &   &        \\
+		 *          & *      & * &   &   &        \\
+		 *          &        & * & * & + &        \\
+		 *          &        &   & * & * &        \\
+		 *          &        &   &   & * & \ddots \\
+		 *          &        &   &   &   & \ddots
+		 * \end{bmatrix}
+		 * \f]
+		 * where
+		 * \f[
+		 * \begin{array}{ccl}
+		 *   \mathbf{Q}   & : & 2 \times 2 \text{ rotator} \\
+		 *   \mathbf{I}_1 & : & n \times n \text{ identity matrix} \\
+		 *   \mathbf{I}_2 & : & (L-n-2) \times (L-n-2) \text{ identity matrix} \\
+		 *   +            & : & \text{bulge}
+		 * \end{array}
+		 * \f]
+		 *
+		 * The behavior is undefined if `n + 1 >= L`.
+		 *
+		 * @param r
+		 *     Rotator to be applied from left-hand-side of this bidiagonal
+		 *     matrix.
+		 * @param n
+		 *     Index of the row where a new bulge is to be made.
+		 * @param bulge
+		 *     Bulge at (n + 1, n).
+		 * @return
+		 *     Bulge made at (n, n + 2).
+		 *     0.0 if `n + 2 >= L`.
+		 */
+		T applyRotatorFromLeft(const BasicRotator< T >& r, int n, T bulge) {
+			T* p = this->pBlock + n * 2;
+			T b1 = p[0];
+			T g1 = p[1];
+			T b2 = p[2];
+			T r11 = r(0, 0);
+			T r12 = r(0, 1);
+			T r21 = r(1, 0);
+			T r22 = r(1, 1);
+			p[0] = r11 * b1 + r21 * bulge;
+			p[1] = r11 * g1 + r21 * b2;
+			p[2] = r12 * g1 + r22 * b2;
+			T newBulge;
+			if (n < this->len - 2) {
+				// leaves a zero element untouched so that blocks split at it
+				// can be processed concurrently
+				T g2 = p[3];
+				if (g2 != 0.0) {
+					newBulge = r21 * g2;
+					p[3] = r22 * g2;
+				} else {
+					newBulge = 0.0;
+				}
+			} else {
+				newBulge = 0.0;
+			}
+			return newBulge;
+		}
+	};
+
+	/** Bidiagonal matrix of `double` elements. */
+	typedef BasicBidiagonalMatrix< double > BidiagonalMatrix;
+
+}
+
+#endif
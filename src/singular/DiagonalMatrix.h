@@ -1,18 +1,27 @@
 #ifndef _SINGULAR_DIAGONAL_MATRIX_H
 #define _SINGULAR_DIAGONAL_MATRIX_H
 
+#include "singular/MemoryBlock.h"
 #include "singular/singular.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <utility>
 
 namespace singular {
 
 	/**
 	 * Diagonal matrix.
+	 *
+	 * @tparam M
+	 *     Number of rows.
+	 * @tparam N
+	 *     Number of columns.
+	 * @tparam T
+	 *     Type of elements.
 	 */
-	template < int M, int N >
+	template < int M, int N, typename T = double >
 	class DiagonalMatrix {
 	public:
 		enum {
@@ -22,14 +31,14 @@ namespace singular {
 	private:
 		/**
 		 * Memory block for the diagonal elements.
-		 * The ith row and ith column is given by `elements[i]`.
+		 * The ith row and ith column is given by `block.data()[i]`.
+		 * Stored inline if the matrix is small enough.
 		 */
-		double* pBlock;
+		MemoryBlock< L, T > block;
 	public:
 		/** Initializes a diagonal matrix filled with 0. */
 		DiagonalMatrix() {
-			this->pBlock = new double[L];
-			std::fill(this->pBlock, this->pBlock + L, 0.0);
+			std::fill(this->block.data(), this->block.data() + L, 0.0);
 		}
 
 		/**
@@ -50,9 +59,8 @@ namespace singular {
 		 * @param values
 		 *     Diagonal values of the matrix.
 		 */
-		explicit DiagonalMatrix(const double values[]) {
-			this->pBlock = new double[L];
-			memcpy(this->pBlock, values, sizeof(double) * L);
+		explicit DiagonalMatrix(const T values[]) {
+			memcpy(this->block.data(), values, sizeof(T) * L);
 		}
 
 		/**
@@ -63,20 +71,12 @@ namespace singular {
 		 *     No loger valid after this call.
 		 */
 #if SINGULAR_RVALUE_REFERENCE_SUPPORTED
-		DiagonalMatrix(DiagonalMatrix&& copyee) : pBlock(copyee.pBlock) {
-			copyee.pBlock = nullptr;
-		}
+		DiagonalMatrix(DiagonalMatrix&& copyee)
+			: block(std::move(copyee.block)) {}
 #else
-		DiagonalMatrix(const DiagonalMatrix& copyee) : pBlock(copyee.pBlock) {
-			const_cast< DiagonalMatrix& >(copyee).pBlock = nullptr;
-		}
+		DiagonalMatrix(const DiagonalMatrix& copyee) : block(copyee.block) {}
 #endif
 
-		/** Releases the memory block of this diagonal matrix. */
-		~DiagonalMatrix() {
-			this->release();
-		}
-
 		/**
 		 * Steals the memory block from a given diagonal matrix.
 		 *
@@ -88,15 +88,10 @@ namespace singular {
 		 */
 #if SINGULAR_RVALUE_REFERENCE_SUPPORTED
 		DiagonalMatrix& operator =(DiagonalMatrix&& copyee) {
+			this->block = std::move(copyee.block);
 #else
 		DiagonalMatrix& operator =(const DiagonalMatrix& copyee) {
-#endif
-			this->release();
-			this->pBlock = copyee.pBlock;
-#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
-			copyee.pBlock = nullptr;
-#else
-			const_cast< DiagonalMatrix& >(copyee).pBlock = nullptr;
+			this->block = copyee.block;
 #endif
 			return *this;
 		}
@@ -108,7 +103,7 @@ namespace singular {
 		 *     Clone of this matrix.
 		 */
 		inline DiagonalMatrix clone() const {
-			return DiagonalMatrix(this->pBlock);
+			return DiagonalMatrix(this->block.data());
 		}
 
 		/**
@@ -126,24 +121,42 @@ namespace singular {
 		 *     Element at the ith row and jth column.
 		 *     0 if `i != j`.
 		 */
-		double operator ()(int i, int j) const {
+		T operator ()(int i, int j) const {
 			assert(i >= 0 && i < M);
 			assert(j >= 0 && j < N);
 			if (i == j) {
-				return this->pBlock[i];
+				return this->block.data()[i];
 			} else {
 				return 0.0;
 			}
 		}
 
+		/**
+		 * Fills the diagonal elements of this matrix with given values.
+		 *
+		 * The ith diagonal element is taken from `values[i]`.
+		 *
+		 * The behavior is undefined if `values` has less than `min(M, N)`
+		 * elements.
+		 *
+		 * @param values
+		 *     Values to fill the diagonal elements.
+		 * @return
+		 *     Reference to this matrix.
+		 */
+		DiagonalMatrix& fill(const T values[]) {
+			std::copy(values, values + L, this->block.data());
+			return *this;
+		}
+
 		/**
 		 * Transposes this matrix.
 		 *
 		 * @return
 		 *     Transposed matrix.
 		 */
-		DiagonalMatrix< N, M > transpose() const {
-			return DiagonalMatrix< N, M >(this->pBlock);
+		DiagonalMatrix< N, M, T > transpose() const {
+			return DiagonalMatrix< N, M, T >(this->block.data());
 		}
 	private:
 #if SINGULAR_FUNCTION_DELETION_SUPPORTED
@@ -161,15 +174,6 @@ namespace singular {
 			return *this;
 		}
 #endif
-
-		/**
-		 * Releases the memory block of this matrix.
-		 * Has no effect if the memory block has already been released.
-		 */
-		inline void release() {
-			delete[] this->pBlock;
-			this->pBlock = nullptr;
-		}
 	};
 
 }
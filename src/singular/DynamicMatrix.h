@@ -0,0 +1,639 @@
+#ifndef _SINGULAR_DYNAMIC_MATRIX_H
+#define _SINGULAR_DYNAMIC_MATRIX_H
+
+#include "singular/AlignedAllocator.h"
+#include "singular/Gemm.h"
+#include "singular/MatrixView.h"
+#include "singular/ThreadPool.h"
+#include "singular/singular.h"
+#include "singular/Transpose.h"
+#include "singular/Vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+namespace singular {
+
+	/**
+	 * Matrix whose dimensions are given at runtime.
+	 *
+	 * Works like `Matrix` but a single type covers matrices of every size.
+	 * Elements are always allocated on the heap, and aligned to
+	 * `SINGULAR_ALIGNMENT` bytes.
+	 *
+	 * Rows are packed unless a matrix is made by `padded`.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	class BasicDynamicMatrix {
+	private:
+		/**
+		 * Memory block for this matrix.
+		 *
+		 * Element at the row `i` and column `j` is given by
+		 * `pBlock[i * rowStride + j]`.
+		 * 0 if this matrix is empty.
+		 */
+		T* pBlock;
+
+		/** Number of rows. */
+		int nRows;
+
+		/** Number of columns. */
+		int nColumns;
+
+		/** Distance from one row to the next row. At least `nColumns`. */
+		int rowStride;
+	public:
+		/** Initializes an empty matrix that has no rows and no columns. */
+		BasicDynamicMatrix() : pBlock(0), nRows(0), nColumns(0), rowStride(0) {}
+
+		/**
+		 * Initializes a matrix filled with zeros.
+		 *
+		 * The behavior is undefined if `rows < 0` or `columns < 0`.
+		 *
+		 * @param rows
+		 *     Number of rows.
+		 * @param columns
+		 *     Number of columns.
+		 */
+		BasicDynamicMatrix(int rows, int columns)
+			: pBlock(AlignedAllocator< T >().allocate(rows * columns)),
+			  nRows(rows),
+			  nColumns(columns),
+			  rowStride(columns)
+		{
+			assert(rows >= 0 && columns >= 0);
+			std::fill(this->pBlock, this->pBlock + rows * columns, 0.0);
+		}
+
+		/**
+		 * Steals the memory block from a given matrix.
+		 *
+		 * @param[in,out] copyee
+		 *     Matrix from which the memory block is to be stolen.
+		 *     Becomes empty after this call.
+		 */
+#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
+		BasicDynamicMatrix(BasicDynamicMatrix&& copyee)
+#else
+		BasicDynamicMatrix(const BasicDynamicMatrix& copyee)
+#endif
+			: pBlock(copyee.pBlock),
+			  nRows(copyee.nRows),
+			  nColumns(copyee.nColumns),
+			  rowStride(copyee.rowStride)
+		{
+#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
+			copyee.release();
+#else
+			const_cast< BasicDynamicMatrix& >(copyee).release();
+#endif
+		}
+
+		/** Releases the memory block of this matrix. */
+		~BasicDynamicMatrix() {
+			AlignedAllocator< T >().deallocate(this->pBlock);
+		}
+
+		/**
+		 * Steals the memory block from a given matrix.
+		 *
+		 * @param[in,out] copyee
+		 *     Matrix from which the memory block is to be stolen.
+		 *     Becomes empty after this call.
+		 * @return
+		 *     Reference to this matrix.
+		 */
+#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
+		BasicDynamicMatrix& operator =(BasicDynamicMatrix&& copyee) {
+#else
+		BasicDynamicMatrix& operator =(const BasicDynamicMatrix& copyee) {
+#endif
+			if (this != &copyee) {
+				AlignedAllocator< T >().deallocate(this->pBlock);
+				this->pBlock = copyee.pBlock;
+				this->nRows = copyee.nRows;
+				this->nColumns = copyee.nColumns;
+				this->rowStride = copyee.rowStride;
+#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
+				copyee.release();
+#else
+				const_cast< BasicDynamicMatrix& >(copyee).release();
+#endif
+			}
+			return *this;
+		}
+
+		/**
+		 * Creates a clone of this matrix.
+		 *
+		 * A clone has the same contents and padding of this matrix but an
+		 * independent memory block from this matrix.
+		 *
+		 * @return
+		 *     Clone of this matrix.
+		 */
+		BasicDynamicMatrix clone() const {
+			BasicDynamicMatrix m(
+				UNINITIALIZED, this->nRows, this->nColumns, this->rowStride);
+			std::copy(this->pBlock, this->pBlock + this->size(), m.pBlock);
+			return m;
+		}
+
+		/**
+		 * Creates a matrix filled with zeros whose rows are padded.
+		 *
+		 * Every row starts at a `SINGULAR_ALIGNMENT`-byte boundary, and the
+		 * distance between rows is an odd number of alignment units.
+		 * So walking down a column touches every cache set instead of
+		 * thrashing a few of them, which happens when the number of
+		 * columns is a large power of two.
+		 *
+		 * @param rows
+		 *     Number of rows.
+		 * @param columns
+		 *     Number of columns.
+		 * @return
+		 *     `rows` x `columns` matrix whose leading dimension is
+		 *     `paddedLeadingDimension(columns)`.
+		 */
+		static BasicDynamicMatrix padded(int rows, int columns) {
+			assert(rows >= 0 && columns >= 0);
+			BasicDynamicMatrix m(UNINITIALIZED,
+								 rows,
+								 columns,
+								 paddedLeadingDimension(columns));
+			std::fill(m.pBlock, m.pBlock + m.size(), 0.0);
+			return m;
+		}
+
+		/**
+		 * Returns the padded distance between rows of a given length.
+		 *
+		 * Rounds `columns` up to a multiple of `SINGULAR_ALIGNMENT` bytes,
+		 * then adds one more alignment unit if the result is an even
+		 * number of units.
+		 *
+		 * @param columns
+		 *     Number of elements in a row.
+		 * @return
+		 *     Padded distance from one row to the next row.
+		 *     `columns` if `columns` is 0.
+		 */
+		static int paddedLeadingDimension(int columns) {
+			const int unit = static_cast< int >(
+				AlignedAllocator< T >::ALIGNMENT / sizeof(T));
+			if (columns == 0 || unit <= 1) {
+				return columns;
+			}
+			int units = (columns + unit - 1) / unit;
+			if (units % 2 == 0) {
+				++units;
+			}
+			return units * unit;
+		}
+
+		/**
+		 * Creates an identity matrix.
+		 *
+		 * @param rows
+		 *     Number of rows.
+		 * @param columns
+		 *     Number of columns.
+		 * @return
+		 *     `rows` x `columns` identity matrix.
+		 */
+		static BasicDynamicMatrix identity(int rows, int columns) {
+			const int L = rows < columns ? rows : columns;
+			BasicDynamicMatrix eye(rows, columns);
+			T* pDst = eye.pBlock;
+			for (int i = 0; i < L; ++i) {
+				*pDst = 1;
+				pDst += eye.rowStride + 1;
+			}
+			return eye;
+		}
+
+		/**
+		 * Creates a matrix filled with given values.
+		 *
+		 * The value at the ith row and jth column is taken from
+		 * `values[i * columns + j]`.
+		 *
+		 * The behavior is undefined if `values` has less than
+		 * `rows * columns` elements.
+		 *
+		 * @param rows
+		 *     Number of rows.
+		 * @param columns
+		 *     Number of columns.
+		 * @param values
+		 *     Values to fill the matrix.
+		 * @return
+		 *     `rows` x `columns` matrix filled with `values`.
+		 */
+		static BasicDynamicMatrix filledWith(int rows,
+											 int columns,
+											 const T values[])
+		{
+			BasicDynamicMatrix m(UNINITIALIZED, rows, columns);
+			memcpy(m.pBlock, values, sizeof(T) * rows * columns);
+			return m;
+		}
+
+		/**
+		 * Returns the number of rows in this matrix.
+		 *
+		 * @return
+		 *     Number of rows.
+		 */
+		inline int rows() const {
+			return this->nRows;
+		}
+
+		/**
+		 * Returns the number of columns in this matrix.
+		 *
+		 * @return
+		 *     Number of columns.
+		 */
+		inline int columns() const {
+			return this->nColumns;
+		}
+
+		/**
+		 * Returns the distance from one row to the next row in this matrix.
+		 *
+		 * @return
+		 *     Leading dimension.
+		 *     Equal to `this->columns()` unless this matrix is padded.
+		 */
+		inline int leadingDimension() const {
+			return this->rowStride;
+		}
+
+		/**
+		 * Returns the value at a given row and column.
+		 *
+		 * The behavior is undefined,
+		 *  - if `i < 0` or `i >= this->rows()`,
+		 *  - or if `j < 0` or `j >= this->columns()`
+		 *
+		 * @param i
+		 *     Index of the row to be obtained.
+		 * @param j
+		 *     Index of the column to be obtained.
+		 * @return
+		 *     Element at the ith row and jth column.
+		 *     Changes on a returned element is reflected to this matrix.
+		 */
+		inline T& operator ()(int i, int j) {
+			assert(i >= 0 && i < this->nRows);
+			assert(j >= 0 && j < this->nColumns);
+			return this->pBlock[i * this->rowStride + j];
+		}
+
+		/**
+		 * Returns the value at a given row and column.
+		 *
+		 * The behavior is undefined,
+		 *  - if `i < 0` or `i >= this->rows()`,
+		 *  - or if `j < 0` or `j >= this->columns()`
+		 *
+		 * @param i
+		 *     Index of the row to be obtained.
+		 * @param j
+		 *     Index of the column to be obtained.
+		 * @return
+		 *     Element at the ith row and jth column.
+		 */
+		inline T operator ()(int i, int j) const {
+			assert(i >= 0 && i < this->nRows);
+			assert(j >= 0 && j < this->nColumns);
+			return this->pBlock[i * this->rowStride + j];
+		}
+
+		/**
+		 * Returns a given row in this matrix as a modifiable vector.
+		 *
+		 * @param i
+		 *     Index of the row to be obtained.
+		 * @return
+		 *     ith row as a vector.
+		 *     Changes on this vector are reflected to this matrix.
+		 */
+		Vector< T > row(int i) {
+			return Vector< T >(
+				this->pBlock + i * this->rowStride, this->nColumns, 1);
+		}
+
+		/**
+		 * Returns a given row in this matrix as an unmodifiable vector.
+		 *
+		 * @param i
+		 *     Index of the row to be obtained.
+		 * @return
+		 *     ith row as a vector.
+		 */
+		Vector< const T > row(int i) const {
+			return Vector< const T >(
+				this->pBlock + i * this->rowStride, this->nColumns, 1);
+		}
+
+		/**
+		 * Returns a given column in this matrix as a modifiable vector.
+		 *
+		 * @param j
+		 *     Index of the column to be obtained.
+		 * @return
+		 *     jth column as a vector.
+		 *     Changes on this vector are reflected to this matrix.
+		 */
+		Vector< T > column(int j) {
+			return Vector< T >(
+				this->pBlock + j, this->nRows, this->rowStride);
+		}
+
+		/**
+		 * Returns a given column in this matrix as an unmodifiable vector.
+		 *
+		 * @param j
+		 *     Index of the column to be obtained.
+		 * @return
+		 *     jth column as a vector.
+		 */
+		Vector< const T > column(int j) const {
+			return Vector< const T >(
+				this->pBlock + j, this->nRows, this->rowStride);
+		}
+
+		/**
+		 * Fills this matrix with given values.
+		 *
+		 * The value at the ith row and jth column is taken from
+		 * `values[i * this->columns() + j]`.
+		 *
+		 * The behavior is undefined if `values` has less than
+		 * `this->rows() * this->columns()` elements.
+		 *
+		 * @param values
+		 *     Values to fill this matrix.
+		 * @return
+		 *     Reference to this matrix.
+		 */
+		BasicDynamicMatrix& fill(const T values[]) {
+			for (int i = 0; i < this->nRows; ++i) {
+				std::copy(values + i * this->nColumns,
+						  values + (i + 1) * this->nColumns,
+						  this->pBlock + i * this->rowStride);
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns a view of this matrix.
+		 *
+		 * A returned view shares the elements with this matrix, and is valid
+		 * as long as this matrix keeps the same memory block.
+		 *
+		 * @return
+		 *     View of this matrix.
+		 */
+		inline BasicMatrixView< T > view() {
+			return BasicMatrixView< T >(
+				this->pBlock, this->nRows, this->nColumns, this->rowStride);
+		}
+
+		/**
+		 * Returns the elements of this matrix.
+		 *
+		 * The element at the ith row and jth column is at
+		 * `i * this->leadingDimension() + j`.
+		 *
+		 * @return
+		 *     First element of this matrix.
+		 *     0 if this matrix is empty.
+		 */
+		inline T* data() {
+			return this->pBlock;
+		}
+
+		/**
+		 * Returns the elements of this matrix.
+		 *
+		 * The element at the ith row and jth column is at
+		 * `i * this->leadingDimension() + j`.
+		 *
+		 * @return
+		 *     First element of this matrix.
+		 *     0 if this matrix is empty.
+		 */
+		inline const T* data() const {
+			return this->pBlock;
+		}
+
+		/**
+		 * Transposes this matrix.
+		 *
+		 * @return
+		 *     Transposition of this matrix.
+		 */
+		BasicDynamicMatrix transpose() const {
+			BasicDynamicMatrix t(UNINITIALIZED, this->nColumns, this->nRows);
+			Transpose::copy(this->nRows,
+							this->nColumns,
+							this->pBlock,
+							this->rowStride,
+							t.pBlock,
+							this->nRows);
+			return t;
+		}
+
+		/**
+		 * Transposes this matrix in place.
+		 *
+		 * The behavior is undefined if `this->rows() != this->columns()`.
+		 *
+		 * @return
+		 *     Reference to this matrix.
+		 */
+		BasicDynamicMatrix& transposeInPlace() {
+			assert(this->nRows == this->nColumns);
+			Transpose::inPlace(this->nRows, this->pBlock, this->rowStride);
+			return *this;
+		}
+
+		/**
+		 * Multiplies this matrix by a given matrix.
+		 *
+		 * Computed by `Gemm`.
+		 * The behavior is undefined if `this->columns() != rhs.rows()`.
+		 *
+		 * @param rhs
+		 *     Right-hand side of the multiplication.
+		 * @return
+		 *     Product of this matrix and `rhs`.
+		 */
+		BasicDynamicMatrix operator *(const BasicDynamicMatrix& rhs) const {
+			assert(this->nColumns == rhs.nRows);
+			BasicDynamicMatrix product(
+				UNINITIALIZED, this->nRows, rhs.nColumns);
+			Gemm::multiply(this->nRows, rhs.nColumns, this->nColumns,
+						   this->pBlock, this->rowStride,
+						   rhs.pBlock, rhs.rowStride,
+						   product.pBlock, rhs.nColumns);
+			return product;
+		}
+
+		/**
+		 * Multiplies this matrix by a given matrix on a given thread pool.
+		 *
+		 * Rows of a large product are split among threads in `pool`.
+		 * The behavior is undefined if `this->columns() != rhs.rows()`.
+		 *
+		 * @param rhs
+		 *     Right-hand side of the multiplication.
+		 * @param pool
+		 *     Thread pool on which the product is computed.
+		 *     May be shared with others, and this may be called from its task.
+		 * @return
+		 *     Product of this matrix and `rhs`.
+		 */
+		BasicDynamicMatrix multiply(const BasicDynamicMatrix& rhs,
+									ThreadPool& pool) const
+		{
+			assert(this->nColumns == rhs.nRows);
+			BasicDynamicMatrix product(
+				UNINITIALIZED, this->nRows, rhs.nColumns);
+			Gemm::multiply(this->nRows, rhs.nColumns, this->nColumns,
+						   this->pBlock, this->rowStride,
+						   rhs.pBlock, rhs.rowStride,
+						   product.pBlock, rhs.nColumns,
+						   &pool);
+			return product;
+		}
+	private:
+		/** Tag to construct a matrix without initializing elements. */
+		enum Uninitialized {
+			/** Uninitialized elements. */
+			UNINITIALIZED
+		};
+
+		/**
+		 * Initializes a matrix without initializing elements.
+		 *
+		 * Elements have indeterminate values.
+		 *
+		 * @param rows
+		 *     Number of rows.
+		 * @param columns
+		 *     Number of columns.
+		 * @param stride
+		 *     Distance from one row to the next row.
+		 *     Must not be less than `columns`.
+		 */
+		BasicDynamicMatrix(Uninitialized, int rows, int columns, int stride)
+			: pBlock(AlignedAllocator< T >().allocate(rows * stride)),
+			  nRows(rows),
+			  nColumns(columns),
+			  rowStride(stride) {}
+
+		/**
+		 * Initializes a matrix whose rows are packed without initializing
+		 * elements.
+		 *
+		 * Elements have indeterminate values.
+		 *
+		 * @param rows
+		 *     Number of rows.
+		 * @param columns
+		 *     Number of columns.
+		 */
+		BasicDynamicMatrix(Uninitialized, int rows, int columns)
+			: pBlock(AlignedAllocator< T >().allocate(rows * columns)),
+			  nRows(rows),
+			  nColumns(columns),
+			  rowStride(columns) {}
+
+		/**
+		 * Returns the number of elements in the memory block of this matrix.
+		 *
+		 * @return
+		 *     Number of elements including padding.
+		 */
+		inline int size() const {
+			return this->nRows * this->rowStride;
+		}
+
+		/**
+		 * Makes this matrix empty without releasing the memory block.
+		 *
+		 * Called after the memory block is stolen.
+		 */
+		inline void release() {
+			this->pBlock = 0;
+			this->nRows = 0;
+			this->nColumns = 0;
+			this->rowStride = 0;
+		}
+
+#if SINGULAR_FUNCTION_DELETION_SUPPORTED
+		/** Simple copy is not allowed. */
+		BasicDynamicMatrix(const BasicDynamicMatrix& copyee) = delete;
+
+		/** Simple copy is not allowed. */
+		BasicDynamicMatrix& operator =(
+			const BasicDynamicMatrix& copyee) = delete;
+#elif SINGULAR_RVALUE_REFERENCE_SUPPORTED
+		/** Simple copy is not allowed. */
+		BasicDynamicMatrix(const BasicDynamicMatrix& copyee) {}
+
+		/** Simple copy is not allowed. */
+		BasicDynamicMatrix& operator =(const BasicDynamicMatrix& copyee) {
+			return *this;
+		}
+#endif
+	};
+
+	/**
+	 * Writes a given matrix to a given output stream.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 * @param out
+	 *     Output stream where the matrix is to be written.
+	 * @param m
+	 *     Matrix to be written.
+	 * @return
+	 *     `out`.
+	 */
+	template < typename T >
+	inline std::ostream& operator <<(std::ostream& out,
+									 const BasicDynamicMatrix< T >& m)
+	{
+		out << '[' << std::endl;
+		for (int i = 0; i < m.rows(); ++i) {
+			for (int j = 0; j < m.columns(); ++j) {
+				out << m(i, j);
+				if (j + 1 < m.columns()) {
+					out << ' ';
+				}
+			}
+			out << std::endl;
+		}
+		out << ']';
+		return out;
+	}
+
+	/** Matrix of `double` elements whose dimensions are given at runtime. */
+	typedef BasicDynamicMatrix< double > DynamicMatrix;
+
+}
+
+#endif
@@ -0,0 +1,556 @@
+#ifndef _SINGULAR_DYNAMIC_SVD_H
+#define _SINGULAR_DYNAMIC_SVD_H
+
+#include "singular/AlignedAllocator.h"
+#include "singular/BidiagonalMatrix.h"
+#include "singular/DynamicMatrix.h"
+#include "singular/MatrixView.h"
+#include "singular/SvdKernel.h"
+#include "singular/ThreadPool.h"
+#include "singular/singular.h"
+#include "singular/Transpose.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace singular {
+
+	/**
+	 * Singular value decomposition of matrices whose dimensions are given at
+	 * runtime.
+	 *
+	 * Works like `Svd` and `SvdWorkspace` but a single type covers matrices
+	 * of every size.
+	 * An instance owns every memory block needed for a decomposition and
+	 * results of the last decomposition.
+	 * Memory blocks are reallocated only when the shape of an input matrix
+	 * changes, so repeated decompositions of same-shaped matrices allocate
+	 * nothing.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	class BasicDynamicSvd {
+	private:
+		/** Left-singular-vectors. */
+		BasicDynamicMatrix< T > u;
+
+		/** Singular values in descending order. */
+		std::vector< T > s;
+
+		/** Right-singular-vectors. */
+		BasicDynamicMatrix< T > v;
+
+		/**
+		 * Memory block for the matrix to be decomposed.
+		 *
+		 * Laid out in the column-major order.
+		 * Holds the transposed matrix if it is wider than tall.
+		 */
+		std::vector< T, AlignedAllocator< T > > aBlock;
+
+		/** Memory block for the bidiagonal matrix made from `aBlock`. */
+		std::vector< T > bidiagonalBlock;
+
+		/** Memory block for reflectors. */
+		std::vector< T, AlignedAllocator< T > > workBlock;
+
+		/** Thread pool on which split blocks are iterated. May be 0. */
+		ThreadPool* pPool;
+	public:
+		/** Initializes an instance that has decomposed nothing yet. */
+		BasicDynamicSvd() : pPool(0) {}
+
+		/**
+		 * Initializes an instance that runs on a given thread pool.
+		 *
+		 * When the bidiagonal matrix splits into independent blocks during
+		 * a decomposition, blocks are iterated concurrently on `pool`.
+		 * `pool` must be valid during this instance is used.
+		 * A decomposition waits only for its own blocks, so `pool` may be
+		 * shared with others and a decomposition may run from its task.
+		 *
+		 * @param pool
+		 *     Thread pool on which split blocks are iterated.
+		 */
+		explicit BasicDynamicSvd(ThreadPool& pool) : pPool(&pool) {}
+
+		/**
+		 * Decomposes a given matrix into left singular vectors,
+		 * singular values and right singular vectors.
+		 *
+		 * \f[
+		 * \mathbf{A} = \mathbf{U} \mathbf{\Sigma} \mathbf{V}^T
+		 * \f]
+		 *
+		 * Singular vectors are computed as specified by `jobU` and `jobV`.
+		 *  - `SVD_FULL` computes all of singular vectors;
+		 *    i.e., `U` is `M` x `M` and `V` is `N` x `N`.
+		 *  - `SVD_THIN` computes only the first `min(M, N)` singular vectors;
+		 *    i.e., `U` is `M` x `min(M, N)` and `V` is `N` x `min(M, N)`.
+		 *  - `SVD_NONE` computes no singular vectors;
+		 *    i.e., `U` or `V` becomes empty.
+		 *
+		 * Skipped singular vectors cost neither memory nor time.
+		 *
+		 * Results of a previous decomposition are overwritten.
+		 *
+		 * @param m
+		 *     Matrix to be decomposed.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 * @return
+		 *     Reference to this instance.
+		 * @see getU
+		 * @see getS
+		 * @see getV
+		 */
+		BasicDynamicSvd& decomposeUSV(const BasicDynamicMatrix< T >& m,
+									  SvdJob jobU = SVD_FULL,
+									  SvdJob jobV = SVD_FULL)
+		{
+			const BasicMatrixView< T > view(const_cast< T* >(m.data()),
+											m.rows(),
+											m.columns(),
+											m.leadingDimension());
+			return this->decomposeUSV(view, jobU, jobV);
+		}
+
+		/**
+		 * Decomposes a matrix in a given view.
+		 *
+		 * Works like `decomposeUSV(const DynamicMatrix&, SvdJob, SvdJob)`
+		 * but reads elements straight from a memory block owned by the
+		 * caller, which may be laid out in either order and have padded
+		 * rows or columns.
+		 *
+		 * @param m
+		 *     Matrix to be decomposed.
+		 *     Not modified.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 * @return
+		 *     Reference to this instance.
+		 */
+		BasicDynamicSvd& decomposeUSV(const BasicMatrixView< T >& m,
+									  SvdJob jobU = SVD_FULL,
+									  SvdJob jobV = SVD_FULL)
+		{
+			this->reserve(m.rows(), m.columns(), jobU, jobV);
+			// works in the column-major order so that columns are contiguous
+			this->decomposeInto(m,
+								columnMajorView(this->u),
+								this->s.data(),
+								columnMajorView(this->v));
+			this->toRowMajor(this->u);
+			this->toRowMajor(this->v);
+			return *this;
+		}
+
+		/**
+		 * Decomposes a matrix in a given view into memory blocks owned by
+		 * the caller.
+		 *
+		 * Nothing is copied out of the decomposition; singular vectors are
+		 * computed in place in `u` and `v`.
+		 * Views may be laid out in either order, though column-major ones
+		 * are faster because the decomposition updates columns.
+		 * This instance provides only temporary memory blocks, so results
+		 * of a previous decomposition held by this instance are left
+		 * unchanged.
+		 *
+		 * Let `M = m.rows()`, `N = m.columns()` and `Q = min(M, N)`.
+		 * Singular vectors are computed as specified by `jobU` and `jobV`.
+		 *  - `SVD_FULL` computes all of singular vectors into an `M` x `M`
+		 *    `u` or an `N` x `N` `v`.
+		 *  - `SVD_THIN` computes only the first `Q` singular vectors into an
+		 *    `M` x `Q` `u` or an `N` x `Q` `v`.
+		 *  - `SVD_NONE` computes no singular vectors; `u` or `v` is ignored.
+		 *
+		 * The behavior is undefined,
+		 *  - if `u` or `v` does not match `jobU` or `jobV`,
+		 *  - or if `u` or `v` overlaps `m`
+		 *
+		 * @param m
+		 *     Matrix to be decomposed.
+		 *     Not modified.
+		 * @param[out] u
+		 *     Where left-singular-vectors are to be stored.
+		 * @param[out] s
+		 *     Where singular values are to be stored in descending order.
+		 *     Must have at least `Q` elements.
+		 * @param[out] v
+		 *     Where right-singular-vectors are to be stored.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 */
+		void decomposeUSV(const BasicMatrixView< T >& m,
+						  BasicMatrixView< T > u,
+						  T s[],
+						  BasicMatrixView< T > v,
+						  SvdJob jobU = SVD_FULL,
+						  SvdJob jobV = SVD_FULL)
+		{
+			const int M = m.rows();
+			const int N = m.columns();
+			const int Q = M < N ? M : N;
+			this->reserveWork(M, N);
+			this->decomposeInto(m,
+								SvdKernel::viewFor(u, jobU, M, Q),
+								s,
+								SvdKernel::viewFor(v, jobV, N, Q));
+		}
+
+		/**
+		 * Computes singular values of a given matrix.
+		 *
+		 * Equivalent to `decomposeUSV(m, SVD_NONE, SVD_NONE)`.
+		 * Singular values are computed by dqds which is much faster than
+		 * Francis iterations.
+		 *
+		 * @param m
+		 *     Matrix whose singular values are to be computed.
+		 * @return
+		 *     Reference to this instance.
+		 * @see getS
+		 */
+		inline BasicDynamicSvd& decomposeS(
+			const BasicDynamicMatrix< T >& m)
+		{
+			return this->decomposeUSV(m, SVD_NONE, SVD_NONE);
+		}
+
+		/**
+		 * Computes singular values of a matrix in a given view.
+		 *
+		 * Equivalent to `decomposeUSV(m, SVD_NONE, SVD_NONE)`.
+		 *
+		 * @param m
+		 *     Matrix whose singular values are to be computed.
+		 *     Not modified.
+		 * @return
+		 *     Reference to this instance.
+		 * @see getS
+		 */
+		inline BasicDynamicSvd& decomposeS(const BasicMatrixView< T >& m) {
+			return this->decomposeUSV(m, SVD_NONE, SVD_NONE);
+		}
+
+		/**
+		 * Returns the left-singular-vectors from the last decomposition.
+		 *
+		 * @return
+		 *     Left-singular-vectors.
+		 *     `M` x `M`, `M` x `min(M, N)` or empty depending on `jobU`,
+		 *     where `M` and `N` are the number of rows and columns in the
+		 *     last input matrix respectively.
+		 */
+		inline const BasicDynamicMatrix< T >& getU() const {
+			return this->u;
+		}
+
+		/**
+		 * Returns the singular values from the last decomposition.
+		 *
+		 * @return
+		 *     Singular values in descending order.
+		 *     Has `min(M, N)` elements where `M` and `N` are the number of
+		 *     rows and columns in the last input matrix respectively.
+		 */
+		inline const std::vector< T >& getS() const {
+			return this->s;
+		}
+
+		/**
+		 * Returns the right-singular-vectors from the last decomposition.
+		 *
+		 * @return
+		 *     Right-singular-vectors.
+		 *     `N` x `N`, `N` x `min(M, N)` or empty depending on `jobV`,
+		 *     where `M` and `N` are the number of rows and columns in the
+		 *     last input matrix respectively.
+		 */
+		inline const BasicDynamicMatrix< T >& getV() const {
+			return this->v;
+		}
+
+		/**
+		 * Multiplies the last decomposition back into a matrix.
+		 *
+		 * Equivalent to `U * S * V^T` but multiplies only singular vectors
+		 * that meet nonzero singular values.
+		 * Use `reconstruct(BasicDynamicMatrix< T >&)` to reuse memory
+		 * across reconstructions.
+		 *
+		 * The behavior is undefined if either of `U` or `V` has not been
+		 * computed; i.e., `SVD_NONE`.
+		 *
+		 * @return
+		 *     \f$\mathbf{U} \mathbf{\Sigma} \mathbf{V}^T\f$ whose dimensions
+		 *     are the same as the last input matrix.
+		 */
+		BasicDynamicMatrix< T > reconstruct() const {
+			const int M = this->u.rows();
+			const int N = this->v.rows();
+			const int Q = static_cast< int >(this->s.size());
+			assert(this->u.columns() >= Q && this->v.columns() >= Q);
+			BasicDynamicMatrix< T > m(M, N);
+			if (Q > 0) {
+				std::vector< T > work(
+					SvdKernel::reconstructWorkSize(M, N, Q));
+				SvdKernel::reconstruct(this->u, this->s.data(), this->v,
+									   M, N, Q,
+									   &m(0, 0), m.leadingDimension(),
+									   work.data());
+			}
+			return m;
+		}
+
+		/**
+		 * Multiplies the last decomposition back into a given matrix.
+		 *
+		 * Works like `reconstruct()` but reuses the memory of `m` and the
+		 * work memory of this decomposition instead of allocating them on
+		 * every call.
+		 *
+		 * @param[out] m
+		 *     Where \f$\mathbf{U} \mathbf{\Sigma} \mathbf{V}^T\f$ is to be
+		 *     stored.
+		 *     Reallocated if it does not have the dimensions of the last
+		 *     input matrix.
+		 *     Rows of a padded matrix stay padded.
+		 */
+		void reconstruct(BasicDynamicMatrix< T >& m) {
+			const int M = this->u.rows();
+			const int N = this->v.rows();
+			const int Q = static_cast< int >(this->s.size());
+			assert(this->u.columns() >= Q && this->v.columns() >= Q);
+			if (m.rows() != M || m.columns() != N) {
+				m = BasicDynamicMatrix< T >(M, N);
+			}
+			if (Q > 0) {
+				// work memory only grows and keeps its capacity
+				const size_t size = SvdKernel::reconstructWorkSize(M, N, Q);
+				if (this->workBlock.size() < size) {
+					this->workBlock.resize(size);
+				}
+				SvdKernel::reconstruct(this->u, this->s.data(), this->v,
+									   M, N, Q,
+									   &m(0, 0), m.leadingDimension(),
+									   this->workBlock.data());
+			}
+		}
+	private:
+		/**
+		 * Prepares memory blocks for an `M` x `N` matrix.
+		 *
+		 * Does nothing if memory blocks for the same shape are already
+		 * prepared.
+		 *
+		 * @param M
+		 *     Number of rows in an input matrix.
+		 * @param N
+		 *     Number of columns in an input matrix.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 */
+		void reserve(int M, int N, SvdJob jobU, SvdJob jobV) {
+			const int Q = M < N ? M : N;
+			reserve(this->u, M, columnsFor(jobU, M, Q));
+			reserve(this->v, N, columnsFor(jobV, N, Q));
+			this->s.resize(Q);
+			this->reserveWork(M, N);
+		}
+
+		/**
+		 * Prepares temporary memory blocks for an `M` x `N` matrix.
+		 *
+		 * @param M
+		 *     Number of rows in an input matrix.
+		 * @param N
+		 *     Number of columns in an input matrix.
+		 */
+		void reserveWork(int M, int N) {
+			const int P = M < N ? N : M;
+			const int Q = M < N ? M : N;
+			this->aBlock.resize(P * Q);
+			this->bidiagonalBlock.resize(Q > 0 ? 2 * Q - 1 : 0);
+			this->workBlock.resize(SvdKernel::workSize(P, Q));
+		}
+
+		/**
+		 * Decomposes a given matrix into given views.
+		 *
+		 * Memory blocks must have been prepared by `reserveWork`.
+		 *
+		 * @param m
+		 *     Matrix to be decomposed.
+		 * @param[out] u
+		 *     Where left-singular-vectors are to be stored.
+		 *     `M` x `M`, `M` x `min(M, N)` or without columns.
+		 * @param[out] s
+		 *     Where singular values are to be stored.
+		 * @param[out] v
+		 *     Where right-singular-vectors are to be stored.
+		 *     `N` x `N`, `N` x `min(M, N)` or without columns.
+		 */
+		void decomposeInto(const BasicMatrixView< T >& m,
+						   BasicMatrixView< T > u,
+						   T s[],
+						   BasicMatrixView< T > v)
+		{
+			const int M = m.rows();
+			const int N = m.columns();
+			const int P = M < N ? N : M;
+			const int Q = M < N ? M : N;
+			if (Q == 0) {
+				// nothing to decompose
+				SvdKernel::makeIdentity(u);
+				SvdKernel::makeIdentity(v);
+				return;
+			}
+			SvdKernel::copyColumnMajor(m, this->aBlock.data());
+			BasicMatrixView< T > a(this->aBlock.data(), P, Q, COLUMN_MAJOR);
+			BasicBidiagonalMatrix< T > b(this->bidiagonalBlock.data(), Q);
+			if (M >= N) {
+				SvdKernel::decomposeInPlace(u,
+											a,
+											b,
+											v,
+											this->workBlock.data(),
+											s,
+											this->pPool);
+			} else {
+				// A^T = V * S^T * U^T
+				SvdKernel::decomposeInPlace(v,
+											a,
+											b,
+											u,
+											this->workBlock.data(),
+											s,
+											this->pPool);
+			}
+		}
+
+		/**
+		 * Returns a column-major view over the memory block of a given
+		 * matrix.
+		 *
+		 * @param m
+		 *     Matrix whose memory block is to be viewed.
+		 * @return
+		 *     Column-major view that has the same dimensions as `m`.
+		 */
+		static BasicMatrixView< T > columnMajorView(
+			BasicDynamicMatrix< T >& m)
+		{
+			return BasicMatrixView< T >(
+				m.data(), m.rows(), m.columns(), COLUMN_MAJOR);
+		}
+
+		/**
+		 * Turns a given matrix computed in a view given by `columnMajorView`
+		 * into the row-major order.
+		 *
+		 * A non-square matrix goes through `aBlock` which is no longer
+		 * needed and is large enough for thin singular vectors.
+		 *
+		 * @param[in,out] m
+		 *     Matrix to be turned into the row-major order.
+		 */
+		void toRowMajor(BasicDynamicMatrix< T >& m) {
+			const int L = m.rows();
+			const int C = m.columns();
+			if (C == 0) {
+				return;
+			}
+			if (L == C) {
+				Transpose::inPlace(L, m.data(), L);
+				return;
+			}
+			assert(this->aBlock.size() >= static_cast< size_t >(L * C));
+			T* pColumnMajor = this->aBlock.data();
+			std::copy(m.data(), m.data() + L * C, pColumnMajor);
+			Transpose::copy(C, L, pColumnMajor, L, m.data(), C);
+		}
+
+		/**
+		 * Reallocates a given matrix unless it has given dimensions.
+		 *
+		 * A matrix with no rows or no columns is made empty.
+		 *
+		 * @param[in,out] m
+		 *     Matrix to be reallocated.
+		 * @param rows
+		 *     Number of rows.
+		 * @param columns
+		 *     Number of columns.
+		 */
+		static void reserve(BasicDynamicMatrix< T >& m,
+							int rows,
+							int columns)
+		{
+			if (rows == 0 || columns == 0) {
+				rows = columns = 0;
+			}
+			if (m.rows() != rows || m.columns() != columns) {
+				m = BasicDynamicMatrix< T >(rows, columns);
+			}
+		}
+
+		/**
+		 * Returns the number of singular vectors computed by a given job.
+		 *
+		 * @param job
+		 *     How much of singular vectors is computed.
+		 * @param L
+		 *     Number of all singular vectors.
+		 * @param Q
+		 *     Number of singular values.
+		 * @return
+		 *     Number of singular vectors to be computed.
+		 */
+		static int columnsFor(SvdJob job, int L, int Q) {
+			switch (job) {
+			case SVD_NONE:
+				return 0;
+			case SVD_THIN:
+				return Q;
+			default:
+				return L;
+			}
+		}
+
+#if SINGULAR_FUNCTION_DELETION_SUPPORTED
+		/** Copy constructor is not allowed. */
+		BasicDynamicSvd(const BasicDynamicSvd& copyee) = delete;
+
+		/** Copy assignment is not allowed. */
+		BasicDynamicSvd& operator =(const BasicDynamicSvd& copyee) = delete;
+#else
+		/** Copy constructor is not allowed. */
+		BasicDynamicSvd(const BasicDynamicSvd& copyee) {}
+
+		/** Copy assignment is not allowed. */
+		BasicDynamicSvd& operator =(const BasicDynamicSvd& copyee) {
+			return *this;
+		}
+#endif
+	};
+
+	/** Singular value decomposition of `double` matrices of any size. */
+	typedef BasicDynamicSvd< double > DynamicSvd;
+
+}
+
+#endif
@@ -0,0 +1,754 @@
+#ifndef _SINGULAR_GEMM_H
+#define _SINGULAR_GEMM_H
+
+#include "singular/AlignedAllocator.h"
+#include "singular/GemmKernel.h"
+#include "singular/ThreadPool.h"
+#include "singular/singular.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace singular {
+
+	/**
+	 * Cache-blocked multiplication of row-major matrices.
+	 *
+	 * Computes \f$\mathbf{C} = \mathbf{A} \mathbf{B}\f$ where
+	 * \f$\mathbf{A}\f$ is `M` x `K`, \f$\mathbf{B}\f$ is `K` x `N` and
+	 * \f$\mathbf{C}\f$ is `M` x `N`.
+	 *
+	 * Operands are split into blocks that fit in caches.
+	 * A `KC` x `NC` block of \f$\mathbf{B}\f$ is packed to stay in the L3
+	 * cache, and an `MC` x `KC` block of \f$\mathbf{A}\f$ is packed to stay
+	 * in the L2 cache.
+	 * Packed blocks are multiplied tile by tile with a `BasicGemmKernel`.
+	 *
+	 * Products too small to amortize packing are computed by a plain loop.
+	 */
+	struct Gemm {
+		/** Number of rows in a block of the left-hand-side matrix. */
+		static const int MC = 96;
+
+		/** Number of columns (rows) in a block of the left (right) matrix. */
+		static const int KC = 256;
+
+		/** Number of columns in a block of the right-hand-side matrix. */
+		static const int NC = 512;
+
+		/** Minimum `M * N * K` to be computed with blocks. */
+		static const long SMALL_PRODUCT_SIZE = 32L * 32L * 32L;
+
+		/** Minimum `M * N * K` to be split among threads. */
+		static const long MIN_CONCURRENT_PRODUCT_SIZE = 128L * 128L * 128L;
+
+		/** Maximum number of rows in a tile of any `BasicGemmKernel`. */
+		static const int MAX_MR = 8;
+
+		/** Maximum number of columns in a tile of any `BasicGemmKernel`. */
+		static const int MAX_NR = 16;
+
+		/**
+		 * Returns the number of elements in a memory block that
+		 * `multiplyBuffered` or `multiplyStridedBuffered` needs to pack
+		 * operands of a product.
+		 *
+		 * `GemmPackingSize` gives the same number at compile time.
+		 *
+		 * @param M
+		 *     Number of rows in the left-hand-side matrix.
+		 * @param N
+		 *     Number of columns in the right-hand-side matrix.
+		 * @param K
+		 *     Number of columns in the left-hand-side matrix.
+		 * @return
+		 *     Number of elements in the memory block.
+		 */
+		static inline int packingSize(int M, int N, int K) {
+			// blocks of the kernel with the largest tile are padded most
+			return std::min(K, int(KC)) *
+				(std::min(M + MAX_MR - 1, int(MC)) +
+				 std::min(N + MAX_NR - 1, int(NC))) +
+				MAX_MR * MAX_NR;
+		}
+
+		/**
+		 * Multiplies given two matrices.
+		 *
+		 * Equivalent to `multiplyWith(GemmKernel::best(), ...)`.
+		 *
+		 * @param M
+		 *     Number of rows in `a` and `c`.
+		 * @param N
+		 *     Number of columns in `b` and `c`.
+		 * @param K
+		 *     Number of columns in `a` and rows in `b`.
+		 * @param a
+		 *     Left-hand-side matrix.
+		 * @param lda
+		 *     Distance from one row to the next row in `a`.
+		 * @param b
+		 *     Right-hand-side matrix.
+		 * @param ldb
+		 *     Distance from one row to the next row in `b`.
+		 * @param[out] c
+		 *     Product of `a` and `b`.
+		 *     Must not overlap `a` or `b`.
+		 * @param ldc
+		 *     Distance from one row to the next row in `c`.
+		 * @param pPool
+		 *     Thread pool among which rows of a large product are split.
+		 *     Computed on the calling thread if this is 0.
+		 *     May be called from a task of this pool.
+		 */
+		static void multiply(int M,
+							 int N,
+							 int K,
+							 const double* a,
+							 ptrdiff_t lda,
+							 const double* b,
+							 ptrdiff_t ldb,
+							 double* c,
+							 ptrdiff_t ldc,
+							 ThreadPool* pPool = 0)
+		{
+			multiplyWith(GemmKernel::best(),
+						 M, N, K, a, lda, b, ldb, c, ldc, pPool);
+		}
+
+		/**
+		 * Multiplies given two matrices whose elements are apart by given
+		 * strides.
+		 *
+		 * The element at the ith row and jth column of `a` is
+		 * `a[i * rsA + j * csA]`, and so is `b`.
+		 * A transposed matrix, for instance, can be given by swapping
+		 * the strides.
+		 *
+		 * @param M
+		 *     Number of rows in `a` and `c`.
+		 * @param N
+		 *     Number of columns in `b` and `c`.
+		 * @param K
+		 *     Number of columns in `a` and rows in `b`.
+		 * @param a
+		 *     Left-hand-side matrix.
+		 * @param rsA
+		 *     Distance from one row to the next row in `a`.
+		 * @param csA
+		 *     Distance from one column to the next column in `a`.
+		 * @param b
+		 *     Right-hand-side matrix.
+		 * @param rsB
+		 *     Distance from one row to the next row in `b`.
+		 * @param csB
+		 *     Distance from one column to the next column in `b`.
+		 * @param[out] c
+		 *     Product of `a` and `b`.
+		 *     Must not overlap `a` or `b`.
+		 * @param ldc
+		 *     Distance from one row to the next row in `c`.
+		 * @param pPool
+		 *     Thread pool among which rows of a large product are split.
+		 *     Computed on the calling thread if this is 0.
+		 *     May be called from a task of this pool.
+		 */
+		static void multiplyStrided(int M,
+									int N,
+									int K,
+									const double* a,
+									ptrdiff_t rsA,
+									ptrdiff_t csA,
+									const double* b,
+									ptrdiff_t rsB,
+									ptrdiff_t csB,
+									double* c,
+									ptrdiff_t ldc,
+									ThreadPool* pPool = 0)
+		{
+			multiplyStridedWith(GemmKernel::best(),
+								M, N, K,
+								a, rsA, csA,
+								b, rsB, csB,
+								c, ldc,
+								pPool);
+		}
+
+		/**
+		 * Multiplies given two matrices with a given memory block to pack
+		 * operands.
+		 *
+		 * Works like `multiply` on the calling thread but allocates no
+		 * memory.
+		 *
+		 * @param pWork
+		 *     Memory block where operands are packed.
+		 *     Must have at least `packingSize(M, N, K)` elements.
+		 */
+		static void multiplyBuffered(int M,
+									 int N,
+									 int K,
+									 const double* a,
+									 ptrdiff_t lda,
+									 const double* b,
+									 ptrdiff_t ldb,
+									 double* c,
+									 ptrdiff_t ldc,
+									 double* pWork)
+		{
+			multiplyStridedBuffered(M, N, K,
+									a, lda, 1,
+									b, ldb, 1,
+									c, ldc,
+									pWork);
+		}
+
+		/**
+		 * Multiplies given two strided matrices with a given memory block
+		 * to pack operands.
+		 *
+		 * Works like `multiplyStrided` on the calling thread but allocates
+		 * no memory.
+		 *
+		 * @param pWork
+		 *     Memory block where operands are packed.
+		 *     Must have at least `packingSize(M, N, K)` elements.
+		 */
+		static void multiplyStridedBuffered(int M,
+											int N,
+											int K,
+											const double* a,
+											ptrdiff_t rsA,
+											ptrdiff_t csA,
+											const double* b,
+											ptrdiff_t rsB,
+											ptrdiff_t csB,
+											double* c,
+											ptrdiff_t ldc,
+											double* pWork)
+		{
+			multiplyStridedWith(GemmKernel::best(),
+								M, N, K,
+								a, rsA, csA,
+								b, rsB, csB,
+								c, ldc,
+								0,
+								pWork);
+		}
+
+		/**
+		 * Multiplies given two matrices with given kernels.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @param kernel
+		 *     Kernels that multiply tiles.
+		 * @param M
+		 *     Number of rows in `a` and `c`.
+		 * @param N
+		 *     Number of columns in `b` and `c`.
+		 * @param K
+		 *     Number of columns in `a` and rows in `b`.
+		 * @param a
+		 *     Left-hand-side matrix.
+		 * @param lda
+		 *     Distance from one row to the next row in `a`.
+		 * @param b
+		 *     Right-hand-side matrix.
+		 * @param ldb
+		 *     Distance from one row to the next row in `b`.
+		 * @param[out] c
+		 *     Product of `a` and `b`.
+		 *     Must not overlap `a` or `b`.
+		 * @param ldc
+		 *     Distance from one row to the next row in `c`.
+		 * @param pPool
+		 *     Thread pool among which rows of a large product are split.
+		 *     Computed on the calling thread if this is 0.
+		 *     May be called from a task of this pool.
+		 */
+		template < typename T >
+		static void multiplyWith(const BasicGemmKernel< T >& kernel,
+								 int M,
+								 int N,
+								 int K,
+								 const T* a,
+								 ptrdiff_t lda,
+								 const T* b,
+								 ptrdiff_t ldb,
+								 T* c,
+								 ptrdiff_t ldc,
+								 ThreadPool* pPool = 0)
+		{
+			multiplyStridedWith(kernel,
+								M, N, K,
+								a, lda, 1,
+								b, ldb, 1,
+								c, ldc,
+								pPool);
+		}
+
+		/**
+		 * Multiplies given two matrices of elements other than `double`.
+		 *
+		 * Equivalent to `multiplyWith(BasicGemmKernel< T >::best(), ...)`.
+		 * Parameters are the same as `multiply`.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 */
+		template < typename T >
+		static void multiply(int M,
+							 int N,
+							 int K,
+							 const T* a,
+							 ptrdiff_t lda,
+							 const T* b,
+							 ptrdiff_t ldb,
+							 T* c,
+							 ptrdiff_t ldc,
+							 ThreadPool* pPool = 0)
+		{
+			multiplyWith(BasicGemmKernel< T >::best(),
+						 M, N, K, a, lda, b, ldb, c, ldc, pPool);
+		}
+
+		/**
+		 * Multiplies given two strided matrices of elements other than
+		 * `double`.
+		 *
+		 * Parameters are the same as `multiplyStrided`.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 */
+		template < typename T >
+		static void multiplyStrided(int M,
+									int N,
+									int K,
+									const T* a,
+									ptrdiff_t rsA,
+									ptrdiff_t csA,
+									const T* b,
+									ptrdiff_t rsB,
+									ptrdiff_t csB,
+									T* c,
+									ptrdiff_t ldc,
+									ThreadPool* pPool = 0)
+		{
+			multiplyStridedWith(BasicGemmKernel< T >::best(),
+								M, N, K,
+								a, rsA, csA,
+								b, rsB, csB,
+								c, ldc,
+								pPool);
+		}
+
+		/**
+		 * Multiplies given two matrices of elements other than `double`
+		 * with a given memory block to pack operands.
+		 *
+		 * Parameters are the same as `multiplyBuffered`.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 */
+		template < typename T >
+		static void multiplyBuffered(int M,
+									 int N,
+									 int K,
+									 const T* a,
+									 ptrdiff_t lda,
+									 const T* b,
+									 ptrdiff_t ldb,
+									 T* c,
+									 ptrdiff_t ldc,
+									 T* pWork)
+		{
+			multiplyStridedBuffered(M, N, K,
+									a, lda, 1,
+									b, ldb, 1,
+									c, ldc,
+									pWork);
+		}
+
+		/**
+		 * Multiplies given two strided matrices of elements other than
+		 * `double` with a given memory block to pack operands.
+		 *
+		 * Parameters are the same as `multiplyStridedBuffered`.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 */
+		template < typename T >
+		static void multiplyStridedBuffered(int M,
+											int N,
+											int K,
+											const T* a,
+											ptrdiff_t rsA,
+											ptrdiff_t csA,
+											const T* b,
+											ptrdiff_t rsB,
+											ptrdiff_t csB,
+											T* c,
+											ptrdiff_t ldc,
+											T* pWork)
+		{
+			multiplyStridedWith(BasicGemmKernel< T >::best(),
+								M, N, K,
+								a, rsA, csA,
+								b, rsB, csB,
+								c, ldc,
+								0,
+								pWork);
+		}
+
+		/**
+		 * Multiplies given two matrices with a plain loop.
+		 *
+		 * Parameters are the same as `multiply` without `pPool`.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 */
+		template < typename T >
+		static void multiplyPlain(int M,
+								  int N,
+								  int K,
+								  const T* a,
+								  ptrdiff_t lda,
+								  const T* b,
+								  ptrdiff_t ldb,
+								  T* c,
+								  ptrdiff_t ldc)
+		{
+			multiplyPlainStrided(M, N, K, a, lda, 1, b, ldb, 1, c, ldc);
+		}
+	private:
+		/**
+		 * Multiplies given two strided matrices with given kernels.
+		 *
+		 * Parameters are the same as `multiplyStrided` except for `kernel`
+		 * which multiplies tiles, and `pWork`.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @param pWork
+		 *     Memory block where operands are packed if `pPool` is 0.
+		 *     Packing buffers are allocated if this is 0.
+		 */
+		template < typename T >
+		static void multiplyStridedWith(const BasicGemmKernel< T >& kernel,
+										int M,
+										int N,
+										int K,
+										const T* a,
+										ptrdiff_t rsA,
+										ptrdiff_t csA,
+										const T* b,
+										ptrdiff_t rsB,
+										ptrdiff_t csB,
+										T* c,
+										ptrdiff_t ldc,
+										ThreadPool* pPool,
+										T* pWork = 0)
+		{
+			const long size = static_cast< long >(M) * N * K;
+			if (size < SMALL_PRODUCT_SIZE) {
+				multiplyPlainStrided(M, N, K, a, rsA, csA, b, rsB, csB, c, ldc);
+				return;
+			}
+			if (pPool == 0 ||
+				pPool->size() < 2 ||
+				size < MIN_CONCURRENT_PRODUCT_SIZE)
+			{
+				multiplyBlocked(
+					kernel, M, N, K, a, rsA, csA, b, rsB, csB, c, ldc, pWork);
+				return;
+			}
+			// splits rows into chunks of whole blocks
+			const int numBlocks = (M + MC - 1) / MC;
+			const int numTasks = std::min(numBlocks, pPool->size());
+			const int blocksPerTask = (numBlocks + numTasks - 1) / numTasks;
+			const int rowsPerTask = blocksPerTask * MC;
+			const BasicGemmKernel< T >* pKernel = &kernel;
+			pPool->runConcurrently(
+				(M + rowsPerTask - 1) / rowsPerTask,
+				[=](int task) {
+					const int top = task * rowsPerTask;
+					multiplyBlocked(*pKernel,
+									std::min(rowsPerTask, M - top), N, K,
+									a + top * rsA, rsA, csA,
+									b, rsB, csB,
+									c + top * ldc, ldc,
+									static_cast< T* >(0));
+				});
+		}
+
+		/**
+		 * Multiplies given two strided matrices with a plain loop.
+		 *
+		 * Parameters are the same as `multiplyStrided` without `pPool`.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 */
+		template < typename T >
+		static void multiplyPlainStrided(int M,
+										 int N,
+										 int K,
+										 const T* a,
+										 ptrdiff_t rsA,
+										 ptrdiff_t csA,
+										 const T* b,
+										 ptrdiff_t rsB,
+										 ptrdiff_t csB,
+										 T* c,
+										 ptrdiff_t ldc)
+		{
+			for (int i = 0; i < M; ++i) {
+				T* pC = c + i * ldc;
+				std::fill(pC, pC + N, T(0));
+				const T* pA = a + i * rsA;
+				for (int k = 0; k < K; ++k) {
+					const T aik = pA[k * csA];
+					const T* pB = b + k * rsB;
+					if (csB == 1) {
+						for (int j = 0; j < N; ++j) {
+							pC[j] += aik * pB[j];
+						}
+					} else {
+						for (int j = 0; j < N; ++j) {
+							pC[j] += aik * pB[j * csB];
+						}
+					}
+				}
+			}
+		}
+
+		/**
+		 * Multiplies given two strided matrices block by block on this
+		 * thread.
+		 *
+		 * Parameters are the same as `multiplyStridedWith` without `pPool`.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @param pWork
+		 *     Memory block that has at least `packingSize(M, N, K)`
+		 *     elements.
+		 *     Packing buffers are allocated if this is 0.
+		 */
+		template < typename T >
+		static void multiplyBlocked(const BasicGemmKernel< T >& kernel,
+									int M,
+									int N,
+									int K,
+									const T* a,
+									ptrdiff_t rsA,
+									ptrdiff_t csA,
+									const T* b,
+									ptrdiff_t rsB,
+									ptrdiff_t csB,
+									T* c,
+									ptrdiff_t ldc,
+									T* pWork)
+		{
+			if (pWork == 0) {
+				// packed panels start at cache lines
+				std::vector< T, AlignedAllocator< T > >
+					work(packingSize(M, N, K));
+				multiplyBlocked(
+					kernel, M, N, K, a, rsA, csA, b, rsB, csB, c, ldc,
+					work.data());
+				return;
+			}
+			const int mr = kernel.mr;
+			const int nr = kernel.nr;
+			// buffers are no larger than operands need
+			const int kcMax = K < KC ? K : KC;
+			const int mcMax = M < MC ? roundUp(M, mr) : MC;
+			const int ncMax = N < NC ? roundUp(N, nr) : NC;
+			T* packedA = pWork;
+			T* packedB = packedA + mcMax * kcMax;
+			T* tile = packedB + kcMax * ncMax;
+			for (int jc = 0; jc < N; jc += NC) {
+				const int nc = N - jc < NC ? N - jc : NC;
+				for (int pc = 0; pc < K; pc += KC) {
+					const int kc = K - pc < KC ? K - pc : KC;
+					const bool accumulate = pc > 0;
+					packB(kc, nc, nr,
+						  b + pc * rsB + jc * csB, rsB, csB, packedB);
+					for (int ic = 0; ic < M; ic += MC) {
+						const int mc = M - ic < MC ? M - ic : MC;
+						packA(mc, kc, mr,
+							  a + ic * rsA + pc * csA, rsA, csA,
+							  packedA);
+						for (int jr = 0; jr < nc; jr += nr) {
+							const int n = std::min(nr, nc - jr);
+							const T* pB = packedB + jr * kc;
+							for (int ir = 0; ir < mc; ir += mr) {
+								const int m = std::min(mr, mc - ir);
+								const T* pA = packedA + ir * kc;
+								T* pC = c + (ic + ir) * ldc + jc + jr;
+								if (m == mr && n == nr) {
+									kernel.multiply(
+										kc, pA, pB, pC, ldc, accumulate);
+								} else {
+									// edge tile goes through a buffer
+									kernel.multiply(
+										kc, pA, pB, tile, nr, false);
+									for (int i = 0; i < m; ++i) {
+										for (int j = 0; j < n; ++j) {
+											const T t = tile[i * nr + j];
+											pC[i * ldc + j] = accumulate
+												? pC[i * ldc + j] + t : t;
+										}
+									}
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		/**
+		 * Rounds up a given number to a multiple of another number.
+		 *
+		 * @param n
+		 *     Number to be rounded up.
+		 * @param unit
+		 *     Unit of the multiple.
+		 * @return
+		 *     Smallest multiple of `unit` that is not less than `n`.
+		 */
+		static inline int roundUp(int n, int unit) {
+			return (n + unit - 1) / unit * unit;
+		}
+
+		/**
+		 * Packs a block of the left-hand-side matrix into panels of `mr`
+		 * rows.
+		 *
+		 * Rows beyond the block are padded with zeros.
+		 *
+		 * @param mc
+		 *     Number of rows in the block.
+		 * @param kc
+		 *     Number of columns in the block.
+		 * @param mr
+		 *     Number of rows in a panel.
+		 * @param a
+		 *     First element of the block.
+		 * @param rsA
+		 *     Distance from one row to the next row in `a`.
+		 * @param csA
+		 *     Distance from one column to the next column in `a`.
+		 * @param[out] packed
+		 *     Packed panels.
+		 */
+		template < typename T >
+		static void packA(int mc,
+						  int kc,
+						  int mr,
+						  const T* a,
+						  ptrdiff_t rsA,
+						  ptrdiff_t csA,
+						  T* packed)
+		{
+			for (int ir = 0; ir < mc; ir += mr, packed += mr * kc) {
+				const int m = std::min(mr, mc - ir);
+				for (int i = 0; i < mr; ++i) {
+					if (i < m) {
+						const T* pA = a + (ir + i) * rsA;
+						for (int p = 0; p < kc; ++p) {
+							packed[p * mr + i] = pA[p * csA];
+						}
+					} else {
+						for (int p = 0; p < kc; ++p) {
+							packed[p * mr + i] = T(0);
+						}
+					}
+				}
+			}
+		}
+
+		/**
+		 * Packs a block of the right-hand-side matrix into panels of `nr`
+		 * columns.
+		 *
+		 * Columns beyond the block are padded with zeros.
+		 *
+		 * @param kc
+		 *     Number of rows in the block.
+		 * @param nc
+		 *     Number of columns in the block.
+		 * @param nr
+		 *     Number of columns in a panel.
+		 * @param b
+		 *     First element of the block.
+		 * @param rsB
+		 *     Distance from one row to the next row in `b`.
+		 * @param csB
+		 *     Distance from one column to the next column in `b`.
+		 * @param[out] packed
+		 *     Packed panels.
+		 */
+		template < typename T >
+		static void packB(int kc,
+						  int nc,
+						  int nr,
+						  const T* b,
+						  ptrdiff_t rsB,
+						  ptrdiff_t csB,
+						  T* packed)
+		{
+			for (int jr = 0; jr < nc; jr += nr) {
+				const int n = std::min(nr, nc - jr);
+				for (int p = 0; p < kc; ++p, packed += nr) {
+					const T* pB = b + p * rsB + jr * csB;
+					if (csB == 1) {
+						std::copy(pB, pB + n, packed);
+					} else {
+						for (int j = 0; j < n; ++j) {
+							packed[j] = pB[j * csB];
+						}
+					}
+					std::fill(packed + n, packed + nr, T(0));
+				}
+			}
+		}
+	};
+
+	/**
+	 * Number of elements in a memory block that `Gemm::multiplyBuffered`
+	 * needs to pack operands of a product.
+	 *
+	 * Compile-time counterpart of `Gemm::packingSize`.
+	 *
+	 * @tparam M
+	 *     Number of rows in the left-hand-side matrix.
+	 * @tparam N
+	 *     Number of columns in the right-hand-side matrix.
+	 * @tparam K
+	 *     Number of columns in the left-hand-side matrix.
+	 */
+	template < int M, int N, int K >
+	struct GemmPackingSize {
+		enum {
+			/** Number of elements. */
+			VALUE = (K < Gemm::KC ? K : Gemm::KC) *
+				((M + Gemm::MAX_MR - 1 < Gemm::MC
+					? M + Gemm::MAX_MR - 1 : Gemm::MC) +
+				 (N + Gemm::MAX_NR - 1 < Gemm::NC
+					? N + Gemm::MAX_NR - 1 : Gemm::NC)) +
+				Gemm::MAX_MR * Gemm::MAX_NR
+		};
+	};
+
+}
+
+#endif
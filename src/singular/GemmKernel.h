@@ -0,0 +1,512 @@
+#ifndef _SINGULAR_GEMM_KERNEL_H
+#define _SINGULAR_GEMM_KERNEL_H
+
+#include "singular/Simd.h"
+#include "singular/singular.h"
+
+#include <cstddef>
+
+namespace singular {
+
+	/**
+	 * Register-blocked kernels of matrix multiplication.
+	 *
+	 * A kernel multiplies an `mr` x `k` panel of the left-hand-side matrix
+	 * and a `k` x `nr` panel of the right-hand-side matrix, and writes the
+	 * `mr` x `nr` product to a tile of a row-major matrix.
+	 * The tile stays in registers while `k` is swept.
+	 *
+	 * Panels are packed by `Gemm`.
+	 * The left-hand-side panel stores `mr` elements of a column after
+	 * another, and the right-hand-side panel stores `nr` elements of a row
+	 * after another.
+	 *
+	 * There is a set of kernels for every `SimdLevel`.
+	 * `best` picks the set for the CPU at runtime.
+	 * Only `double` and `float` have SIMD kernels; the other types are
+	 * multiplied by a portable kernel at every level.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	struct BasicGemmKernel {
+		/**
+		 * Kernel that multiplies packed panels.
+		 *
+		 * @param k
+		 *     Number of columns in `a` and rows in `b`.
+		 * @param a
+		 *     Packed `mr` x `k` panel.
+		 * @param b
+		 *     Packed `k` x `nr` panel.
+		 * @param[in,out] c
+		 *     First element of the `mr` x `nr` tile of the product.
+		 * @param ldc
+		 *     Distance from one row to the next row in `c`.
+		 * @param accumulate
+		 *     Whether the product is added to `c`.
+		 *     `c` is overwritten if this is `false`.
+		 */
+		typedef void (*MultiplyFunction)(
+			int k, const T* a, const T* b, T* c, ptrdiff_t ldc, bool accumulate);
+
+		/** Multiplies packed panels. */
+		MultiplyFunction multiply;
+
+		/** Number of rows in a tile. */
+		int mr;
+
+		/** Number of columns in a tile. */
+		int nr;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicGemmKernel& best() {
+			static const BasicGemmKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 *     Ignored.
+		 * @return
+		 *     Portable kernels.
+		 */
+		static const BasicGemmKernel& get(SimdLevel level) {
+			static const BasicGemmKernel SCALAR_KERNEL = {
+				&multiplyScalar, SCALAR_MR, SCALAR_NR
+			};
+			return SCALAR_KERNEL;
+		}
+
+		/** Number of rows in a tile of the portable kernel. */
+		static const int SCALAR_MR = 4;
+
+		/** Number of columns in a tile of the portable kernel. */
+		static const int SCALAR_NR = 4;
+
+		/** Portable `MultiplyFunction`. */
+		static void multiplyScalar(
+			int k, const T* a, const T* b, T* c, ptrdiff_t ldc, bool accumulate)
+		{
+			T t[SCALAR_MR][SCALAR_NR] = {};
+			for (int p = 0; p < k; ++p, a += SCALAR_MR, b += SCALAR_NR) {
+				for (int i = 0; i < SCALAR_MR; ++i) {
+					for (int j = 0; j < SCALAR_NR; ++j) {
+						t[i][j] += a[i] * b[j];
+					}
+				}
+			}
+			for (int i = 0; i < SCALAR_MR; ++i, c += ldc) {
+				for (int j = 0; j < SCALAR_NR; ++j) {
+					c[j] = accumulate ? c[j] + t[i][j] : t[i][j];
+				}
+			}
+		}
+	};
+
+	/**
+	 * Register-blocked kernels of `double` matrix multiplication.
+	 *
+	 * Works like `BasicGemmKernel` but there is a set of kernels for
+	 * every `SimdLevel`.
+	 */
+	template <>
+	struct BasicGemmKernel< double > {
+		/** Kernel that multiplies packed panels. */
+		typedef void (*MultiplyFunction)(int k,
+										 const double* a,
+										 const double* b,
+										 double* c,
+										 ptrdiff_t ldc,
+										 bool accumulate);
+
+		/** Multiplies packed panels. */
+		MultiplyFunction multiply;
+
+		/** Number of rows in a tile. */
+		int mr;
+
+		/** Number of columns in a tile. */
+		int nr;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicGemmKernel& best() {
+			static const BasicGemmKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The behavior is undefined if the CPU does not support `level`.
+		 * `SIMD_SSE2` shares the portable kernel, which compilers vectorize
+		 * with SSE2 anyway.
+		 * Levels not compiled in fall back to the highest compiled level
+		 * below them.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 * @return
+		 *     Kernels for `level`.
+		 */
+		static const BasicGemmKernel& get(SimdLevel level) {
+			static const BasicGemmKernel SCALAR_KERNEL = {
+				&multiplyScalar, SCALAR_MR, SCALAR_NR
+			};
+#if SINGULAR_SIMD_SUPPORTED
+			static const BasicGemmKernel AVX2_KERNEL = {
+				&multiplyAvx2, AVX2_MR, AVX2_NR
+			};
+#if SINGULAR_AVX512_SUPPORTED
+			static const BasicGemmKernel AVX512_KERNEL = {
+				&multiplyAvx512, AVX512_MR, AVX512_NR
+			};
+#endif
+			switch (level) {
+#if SINGULAR_AVX512_SUPPORTED
+			case SIMD_AVX512:
+				return AVX512_KERNEL;
+#else
+			case SIMD_AVX512:
+#endif
+			case SIMD_AVX2:
+				return AVX2_KERNEL;
+			default:
+				return SCALAR_KERNEL;
+			}
+#else
+			return SCALAR_KERNEL;
+#endif
+		}
+
+		/** Number of rows in a tile of the portable kernel. */
+		static const int SCALAR_MR = 4;
+
+		/** Number of columns in a tile of the portable kernel. */
+		static const int SCALAR_NR = 4;
+
+		/** Portable `MultiplyFunction`. */
+		static void multiplyScalar(int k,
+								   const double* a,
+								   const double* b,
+								   double* c,
+								   ptrdiff_t ldc,
+								   bool accumulate)
+		{
+			double t[SCALAR_MR][SCALAR_NR] = {};
+			for (int p = 0; p < k; ++p, a += SCALAR_MR, b += SCALAR_NR) {
+				for (int i = 0; i < SCALAR_MR; ++i) {
+					for (int j = 0; j < SCALAR_NR; ++j) {
+						t[i][j] += a[i] * b[j];
+					}
+				}
+			}
+			for (int i = 0; i < SCALAR_MR; ++i, c += ldc) {
+				for (int j = 0; j < SCALAR_NR; ++j) {
+					c[j] = accumulate ? c[j] + t[i][j] : t[i][j];
+				}
+			}
+		}
+#if SINGULAR_SIMD_SUPPORTED
+		/** Number of rows in a tile of the AVX2 kernel. */
+		static const int AVX2_MR = 6;
+
+		/** Number of columns in a tile of the AVX2 kernel. */
+		static const int AVX2_NR = 8;
+
+		/**
+		 * `MultiplyFunction` with AVX2 and FMA.
+		 *
+		 * A 6 x 8 tile occupies 12 of 16 registers.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void multiplyAvx2(int k,
+								 const double* a,
+								 const double* b,
+								 double* c,
+								 ptrdiff_t ldc,
+								 bool accumulate)
+		{
+			__m256d t[AVX2_MR][2];
+			for (int i = 0; i < AVX2_MR; ++i) {
+				t[i][0] = _mm256_setzero_pd();
+				t[i][1] = _mm256_setzero_pd();
+			}
+			for (int p = 0; p < k; ++p, a += AVX2_MR, b += AVX2_NR) {
+				const __m256d b0 = _mm256_loadu_pd(b);
+				const __m256d b1 = _mm256_loadu_pd(b + 4);
+				for (int i = 0; i < AVX2_MR; ++i) {
+					const __m256d ai = _mm256_broadcast_sd(a + i);
+					t[i][0] = _mm256_fmadd_pd(ai, b0, t[i][0]);
+					t[i][1] = _mm256_fmadd_pd(ai, b1, t[i][1]);
+				}
+			}
+			for (int i = 0; i < AVX2_MR; ++i, c += ldc) {
+				if (accumulate) {
+					t[i][0] = _mm256_add_pd(t[i][0], _mm256_loadu_pd(c));
+					t[i][1] = _mm256_add_pd(t[i][1], _mm256_loadu_pd(c + 4));
+				}
+				_mm256_storeu_pd(c, t[i][0]);
+				_mm256_storeu_pd(c + 4, t[i][1]);
+			}
+		}
+#if SINGULAR_AVX512_SUPPORTED
+		/** Number of rows in a tile of the AVX-512 kernel. */
+		static const int AVX512_MR = 8;
+
+		/** Number of columns in a tile of the AVX-512 kernel. */
+		static const int AVX512_NR = 16;
+
+		/**
+		 * `MultiplyFunction` with AVX-512F.
+		 *
+		 * An 8 x 16 tile occupies 16 of 32 registers.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void multiplyAvx512(int k,
+								   const double* a,
+								   const double* b,
+								   double* c,
+								   ptrdiff_t ldc,
+								   bool accumulate)
+		{
+			__m512d t[AVX512_MR][2];
+			for (int i = 0; i < AVX512_MR; ++i) {
+				t[i][0] = _mm512_setzero_pd();
+				t[i][1] = _mm512_setzero_pd();
+			}
+			for (int p = 0; p < k; ++p, a += AVX512_MR, b += AVX512_NR) {
+				const __m512d b0 = _mm512_loadu_pd(b);
+				const __m512d b1 = _mm512_loadu_pd(b + 8);
+				for (int i = 0; i < AVX512_MR; ++i) {
+					const __m512d ai = _mm512_set1_pd(a[i]);
+					t[i][0] = _mm512_fmadd_pd(ai, b0, t[i][0]);
+					t[i][1] = _mm512_fmadd_pd(ai, b1, t[i][1]);
+				}
+			}
+			for (int i = 0; i < AVX512_MR; ++i, c += ldc) {
+				if (accumulate) {
+					t[i][0] = _mm512_add_pd(t[i][0], _mm512_loadu_pd(c));
+					t[i][1] = _mm512_add_pd(t[i][1], _mm512_loadu_pd(c + 8));
+				}
+				_mm512_storeu_pd(c, t[i][0]);
+				_mm512_storeu_pd(c + 8, t[i][1]);
+			}
+		}
+#endif
+#endif
+	};
+
+	/**
+	 * Register-blocked kernels of `float` matrix multiplication.
+	 *
+	 * Works like `BasicGemmKernel< double >` but a register holds twice as
+	 * many columns of a tile.
+	 */
+	template <>
+	struct BasicGemmKernel< float > {
+		/** Kernel that multiplies packed panels. */
+		typedef void (*MultiplyFunction)(int k,
+										 const float* a,
+										 const float* b,
+										 float* c,
+										 ptrdiff_t ldc,
+										 bool accumulate);
+
+		/** Multiplies packed panels. */
+		MultiplyFunction multiply;
+
+		/** Number of rows in a tile. */
+		int mr;
+
+		/** Number of columns in a tile. */
+		int nr;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicGemmKernel& best() {
+			static const BasicGemmKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The behavior is undefined if the CPU does not support `level`.
+		 * `SIMD_SSE2` shares the portable kernel, which compilers vectorize
+		 * with SSE2 anyway.
+		 * Levels not compiled in fall back to the highest compiled level
+		 * below them.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 * @return
+		 *     Kernels for `level`.
+		 */
+		static const BasicGemmKernel& get(SimdLevel level) {
+			static const BasicGemmKernel SCALAR_KERNEL = {
+				&multiplyScalar, SCALAR_MR, SCALAR_NR
+			};
+#if SINGULAR_SIMD_SUPPORTED
+			static const BasicGemmKernel AVX2_KERNEL = {
+				&multiplyAvx2, AVX2_MR, AVX2_NR
+			};
+#if SINGULAR_AVX512_SUPPORTED
+			static const BasicGemmKernel AVX512_KERNEL = {
+				&multiplyAvx512, AVX512_MR, AVX512_NR
+			};
+#endif
+			switch (level) {
+#if SINGULAR_AVX512_SUPPORTED
+			case SIMD_AVX512:
+				return AVX512_KERNEL;
+#else
+			case SIMD_AVX512:
+#endif
+			case SIMD_AVX2:
+				return AVX2_KERNEL;
+			default:
+				return SCALAR_KERNEL;
+			}
+#else
+			return SCALAR_KERNEL;
+#endif
+		}
+
+		/** Number of rows in a tile of the portable kernel. */
+		static const int SCALAR_MR = 4;
+
+		/** Number of columns in a tile of the portable kernel. */
+		static const int SCALAR_NR = 4;
+
+		/** Portable `MultiplyFunction`. */
+		static void multiplyScalar(int k,
+								   const float* a,
+								   const float* b,
+								   float* c,
+								   ptrdiff_t ldc,
+								   bool accumulate)
+		{
+			float t[SCALAR_MR][SCALAR_NR] = {};
+			for (int p = 0; p < k; ++p, a += SCALAR_MR, b += SCALAR_NR) {
+				for (int i = 0; i < SCALAR_MR; ++i) {
+					for (int j = 0; j < SCALAR_NR; ++j) {
+						t[i][j] += a[i] * b[j];
+					}
+				}
+			}
+			for (int i = 0; i < SCALAR_MR; ++i, c += ldc) {
+				for (int j = 0; j < SCALAR_NR; ++j) {
+					c[j] = accumulate ? c[j] + t[i][j] : t[i][j];
+				}
+			}
+		}
+#if SINGULAR_SIMD_SUPPORTED
+		/** Number of rows in a tile of the AVX2 kernel. */
+		static const int AVX2_MR = 6;
+
+		/** Number of columns in a tile of the AVX2 kernel. */
+		static const int AVX2_NR = 16;
+
+		/**
+		 * `MultiplyFunction` with AVX2 and FMA.
+		 *
+		 * A 6 x 16 tile occupies 12 of 16 registers.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void multiplyAvx2(int k,
+								 const float* a,
+								 const float* b,
+								 float* c,
+								 ptrdiff_t ldc,
+								 bool accumulate)
+		{
+			__m256 t[AVX2_MR][2];
+			for (int i = 0; i < AVX2_MR; ++i) {
+				t[i][0] = _mm256_setzero_ps();
+				t[i][1] = _mm256_setzero_ps();
+			}
+			for (int p = 0; p < k; ++p, a += AVX2_MR, b += AVX2_NR) {
+				const __m256 b0 = _mm256_loadu_ps(b);
+				const __m256 b1 = _mm256_loadu_ps(b + 8);
+				for (int i = 0; i < AVX2_MR; ++i) {
+					const __m256 ai = _mm256_broadcast_ss(a + i);
+					t[i][0] = _mm256_fmadd_ps(ai, b0, t[i][0]);
+					t[i][1] = _mm256_fmadd_ps(ai, b1, t[i][1]);
+				}
+			}
+			for (int i = 0; i < AVX2_MR; ++i, c += ldc) {
+				if (accumulate) {
+					t[i][0] = _mm256_add_ps(t[i][0], _mm256_loadu_ps(c));
+					t[i][1] = _mm256_add_ps(t[i][1], _mm256_loadu_ps(c + 8));
+				}
+				_mm256_storeu_ps(c, t[i][0]);
+				_mm256_storeu_ps(c + 8, t[i][1]);
+			}
+		}
+#if SINGULAR_AVX512_SUPPORTED
+		/** Number of rows in a tile of the AVX-512 kernel. */
+		static const int AVX512_MR = 8;
+
+		/** Number of columns in a tile of the AVX-512 kernel. */
+		static const int AVX512_NR = 16;
+
+		/**
+		 * `MultiplyFunction` with AVX-512F.
+		 *
+		 * An 8 x 16 tile occupies 8 of 32 registers; `Gemm::MAX_NR` keeps
+		 * the tile from growing wider.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void multiplyAvx512(int k,
+								   const float* a,
+								   const float* b,
+								   float* c,
+								   ptrdiff_t ldc,
+								   bool accumulate)
+		{
+			__m512 t[AVX512_MR];
+			for (int i = 0; i < AVX512_MR; ++i) {
+				t[i] = _mm512_setzero_ps();
+			}
+			for (int p = 0; p < k; ++p, a += AVX512_MR, b += AVX512_NR) {
+				const __m512 b0 = _mm512_loadu_ps(b);
+				for (int i = 0; i < AVX512_MR; ++i) {
+					t[i] = _mm512_fmadd_ps(_mm512_set1_ps(a[i]), b0, t[i]);
+				}
+			}
+			for (int i = 0; i < AVX512_MR; ++i, c += ldc) {
+				if (accumulate) {
+					t[i] = _mm512_add_ps(t[i], _mm512_loadu_ps(c));
+				}
+				_mm512_storeu_ps(c, t[i]);
+			}
+		}
+#endif
+#endif
+	};
+
+	/** Kernels for matrices of `double` elements. */
+	typedef BasicGemmKernel< double > GemmKernel;
+
+}
+
+#endif
@@ -1,12 +1,18 @@
 #ifndef _SINGULAR_MATRIX_H
 #define _SINGULAR_MATRIX_H
 
+#include "singular/DiagonalMatrix.h"
+#include "singular/MatrixExpression.h"
+#include "singular/MatrixView.h"
+#include "singular/MemoryBlock.h"
 #include "singular/singular.h"
+#include "singular/Transpose.h"
 #include "singular/Vector.h"
 
 #include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <type_traits>
 
 namespace singular {
 
@@ -17,59 +23,47 @@ namespace singular {
 	 *     Number of rows.
 	 * @tparam N
 	 *     Number of columns.
+	 * @tparam T
+	 *     Type of elements.
+	 *     `double` by default (see `MatrixExpression.h`).
 	 */
-	template < int M, int N >
+	template < int M, int N, typename T >
 	class Matrix {
 	private:
 		/**
 		 * Memory block for this matrix.
 		 *
 		 * Element at the row `i` and column `j` is given by
-		 * `pBlock[i * N + j]`.
+		 * `block.data()[i * N + j]`.
+		 * Stored inline if the matrix is small enough.
 		 */
-		double* pBlock;
-
-#if SINGULAR_TEMPLATE_FRIEND_OPERATOR_OVERLOADING_SUPPORTED
-		// transposed Matrix is a friend
-		friend class Matrix< N, M >;
-#else
-		// every Matrix should be a friend
-		// because some workarounds need private members
-		template < int, int >
-		friend class Matrix;
-#endif
+		MemoryBlock< M * N, T > block;
 	public:
 		/** Initializes a matrix filled with zeros. */
 		Matrix() {
-			this->pBlock = new double[M * N];
-			std::fill(this->pBlock, this->pBlock + (M * N), 0.0);
+			std::fill(this->block.data(), this->block.data() + (M * N), 0.0);
 		}
 
 		/**
 		 * Steals the memory block from a given matrix.
 		 *
+		 * Elements are copied instead if they are stored inline.
+		 *
 		 * @param[in,out] copyee
 		 *     Matrix from which the memory block is to be stolen.
 		 *     No longer valid after this call.
 		 */
 #if SINGULAR_RVALUE_REFERENCE_SUPPORTED
-		Matrix(Matrix&& copyee) : pBlock(copyee.pBlock) {
-			copyee.pBlock = 0;
-		}
+		Matrix(Matrix&& copyee) : block(std::move(copyee.block)) {}
 #else
-		Matrix(const Matrix& copyee) : pBlock(copyee.pBlock) {
-			const_cast< Matrix& >(copyee).pBlock = 0;
-		}
+		Matrix(const Matrix& copyee) : block(copyee.block) {}
 #endif
 
-		/** Releases the allocated block. */
-		~Matrix() {
-			this->release();
-		}
-
 		/**
 		 * Steals the memory block from a given matrix.
 		 *
+		 * Elements are copied instead if they are stored inline.
+		 *
 		 * @param[in,out] copyee
 		 *     Matrix from which the memory block is to be stolen.
 		 *     No longer valid after this call.
@@ -78,15 +72,67 @@ namespace singular {
 		 */
 #if SINGULAR_RVALUE_REFERENCE_SUPPORTED
 		Matrix& operator =(Matrix&& copyee) {
+			this->block = std::move(copyee.block);
 #else
 		Matrix& operator =(const Matrix& copyee) {
+			this->block = copyee.block;
 #endif
-			this->release();
-			this->pBlock = copyee.pBlock;
+			return *this;
+		}
+
+		/**
+		 * Evaluates a given matrix expression.
+		 *
+		 * Products, transpositions and scalings of matrices are lazy
+		 * expressions until they are evaluated by this constructor.
+		 *
+		 * @tparam E
+		 *     Type of the expression.
+		 *     Must have `M` rows and `N` columns of `T`.
+		 * @param e
+		 *     Expression to be evaluated.
+		 */
+		template < typename E >
+		Matrix(const E& e,
+			   typename std::enable_if<
+				   MatrixTraits< E >::IS_EXPRESSION &&
+					   (int)MatrixTraits< E >::ROWS == M &&
+					   (int)MatrixTraits< E >::COLUMNS == N &&
+					   std::is_same< typename MatrixTraits< E >::Element,
+									 T >::value,
+				   int >::type = 0)
+		{
+			MatrixEvaluator::evaluate(e, this->block.data(), N);
+		}
+
+		/**
+		 * Evaluates a given matrix expression into this matrix.
+		 *
+		 * The expression may refer to this matrix; e.g., `m = m * m`.
+		 *
+		 * @tparam E
+		 *     Type of the expression.
+		 *     Must have `M` rows and `N` columns of `T`.
+		 * @param e
+		 *     Expression to be evaluated.
+		 * @return
+		 *     Reference to this matrix.
+		 */
+		template < typename E >
+		typename std::enable_if<
+			MatrixTraits< E >::IS_EXPRESSION &&
+				(int)MatrixTraits< E >::ROWS == M &&
+				(int)MatrixTraits< E >::COLUMNS == N &&
+				std::is_same< typename MatrixTraits< E >::Element,
+							  T >::value,
+			Matrix& >::type
+		operator =(const E& e) {
+			// evaluates into another block in case e refers to this matrix
+			Matrix m(e);
 #if SINGULAR_RVALUE_REFERENCE_SUPPORTED
-			copyee.pBlock = 0;
+			this->block = std::move(m.block);
 #else
-			const_cast< Matrix& >(copyee).pBlock = 0;
+			this->block = m.block;
 #endif
 			return *this;
 		}
@@ -101,9 +147,10 @@ namespace singular {
 		 *     Clone of this matrix.
 		 */
 		Matrix clone() const {
-			double* pBlock = new double[M * N];
-			std::copy(this->pBlock, this->pBlock + M * N, pBlock);
-			return Matrix(pBlock);
+			Matrix m(UNINITIALIZED);
+			std::copy(this->block.data(), this->block.data() + M * N,
+					  m.block.data());
+			return m;
 		}
 
 		/**
@@ -115,7 +162,7 @@ namespace singular {
 		static Matrix identity() {
 			const int L = M < N ? M : N;
 			Matrix eye;
-			double* pDst = eye.pBlock;
+			T* pDst = eye.block.data();
 			for (int i = 0; i < L; ++i) {
 				*pDst = 1;
 				pDst += N + 1;
@@ -136,10 +183,10 @@ namespace singular {
 		 * @return
 		 *     Matrix filled with `values`.
 		 */
-		static Matrix filledWith(const double values[]) {
-			double* pBlock = new double[M * N];
-			memcpy(pBlock, values, sizeof(double) * M * N);
-			return Matrix(pBlock);
+		static Matrix filledWith(const T values[]) {
+			Matrix m(UNINITIALIZED);
+			memcpy(m.block.data(), values, sizeof(T) * M * N);
+			return m;
 		}
 
 		/**
@@ -157,10 +204,10 @@ namespace singular {
 		 *     Element at the ith row and jth column.
 		 *     Changes on a returned element is reflected to this matrix.
 		 */
-		inline double& operator ()(int i, int j) {
+		inline T& operator ()(int i, int j) {
 			assert(i >= 0 && i < M);
 			assert(j >= 0 && j < N);
-			return this->pBlock[i * N + j];
+			return this->block.data()[i * N + j];
 		}
 
 		/**
@@ -177,10 +224,10 @@ namespace singular {
 		 * @return
 		 *     Element at the ith row and jth column.
 		 */
-		inline double operator ()(int i, int j) const {
+		inline T operator ()(int i, int j) const {
 			assert(i >= 0 && i < M);
 			assert(j >= 0 && j < N);
-			return this->pBlock[i * N + j];
+			return this->block.data()[i * N + j];
 		}
 
 		/**
@@ -192,8 +239,8 @@ namespace singular {
 		 *     ith row as a vector.
 		 *     Changes on this vector are reflected to this matrix.
 		 */
-		Vector< double > row(int i) {
-			return Vector< double >(this->pBlock + i * N, N, 1);
+		Vector< T > row(int i) {
+			return Vector< T >(this->block.data() + i * N, N, 1);
 		}
 
 		/**
@@ -204,8 +251,8 @@ namespace singular {
 		 * @return
 		 *     ith row as a vector.
 		 */
-		Vector< const double > row(int i) const {
-			return Vector< const double >(this->pBlock + i * N, N, 1);
+		Vector< const T > row(int i) const {
+			return Vector< const T >(this->block.data() + i * N, N, 1);
 		}
 
 		/**
@@ -217,8 +264,8 @@ namespace singular {
 		 *     jth column as a vector.
 		 *     Changes on this vector are reflected to this matrix.
 		 */
-		Vector< double > column(int j) {
-			return Vector< double >(this->pBlock + j, M, N);
+		Vector< T > column(int j) {
+			return Vector< T >(this->block.data() + j, M, N);
 		}
 
 		/**
@@ -229,8 +276,8 @@ namespace singular {
 		 * @return
 		 *     jth column as a vector.
 		 */
-		Vector< const double > column(int j) const {
-			return Vector< const double >(this->pBlock + j, M, N);
+		Vector< const T > column(int j) const {
+			return Vector< const T >(this->block.data() + j, M, N);
 		}
 
 		/**
@@ -244,154 +291,84 @@ namespace singular {
 		 * @param values
 		 *     Values to fill this matrix.
 		 */
-		Matrix& fill(const double values[]) {
-			std::copy(values, values + M * N, this->pBlock);
+		Matrix& fill(const T values[]) {
+			std::copy(values, values + M * N, this->block.data());
 			return *this;
 		}
 
-		// Defined outside
-		template < int M2, int N2, int L >
-		friend Matrix< M2, L > operator *(const Matrix< M2, N2 >& lhs,
-										  const Matrix< N2, L >& rhs);
-
-#if SINGULAR_TEMPLATE_FRIEND_OPERATOR_OVERLOADING_SUPPORTED
-		// Defined outside
-		template <
-			int M2, int N2, int L, template < int, int > class MatrixLike >
-		friend Matrix< M2, L > operator *(const Matrix< M2, N2 >& lhs,
-										  const MatrixLike< N2, L >& rhs);
-
-		// Defined outside
-		template <
-			int M2, int N2, int L, template < int, int > class MatrixLike >
-		friend Matrix< M2, L > operator *(const MatrixLike< M2, N2 >& lhs,
-										  const Matrix< N2, L >& rhs);
-
-		// Defined outside
-		template <
-			int M2, int N2, int L,
-			template < int, int > class MatrixLike1,
-			template < int, int > class MatrixLike2 >
-		friend Matrix< M2, L > operator *(const MatrixLike1< M2, N2 >& lhs,
-										  const MatrixLike2< N2, L >& rhs);
-#else
-		// Visual Studio 2012 does not like a friend function has templates
-		// in its type parameters
+		/**
+		 * Returns the number of rows in this matrix.
+		 *
+		 * @return
+		 *     Number of rows; i.e., `M`.
+		 */
+		inline int rows() const {
+			return M;
+		}
 
 		/**
-		 * Multiplies given two matrices.
+		 * Returns the number of columns in this matrix.
 		 *
-		 * `MatrixLike` must overload the function-call operator `()` which
-		 * takes a row index `i` and column index `j` and returns the element at
-		 * the ith row and jth column.
-		 * The function prototype should look like the following,
-		 *  - `double operator ()(int i, int j) const`
-		 *
-		 * @tparam M2
-		 *     Number of rows in the left-hand-side matrix.
-		 * @tparam N2
-		 *     Number of columns in the left-hand-side matrix.
-		 *     Number of rows in the right-hand-side matrix.
-		 * @tparam L
-		 *     Number of columns in the right-hand-side matrix.
-		 * @tparam MatrixLike
-		 *     Type of the right-hand-side matrix.
-		 * @param lhs
-		 *     Left-hand-side of the multiplication.
-		 * @param rhs
-		 *     Right-hand-side of the multiplication.
 		 * @return
-		 *     Product of `lhs` and `rhs`.
+		 *     Number of columns; i.e., `N`.
 		 */
-		template <
-			int M2, int N2, int L, template < int, int > class MatrixLike >
-		static Matrix< M2, L > multiply(const Matrix< M2, N2 >& lhs,
-										const MatrixLike< N2, L >& rhs)
-		{
-			double* pBlock = new double[M2 * L];
-			double* pDst = pBlock;
-			for (int i = 0; i < M2; ++i) {
-				for (int j = 0; j < L; ++j) {
-					const double* pL = lhs.pBlock + i * N2;
-					double x = 0.0;
-					for (int k = 0; k < N2; ++k) {
-						x += *pL * rhs(k, j);
-						++pL;
-					}
-					*pDst = x;
-					++pDst;
-				}
-			}
-			return Matrix< M2, L >(pBlock);
+		inline int columns() const {
+			return N;
 		}
 
 		/**
-		 * Multiplies given two matrices.
+		 * Returns a view of this matrix.
+		 *
+		 * A returned view shares the elements with this matrix, and is valid
+		 * as long as this matrix is.
 		 *
-		 * `MatrixLike` must overload the function-call operator `()` which
-		 * takes a row index `i` and column index `j` and returns the element at
-		 * the ith row and jth column.
-		 * The function prototype should look like the following,
-		 *  - `double operator ()(int i, int j) const`
-		 *
-		 * @tparam M2
-		 *     Number of rows in the left-hand-side matrix.
-		 * @tparam N2
-		 *     Number of columns in the left-hand-side matrix.
-		 *     Number of rows in the right-hand-side matrix.
-		 * @tparam L
-		 *     Number of columns in the right-hand-side matrix.
-		 * @tparam MatrixLike
-		 *     Type of the left-hand-side matrix.
-		 * @param lhs
-		 *     Left-hand-side of the multiplication.
-		 * @param rhs
-		 *     Right-hand-side of the multiplication.
 		 * @return
-		 *     Product of `lhs` and `rhs`.
+		 *     View of this matrix.
 		 */
-		template <
-			int M2, int N2, int L, template < int, int > class MatrixLike >
-		static Matrix< M2, L > multiply(const MatrixLike< M2, N2 >& lhs,
-										const Matrix< N2, L >& rhs)
-		{
-			double* pBlock = new double[M2 * L];
-			double* pDst = pBlock;
-			for (int i = 0; i < M2; ++i) {
-				for (int j = 0; j < L; ++j) {
-					const double* pR = rhs.pBlock + j;
-					double x = 0.0;
-					for (int k = 0; k < N2; ++k) {
-						x += lhs(i, k) * *pR;
-						pR += L;
-					}
-					*pDst = x;
-					++pDst;
-				}
-			}
-			return Matrix< M2, L >(pBlock);
+		inline BasicMatrixView< T > view() {
+			return BasicMatrixView< T >(this->block.data(), M, N);
+		}
+
+		/**
+		 * Returns the elements of this matrix.
+		 *
+		 * The element at the ith row and jth column is at `i * N + j`.
+		 *
+		 * @return
+		 *     First element of this matrix.
+		 */
+		inline T* data() {
+			return this->block.data();
+		}
+
+		/**
+		 * Returns the elements of this matrix.
+		 *
+		 * The element at the ith row and jth column is at `i * N + j`.
+		 *
+		 * @return
+		 *     First element of this matrix.
+		 */
+		inline const T* data() const {
+			return this->block.data();
 		}
 
 		/**
 		 * Multiplies given two matrices.
 		 *
-		 * Both of `MatrixLike1` and `MatrixLike2` must overload the
-		 * function-call operator `()` which takes a row index `i` and column
-		 * index `j` and returns the element at ith row and jth column.
-		 * The function prototype should look like the following,
-		 *  - `double operator ()(int i, int j) const`
-		 *
-		 * @tparam M2
-		 *     Number of rows in the left-hand-side matrix.
-		 * @tparam N2
-		 *     Number of columns in the left-hand-side matrix.
-		 *     Number of rows in the right-hand-side matrix.
+		 * Unlike `operator *` on matrices, evaluates the product right away.
+		 *
+		 * Both of `L` and `R` must act as matrices of `T` (see
+		 * `MatrixTraits`), and the number of columns in `lhs` must equal
+		 * the number of rows in `rhs`.
+		 * The size of the product does not depend on `M` and `N`.
+		 *
 		 * @tparam L
-		 *     Number of columns in the right-hand-side matrix.
-		 * @tparam MatrixLike1
 		 *     Type of the left-hand-side matrix.
-		 * @tparam MatrixLike2
+		 *     May be `Matrix`.
+		 * @tparam R
 		 *     Type of the right-hand-side matrix.
+		 *     May be `Matrix`.
 		 * @param lhs
 		 *     Left-hand-side of the multiplication.
 		 * @param rhs
@@ -399,47 +376,48 @@ namespace singular {
 		 * @return
 		 *     Product of `lhs` and `rhs`.
 		 */
-		template <
-			int M2, int N2, int L,
-			template < int, int > class MatrixLike1,
-			template < int, int > class MatrixLike2 >
-		static Matrix< M2, L > multiply(const MatrixLike1< M2, N2 >& lhs,
-										const MatrixLike2< N2, L >& rhs)
-		{
-			double* pBlock = new double[M2 * L];
-			double* pDst = pBlock;
-			for (int i = 0; i < M2; ++i) {
-				for (int j = 0; j < L; ++j) {
-					double x = 0.0;
-					for (int k = 0; k < N2; ++k) {
-						x += lhs(i, k) * rhs(k, j);
-					}
-					*pDst = x;
-					++pDst;
-				}
-			}
-			return Matrix< M2, L >(pBlock);
+		template < typename L, typename R >
+		static typename std::enable_if<
+			(int)MatrixTraits< L >::COLUMNS == (int)MatrixTraits< R >::ROWS &&
+				std::is_same< typename MatrixTraits< L >::Element,
+							  T >::value &&
+				std::is_same< typename MatrixTraits< R >::Element,
+							  T >::value,
+			Matrix< MatrixTraits< L >::ROWS,
+					MatrixTraits< R >::COLUMNS,
+					T > >::type
+		multiply(const L& lhs, const R& rhs) {
+			return Matrix< MatrixTraits< L >::ROWS,
+						   MatrixTraits< R >::COLUMNS,
+						   T >(ProductExpression< L, R >(lhs, rhs));
 		}
-#endif
 
 		/**
 		 * Returns the transposition of this matrix.
 		 *
+		 * The transposition is lazy and refers to this matrix.
+		 * It is evaluated when assigned to a `Matrix< N, M, T >`, or read
+		 * with swapped strides if it is an operand of a product.
+		 *
 		 * @return
 		 *     Transposition of this matrix.
 		 */
-		Matrix< N, M > transpose() const {
-			double* pBlock = new double[M * N];
-			const double* pSrc = this->pBlock;
-			for (int i = 0; i < M; ++i){
-				double* pDst = pBlock + i;
-				for (int j = 0; j < N; ++j) {
-					*pDst = *pSrc;
-					++pSrc;
-					pDst += M;
-				}
-			}
-			return Matrix< N, M >(pBlock);
+		inline TransposeExpression< Matrix > transpose() const {
+			return TransposeExpression< Matrix >(*this);
+		}
+
+		/**
+		 * Transposes this matrix in place.
+		 *
+		 * Available only if this matrix is square.
+		 *
+		 * @return
+		 *     Reference to this matrix.
+		 */
+		Matrix& transposeInPlace() {
+			static_assert(M == N, "only a square matrix can be transposed in place");
+			Transpose::inPlace(N, this->block.data(), N);
+			return *this;
 		}
 
 		/**
@@ -465,14 +443,14 @@ namespace singular {
 		 *     Matrix shuffled in the given order.
 		 */
 		Matrix shuffleRows(const int order[]) const {
-			double* pBlock = new double[M * N];
-			double* pDst = pBlock;
+			Matrix m(UNINITIALIZED);
+			T* pDst = m.block.data();
 			for (int i = 0; i < M; ++i) {
-				double* pSrc = this->pBlock + order[i] * N;
+				const T* pSrc = this->block.data() + order[i] * N;
 				std::copy(pSrc, pSrc + N, pDst);
 				pDst += N;
 			}
-			return Matrix(pBlock);
+			return m;
 		}
 
 		/**
@@ -498,27 +476,31 @@ namespace singular {
 		 *     Matrix shuffled in the given order.
 		 */
 		Matrix shuffleColumns(const int order[]) const {
-			double* pBlock = new double[M * N];
+			Matrix m(UNINITIALIZED);
 			for (int j = 0; j < N; ++j) {
-				double* pDst = pBlock + j;
-				double* pSrc = this->pBlock + order[j];
+				T* pDst = m.block.data() + j;
+				const T* pSrc = this->block.data() + order[j];
 				for (int i = 0; i < M; ++i) {
 					*pDst = *pSrc;
 					pSrc += N;
 					pDst += N;
 				}
 			}
-			return Matrix(pBlock);
+			return m;
 		}
 	private:
+		/** Tag to construct a matrix without initializing elements. */
+		enum Uninitialized {
+			/** Uninitialized elements. */
+			UNINITIALIZED
+		};
+
 		/**
-		 * Initializes with a given memory block.
+		 * Initializes a matrix without initializing elements.
 		 *
-		 * @param pBlock
-		 *     Memory block of the new matrix.
-		 *     Must have at least M * N elements.
+		 * Elements have indeterminate values.
 		 */
-		Matrix(double* pBlock) : pBlock(pBlock) {}
+		explicit Matrix(Uninitialized) {}
 
 #if SINGULAR_FUNCTION_DELETION_SUPPORTED
 		/** Simple copy is not allowed. */
@@ -536,113 +518,20 @@ namespace singular {
 		}
 #endif
 
-		/**
-		 * Releases the memory block of this matrix.
-		 *
-		 * Has no effect if the memory block has already been released.
-		 */
-		inline void release() {
-			delete[] this->pBlock;
-			this->pBlock = 0;
-		}
 	};
 
 	/**
-	 * Multiplies given two matrices.
+	 * Multiplies given two matrices neither of which is a `Matrix`, a
+	 * `DiagonalMatrix` or an expression.
 	 *
-	 * @tparam M
-	 *     Number of rows in the left-hand-side matrix.
-	 * @tparam N
-	 *     Number of columns in the left-hand-side matrix.
-	 *     Number of rows in the right-hand-side matrix as well.
-	 * @tparam L
-	 *     Number of columns in the right-hand-side matrix.
-	 * @param lhs
-	 *     Left-hand side of the multiplication.
-	 * @param rhs
-	 *     Right-hand side of the multiplication.
-	 * @return
-	 *     Product of `lhs` and `rhs`.
-	 */
-	template < int M, int N, int L >
-	Matrix< M, L > operator *(const Matrix< M, N >& lhs,
-							  const Matrix< N, L >& rhs)
-	{
-		double* pBlock = new double[M * L];
-		double* pDst = pBlock;
-		for (int i = 0; i < M; ++i) {
-			for (int l = 0; l < L; ++l) {
-				double* pL = lhs.pBlock + i * N;
-				double* pR = rhs.pBlock + l;
-				double x = 0.0;
-				for (int j = 0; j < N; ++j) {
-					x += *pL * *pR;
-					++pL;
-					pR += L;
-				}
-				*pDst = x;
-				++pDst;
-			}
-		}
-		return Matrix< M, L >(pBlock);
-	}
-
-	/**
-	 * Multiplies given two matrices.
+	 * Evaluates the product right away into a `Matrix` by
+	 * `Matrix::multiply`.
+	 * A product that involves a `Matrix` or an expression is lazy instead
+	 * (see `MatrixExpression.h`).
 	 *
-	 * `MatrixLike` must overload the function-call operator `()` which
-	 * takes a row index `i` and column index `j` and returns the element at
-	 * the ith row and jth column.
-	 * The function prototype should look like the following,
-	 *  - `double operator ()(int i, int j) const`
-	 *
-	 * @tparam M
-	 *     Number of rows in the left-hand-side matrix.
-	 * @tparam N
-	 *     Number of columns in the left-hand-side matrix.
-	 *     Number of rows in the right-hand-side matrix.
-	 * @tparam L
-	 *     Number of columns in the right-hand-side matrix.
-	 * @tparam MatrixLike
-	 *     Type of the right-hand-side matrix.
-	 * @param lhs
-	 *     Left-hand-side of the multiplication.
-	 * @param rhs
-	 *     Right-hand-side of the multiplication.
-	 * @return
-	 *     Product of `lhs` and `rhs`.
-	 */
-	template < int M, int N, int L, template < int, int > class MatrixLike >
-	Matrix< M, L > operator *(const Matrix< M, N >& lhs,
-							  const MatrixLike< N, L >& rhs)
-	{
-#if SINGULAR_TEMPLATE_FRIEND_OPERATOR_OVERLOADING_SUPPORTED
-		double* pBlock = new double[M * L];
-		double* pDst = pBlock;
-		for (int i = 0; i < M; ++i) {
-			for (int j = 0; j < L; ++j) {
-				const double* pL = lhs.pBlock + i * N;
-				double x = 0.0;
-				for (int k = 0; k < N; ++k) {
-					x += *pL * rhs(k, j);
-					++pL;
-				}
-				*pDst = x;
-				++pDst;
-			}
-		}
-		return Matrix< M, L >(pBlock);
-#else
-		return Matrix< M, N >::multiply(lhs, rhs);
-#endif
-	}
-
-	/**
-	 * Multiplies given two matrices.
-	 *
-	 * `MatrixLike` must overload the function-call operator `()` which
-	 * takes a row index `i` and column index `j` and returns the element at
-	 * the ith row and jth column.
+	 * Both of `MatrixLike1` and `MatrixLike2` must overload the
+	 * function-call operator `()` which takes a row index `i` and column
+	 * index `j` and returns the element at ith row and jth column.
 	 * The function prototype should look like the following,
 	 *  - `double operator ()(int i, int j) const`
 	 *
@@ -653,8 +542,10 @@ namespace singular {
 	 *     Number of rows in the right-hand-side matrix.
 	 * @tparam L
 	 *     Number of columns in the right-hand-side matrix.
-	 * @tparam MatrixLike
+	 * @tparam MatrixLike1
 	 *     Type of the left-hand-side matrix.
+	 * @tparam MatrixLike2
+	 *     Type of the right-hand-side matrix.
 	 * @param lhs
 	 *     Left-hand-side of the multiplication.
 	 * @param rhs
@@ -662,39 +553,21 @@ namespace singular {
 	 * @return
 	 *     Product of `lhs` and `rhs`.
 	 */
-	template < int M, int N, int L, template < int, int > class MatrixLike >
-	Matrix< M, L > operator *(const MatrixLike< M, N >& lhs,
-							  const Matrix< N, L >& rhs)
+	template <
+		int M, int N, int L,
+		template < int, int > class MatrixLike1,
+		template < int, int > class MatrixLike2 >
+	inline Matrix< M, L > operator *(const MatrixLike1< M, N >& lhs,
+									 const MatrixLike2< N, L >& rhs)
 	{
-#if SINGULAR_TEMPLATE_FRIEND_OPERATOR_OVERLOADING_SUPPORTED
-		double* pBlock = new double[M * L];
-		double* pDst = pBlock;
-		for (int i = 0; i < M; ++i) {
-			for (int j = 0; j < L; ++j) {
-				const double* pR = rhs.pBlock + j;
-				double x = 0.0;
-				for (int k = 0; k < N; ++k) {
-					x += lhs(i, k) * *pR;
-					pR += L;
-				}
-				*pDst = x;
-				++pDst;
-			}
-		}
-		return Matrix< M, L >(pBlock);
-#else
 		return Matrix< M, L >::multiply(lhs, rhs);
-#endif
 	}
 
 	/**
-	 * Multiplies given two matrices.
+	 * Multiplies given two diagonal matrices.
 	 *
-	 * Both of `MatrixLike1` and `MatrixLike2` must overload the
-	 * function-call operator `()` which takes a row index `i` and column
-	 * index `j` and returns the element at ith row and jth column.
-	 * The function prototype should look like the following,
-	 *  - `double operator ()(int i, int j) const`
+	 * Evaluates the product right away into a `Matrix` by
+	 * `Matrix::multiply`.
 	 *
 	 * @tparam M
 	 *     Number of rows in the left-hand-side matrix.
@@ -703,10 +576,8 @@ namespace singular {
 	 *     Number of rows in the right-hand-side matrix.
 	 * @tparam L
 	 *     Number of columns in the right-hand-side matrix.
-	 * @tparam MatrixLike1
-	 *     Type of the left-hand-side matrix.
-	 * @tparam MatrixLike2
-	 *     Type of the right-hand-side matrix.
+	 * @tparam T
+	 *     Type of elements.
 	 * @param lhs
 	 *     Left-hand-side of the multiplication.
 	 * @param rhs
@@ -714,46 +585,19 @@ namespace singular {
 	 * @return
 	 *     Product of `lhs` and `rhs`.
 	 */
-	template <
-		int M, int N, int L,
-		template < int, int > class MatrixLike1,
-		template < int, int > class MatrixLike2 >
-	Matrix< M, L > operator *(const MatrixLike1< M, N >& lhs,
-							  const MatrixLike2< N, L >& rhs)
+	template < int M, int N, int L, typename T >
+	inline Matrix< M, L, T > operator *(const DiagonalMatrix< M, N, T >& lhs,
+										const DiagonalMatrix< N, L, T >& rhs)
 	{
-#if SINGULAR_TEMPLATE_FRIEND_OPERATOR_OVERLOADING_SUPPORTED
-		double* pBlock = new double[M * L];
-		double* pDst = pBlock;
-		for (int i = 0; i < M; ++i) {
-			for (int j = 0; j < L; ++j) {
-				double x = 0.0;
-				for (int k = 0; k < N; ++k) {
-					x += lhs(i, k) * rhs(k, j);
-				}
-				*pDst = x;
-				++pDst;
-			}
-		}
-		return Matrix< M, L >(pBlock);
-#else
-		return Matrix< M, L >::multiply(lhs, rhs);
-#endif
+		return Matrix< M, L, T >::multiply(lhs, rhs);
 	}
 
-
 	/**
 	 * Writes a given matrix to a given stream.
 	 *
-	 * `MatrixLike` should overload the function-call operator `()` which takes
-	 * a row index `i` and column index `j` and returns the element at the ith
-	 * row and jth column.
-	 * The function prototype should look like the following,
-	 *  - `double operator ()(int i, int j) const`
+	 * `MatrixLike` must act as a matrix (see `MatrixTraits`) but must not
+	 * be an expression.
 	 *
-	 * @tparam M
-	 *     Number of rows in the matrix to be written.
-	 * @tparam N
-	 *     Number of columns in the matrix to be written.
 	 * @tparam MatrixLike
 	 *     Type of the matrix to be written.
 	 * @param out
@@ -763,8 +607,14 @@ namespace singular {
 	 * @return
 	 *     `out`.
 	 */
-	template < int M, int N, template < int, int > class MatrixLike >
-	std::ostream& operator <<(std::ostream& out, const MatrixLike< M, N >& m) {
+	template < typename MatrixLike >
+	typename std::enable_if<
+		MatrixTraits< MatrixLike >::IS_MATRIX &&
+			!MatrixTraits< MatrixLike >::IS_EXPRESSION,
+		std::ostream& >::type
+	operator <<(std::ostream& out, const MatrixLike& m) {
+		const int M = MatrixTraits< MatrixLike >::ROWS;
+		const int N = MatrixTraits< MatrixLike >::COLUMNS;
 		out << '[' << std::endl;
 		for (int i = 0; i < M; ++i) {
 			for (int j = 0; j < N; ++j) {
@@ -0,0 +1,856 @@
+#ifndef _SINGULAR_MATRIX_EXPRESSION_H
+#define _SINGULAR_MATRIX_EXPRESSION_H
+
+#include "singular/DiagonalMatrix.h"
+#include "singular/Gemm.h"
+#include "singular/MemoryBlock.h"
+#include "singular/singular.h"
+#include "singular/Transpose.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace singular {
+
+	// Defined in Matrix.h
+	template < int M, int N, typename T = double >
+	class Matrix;
+
+	// Defined later in this file
+	template < typename E >
+	class TransposeExpression;
+
+	// Defined later in this file
+	template < typename E >
+	class ScaleExpression;
+
+	// Defined later in this file
+	template < typename L, typename R >
+	class ProductExpression;
+
+	/**
+	 * Traits of a type that acts as a matrix.
+	 *
+	 * A type acts as a matrix if it is
+	 *  - `Matrix` or `DiagonalMatrix`,
+	 *  - a class template that takes the number of rows and columns,
+	 *    whose elements are `double`,
+	 *  - or an expression defined in this file.
+	 *
+	 * A matrix type must overload the function-call operator `()` which
+	 * takes a row index `i` and column index `j` and returns the element at
+	 * the ith row and jth column.
+	 *
+	 * @tparam T
+	 *     Type to be examined.
+	 */
+	template < typename T >
+	struct MatrixTraits {
+		enum {
+			/** Whether `T` acts as a matrix. */
+			IS_MATRIX = 0,
+			/** Whether `T` is a lazy expression. */
+			IS_EXPRESSION = 0,
+			/** Number of rows. */
+			ROWS = 0,
+			/** Number of columns. */
+			COLUMNS = 0
+		};
+
+		/** Type of elements. */
+		typedef double Element;
+	};
+
+	/** `MatrixTraits` of a `Matrix`. */
+	template < int M, int N, typename T >
+	struct MatrixTraits< Matrix< M, N, T > > {
+		enum {
+			IS_MATRIX = 1,
+			IS_EXPRESSION = 0,
+			ROWS = M,
+			COLUMNS = N
+		};
+		typedef T Element;
+	};
+
+	/** `MatrixTraits` of a `DiagonalMatrix`. */
+	template < int M, int N, typename T >
+	struct MatrixTraits< DiagonalMatrix< M, N, T > > {
+		enum {
+			IS_MATRIX = 1,
+			IS_EXPRESSION = 0,
+			ROWS = M,
+			COLUMNS = N
+		};
+		typedef T Element;
+	};
+
+	/** `MatrixTraits` of a class template like `Matrix< M, N >`. */
+	template < template < int, int > class MatrixLike, int M, int N >
+	struct MatrixTraits< MatrixLike< M, N > > {
+		enum {
+			IS_MATRIX = 1,
+			IS_EXPRESSION = 0,
+			ROWS = M,
+			COLUMNS = N
+		};
+		typedef double Element;
+	};
+
+	/** `MatrixTraits` of a transposition. */
+	template < typename E >
+	struct MatrixTraits< TransposeExpression< E > > {
+		enum {
+			IS_MATRIX = 1,
+			IS_EXPRESSION = 1,
+			ROWS = MatrixTraits< E >::COLUMNS,
+			COLUMNS = MatrixTraits< E >::ROWS
+		};
+		typedef typename MatrixTraits< E >::Element Element;
+	};
+
+	/** `MatrixTraits` of a scaling. */
+	template < typename E >
+	struct MatrixTraits< ScaleExpression< E > > {
+		enum {
+			IS_MATRIX = 1,
+			IS_EXPRESSION = 1,
+			ROWS = MatrixTraits< E >::ROWS,
+			COLUMNS = MatrixTraits< E >::COLUMNS
+		};
+		typedef typename MatrixTraits< E >::Element Element;
+	};
+
+	/**
+	 * `MatrixTraits` of a product.
+	 *
+	 * Both operands have the same type of elements (see `operator *`).
+	 */
+	template < typename L, typename R >
+	struct MatrixTraits< ProductExpression< L, R > > {
+		enum {
+			IS_MATRIX = 1,
+			IS_EXPRESSION = 1,
+			ROWS = MatrixTraits< L >::ROWS,
+			COLUMNS = MatrixTraits< R >::COLUMNS
+		};
+		typedef typename MatrixTraits< L >::Element Element;
+	};
+
+	/**
+	 * How an expression holds an operand of a given type.
+	 *
+	 * A matrix is held by reference, whereas a nested expression is held by
+	 * value because it is usually a temporary that dies at the end of the
+	 * statement that built the enclosing expression.
+	 * An expression therefore must not outlive the matrices it refers to,
+	 * but may outlive the expressions it was built from.
+	 *
+	 * @tparam E
+	 *     Type of the operand.
+	 */
+	template < typename E >
+	struct ExpressionOperand {
+		/** Type of the member that holds the operand. */
+		typedef typename std::conditional<
+			MatrixTraits< E >::IS_EXPRESSION, const E, const E& >::type Type;
+	};
+
+	/**
+	 * Number of elements that `MatrixEvaluator` needs to materialize an
+	 * operand of a product.
+	 *
+	 * A `Matrix` and transpositions and scalings of it are read in place
+	 * and need no elements.
+	 * Other operands are materialized with as many elements as they have;
+	 * transpositions and scalings of them do not change that number.
+	 *
+	 * @tparam E
+	 *     Type of the operand.
+	 */
+	template < typename E >
+	struct OperandStorageSize {
+		enum {
+			/** Number of elements. */
+			VALUE = MatrixTraits< E >::ROWS * MatrixTraits< E >::COLUMNS
+		};
+	};
+
+	/** `OperandStorageSize` of a `Matrix`. */
+	template < int M, int N, typename T >
+	struct OperandStorageSize< Matrix< M, N, T > > {
+		enum {
+			VALUE = 0
+		};
+	};
+
+	/** `OperandStorageSize` of a transposition. */
+	template < typename E >
+	struct OperandStorageSize< TransposeExpression< E > > {
+		enum {
+			VALUE = OperandStorageSize< E >::VALUE
+		};
+	};
+
+	/** `OperandStorageSize` of a scaling. */
+	template < typename E >
+	struct OperandStorageSize< ScaleExpression< E > > {
+		enum {
+			VALUE = OperandStorageSize< E >::VALUE
+		};
+	};
+
+	/**
+	 * Lazy transposition of a matrix.
+	 *
+	 * Holds the operand as `ExpressionOperand` specifies, and is evaluated
+	 * when it is assigned to a `Matrix`.
+	 * Must not outlive the matrix it refers to.
+	 *
+	 * @tparam E
+	 *     Type of the matrix to be transposed.
+	 */
+	template < typename E >
+	class TransposeExpression {
+	public:
+		/** Type of elements. */
+		typedef typename MatrixTraits< E >::Element Element;
+	private:
+		/** Matrix to be transposed. */
+		typename ExpressionOperand< E >::Type e;
+	public:
+		/**
+		 * Transposes a given matrix.
+		 *
+		 * @param e
+		 *     Matrix to be transposed.
+		 */
+		explicit TransposeExpression(const E& e) : e(e) {}
+
+		/**
+		 * Returns the matrix to be transposed.
+		 *
+		 * @return
+		 *     Operand of this transposition.
+		 */
+		inline const E& operand() const {
+			return this->e;
+		}
+
+		/**
+		 * Returns the element at a given row and column.
+		 *
+		 * @param i
+		 *     Index of the row.
+		 * @param j
+		 *     Index of the column.
+		 * @return
+		 *     Element at the jth row and ith column of the operand.
+		 */
+		inline Element operator ()(int i, int j) const {
+			return this->e(j, i);
+		}
+
+		/**
+		 * Transposes this transposition.
+		 *
+		 * The result is evaluated into a new `Matrix` like any other
+		 * expression; it is read with the original strides of the
+		 * operand.
+		 *
+		 * @return
+		 *     Lazy transposition of this transposition.
+		 */
+		inline TransposeExpression< TransposeExpression > transpose() const {
+			return TransposeExpression< TransposeExpression >(*this);
+		}
+	};
+
+	/**
+	 * Lazy multiplication of a matrix by a scalar.
+	 *
+	 * Holds the operand as `ExpressionOperand` specifies, and is evaluated
+	 * when it is assigned to a `Matrix`.
+	 * Must not outlive the matrix it refers to.
+	 *
+	 * @tparam E
+	 *     Type of the matrix to be scaled.
+	 */
+	template < typename E >
+	class ScaleExpression {
+	public:
+		/** Type of elements. */
+		typedef typename MatrixTraits< E >::Element Element;
+	private:
+		/** Matrix to be scaled. */
+		typename ExpressionOperand< E >::Type e;
+
+		/** Scalar multiplied to the matrix. */
+		Element a;
+	public:
+		/**
+		 * Scales a given matrix.
+		 *
+		 * @param e
+		 *     Matrix to be scaled.
+		 * @param a
+		 *     Scalar multiplied to `e`.
+		 */
+		ScaleExpression(const E& e, Element a) : e(e), a(a) {}
+
+		/**
+		 * Returns the matrix to be scaled.
+		 *
+		 * @return
+		 *     Operand of this scaling.
+		 */
+		inline const E& operand() const {
+			return this->e;
+		}
+
+		/**
+		 * Returns the scalar multiplied to the operand.
+		 *
+		 * @return
+		 *     Scaling factor.
+		 */
+		inline Element factor() const {
+			return this->a;
+		}
+
+		/**
+		 * Returns the element at a given row and column.
+		 *
+		 * @param i
+		 *     Index of the row.
+		 * @param j
+		 *     Index of the column.
+		 * @return
+		 *     Element at the ith row and jth column.
+		 */
+		inline Element operator ()(int i, int j) const {
+			return this->a * this->e(i, j);
+		}
+
+		/**
+		 * Transposes this scaling.
+		 *
+		 * @return
+		 *     Lazy transposition of this scaling.
+		 */
+		inline TransposeExpression< ScaleExpression > transpose() const {
+			return TransposeExpression< ScaleExpression >(*this);
+		}
+	};
+
+	/**
+	 * Lazy product of two matrices.
+	 *
+	 * Holds the operands as `ExpressionOperand` specifies, and is evaluated
+	 * when it is assigned to a `Matrix`.
+	 * Must not outlive the matrices it refers to.
+	 *
+	 * @tparam L
+	 *     Type of the left-hand-side matrix.
+	 * @tparam R
+	 *     Type of the right-hand-side matrix.
+	 */
+	template < typename L, typename R >
+	class ProductExpression {
+	public:
+		/** Type of elements. */
+		typedef typename MatrixTraits< L >::Element Element;
+	private:
+		/** Left-hand side of the product. */
+		typename ExpressionOperand< L >::Type l;
+
+		/** Right-hand side of the product. */
+		typename ExpressionOperand< R >::Type r;
+	public:
+		/**
+		 * Multiplies given two matrices.
+		 *
+		 * @param l
+		 *     Left-hand side of the product.
+		 * @param r
+		 *     Right-hand side of the product.
+		 */
+		ProductExpression(const L& l, const R& r) : l(l), r(r) {}
+
+		/**
+		 * Returns the left-hand side of this product.
+		 *
+		 * @return
+		 *     Left-hand side.
+		 */
+		inline const L& lhs() const {
+			return this->l;
+		}
+
+		/**
+		 * Returns the right-hand side of this product.
+		 *
+		 * @return
+		 *     Right-hand side.
+		 */
+		inline const R& rhs() const {
+			return this->r;
+		}
+
+		/**
+		 * Computes the element at a given row and column.
+		 *
+		 * Takes as many operations as the inner dimension.
+		 * Assign this product to a `Matrix` to obtain many elements.
+		 *
+		 * @param i
+		 *     Index of the row.
+		 * @param j
+		 *     Index of the column.
+		 * @return
+		 *     Element at the ith row and jth column.
+		 */
+		Element operator ()(int i, int j) const {
+			Element x = 0.0;
+			for (int k = 0; k < MatrixTraits< L >::COLUMNS; ++k) {
+				x += this->l(i, k) * this->r(k, j);
+			}
+			return x;
+		}
+
+		/**
+		 * Transposes this product.
+		 *
+		 * @return
+		 *     Lazy transposition of this product.
+		 */
+		inline TransposeExpression< ProductExpression > transpose() const {
+			return TransposeExpression< ProductExpression >(*this);
+		}
+	};
+
+	/**
+	 * Multiplies given two matrices lazily.
+	 *
+	 * Both operands must act as matrices (see `MatrixTraits`) of the same
+	 * type of elements, and the number of columns in `lhs` must equal the
+	 * number of rows in `rhs`.
+	 * A product of two matrices neither of which is a `Matrix` or an
+	 * expression, except for a product with a `DiagonalMatrix`, is
+	 * evaluated right away by `operator *` in `Matrix.h` instead.
+	 *
+	 * @tparam L
+	 *     Type of the left-hand-side matrix.
+	 * @tparam R
+	 *     Type of the right-hand-side matrix.
+	 * @param lhs
+	 *     Left-hand side of the multiplication.
+	 * @param rhs
+	 *     Right-hand side of the multiplication.
+	 * @return
+	 *     Lazy product of `lhs` and `rhs`.
+	 */
+	template < typename L, typename R >
+	inline typename std::enable_if<
+		MatrixTraits< L >::IS_MATRIX && MatrixTraits< R >::IS_MATRIX &&
+			(int)MatrixTraits< L >::COLUMNS == (int)MatrixTraits< R >::ROWS &&
+			std::is_same< typename MatrixTraits< L >::Element,
+						  typename MatrixTraits< R >::Element >::value,
+		ProductExpression< L, R > >::type
+	operator *(const L& lhs, const R& rhs) {
+		return ProductExpression< L, R >(lhs, rhs);
+	}
+
+	/**
+	 * Multiplies a given matrix by a given scalar lazily.
+	 *
+	 * @tparam E
+	 *     Type of the matrix.
+	 * @param a
+	 *     Scalar.
+	 *     Converted to the type of elements of `e`.
+	 * @param e
+	 *     Matrix.
+	 * @return
+	 *     Lazy product of `a` and `e`.
+	 */
+	template < typename E >
+	inline typename std::enable_if<
+		MatrixTraits< E >::IS_MATRIX, ScaleExpression< E > >::type
+	operator *(typename MatrixTraits< E >::Element a, const E& e) {
+		return ScaleExpression< E >(e, a);
+	}
+
+	/**
+	 * Multiplies a given matrix by a given scalar lazily.
+	 *
+	 * @tparam E
+	 *     Type of the matrix.
+	 * @param e
+	 *     Matrix.
+	 * @param a
+	 *     Scalar.
+	 *     Converted to the type of elements of `e`.
+	 * @return
+	 *     Lazy product of `e` and `a`.
+	 */
+	template < typename E >
+	inline typename std::enable_if<
+		MatrixTraits< E >::IS_MATRIX, ScaleExpression< E > >::type
+	operator *(const E& e, typename MatrixTraits< E >::Element a) {
+		return ScaleExpression< E >(e, a);
+	}
+
+	/**
+	 * Evaluation of matrix expressions.
+	 *
+	 * Writes an expression into a row-major memory block without
+	 * materializing intermediates where possible.
+	 *  - A transposition of a `Matrix` is read with swapped strides, or
+	 *    copied by `Transpose` if it is not an operand of a product.
+	 *  - A scaling is folded into the scalar of the enclosing product.
+	 *  - A product with a `DiagonalMatrix` scales rows or columns.
+	 *  - Other products are computed by `Gemm`.
+	 *
+	 * Only a nested product that is an operand of another product is
+	 * materialized into a temporary memory block.
+	 * The memory block is a `MemoryBlock` sized by `OperandStorageSize`,
+	 * so small operands are materialized without allocation.
+	 */
+	struct MatrixEvaluator {
+		/**
+		 * Operand of a product resolved into a strided memory block.
+		 *
+		 * The element at the ith row and jth column is
+		 * `factor * data[i * rowStride + j * columnStride]`.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 */
+		template < typename T >
+		struct DenseOperand {
+			/** First element. */
+			const T* data;
+
+			/** Distance from one row to the next row. */
+			ptrdiff_t rowStride;
+
+			/** Distance from one column to the next column. */
+			ptrdiff_t columnStride;
+
+			/** Scalar multiplied to every element. */
+			T factor;
+		};
+
+		/**
+		 * Memory block where an operand of a given type is materialized.
+		 *
+		 * Has a single element if the operand needs no elements.
+		 *
+		 * @tparam E
+		 *     Type of the operand.
+		 */
+		template < typename E >
+		struct OperandStorage {
+			enum {
+				/** Number of elements. */
+				SIZE = (OperandStorageSize< E >::VALUE > 0)
+					? OperandStorageSize< E >::VALUE
+					: 1
+			};
+
+			/** Elements. */
+			MemoryBlock< SIZE, typename MatrixTraits< E >::Element > block;
+		};
+
+		/**
+		 * Evaluates a given matrix expression into a given memory block.
+		 *
+		 * @tparam E
+		 *     Type of the expression.
+		 * @tparam T
+		 *     Type of elements.
+		 * @param e
+		 *     Expression to be evaluated.
+		 * @param[out] c
+		 *     Memory block where the elements are to be written.
+		 *     Must not overlap any operand of `e`.
+		 * @param ldc
+		 *     Distance from one row to the next row in `c`.
+		 */
+		template < int M, int N, typename T >
+		static void evaluate(const Matrix< M, N, T >& e,
+							 T* c,
+							 ptrdiff_t ldc)
+		{
+			for (int i = 0; i < M; ++i) {
+				const T* pSrc = e.data() + i * N;
+				std::copy(pSrc, pSrc + N, c + i * ldc);
+			}
+		}
+
+		/** Evaluates a given transposition. */
+		template < typename E, typename T >
+		static void evaluate(const TransposeExpression< E >& e,
+							 T* c,
+							 ptrdiff_t ldc)
+		{
+			const int M = MatrixTraits< TransposeExpression< E > >::ROWS;
+			const int N = MatrixTraits< TransposeExpression< E > >::COLUMNS;
+			OperandStorage< E > storage;
+			DenseOperand< T > a;
+			resolve(e, a, storage.block.data());
+			if (a.rowStride == 1) {
+				// transposes the operand block by block
+				Transpose::copy(N, M, a.data, a.columnStride, c, ldc);
+				scale(M, N, a.factor, c, ldc);
+				return;
+			}
+			for (int i = 0; i < M; ++i) {
+				const T* pSrc = a.data + i * a.rowStride;
+				T* pDst = c + i * ldc;
+				for (int j = 0; j < N; ++j) {
+					pDst[j] = a.factor * *pSrc;
+					pSrc += a.columnStride;
+				}
+			}
+		}
+
+		/** Evaluates a given scaling. */
+		template < typename E, typename T >
+		static void evaluate(const ScaleExpression< E >& e,
+							 T* c,
+							 ptrdiff_t ldc)
+		{
+			evaluate(e.operand(), c, ldc);
+			scale(MatrixTraits< E >::ROWS,
+				  MatrixTraits< E >::COLUMNS,
+				  e.factor(),
+				  c,
+				  ldc);
+		}
+
+		/** Evaluates a given product. */
+		template < typename L, typename R, typename T >
+		static void evaluate(const ProductExpression< L, R >& e,
+							 T* c,
+							 ptrdiff_t ldc)
+		{
+			multiply(e.lhs(), e.rhs(), c, ldc);
+		}
+
+		/** Evaluates a given matrix element by element. */
+		template < typename E, typename T >
+		static void evaluate(const E& e, T* c, ptrdiff_t ldc) {
+			for (int i = 0; i < MatrixTraits< E >::ROWS; ++i) {
+				T* pDst = c + i * ldc;
+				for (int j = 0; j < MatrixTraits< E >::COLUMNS; ++j) {
+					pDst[j] = e(i, j);
+				}
+			}
+		}
+	private:
+		/**
+		 * Resolves a given operand into a strided memory block.
+		 *
+		 * A `Matrix` is referred in place.
+		 * Transpositions and scalings of a `Matrix` are referred in place
+		 * as well.
+		 * Others are materialized into `storage`.
+		 *
+		 * @tparam E
+		 *     Type of the operand.
+		 * @tparam T
+		 *     Type of elements.
+		 * @param e
+		 *     Operand to be resolved.
+		 * @param[out] a
+		 *     Resolved operand.
+		 * @param storage
+		 *     Memory block where the operand is materialized if necessary.
+		 *     Must have at least `OperandStorageSize< E >::VALUE` elements.
+		 */
+		template < int M, int N, typename T >
+		static void resolve(const Matrix< M, N, T >& e,
+							DenseOperand< T >& a,
+							T* /* storage */)
+		{
+			a.data = e.data();
+			a.rowStride = N;
+			a.columnStride = 1;
+			a.factor = 1.0;
+		}
+
+		/** Resolves a given transposition. */
+		template < typename E, typename T >
+		static void resolve(const TransposeExpression< E >& e,
+							DenseOperand< T >& a,
+							T* storage)
+		{
+			resolve(e.operand(), a, storage);
+			std::swap(a.rowStride, a.columnStride);
+		}
+
+		/** Resolves a given scaling. */
+		template < typename E, typename T >
+		static void resolve(const ScaleExpression< E >& e,
+							DenseOperand< T >& a,
+							T* storage)
+		{
+			resolve(e.operand(), a, storage);
+			a.factor *= e.factor();
+		}
+
+		/** Materializes a given operand. */
+		template < typename E, typename T >
+		static void resolve(const E& e, DenseOperand< T >& a, T* storage) {
+			const int N = MatrixTraits< E >::COLUMNS;
+			evaluate(e, storage, N);
+			a.data = storage;
+			a.rowStride = N;
+			a.columnStride = 1;
+			a.factor = 1.0;
+		}
+
+		/**
+		 * Multiplies given two matrices into a given memory block.
+		 *
+		 * @tparam L
+		 *     Type of the left-hand-side matrix.
+		 * @tparam R
+		 *     Type of the right-hand-side matrix.
+		 * @tparam T
+		 *     Type of elements.
+		 * @param lhs
+		 *     Left-hand side of the multiplication.
+		 * @param rhs
+		 *     Right-hand side of the multiplication.
+		 * @param[out] c
+		 *     Memory block where the product is to be written.
+		 * @param ldc
+		 *     Distance from one row to the next row in `c`.
+		 */
+		template < typename L, typename R, typename T >
+		static void multiply(const L& lhs,
+							 const R& rhs,
+							 T* c,
+							 ptrdiff_t ldc)
+		{
+			const int M = MatrixTraits< L >::ROWS;
+			const int N = MatrixTraits< R >::COLUMNS;
+			const int K = MatrixTraits< L >::COLUMNS;
+			OperandStorage< L > aStorage;
+			OperandStorage< R > bStorage;
+			DenseOperand< T > a;
+			DenseOperand< T > b;
+			resolve(lhs, a, aStorage.block.data());
+			resolve(rhs, b, bStorage.block.data());
+			Gemm::multiplyStrided(M, N, K,
+								  a.data, a.rowStride, a.columnStride,
+								  b.data, b.rowStride, b.columnStride,
+								  c, ldc);
+			scale(M, N, a.factor * b.factor, c, ldc);
+		}
+
+		/** Multiplies a given matrix by a given diagonal matrix. */
+		template < typename L, int K, int N, typename T >
+		static void multiply(const L& lhs,
+							 const DiagonalMatrix< K, N, T >& rhs,
+							 T* c,
+							 ptrdiff_t ldc)
+		{
+			const int M = MatrixTraits< L >::ROWS;
+			const int D = K < N ? K : N;
+			OperandStorage< L > storage;
+			DenseOperand< T > a;
+			resolve(lhs, a, storage.block.data());
+			// columns beyond the diagonal are zeros
+			for (int i = 0; i < M; ++i) {
+				const T* pSrc = a.data + i * a.rowStride;
+				T* pDst = c + i * ldc;
+				for (int k = 0; k < D; ++k) {
+					pDst[k] = pSrc[k * a.columnStride] *
+						(a.factor * rhs(k, k));
+				}
+				std::fill(pDst + D, pDst + N, 0.0);
+			}
+		}
+
+		/** Multiplies a given diagonal matrix by a given matrix. */
+		template < int M, int K, typename R, typename T >
+		static void multiply(const DiagonalMatrix< M, K, T >& lhs,
+							 const R& rhs,
+							 T* c,
+							 ptrdiff_t ldc)
+		{
+			const int N = MatrixTraits< R >::COLUMNS;
+			const int D = M < K ? M : K;
+			OperandStorage< R > storage;
+			DenseOperand< T > b;
+			resolve(rhs, b, storage.block.data());
+			// rows beyond the diagonal are zeros
+			for (int i = 0; i < M; ++i) {
+				T* pDst = c + i * ldc;
+				if (i < D) {
+					const T d = b.factor * lhs(i, i);
+					const T* pSrc = b.data + i * b.rowStride;
+					for (int j = 0; j < N; ++j) {
+						pDst[j] = d * pSrc[j * b.columnStride];
+					}
+				} else {
+					std::fill(pDst, pDst + N, 0.0);
+				}
+			}
+		}
+
+		/** Multiplies given two diagonal matrices. */
+		template < int M, int K, int N, typename T >
+		static void multiply(const DiagonalMatrix< M, K, T >& lhs,
+							 const DiagonalMatrix< K, N, T >& rhs,
+							 T* c,
+							 ptrdiff_t ldc)
+		{
+			for (int i = 0; i < M; ++i) {
+				std::fill(c + i * ldc, c + i * ldc + N, 0.0);
+				if (i < K && i < N) {
+					c[i * ldc + i] = lhs(i, i) * rhs(i, i);
+				}
+			}
+		}
+
+		/**
+		 * Multiplies elements in a given memory block by a given scalar.
+		 *
+		 * Does nothing if the scalar is 1.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @param M
+		 *     Number of rows.
+		 * @param N
+		 *     Number of columns.
+		 * @param a
+		 *     Scalar.
+		 * @param[in,out] c
+		 *     Memory block to be scaled.
+		 * @param ldc
+		 *     Distance from one row to the next row in `c`.
+		 */
+		template < typename T >
+		static void scale(int M, int N, T a, T* c, ptrdiff_t ldc) {
+			if (a == 1.0) {
+				return;
+			}
+			for (int i = 0; i < M; ++i) {
+				T* pDst = c + i * ldc;
+				for (int j = 0; j < N; ++j) {
+					pDst[j] *= a;
+				}
+			}
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef _SINGULAR_MATRIX_VIEW_H
+#define _SINGULAR_MATRIX_VIEW_H
+
+#include "singular/singular.h"
+#include "singular/Vector.h"
+
+#include <cassert>
+
+namespace singular {
+
+	/** Order in which elements of a matrix are laid out. */
+	enum MatrixLayout {
+		/** Elements in a row are adjacent. */
+		ROW_MAJOR,
+		/** Elements in a column are adjacent. */
+		COLUMN_MAJOR
+	};
+
+	/**
+	 * Matrix that wraps a given memory block.
+	 *
+	 * Dimensions are given at runtime.
+	 * Elements are laid out in the row-major order by default.
+	 * A column-major view makes every column a contiguous vector, which
+	 * suits algorithms that update columns.
+	 *
+	 * A view does not own elements.
+	 * Changes on a view are reflected to the memory block, and a copy of a
+	 * view shares the memory block with the original view.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	class BasicMatrixView {
+	private:
+		/**
+		 * Memory block of this view.
+		 *
+		 * Element at the row `i` and column `j` is given by
+		 * `pBlock[i * rowStride + j * columnStride]`.
+		 */
+		T* pBlock;
+
+		/** Number of rows. */
+		int nRows;
+
+		/** Number of columns. */
+		int nColumns;
+
+		/** Distance from one row to the next row. */
+		int rowStride;
+
+		/** Distance from one column to the next column. */
+		int columnStride;
+
+		/** Order in which elements are laid out. */
+		MatrixLayout order;
+	public:
+		/**
+		 * Constructs a view that wraps a given memory block.
+		 *
+		 * `pBlock` must be valid during this view is used.
+		 * It is the caller's responsibility to release `pBlock` when it is no
+		 * longer needed.
+		 *
+		 * @param pBlock
+		 *     Pointer to the memory block of the matrix.
+		 *     Must have at least `rows * columns` elements.
+		 * @param rows
+		 *     Number of rows.
+		 * @param columns
+		 *     Number of columns.
+		 * @param layout
+		 *     Order in which elements are laid out in `pBlock`.
+		 */
+		BasicMatrixView(T* pBlock,
+						int rows,
+						int columns,
+						MatrixLayout layout = ROW_MAJOR)
+			: pBlock(pBlock),
+			  nRows(rows),
+			  nColumns(columns),
+			  rowStride(layout == ROW_MAJOR ? columns : 1),
+			  columnStride(layout == ROW_MAJOR ? 1 : rows),
+			  order(layout) {}
+
+		/**
+		 * Constructs a view that wraps a given memory block whose rows or
+		 * columns are padded.
+		 *
+		 * `pBlock` must be valid during this view is used.
+		 *
+		 * The behavior is undefined if `leadingDimension` is less than
+		 * `columns` for `ROW_MAJOR`, or less than `rows` for
+		 * `COLUMN_MAJOR`.
+		 *
+		 * @param pBlock
+		 *     Pointer to the memory block of the matrix.
+		 * @param rows
+		 *     Number of rows.
+		 * @param columns
+		 *     Number of columns.
+		 * @param leadingDimension
+		 *     Distance from one row to the next row for `ROW_MAJOR`.
+		 *     Distance from one column to the next column for
+		 *     `COLUMN_MAJOR`.
+		 * @param layout
+		 *     Order in which elements are laid out in `pBlock`.
+		 */
+		BasicMatrixView(T* pBlock,
+						int rows,
+						int columns,
+						int leadingDimension,
+						MatrixLayout layout = ROW_MAJOR)
+			: pBlock(pBlock),
+			  nRows(rows),
+			  nColumns(columns),
+			  rowStride(layout == ROW_MAJOR ? leadingDimension : 1),
+			  columnStride(layout == ROW_MAJOR ? 1 : leadingDimension),
+			  order(layout)
+		{
+			assert(leadingDimension >= (layout == ROW_MAJOR ? columns : rows));
+		}
+
+		/**
+		 * Returns the number of rows in this view.
+		 *
+		 * @return
+		 *     Number of rows.
+		 */
+		inline int rows() const {
+			return this->nRows;
+		}
+
+		/**
+		 * Returns the number of columns in this view.
+		 *
+		 * @return
+		 *     Number of columns.
+		 */
+		inline int columns() const {
+			return this->nColumns;
+		}
+
+		/**
+		 * Returns the order in which elements of this view are laid out.
+		 *
+		 * @return
+		 *     Layout of this view.
+		 */
+		inline MatrixLayout layout() const {
+			return this->order;
+		}
+
+		/**
+		 * Returns the distance between consecutive rows or columns.
+		 *
+		 * @return
+		 *     Distance from one row to the next row for `ROW_MAJOR`.
+		 *     Distance from one column to the next column for
+		 *     `COLUMN_MAJOR`.
+		 */
+		inline int leadingDimension() const {
+			return this->order == ROW_MAJOR ? this->rowStride
+											: this->columnStride;
+		}
+
+		/**
+		 * Returns the memory block of this view.
+		 *
+		 * @return
+		 *     Pointer to the element at the first row and first column.
+		 */
+		inline T* data() const {
+			return this->pBlock;
+		}
+
+		/**
+		 * Returns the value at a given row and column.
+		 *
+		 * The behavior is undefined,
+		 *  - if `i < 0` or `i >= this->rows()`,
+		 *  - or if `j < 0` or `j >= this->columns()`
+		 *
+		 * @param i
+		 *     Index of the row to be obtained.
+		 * @param j
+		 *     Index of the column to be obtained.
+		 * @return
+		 *     Element at the ith row and jth column.
+		 *     Changes on a returned element is reflected to this view.
+		 */
+		inline T& operator ()(int i, int j) const {
+			assert(i >= 0 && i < this->nRows);
+			assert(j >= 0 && j < this->nColumns);
+			return this->pBlock[i * this->rowStride + j * this->columnStride];
+		}
+
+		/**
+		 * Returns a given row in this view as a vector.
+		 *
+		 * @param i
+		 *     Index of the row to be obtained.
+		 * @return
+		 *     ith row as a vector.
+		 *     Changes on this vector are reflected to this view.
+		 */
+		inline Vector< T > row(int i) const {
+			return Vector< T >(this->pBlock + i * this->rowStride,
+							   this->nColumns,
+							   this->columnStride);
+		}
+
+		/**
+		 * Returns a given column in this view as a vector.
+		 *
+		 * @param j
+		 *     Index of the column to be obtained.
+		 * @return
+		 *     jth column as a vector.
+		 *     Changes on this vector are reflected to this view.
+		 */
+		inline Vector< T > column(int j) const {
+			return Vector< T >(this->pBlock + j * this->columnStride,
+							   this->nRows,
+							   this->rowStride);
+		}
+	};
+
+	/** View of a matrix of `double` elements. */
+	typedef BasicMatrixView< double > MatrixView;
+
+}
+
+#endif
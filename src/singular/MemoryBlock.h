@@ -0,0 +1,237 @@
+#ifndef _SINGULAR_MEMORY_BLOCK_H
+#define _SINGULAR_MEMORY_BLOCK_H
+
+#include "singular/AlignedAllocator.h"
+#include "singular/singular.h"
+
+#include <algorithm>
+
+namespace singular {
+
+	/**
+	 * Memory block of a fixed number of elements.
+	 *
+	 * Elements are stored inline if `SIZE` does not exceed
+	 * `SINGULAR_MAX_INLINE_ELEMENTS`.
+	 * Otherwise they are allocated on the heap.
+	 *
+	 * Elements are not initialized.
+	 *
+	 * @tparam SIZE
+	 *     Number of elements.
+	 * @tparam T
+	 *     Type of elements.
+	 * @tparam INLINE
+	 *     Whether elements are stored inline.
+	 *     Determined by `SIZE` by default.
+	 */
+	template < int SIZE,
+			   typename T = double,
+			   bool INLINE = (SIZE <= SINGULAR_MAX_INLINE_ELEMENTS) >
+	class MemoryBlock;
+
+	/**
+	 * Memory block whose elements are allocated on the heap.
+	 *
+	 * Elements are aligned to `SINGULAR_ALIGNMENT` bytes.
+	 *
+	 * @tparam SIZE
+	 *     Number of elements.
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < int SIZE, typename T >
+	class MemoryBlock< SIZE, T, false > {
+	private:
+		/** Elements. */
+		T* pBlock;
+	public:
+		/** Allocates elements. */
+		MemoryBlock() : pBlock(AlignedAllocator< T >().allocate(SIZE)) {}
+
+		/**
+		 * Steals elements from a given memory block.
+		 *
+		 * @param[in,out] copyee
+		 *     Memory block from which elements are to be stolen.
+		 *     No longer valid after this call.
+		 */
+#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
+		MemoryBlock(MemoryBlock&& copyee) : pBlock(copyee.pBlock) {
+			copyee.pBlock = 0;
+		}
+#else
+		MemoryBlock(const MemoryBlock& copyee) : pBlock(copyee.pBlock) {
+			const_cast< MemoryBlock& >(copyee).pBlock = 0;
+		}
+#endif
+
+		/** Releases elements. */
+		~MemoryBlock() {
+			AlignedAllocator< T >().deallocate(this->pBlock);
+		}
+
+		/**
+		 * Steals elements from a given memory block.
+		 *
+		 * @param[in,out] copyee
+		 *     Memory block from which elements are to be stolen.
+		 *     No longer valid after this call.
+		 * @return
+		 *     Reference to this memory block.
+		 */
+#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
+		MemoryBlock& operator =(MemoryBlock&& copyee) {
+#else
+		MemoryBlock& operator =(const MemoryBlock& copyee) {
+#endif
+			if (this != &copyee) {
+				AlignedAllocator< T >().deallocate(this->pBlock);
+				this->pBlock = copyee.pBlock;
+#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
+				copyee.pBlock = 0;
+#else
+				const_cast< MemoryBlock& >(copyee).pBlock = 0;
+#endif
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns the pointer to the first element.
+		 *
+		 * @return
+		 *     Pointer to the first element.
+		 */
+		inline T* data() {
+			return this->pBlock;
+		}
+
+		/**
+		 * Returns the pointer to the first element.
+		 *
+		 * @return
+		 *     Pointer to the first element.
+		 */
+		inline const T* data() const {
+			return this->pBlock;
+		}
+	private:
+#if SINGULAR_FUNCTION_DELETION_SUPPORTED
+		/** Simple copy is not allowed. */
+		MemoryBlock(const MemoryBlock& copyee) = delete;
+
+		/** Simple copy is not allowed. */
+		MemoryBlock& operator =(const MemoryBlock& copyee) = delete;
+#elif SINGULAR_RVALUE_REFERENCE_SUPPORTED
+		/** Simple copy is not allowed. */
+		MemoryBlock(const MemoryBlock& copyee) {}
+
+		/** Simple copy is not allowed. */
+		MemoryBlock& operator =(const MemoryBlock& copyee) {
+			return *this;
+		}
+#endif
+	};
+
+	/**
+	 * Memory block whose elements are stored inline.
+	 *
+	 * Moving a memory block of this kind copies elements.
+	 * Elements are aligned only to 16 bytes so that small matrices do not
+	 * grow to a whole cache line.
+	 *
+	 * @tparam SIZE
+	 *     Number of elements.
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < int SIZE, typename T >
+	class MemoryBlock< SIZE, T, true > {
+	private:
+		/** Elements. */
+#if SINGULAR_ALIGNAS_SUPPORTED
+		alignas(16) T elements[SIZE];
+#else
+		T elements[SIZE];
+#endif
+	public:
+		/** Initializes a memory block. */
+		MemoryBlock() {}
+
+		/**
+		 * Copies elements from a given memory block.
+		 *
+		 * @param copyee
+		 *     Memory block from which elements are to be copied.
+		 *     Still valid after this call.
+		 */
+#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
+		MemoryBlock(MemoryBlock&& copyee) {
+#else
+		MemoryBlock(const MemoryBlock& copyee) {
+#endif
+			std::copy(copyee.elements, copyee.elements + SIZE, this->elements);
+		}
+
+		/**
+		 * Copies elements from a given memory block.
+		 *
+		 * @param copyee
+		 *     Memory block from which elements are to be copied.
+		 *     Still valid after this call.
+		 * @return
+		 *     Reference to this memory block.
+		 */
+#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
+		MemoryBlock& operator =(MemoryBlock&& copyee) {
+#else
+		MemoryBlock& operator =(const MemoryBlock& copyee) {
+#endif
+			if (this != &copyee) {
+				std::copy(
+					copyee.elements, copyee.elements + SIZE, this->elements);
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns the pointer to the first element.
+		 *
+		 * @return
+		 *     Pointer to the first element.
+		 */
+		inline T* data() {
+			return this->elements;
+		}
+
+		/**
+		 * Returns the pointer to the first element.
+		 *
+		 * @return
+		 *     Pointer to the first element.
+		 */
+		inline const T* data() const {
+			return this->elements;
+		}
+	private:
+#if SINGULAR_FUNCTION_DELETION_SUPPORTED
+		/** Simple copy is not allowed. */
+		MemoryBlock(const MemoryBlock& copyee) = delete;
+
+		/** Simple copy is not allowed. */
+		MemoryBlock& operator =(const MemoryBlock& copyee) = delete;
+#elif SINGULAR_RVALUE_REFERENCE_SUPPORTED
+		/** Simple copy is not allowed. */
+		MemoryBlock(const MemoryBlock& copyee) {}
+
+		/** Simple copy is not allowed. */
+		MemoryBlock& operator =(const MemoryBlock& copyee) {
+			return *this;
+		}
+#endif
+	};
+
+}
+
+#endif
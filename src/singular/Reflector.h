@@ -2,20 +2,20 @@
 #define _SINGULAR_REFLECTOR_H
 
 #include "singular/Matrix.h"
+#include "singular/VectorKernel.h"
 #include "singular/singular.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <iostream>
-#include <iterator>
 #include <limits>
-#include <numeric>
 #include <vector>
 
 namespace singular {
 
 	/**
-	 * Reflector.
+	 * Reflector whose size is determined by a matrix it is applied to.
 	 *
 	 * A reflector transforms a vector (\f$\mathbf{x} =
 	 * \begin{bmatrix} x_1 & x_2 & \dots & x_N \end{bmatrix}\f$)
@@ -27,69 +27,299 @@ namespace singular {
 	 * \mathbf{H} = \mathbf{I} - \gamma \mathbf{u} \mathbf{u}^T
 	 * \f]
 	 *
-	 * @tparam L
-	 *     Size of the transform matrix.
+	 * When applied to a matrix with `L` rows (or columns),
+	 * a reflector made from an `N`-element vector acts as the following
+	 * \f$L \times L\f$ matrix,
+	 * \f[
+	 * \begin{bmatrix}
+	 *   \mathbf{I} & \mathbf{0} \\
+	 *   \mathbf{0} & \mathbf{H}
+	 * \end{bmatrix}
+	 * \f]
+	 * where \f$\mathbf{I}\f$ is an \f$(L-N) \times (L-N)\f$ identity matrix.
+	 *
+	 * @tparam T
+	 *     Type of elements.
 	 */
-	template < int L >
-	class Reflector {
+	template < typename T >
+	class BasicDynamicReflector {
 	private:
+		/**
+		 * Memory block for the u vector.
+		 *
+		 * Empty if the u vector is stored in a memory block given by the
+		 * caller.
+		 */
+		std::vector< T > block;
+
 		/** U vector. */
-		std::vector< double > u;
+		Vector< T > u;
 
 		/** Gamma. */
-		double gamma;
+		T gamma;
 	public:
 		/**
 		 * Constructs a reflector from a given vector.
 		 *
-		 * Forms an \f$L \times L\f$ matrix like the following,
-		 * \f[
-		 * \begin{bmatrix}
-		 *   \mathbf{I} & \mathbf{0} \\
-		 *   \mathbf{0} & \mathbf{R}
-		 * \end{bmatrix}
-		 * \f]
+		 * The behavior is undefined if `v.size() == 0`.
 		 *
-		 * \f$\mathbf{R}\f$ is an \f$N \times N\f$ reflector created from
-		 * `v` where `N = v.size()`.
-		 * \f$\mathbf{I}\f$ is an \f$(L-N) \times (L-N)\f$ identity matrix.
+		 * @param v
+		 *     Vector from which the reflector is formed.
+		 */
+		BasicDynamicReflector(const Vector< const T >& v)
+			: block(v.size()), u(this->block.data(), v.size(), 1)
+		{
+			this->initialize(v);
+		}
+
+		/**
+		 * Constructs a reflector from a given vector on a given memory block.
 		 *
-		 * The behavior is undefined if `v.size() == 0` or `v.size() > L`.
+		 * Works like `BasicDynamicReflector(const Vector< const T >&)` but
+		 * stores the u vector in `pBlock` instead of allocating a new memory
+		 * block.
+		 *
+		 * `pBlock` must be valid during this reflector is used.
+		 * It is the caller's responsibility to release `pBlock` when it is no
+		 * longer needed.
+		 *
+		 * The behavior is undefined,
+		 *  - if `v.size() == 0`,
+		 *  - or if `pBlock` has less than `v.size()` elements
 		 *
 		 * @param v
 		 *     Vector from which the reflector is formed.
-		 * @throws Exception
-		 *     If `v.size() == 0`, or if `v.size() > L`.
+		 * @param pBlock
+		 *     Memory block where the u vector is to be stored.
+		 *     May not overlap `v`.
+		 */
+		BasicDynamicReflector(const Vector< const T >& v, T* pBlock)
+			: u(pBlock, v.size(), 1)
+		{
+			this->initialize(v);
+		}
+
+		/**
+		 * Copies a given reflector.
+		 *
+		 * The copy shares the u vector with `copyee` if `copyee` stores it
+		 * in a memory block given by the caller.
+		 *
+		 * @param copyee
+		 *     Reflector to be copied.
+		 */
+		BasicDynamicReflector(const BasicDynamicReflector& copyee)
+			: block(copyee.block),
+			  u(copyee.block.empty() ? copyee.u
+				  : Vector< T >(this->block.data(), copyee.u.size(), 1)),
+			  gamma(copyee.gamma) {}
+
+		/**
+		 * Copies a given reflector.
+		 *
+		 * @param copyee
+		 *     Reflector to be copied.
+		 * @return
+		 *     Reference to this reflector.
+		 * @see BasicDynamicReflector(const BasicDynamicReflector&)
+		 */
+		BasicDynamicReflector& operator =(const BasicDynamicReflector& copyee) {
+			this->block = copyee.block;
+			this->u = copyee.block.empty() ? copyee.u
+				: Vector< T >(this->block.data(), copyee.u.size(), 1);
+			this->gamma = copyee.gamma;
+			return *this;
+		}
+
+		/**
+		 * Makes a reflector that wraps a given u vector.
+		 *
+		 * The first element of `u` is regarded as 1 whatever it is,
+		 * so `u` has to hold 1 there while the reflector is applied.
+		 * This is how `SvdKernel` keeps reflectors in the zeroed parts of a
+		 * bidiagonalized matrix.
+		 *
+		 * `u` must be valid during the reflector is used.
+		 *
+		 * @param u
+		 *     U vector to be wrapped.
+		 *     Not copied.
+		 * @param gamma
+		 *     Gamma of the reflector.
+		 * @return
+		 *     Reflector that wraps `u`.
+		 */
+		static BasicDynamicReflector wrap(const Vector< T >& u, T gamma) {
+			return BasicDynamicReflector(u, gamma);
+		}
+
+		/**
+		 * Returns the u vector of this reflector.
+		 *
+		 * The first element is 1 unless this reflector is made from a zero
+		 * vector.
+		 *
+		 * @return
+		 *     U vector.
+		 */
+		inline const Vector< T >& getU() const {
+			return this->u;
+		}
+
+		/**
+		 * Returns gamma of this reflector.
+		 *
+		 * @return
+		 *     Gamma.
+		 */
+		inline T getGamma() const {
+			return this->gamma;
+		}
+
+		/**
+		 * Applies this reflector to a given matrix from left in place.
+		 *
+		 * This reflector acts on the last `u.size()` rows of `m`.
+		 * Only the columns from `firstColumn` to `m.columns() - 1` are
+		 * transformed.
+		 * The other columns are left untouched, which is equivalent to the
+		 * full transformation if they are zero in the rows this reflector
+		 * acts on.
+		 * Rows above the ones this reflector acts on are never touched.
+		 *
+		 * The behavior is undefined,
+		 *  - if `m` has less rows than this reflector,
+		 *  - or if `firstColumn < 0` or `firstColumn > m.columns()`
+		 *
+		 * @tparam MatrixLike
+		 *     Type of the given matrix.
+		 *     `Matrix` or `MatrixView`.
+		 * @param[in,out] m
+		 *     Matrix to be transformed.
+		 * @param firstColumn
+		 *     Index of the first column to be transformed.
+		 */
+		template < typename MatrixLike >
+		void applyFromLeftInPlace(MatrixLike& m, int firstColumn = 0) const {
+			assert(firstColumn >= 0 && firstColumn <= m.columns());
+			assert(m.rows() >= static_cast< int >(this->u.size()));
+			// H * m = m - gamma * u * u^T * m
+			int offset = m.rows() - static_cast< int >(this->u.size());
+			const BasicVectorKernel< T >& kernel =
+				BasicVectorKernel< T >::best();
+			const size_t L = this->u.size();
+			for (int i = firstColumn; i < m.columns(); ++i) {
+				// caches gamma * u^T * m
+				Vector< T > column = m.column(i).slice(offset);
+				T gUM = kernel.dot(
+					L,
+					this->u.data(), this->u.stride(),
+					column.data(), column.stride());
+				gUM *= this->gamma;
+				// H * m = m - u * gUM
+				kernel.axpy(
+					L,
+					-gUM,
+					this->u.data(), this->u.stride(),
+					column.data(), column.stride());
+			}
+		}
+
+		/**
+		 * Applies this reflector to a given matrix from right in place.
+		 *
+		 * This reflector acts on the last `u.size()` columns of `m`.
+		 * Only the rows from `firstRow` to `m.rows() - 1` are transformed.
+		 * The other rows are left untouched, which is equivalent to the
+		 * full transformation if they are zero in the columns this reflector
+		 * acts on.
+		 * Columns on the left of the ones this reflector acts on are never
+		 * touched.
+		 *
+		 * The behavior is undefined,
+		 *  - if `m` has less columns than this reflector,
+		 *  - or if `firstRow < 0` or `firstRow > m.rows()`
+		 *
+		 * @tparam MatrixLike
+		 *     Type of the given matrix.
+		 *     `Matrix` or `MatrixView`.
+		 * @param[in,out] m
+		 *     Matrix to be transformed.
+		 * @param firstRow
+		 *     Index of the first row to be transformed.
+		 */
+		template < typename MatrixLike >
+		void applyFromRightInPlace(MatrixLike& m, int firstRow = 0) const {
+			assert(firstRow >= 0 && firstRow <= m.rows());
+			assert(m.columns() >= static_cast< int >(this->u.size()));
+			// m * H = m - m * gamma * u * u^T
+			int offset = m.columns() - static_cast< int >(this->u.size());
+			const BasicVectorKernel< T >& kernel =
+				BasicVectorKernel< T >::best();
+			const size_t L = this->u.size();
+			for (int i = firstRow; i < m.rows(); ++i) {
+				// caches gamma * m * u
+				Vector< T > row = m.row(i).slice(offset);
+				T gMU = kernel.dot(
+					L,
+					this->u.data(), this->u.stride(),
+					row.data(), row.stride());
+				gMU *= this->gamma;
+				// m * H = m - gMU * u^T
+				kernel.axpy(
+					L,
+					-gMU,
+					this->u.data(), this->u.stride(),
+					row.data(), row.stride());
+			}
+		}
+	private:
+		/**
+		 * Wraps a given u vector.
+		 *
+		 * @param u
+		 *     U vector to be wrapped.
+		 * @param gamma
+		 *     Gamma.
 		 */
-		Reflector(const Vector< const double >& v) {
-			assert(v.size() > 0 && v.size() <= L);
+		BasicDynamicReflector(const Vector< T >& u, T gamma)
+			: u(u), gamma(gamma) {}
+
+		/**
+		 * Initializes the u vector and gamma from a given vector.
+		 *
+		 * `this->u` must have been bound to a memory block of `v.size()`
+		 * elements.
+		 *
+		 * @param v
+		 *     Vector from which this reflector is formed.
+		 */
+		void initialize(const Vector< const T >& v) {
+			assert(v.size() > 0);
 			const size_t N = v.size();
 			// copies the vector
-			this->u.reserve(N);
-			std::copy(v.begin(), v.end(), std::back_inserter(this->u));
+			std::copy(v.begin(), v.end(), this->u.begin());
 			// normalizes elements by the maximum amplitude
 			// to avoid harmful underflow and overflow
-			double mx = 0.0;
+			T mx = 0.0;
 			for (size_t i = 0; i < N; ++i) {
 				mx = std::max(std::abs(this->u[i]), mx);
 			}
 			if (mx > 0.0) {
 				// calculates the normalized norm
-				double tau = 0.0;
-				for (size_t i = 0; i < N; ++i) {
-					double x = this->u[i] / mx;
-					this->u[i] = x;
-					tau += x * x;
-				}
-				tau = sqrt(tau);
+				const BasicVectorKernel< T >& kernel =
+					BasicVectorKernel< T >::best();
+				T* pU = this->u.data();
+				const ptrdiff_t incU = this->u.stride();
+				kernel.scale(N, T(1) / mx, pU, incU);
+				T tau = std::sqrt(kernel.dot(N, pU, incU, pU, incU));
 				// tau's sign should be the same as the first element in `u`
 				if (this->u[0] < 0.0) {
 					tau = -tau;
 				}
-				double u0 = this->u[0] + tau;
-				this->u[0] = u0;
-				std::transform(this->u.begin(), this->u.end(), this->u.begin(),
-					[u0] (double& e) { return e / u0; });
+				T u0 = this->u[0] + tau;
+				kernel.scale(N, T(1) / u0, pU, incU);
+				this->u[0] = 1.0;
 				this->gamma = u0 / tau;
 			} else {
 				// v is a zero vector
@@ -97,6 +327,72 @@ namespace singular {
 				std::fill(this->u.begin(), this->u.end(), 0.0);
 			}
 		}
+	};
+
+	/** Reflector of `double` elements whose size is given at runtime. */
+	typedef BasicDynamicReflector< double > DynamicReflector;
+
+	/**
+	 * Reflector.
+	 *
+	 * Works like `DynamicReflector` but the size of the transform matrix is
+	 * fixed at compile time.
+	 *
+	 * @tparam L
+	 *     Size of the transform matrix.
+	 */
+	template < int L >
+	class Reflector : public DynamicReflector {
+	public:
+		/**
+		 * Constructs a reflector from a given vector.
+		 *
+		 * Forms an \f$L \times L\f$ matrix like the following,
+		 * \f[
+		 * \begin{bmatrix}
+		 *   \mathbf{I} & \mathbf{0} \\
+		 *   \mathbf{0} & \mathbf{R}
+		 * \end{bmatrix}
+		 * \f]
+		 *
+		 * \f$\mathbf{R}\f$ is an \f$N \times N\f$ reflector created from
+		 * `v` where `N = v.size()`.
+		 * \f$\mathbf{I}\f$ is an \f$(L-N) \times (L-N)\f$ identity matrix.
+		 *
+		 * The behavior is undefined if `v.size() == 0` or `v.size() > L`.
+		 *
+		 * @param v
+		 *     Vector from which the reflector is formed.
+		 */
+		Reflector(const Vector< const double >& v) : DynamicReflector(v) {
+			assert(v.size() <= L);
+		}
+
+		/**
+		 * Constructs a reflector from a given vector on a given memory block.
+		 *
+		 * Works like `Reflector(const Vector< const double >&)` but stores
+		 * the u vector in `pBlock` instead of allocating a new memory block.
+		 *
+		 * `pBlock` must be valid during this reflector is used.
+		 * It is the caller's responsibility to release `pBlock` when it is no
+		 * longer needed.
+		 *
+		 * The behavior is undefined,
+		 *  - if `v.size() == 0` or `v.size() > L`,
+		 *  - or if `pBlock` has less than `v.size()` elements
+		 *
+		 * @param v
+		 *     Vector from which the reflector is formed.
+		 * @param pBlock
+		 *     Memory block where the u vector is to be stored.
+		 *     May not overlap `v`.
+		 */
+		Reflector(const Vector< const double >& v, double* pBlock)
+			: DynamicReflector(v, pBlock)
+		{
+			assert(v.size() <= L);
+		}
 
 		/**
 		 * Applies this reflector to a given matrix from left.
@@ -110,24 +406,8 @@ namespace singular {
 		 */
 		template < int N >
 		Matrix< L, N > applyFromLeftTo(const Matrix< L, N >& m) const {
-			// H * m = m - gamma * u * u^T * m
 			Matrix< L, N > m2 = m.clone();
-			int offset = L - u.size();
-			for (int i = 0; i < N; ++i) {
-				// caches gamma * u^T * m
-				Vector< const double > srcColumn = m.column(i).slice(offset);
-				double gUM = std::inner_product(
-					this->u.begin(), this->u.end(), srcColumn.begin(), 0.0);
-				gUM *= this->gamma;
-				// H * m = m - u * gUM
-				Vector< double > dstColumn = m2.column(i).slice(offset);
-				std::transform(
-					this->u.begin(), this->u.end(), srcColumn.begin(),
-					dstColumn.begin(),
-					[gUM](double a, double b) {
-						return b - a * gUM;
-					});
-			}
+			this->applyFromLeftInPlace(m2);
 			return m2;
 		}
 
@@ -143,28 +423,11 @@ namespace singular {
 		 */
 		template < int M >
 		Matrix< M, L > applyFromRightTo(const Matrix< M, L >& m) const {
-			// m * H = m - m * gamma * u * u^T
 			Matrix< M, L > m2 = m.clone();
-			int offset = L - u.size();
-			for (int i = 0; i < M; ++i) {
-				// caches gamma * m * u
-				Vector< const double > srcRow = m.row(i).slice(offset);
-				double gMU = std::inner_product(
-					this->u.begin(), this->u.end(), srcRow.begin(), 0.0);
-				gMU *= this->gamma;
-				// m * H = m - gMU * u^T
-				Vector< double > dstRow = m2.row(i).slice(offset);
-				std::transform(
-					this->u.begin(), this->u.end(), srcRow.begin(),
-					dstRow.begin(),
-					[gMU](double a, double b) {
-						return b - gMU * a;
-					});
-			}
+			this->applyFromRightInPlace(m2);
 			return m2;
 		}
 	};
-
 }
 
 #endif
@@ -0,0 +1,1488 @@
+#ifndef _SINGULAR_ROTATION_KERNEL_H
+#define _SINGULAR_ROTATION_KERNEL_H
+
+#include "singular/Simd.h"
+#include "singular/singular.h"
+
+#include <cstddef>
+
+namespace singular {
+
+	/**
+	 * Kernels that apply a plane rotation to pairs of elements.
+	 *
+	 * Every kernel replaces each pair \f$(x, y)\f$ with
+	 * \f$(c x + s y, c y - s x)\f$.
+	 *
+	 * There is a set of kernels for every `SimdLevel`.
+	 * `best` picks the set for the CPU at runtime, so one binary runs well
+	 * on every CPU.
+	 * Only `double` and `float` have SIMD kernels; the other types are
+	 * rotated by portable kernels at every level.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	struct BasicRotationKernel {
+		enum {
+			/** Number of sweeps that `rotateSweeps` applies at once. */
+			SWEEPS = 8
+		};
+
+		/**
+		 * Kernel that rotates two contiguous arrays.
+		 *
+		 * @param[in,out] x
+		 *     First array.
+		 * @param[in,out] y
+		 *     Second array.
+		 * @param n
+		 *     Number of elements in each array.
+		 * @param c
+		 *     Cosine of the rotation.
+		 * @param s
+		 *     Sine of the rotation.
+		 */
+		typedef void (*RowsFunction)(T* x, T* y, size_t n, T c, T s);
+
+		/**
+		 * Kernel that rotates pairs of adjacent elements laid out at
+		 * a given interval.
+		 *
+		 * The ith pair is `(p[i * stride], p[i * stride + 1])`.
+		 * This is how a pair of adjacent columns of a row-major matrix is
+		 * laid out.
+		 *
+		 * @param[in,out] p
+		 *     Pointer to the first pair.
+		 * @param n
+		 *     Number of pairs.
+		 * @param stride
+		 *     Distance from one pair to the next pair.
+		 * @param c
+		 *     Cosine of the rotation.
+		 * @param s
+		 *     Sine of the rotation.
+		 */
+		typedef void (*PairsFunction)(
+			T* p, size_t n, ptrdiff_t stride, T c, T s);
+
+		/**
+		 * Kernel that applies `SWEEPS` sweeps of rotations to adjacent
+		 * columns of a column-major matrix in a wavefront order.
+		 *
+		 * Every sweep rotates the columns `i` and `i + 1` like `RowsFunction`
+		 * for `i = 0, ..., columns - 2` in this order, and the sweep `s` is
+		 * applied before the sweep `s + 1`.
+		 * The rotation `i` of the sweep `s` only has to follow the rotation
+		 * `i - 1` of the sweep `s` and the rotation `i + 1` of the sweep
+		 * `s - 1`.
+		 * So rotations are applied wave by wave, where the wave `d` consists
+		 * of the rotation `d - s` of every sweep `s`.
+		 * A strip of rows keeps the `SWEEPS` columns that a wave passes in
+		 * registers, so every element is loaded and stored only once.
+		 *
+		 * @param[in,out] a
+		 *     First column of the matrix.
+		 * @param rows
+		 *     Number of rows in the matrix.
+		 * @param ld
+		 *     Distance from one column to the next column.
+		 * @param columns
+		 *     Number of columns in the matrix.
+		 * @param r
+		 *     Rotations.
+		 *     The cosine and sine of the rotation `i` of the sweep `s` are
+		 *     `r[s * stride + 2 * i]` and `r[s * stride + 2 * i + 1]`.
+		 * @param stride
+		 *     Distance from one sweep to the next sweep in `r`.
+		 */
+		typedef void (*SweepsFunction)(T* a,
+									   size_t rows,
+									   ptrdiff_t ld,
+									   int columns,
+									   const T* r,
+									   ptrdiff_t stride);
+
+		/** Rotates two contiguous arrays. */
+		RowsFunction rotateRows;
+
+		/** Rotates pairs of adjacent elements. */
+		PairsFunction rotatePairs;
+
+		/** Applies `SWEEPS` sweeps of rotations in a wavefront order. */
+		SweepsFunction rotateSweeps;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicRotationKernel& best() {
+			static const BasicRotationKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The level is ignored because there are no SIMD kernels for this
+		 * type of elements.
+		 *
+		 * @return
+		 *     Portable kernels.
+		 */
+		static const BasicRotationKernel& get(SimdLevel) {
+			static const BasicRotationKernel SCALAR_KERNEL = {
+				&rotateRowsScalar, &rotatePairsScalar, &rotateSweepsScalar
+			};
+			return SCALAR_KERNEL;
+		}
+
+		/** Portable `RowsFunction`. */
+		static void rotateRowsScalar(T* x, T* y, size_t n, T c, T s) {
+			for (size_t i = 0; i < n; ++i) {
+				T x1 = x[i];
+				T y1 = y[i];
+				x[i] = c * x1 + s * y1;
+				y[i] = c * y1 - s * x1;
+			}
+		}
+
+		/** Portable `PairsFunction`. */
+		static void rotatePairsScalar(
+			T* p, size_t n, ptrdiff_t stride, T c, T s)
+		{
+			for (size_t i = 0; i < n; ++i, p += stride) {
+				T x1 = p[0];
+				T y1 = p[1];
+				p[0] = c * x1 + s * y1;
+				p[1] = c * y1 - s * x1;
+			}
+		}
+
+		/**
+		 * Returns the rotations of a given wave for `rotateSweeps`.
+		 *
+		 * Rotations that would touch a column out of the matrix are
+		 * replaced with the identity, which passes a column through the
+		 * window unchanged.
+		 *
+		 * @param r
+		 *     Rotations given to `rotateSweeps`.
+		 * @param stride
+		 *     Distance from one sweep to the next sweep in `r`.
+		 * @param columns
+		 *     Number of columns in the matrix.
+		 * @param d
+		 *     Index of the wave.
+		 * @param[out] p
+		 *     Where the rotation of each sweep is to be stored.
+		 */
+		static inline void waveRotations(const T* r,
+										 ptrdiff_t stride,
+										 int columns,
+										 int d,
+										 const T* p[SWEEPS])
+		{
+			static const T IDENTITY[2] = { 1, 0 };
+			if (d >= SWEEPS - 1 && d + 2 <= columns) {
+				const T* q = r + 2 * d;
+				for (int s = 0; s < SWEEPS; ++s, q += stride - 2) {
+					p[s] = q;
+				}
+				return;
+			}
+			for (int s = 0; s < SWEEPS; ++s) {
+				const int i = d - s;
+				p[s] = (i >= 0 && i + 2 <= columns)
+					? r + s * stride + 2 * i
+					: IDENTITY;
+			}
+		}
+
+		/**
+		 * Portable `SweepsFunction`.
+		 *
+		 * Before the wave `d`, `w[j]` holds the column
+		 * `d - SWEEPS + 1 + j`.
+		 * The wave carries the next column down the window and leaves the
+		 * column `d - SWEEPS + 1`, which every sweep has passed.
+		 */
+		static void rotateSweepsScalar(T* a,
+									   size_t rows,
+									   ptrdiff_t ld,
+									   int columns,
+									   const T* r,
+									   ptrdiff_t stride)
+		{
+			const int lastWave = columns + SWEEPS - 3;
+			for (size_t k = 0; k < rows; ++k) {
+				T* x = a + k;
+				T w[SWEEPS] = {};
+				w[SWEEPS - 1] = x[0];
+				for (int d = 0; d <= lastWave; ++d) {
+					const T* p[SWEEPS];
+					waveRotations(r, stride, columns, d, p);
+					T y = (d + 1 < columns) ? x[(d + 1) * ld] : T(0);
+					for (int s = 0; s < SWEEPS; ++s) {
+						T& ws = w[SWEEPS - 1 - s];
+						const T xs = ws;
+						ws = p[s][0] * y - p[s][1] * xs;
+						y = p[s][0] * xs + p[s][1] * y;
+					}
+					if (d >= SWEEPS - 1) {
+						x[(d - SWEEPS + 1) * ld] = y;
+					}
+				}
+				x[(columns - 1) * ld] = w[0];
+			}
+		}
+	};
+
+	/**
+	 * Kernels that apply a plane rotation to pairs of `double` elements.
+	 *
+	 * Works like `BasicRotationKernel` but there is a set of kernels for
+	 * every `SimdLevel`.
+	 */
+	template <>
+	struct BasicRotationKernel< double > {
+		enum {
+			/** Number of sweeps that `rotateSweeps` applies at once. */
+			SWEEPS = 8,
+
+			/**
+			 * Number of waves by which `rotateSweeps` prefetches a column.
+			 *
+			 * Columns of a large matrix are pages apart, which hardware
+			 * prefetchers do not follow.
+			 */
+			PREFETCH_WAVES = 2 * SWEEPS
+		};
+
+		/**
+		 * Kernel that rotates two contiguous arrays.
+		 *
+		 * @param[in,out] x
+		 *     First array.
+		 * @param[in,out] y
+		 *     Second array.
+		 * @param n
+		 *     Number of elements in each array.
+		 * @param c
+		 *     Cosine of the rotation.
+		 * @param s
+		 *     Sine of the rotation.
+		 */
+		typedef void (*RowsFunction)(
+			double* x, double* y, size_t n, double c, double s);
+
+		/**
+		 * Kernel that rotates pairs of adjacent elements laid out at
+		 * a given interval.
+		 *
+		 * The ith pair is `(p[i * stride], p[i * stride + 1])`.
+		 * This is how a pair of adjacent columns of a row-major matrix is
+		 * laid out.
+		 *
+		 * @param[in,out] p
+		 *     Pointer to the first pair.
+		 * @param n
+		 *     Number of pairs.
+		 * @param stride
+		 *     Distance from one pair to the next pair.
+		 * @param c
+		 *     Cosine of the rotation.
+		 * @param s
+		 *     Sine of the rotation.
+		 */
+		typedef void (*PairsFunction)(
+			double* p, size_t n, ptrdiff_t stride, double c, double s);
+
+		/**
+		 * Kernel that applies `SWEEPS` sweeps of rotations to adjacent
+		 * columns of a column-major matrix in a wavefront order.
+		 *
+		 * Every sweep rotates the columns `i` and `i + 1` like `RowsFunction`
+		 * for `i = 0, ..., columns - 2` in this order, and the sweep `s` is
+		 * applied before the sweep `s + 1`.
+		 * The rotation `i` of the sweep `s` only has to follow the rotation
+		 * `i - 1` of the sweep `s` and the rotation `i + 1` of the sweep
+		 * `s - 1`.
+		 * So rotations are applied wave by wave, where the wave `d` consists
+		 * of the rotation `d - s` of every sweep `s`.
+		 * A strip of rows keeps the `SWEEPS` columns that a wave passes in
+		 * registers, so every element is loaded and stored only once.
+		 *
+		 * @param[in,out] a
+		 *     First column of the matrix.
+		 * @param rows
+		 *     Number of rows in the matrix.
+		 * @param ld
+		 *     Distance from one column to the next column.
+		 * @param columns
+		 *     Number of columns in the matrix.
+		 * @param r
+		 *     Rotations.
+		 *     The cosine and sine of the rotation `i` of the sweep `s` are
+		 *     `r[s * stride + 2 * i]` and `r[s * stride + 2 * i + 1]`.
+		 * @param stride
+		 *     Distance from one sweep to the next sweep in `r`.
+		 */
+		typedef void (*SweepsFunction)(double* a,
+									   size_t rows,
+									   ptrdiff_t ld,
+									   int columns,
+									   const double* r,
+									   ptrdiff_t stride);
+
+		/** Rotates two contiguous arrays. */
+		RowsFunction rotateRows;
+
+		/** Rotates pairs of adjacent elements. */
+		PairsFunction rotatePairs;
+
+		/** Applies `SWEEPS` sweeps of rotations in a wavefront order. */
+		SweepsFunction rotateSweeps;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicRotationKernel& best() {
+			static const BasicRotationKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The behavior is undefined if the CPU does not support `level`.
+		 * Levels not compiled in fall back to the highest compiled level
+		 * below them.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 * @return
+		 *     Kernels for `level`.
+		 */
+		static const BasicRotationKernel& get(SimdLevel level) {
+			static const BasicRotationKernel SCALAR_KERNEL = {
+				&rotateRowsScalar, &rotatePairsScalar, &rotateSweepsScalar
+			};
+#if SINGULAR_SIMD_SUPPORTED
+			static const BasicRotationKernel SSE2_KERNEL = {
+				&rotateRowsSse2, &rotatePairsSse2, &rotateSweepsSse2
+			};
+			static const BasicRotationKernel AVX2_KERNEL = {
+				&rotateRowsAvx2, &rotatePairsAvx2, &rotateSweepsAvx2
+			};
+#if SINGULAR_AVX512_SUPPORTED
+			static const BasicRotationKernel AVX512_KERNEL = {
+				&rotateRowsAvx512, &rotatePairsAvx2, &rotateSweepsAvx512
+			};
+#endif
+			switch (level) {
+#if SINGULAR_AVX512_SUPPORTED
+			case SIMD_AVX512:
+				return AVX512_KERNEL;
+#else
+			case SIMD_AVX512:
+#endif
+			case SIMD_AVX2:
+				return AVX2_KERNEL;
+			case SIMD_SSE2:
+				return SSE2_KERNEL;
+			default:
+				return SCALAR_KERNEL;
+			}
+#else
+			return SCALAR_KERNEL;
+#endif
+		}
+
+		/** Portable `RowsFunction`. */
+		static void rotateRowsScalar(
+			double* x, double* y, size_t n, double c, double s)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				double x1 = x[i];
+				double y1 = y[i];
+				x[i] = c * x1 + s * y1;
+				y[i] = c * y1 - s * x1;
+			}
+		}
+
+		/** Portable `PairsFunction`. */
+		static void rotatePairsScalar(
+			double* p, size_t n, ptrdiff_t stride, double c, double s)
+		{
+			for (size_t i = 0; i < n; ++i, p += stride) {
+				double x1 = p[0];
+				double y1 = p[1];
+				p[0] = c * x1 + s * y1;
+				p[1] = c * y1 - s * x1;
+			}
+		}
+
+		/**
+		 * Returns the rotations of a given wave for `rotateSweeps`.
+		 *
+		 * Rotations that would touch a column out of the matrix are
+		 * replaced with the identity, which passes a column through the
+		 * window unchanged.
+		 *
+		 * @param r
+		 *     Rotations given to `rotateSweeps`.
+		 * @param stride
+		 *     Distance from one sweep to the next sweep in `r`.
+		 * @param columns
+		 *     Number of columns in the matrix.
+		 * @param d
+		 *     Index of the wave.
+		 * @param[out] p
+		 *     Where the rotation of each sweep is to be stored.
+		 */
+		static inline void waveRotations(const double* r,
+										 ptrdiff_t stride,
+										 int columns,
+										 int d,
+										 const double* p[SWEEPS])
+		{
+			static const double IDENTITY[2] = { 1, 0 };
+			if (d >= SWEEPS - 1 && d + 2 <= columns) {
+				const double* q = r + 2 * d;
+				for (int s = 0; s < SWEEPS; ++s, q += stride - 2) {
+					p[s] = q;
+				}
+				return;
+			}
+			for (int s = 0; s < SWEEPS; ++s) {
+				const int i = d - s;
+				p[s] = (i >= 0 && i + 2 <= columns)
+					? r + s * stride + 2 * i
+					: IDENTITY;
+			}
+		}
+
+		/**
+		 * Portable `SweepsFunction`.
+		 *
+		 * Before the wave `d`, `w[j]` holds the column
+		 * `d - SWEEPS + 1 + j`.
+		 * The wave carries the next column down the window and leaves the
+		 * column `d - SWEEPS + 1`, which every sweep has passed.
+		 */
+		static void rotateSweepsScalar(double* a,
+									   size_t rows,
+									   ptrdiff_t ld,
+									   int columns,
+									   const double* r,
+									   ptrdiff_t stride)
+		{
+			const int lastWave = columns + SWEEPS - 3;
+			for (size_t k = 0; k < rows; ++k) {
+				double* x = a + k;
+				double w[SWEEPS] = {};
+				w[SWEEPS - 1] = x[0];
+				for (int d = 0; d <= lastWave; ++d) {
+					const double* p[SWEEPS];
+					waveRotations(r, stride, columns, d, p);
+					double y = (d + 1 < columns) ? x[(d + 1) * ld] : double(0);
+					for (int s = 0; s < SWEEPS; ++s) {
+						double& ws = w[SWEEPS - 1 - s];
+						const double xs = ws;
+						ws = p[s][0] * y - p[s][1] * xs;
+						y = p[s][0] * xs + p[s][1] * y;
+					}
+					if (d >= SWEEPS - 1) {
+						x[(d - SWEEPS + 1) * ld] = y;
+					}
+				}
+				x[(columns - 1) * ld] = w[0];
+			}
+		}
+#if SINGULAR_SIMD_SUPPORTED
+		/** `RowsFunction` with SSE2. */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void rotateRowsSse2(
+			double* x, double* y, size_t n, double c, double s)
+		{
+			const __m128d vc = _mm_set1_pd(c);
+			const __m128d vs = _mm_set1_pd(s);
+			size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				__m128d vx = _mm_loadu_pd(x + i);
+				__m128d vy = _mm_loadu_pd(y + i);
+				_mm_storeu_pd(x + i, _mm_add_pd(
+					_mm_mul_pd(vc, vx), _mm_mul_pd(vs, vy)));
+				_mm_storeu_pd(y + i, _mm_sub_pd(
+					_mm_mul_pd(vc, vy), _mm_mul_pd(vs, vx)));
+			}
+			rotateRowsScalar(x + i, y + i, n - i, c, s);
+		}
+
+		/**
+		 * `PairsFunction` with SSE2.
+		 *
+		 * A pair fits in a register; the swapped pair is multiplied by
+		 * \f$(s, -s)\f$.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void rotatePairsSse2(
+			double* p, size_t n, ptrdiff_t stride, double c, double s)
+		{
+			const __m128d vc = _mm_set1_pd(c);
+			const __m128d vs = _mm_set_pd(-s, s);
+			for (size_t i = 0; i < n; ++i, p += stride) {
+				__m128d v = _mm_loadu_pd(p);
+				__m128d w = _mm_shuffle_pd(v, v, 1);
+				_mm_storeu_pd(p, _mm_add_pd(
+					_mm_mul_pd(vc, v), _mm_mul_pd(vs, w)));
+			}
+		}
+
+		/**
+		 * Rotates a column in the window of `rotateSweepsSse2` and the
+		 * column carried through the wave.
+		 *
+		 * @param[in,out] w
+		 *     Column in the window.
+		 * @param[in,out] y
+		 *     Carried column.
+		 * @param p
+		 *     Cosine and sine of the rotation.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static inline void rotateWindowSse2(__m128d& w,
+											__m128d& y,
+											const double* p)
+		{
+			const __m128d vc = _mm_set1_pd(p[0]);
+			const __m128d vs = _mm_set1_pd(p[1]);
+			const __m128d x = w;
+			w = _mm_sub_pd(_mm_mul_pd(vc, y), _mm_mul_pd(vs, x));
+			y = _mm_add_pd(_mm_mul_pd(vc, x), _mm_mul_pd(vs, y));
+		}
+
+		/**
+		 * `SweepsFunction` with SSE2.
+		 *
+		 * The window of a strip of 2 rows is held in `w0`, ..., `w7`
+		 * like `w` of `rotateSweepsScalar`.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void rotateSweepsSse2(double* a,
+									 size_t rows,
+									 ptrdiff_t ld,
+									 int columns,
+									 const double* r,
+									 ptrdiff_t stride)
+		{
+			const int lastWave = columns + SWEEPS - 3;
+			size_t k = 0;
+			for (; k + 2 <= rows; k += 2) {
+				double* x = a + k;
+				__m128d w0 = _mm_setzero_pd();
+				__m128d w1 = w0;
+				__m128d w2 = w0;
+				__m128d w3 = w0;
+				__m128d w4 = w0;
+				__m128d w5 = w0;
+				__m128d w6 = w0;
+				__m128d w7 = _mm_loadu_pd(x);
+				for (int d = 0; d <= lastWave; ++d) {
+					const double* p[SWEEPS];
+					waveRotations(r, stride, columns, d, p);
+					__m128d y = (d + 1 < columns)
+						? _mm_loadu_pd(x + (d + 1) * ld)
+						: _mm_setzero_pd();
+					if (d + PREFETCH_WAVES < columns) {
+						_mm_prefetch(reinterpret_cast< const char* >(
+							x + (d + PREFETCH_WAVES) * ld), _MM_HINT_T0);
+					}
+					rotateWindowSse2(w7, y, p[0]);
+					rotateWindowSse2(w6, y, p[1]);
+					rotateWindowSse2(w5, y, p[2]);
+					rotateWindowSse2(w4, y, p[3]);
+					rotateWindowSse2(w3, y, p[4]);
+					rotateWindowSse2(w2, y, p[5]);
+					rotateWindowSse2(w1, y, p[6]);
+					rotateWindowSse2(w0, y, p[7]);
+					if (d >= SWEEPS - 1) {
+						_mm_storeu_pd(x + (d - SWEEPS + 1) * ld, y);
+					}
+				}
+				_mm_storeu_pd(x + (columns - 1) * ld, w0);
+			}
+			rotateSweepsScalar(a + k, rows - k, ld, columns, r, stride);
+		}
+
+		/** `RowsFunction` with AVX2 and FMA. */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void rotateRowsAvx2(
+			double* x, double* y, size_t n, double c, double s)
+		{
+			const __m256d vc = _mm256_set1_pd(c);
+			const __m256d vs = _mm256_set1_pd(s);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				__m256d vx = _mm256_loadu_pd(x + i);
+				__m256d vy = _mm256_loadu_pd(y + i);
+				_mm256_storeu_pd(x + i,
+					_mm256_fmadd_pd(vc, vx, _mm256_mul_pd(vs, vy)));
+				_mm256_storeu_pd(y + i,
+					_mm256_fmsub_pd(vc, vy, _mm256_mul_pd(vs, vx)));
+			}
+			rotateRowsScalar(x + i, y + i, n - i, c, s);
+		}
+
+		/**
+		 * `PairsFunction` with AVX2 and FMA.
+		 *
+		 * Two pairs from consecutive rows share a register.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void rotatePairsAvx2(
+			double* p, size_t n, ptrdiff_t stride, double c, double s)
+		{
+			const __m256d vc = _mm256_set1_pd(c);
+			const __m256d vs = _mm256_set_pd(-s, s, -s, s);
+			size_t i = 0;
+			for (; i + 2 <= n; i += 2, p += 2 * stride) {
+				double* q = p + stride;
+				__m256d v = _mm256_insertf128_pd(
+					_mm256_castpd128_pd256(_mm_loadu_pd(p)),
+					_mm_loadu_pd(q),
+					1);
+				__m256d w = _mm256_permute_pd(v, 0x5);
+				__m256d r = _mm256_fmadd_pd(vc, v, _mm256_mul_pd(vs, w));
+				_mm_storeu_pd(p, _mm256_castpd256_pd128(r));
+				_mm_storeu_pd(q, _mm256_extractf128_pd(r, 1));
+			}
+			rotatePairsScalar(p, n - i, stride, c, s);
+		}
+
+		/**
+		 * Rotates a column in the window of `rotateSweepsAvx2` and the
+		 * column carried through the wave.
+		 *
+		 * @param[in,out] w
+		 *     Column in the window.
+		 * @param[in,out] y
+		 *     Carried column.
+		 * @param p
+		 *     Cosine and sine of the rotation.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static inline void rotateWindowAvx2(__m256d& w,
+											__m256d& y,
+											const double* p)
+		{
+			const __m256d vc = _mm256_set1_pd(p[0]);
+			const __m256d vs = _mm256_set1_pd(p[1]);
+			const __m256d x = w;
+			w = _mm256_fmsub_pd(vc, y, _mm256_mul_pd(vs, x));
+			y = _mm256_fmadd_pd(vc, x, _mm256_mul_pd(vs, y));
+		}
+
+		/**
+		 * `SweepsFunction` with AVX2 and FMA.
+		 *
+		 * The window of a strip of 4 rows is held in `w0`, ..., `w7`
+		 * like `w` of `rotateSweepsScalar`.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void rotateSweepsAvx2(double* a,
+									 size_t rows,
+									 ptrdiff_t ld,
+									 int columns,
+									 const double* r,
+									 ptrdiff_t stride)
+		{
+			const int lastWave = columns + SWEEPS - 3;
+			size_t k = 0;
+			for (; k + 4 <= rows; k += 4) {
+				double* x = a + k;
+				__m256d w0 = _mm256_setzero_pd();
+				__m256d w1 = w0;
+				__m256d w2 = w0;
+				__m256d w3 = w0;
+				__m256d w4 = w0;
+				__m256d w5 = w0;
+				__m256d w6 = w0;
+				__m256d w7 = _mm256_loadu_pd(x);
+				for (int d = 0; d <= lastWave; ++d) {
+					const double* p[SWEEPS];
+					waveRotations(r, stride, columns, d, p);
+					__m256d y = (d + 1 < columns)
+						? _mm256_loadu_pd(x + (d + 1) * ld)
+						: _mm256_setzero_pd();
+					if (d + PREFETCH_WAVES < columns) {
+						_mm_prefetch(reinterpret_cast< const char* >(
+							x + (d + PREFETCH_WAVES) * ld), _MM_HINT_T0);
+					}
+					rotateWindowAvx2(w7, y, p[0]);
+					rotateWindowAvx2(w6, y, p[1]);
+					rotateWindowAvx2(w5, y, p[2]);
+					rotateWindowAvx2(w4, y, p[3]);
+					rotateWindowAvx2(w3, y, p[4]);
+					rotateWindowAvx2(w2, y, p[5]);
+					rotateWindowAvx2(w1, y, p[6]);
+					rotateWindowAvx2(w0, y, p[7]);
+					if (d >= SWEEPS - 1) {
+						_mm256_storeu_pd(x + (d - SWEEPS + 1) * ld, y);
+					}
+				}
+				_mm256_storeu_pd(x + (columns - 1) * ld, w0);
+			}
+			rotateSweepsScalar(a + k, rows - k, ld, columns, r, stride);
+		}
+#if SINGULAR_AVX512_SUPPORTED
+		/**
+		 * `RowsFunction` with AVX-512F.
+		 *
+		 * Pairs are rotated by `rotatePairsAvx2` even on AVX-512 CPUs,
+		 * because gathering pairs from more rows does not pay off.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void rotateRowsAvx512(
+			double* x, double* y, size_t n, double c, double s)
+		{
+			const __m512d vc = _mm512_set1_pd(c);
+			const __m512d vs = _mm512_set1_pd(s);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m512d vx = _mm512_loadu_pd(x + i);
+				__m512d vy = _mm512_loadu_pd(y + i);
+				_mm512_storeu_pd(x + i,
+					_mm512_fmadd_pd(vc, vx, _mm512_mul_pd(vs, vy)));
+				_mm512_storeu_pd(y + i,
+					_mm512_fmsub_pd(vc, vy, _mm512_mul_pd(vs, vx)));
+			}
+			rotateRowsScalar(x + i, y + i, n - i, c, s);
+		}
+
+		/**
+		 * Rotates a column in the windows of two strips in
+		 * `rotateSweepsAvx512` and the columns carried through the wave.
+		 *
+		 * @param[in,out] w1
+		 *     Column in the window of the first strip.
+		 * @param[in,out] w2
+		 *     Column in the window of the second strip.
+		 * @param[in,out] y1
+		 *     Carried column of the first strip.
+		 * @param[in,out] y2
+		 *     Carried column of the second strip.
+		 * @param p
+		 *     Cosine and sine of the rotation.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static inline void rotateWindowAvx512(__m512d& w1,
+											  __m512d& w2,
+											  __m512d& y1,
+											  __m512d& y2,
+											  const double* p)
+		{
+			const __m512d vc = _mm512_set1_pd(p[0]);
+			const __m512d vs = _mm512_set1_pd(p[1]);
+			const __m512d x1 = w1;
+			const __m512d x2 = w2;
+			w1 = _mm512_fmsub_pd(vc, y1, _mm512_mul_pd(vs, x1));
+			w2 = _mm512_fmsub_pd(vc, y2, _mm512_mul_pd(vs, x2));
+			y1 = _mm512_fmadd_pd(vc, x1, _mm512_mul_pd(vs, y1));
+			y2 = _mm512_fmadd_pd(vc, x2, _mm512_mul_pd(vs, y2));
+		}
+
+		/**
+		 * `SweepsFunction` with AVX-512F.
+		 *
+		 * Two strips of 8 rows share every rotation; their windows are
+		 * held in `u0`, ..., `u7` and `v0`, ..., `v7`.
+		 * The rows left over are rotated by `rotateSweepsAvx2`.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void rotateSweepsAvx512(double* a,
+									   size_t rows,
+									   ptrdiff_t ld,
+									   int columns,
+									   const double* r,
+									   ptrdiff_t stride)
+		{
+			const int lastWave = columns + SWEEPS - 3;
+			size_t k = 0;
+			for (; k + 16 <= rows; k += 16) {
+				double* x = a + k;
+				__m512d u0 = _mm512_setzero_pd();
+				__m512d u1 = u0;
+				__m512d u2 = u0;
+				__m512d u3 = u0;
+				__m512d u4 = u0;
+				__m512d u5 = u0;
+				__m512d u6 = u0;
+				__m512d u7 = _mm512_loadu_pd(x);
+				__m512d v0 = u0;
+				__m512d v1 = u0;
+				__m512d v2 = u0;
+				__m512d v3 = u0;
+				__m512d v4 = u0;
+				__m512d v5 = u0;
+				__m512d v6 = u0;
+				__m512d v7 = _mm512_loadu_pd(x + 8);
+				for (int d = 0; d <= lastWave; ++d) {
+					const double* p[SWEEPS];
+					waveRotations(r, stride, columns, d, p);
+					__m512d y1 = _mm512_setzero_pd();
+					__m512d y2 = y1;
+					if (d + 1 < columns) {
+						y1 = _mm512_loadu_pd(x + (d + 1) * ld);
+						y2 = _mm512_loadu_pd(x + (d + 1) * ld + 8);
+					}
+					if (d + PREFETCH_WAVES < columns) {
+						_mm_prefetch(reinterpret_cast< const char* >(
+							x + (d + PREFETCH_WAVES) * ld), _MM_HINT_T0);
+						_mm_prefetch(reinterpret_cast< const char* >(
+							x + (d + PREFETCH_WAVES) * ld + 8), _MM_HINT_T0);
+					}
+					rotateWindowAvx512(u7, v7, y1, y2, p[0]);
+					rotateWindowAvx512(u6, v6, y1, y2, p[1]);
+					rotateWindowAvx512(u5, v5, y1, y2, p[2]);
+					rotateWindowAvx512(u4, v4, y1, y2, p[3]);
+					rotateWindowAvx512(u3, v3, y1, y2, p[4]);
+					rotateWindowAvx512(u2, v2, y1, y2, p[5]);
+					rotateWindowAvx512(u1, v1, y1, y2, p[6]);
+					rotateWindowAvx512(u0, v0, y1, y2, p[7]);
+					if (d >= SWEEPS - 1) {
+						_mm512_storeu_pd(x + (d - SWEEPS + 1) * ld, y1);
+						_mm512_storeu_pd(x + (d - SWEEPS + 1) * ld + 8, y2);
+					}
+				}
+				_mm512_storeu_pd(x + (columns - 1) * ld, u0);
+				_mm512_storeu_pd(x + (columns - 1) * ld + 8, v0);
+			}
+			rotateSweepsAvx2(a + k, rows - k, ld, columns, r, stride);
+		}
+#endif
+#endif
+	};
+
+	/**
+	 * Kernels that apply a plane rotation to pairs of `float` elements.
+	 *
+	 * Works like `BasicRotationKernel< double >` but a register holds twice
+	 * as many elements.
+	 */
+	template <>
+	struct BasicRotationKernel< float > {
+		enum {
+			/** Number of sweeps that `rotateSweeps` applies at once. */
+			SWEEPS = 8,
+
+			/**
+			 * Number of waves by which `rotateSweeps` prefetches a column.
+			 *
+			 * Columns of a large matrix are pages apart, which hardware
+			 * prefetchers do not follow.
+			 */
+			PREFETCH_WAVES = 2 * SWEEPS
+		};
+
+		/** Kernel that rotates two contiguous arrays. */
+		typedef void (*RowsFunction)(
+			float* x, float* y, size_t n, float c, float s);
+
+		/** Kernel that rotates pairs of adjacent elements. */
+		typedef void (*PairsFunction)(
+			float* p, size_t n, ptrdiff_t stride, float c, float s);
+
+		/** Kernel that applies `SWEEPS` sweeps of rotations in a wavefront. */
+		typedef void (*SweepsFunction)(float* a,
+									   size_t rows,
+									   ptrdiff_t ld,
+									   int columns,
+									   const float* r,
+									   ptrdiff_t stride);
+
+		/** Rotates two contiguous arrays. */
+		RowsFunction rotateRows;
+
+		/** Rotates pairs of adjacent elements. */
+		PairsFunction rotatePairs;
+
+		/** Applies `SWEEPS` sweeps of rotations in a wavefront order. */
+		SweepsFunction rotateSweeps;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicRotationKernel& best() {
+			static const BasicRotationKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The behavior is undefined if the CPU does not support `level`.
+		 * Levels not compiled in fall back to the highest compiled level
+		 * below them.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 * @return
+		 *     Kernels for `level`.
+		 */
+		static const BasicRotationKernel& get(SimdLevel level) {
+			static const BasicRotationKernel SCALAR_KERNEL = {
+				&rotateRowsScalar, &rotatePairsScalar, &rotateSweepsScalar
+			};
+#if SINGULAR_SIMD_SUPPORTED
+			static const BasicRotationKernel SSE2_KERNEL = {
+				&rotateRowsSse2, &rotatePairsSse2, &rotateSweepsSse2
+			};
+			static const BasicRotationKernel AVX2_KERNEL = {
+				&rotateRowsAvx2, &rotatePairsAvx2, &rotateSweepsAvx2
+			};
+#if SINGULAR_AVX512_SUPPORTED
+			static const BasicRotationKernel AVX512_KERNEL = {
+				&rotateRowsAvx512, &rotatePairsAvx2, &rotateSweepsAvx512
+			};
+#endif
+			switch (level) {
+#if SINGULAR_AVX512_SUPPORTED
+			case SIMD_AVX512:
+				return AVX512_KERNEL;
+#else
+			case SIMD_AVX512:
+#endif
+			case SIMD_AVX2:
+				return AVX2_KERNEL;
+			case SIMD_SSE2:
+				return SSE2_KERNEL;
+			default:
+				return SCALAR_KERNEL;
+			}
+#else
+			return SCALAR_KERNEL;
+#endif
+		}
+
+		/** Portable `RowsFunction`. */
+		static void rotateRowsScalar(
+			float* x, float* y, size_t n, float c, float s)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				float x1 = x[i];
+				float y1 = y[i];
+				x[i] = c * x1 + s * y1;
+				y[i] = c * y1 - s * x1;
+			}
+		}
+
+		/** Portable `PairsFunction`. */
+		static void rotatePairsScalar(
+			float* p, size_t n, ptrdiff_t stride, float c, float s)
+		{
+			for (size_t i = 0; i < n; ++i, p += stride) {
+				float x1 = p[0];
+				float y1 = p[1];
+				p[0] = c * x1 + s * y1;
+				p[1] = c * y1 - s * x1;
+			}
+		}
+
+		/**
+		 * Returns the rotations of a given wave for `rotateSweeps`.
+		 *
+		 * Rotations that would touch a column out of the matrix are
+		 * replaced with the identity, which passes a column through the
+		 * window unchanged.
+		 *
+		 * @param r
+		 *     Rotations given to `rotateSweeps`.
+		 * @param stride
+		 *     Distance from one sweep to the next sweep in `r`.
+		 * @param columns
+		 *     Number of columns in the matrix.
+		 * @param d
+		 *     Index of the wave.
+		 * @param[out] p
+		 *     Where the rotation of each sweep is to be stored.
+		 */
+		static inline void waveRotations(const float* r,
+										 ptrdiff_t stride,
+										 int columns,
+										 int d,
+										 const float* p[SWEEPS])
+		{
+			static const float IDENTITY[2] = { 1, 0 };
+			if (d >= SWEEPS - 1 && d + 2 <= columns) {
+				const float* q = r + 2 * d;
+				for (int s = 0; s < SWEEPS; ++s, q += stride - 2) {
+					p[s] = q;
+				}
+				return;
+			}
+			for (int s = 0; s < SWEEPS; ++s) {
+				const int i = d - s;
+				p[s] = (i >= 0 && i + 2 <= columns)
+					? r + s * stride + 2 * i
+					: IDENTITY;
+			}
+		}
+
+		/**
+		 * Portable `SweepsFunction`.
+		 *
+		 * Before the wave `d`, `w[j]` holds the column
+		 * `d - SWEEPS + 1 + j`.
+		 * The wave carries the next column down the window and leaves the
+		 * column `d - SWEEPS + 1`, which every sweep has passed.
+		 */
+		static void rotateSweepsScalar(float* a,
+									   size_t rows,
+									   ptrdiff_t ld,
+									   int columns,
+									   const float* r,
+									   ptrdiff_t stride)
+		{
+			const int lastWave = columns + SWEEPS - 3;
+			for (size_t k = 0; k < rows; ++k) {
+				float* x = a + k;
+				float w[SWEEPS] = {};
+				w[SWEEPS - 1] = x[0];
+				for (int d = 0; d <= lastWave; ++d) {
+					const float* p[SWEEPS];
+					waveRotations(r, stride, columns, d, p);
+					float y = (d + 1 < columns) ? x[(d + 1) * ld] : float(0);
+					for (int s = 0; s < SWEEPS; ++s) {
+						float& ws = w[SWEEPS - 1 - s];
+						const float xs = ws;
+						ws = p[s][0] * y - p[s][1] * xs;
+						y = p[s][0] * xs + p[s][1] * y;
+					}
+					if (d >= SWEEPS - 1) {
+						x[(d - SWEEPS + 1) * ld] = y;
+					}
+				}
+				x[(columns - 1) * ld] = w[0];
+			}
+		}
+#if SINGULAR_SIMD_SUPPORTED
+		/**
+		 * Loads two pairs into a register.
+		 *
+		 * @param p
+		 *     First pair; goes to the lower half.
+		 * @param q
+		 *     Second pair; goes to the upper half.
+		 * @return
+		 *     `(p[0], p[1], q[0], q[1])`.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static inline __m128 loadPairs(const float* p, const float* q) {
+			return _mm_loadh_pi(
+				_mm_loadl_pi(_mm_setzero_ps(),
+							 reinterpret_cast< const __m64* >(p)),
+				reinterpret_cast< const __m64* >(q));
+		}
+
+		/**
+		 * Stores a register loaded by `loadPairs` back into two pairs.
+		 *
+		 * @param[out] p
+		 *     Where the lower half is to be stored.
+		 * @param[out] q
+		 *     Where the upper half is to be stored.
+		 * @param v
+		 *     Register to be stored.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static inline void storePairs(float* p, float* q, __m128 v) {
+			_mm_storel_pi(reinterpret_cast< __m64* >(p), v);
+			_mm_storeh_pi(reinterpret_cast< __m64* >(q), v);
+		}
+
+		/** `RowsFunction` with SSE2. */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void rotateRowsSse2(
+			float* x, float* y, size_t n, float c, float s)
+		{
+			const __m128 vc = _mm_set1_ps(c);
+			const __m128 vs = _mm_set1_ps(s);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				__m128 vx = _mm_loadu_ps(x + i);
+				__m128 vy = _mm_loadu_ps(y + i);
+				_mm_storeu_ps(x + i, _mm_add_ps(
+					_mm_mul_ps(vc, vx), _mm_mul_ps(vs, vy)));
+				_mm_storeu_ps(y + i, _mm_sub_ps(
+					_mm_mul_ps(vc, vy), _mm_mul_ps(vs, vx)));
+			}
+			rotateRowsScalar(x + i, y + i, n - i, c, s);
+		}
+
+		/**
+		 * `PairsFunction` with SSE2.
+		 *
+		 * Two pairs from consecutive rows share a register; swapped pairs
+		 * are multiplied by \f$(s, -s, s, -s)\f$.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void rotatePairsSse2(
+			float* p, size_t n, ptrdiff_t stride, float c, float s)
+		{
+			const __m128 vc = _mm_set1_ps(c);
+			const __m128 vs = _mm_set_ps(-s, s, -s, s);
+			size_t i = 0;
+			for (; i + 2 <= n; i += 2, p += 2 * stride) {
+				float* q = p + stride;
+				__m128 v = loadPairs(p, q);
+				__m128 w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+				__m128 r = _mm_add_ps(_mm_mul_ps(vc, v), _mm_mul_ps(vs, w));
+				storePairs(p, q, r);
+			}
+			rotatePairsScalar(p, n - i, stride, c, s);
+		}
+
+		/**
+		 * Rotates a column in the window of `rotateSweepsSse2` and the
+		 * column carried through the wave.
+		 *
+		 * @param[in,out] w
+		 *     Column in the window.
+		 * @param[in,out] y
+		 *     Carried column.
+		 * @param p
+		 *     Cosine and sine of the rotation.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static inline void rotateWindowSse2(__m128& w,
+											__m128& y,
+											const float* p)
+		{
+			const __m128 vc = _mm_set1_ps(p[0]);
+			const __m128 vs = _mm_set1_ps(p[1]);
+			const __m128 x = w;
+			w = _mm_sub_ps(_mm_mul_ps(vc, y), _mm_mul_ps(vs, x));
+			y = _mm_add_ps(_mm_mul_ps(vc, x), _mm_mul_ps(vs, y));
+		}
+
+		/**
+		 * `SweepsFunction` with SSE2.
+		 *
+		 * The window of a strip of 4 rows is held in `w0`, ..., `w7`
+		 * like `w` of `rotateSweepsScalar`.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void rotateSweepsSse2(float* a,
+									 size_t rows,
+									 ptrdiff_t ld,
+									 int columns,
+									 const float* r,
+									 ptrdiff_t stride)
+		{
+			const int lastWave = columns + SWEEPS - 3;
+			size_t k = 0;
+			for (; k + 4 <= rows; k += 4) {
+				float* x = a + k;
+				__m128 w0 = _mm_setzero_ps();
+				__m128 w1 = w0;
+				__m128 w2 = w0;
+				__m128 w3 = w0;
+				__m128 w4 = w0;
+				__m128 w5 = w0;
+				__m128 w6 = w0;
+				__m128 w7 = _mm_loadu_ps(x);
+				for (int d = 0; d <= lastWave; ++d) {
+					const float* p[SWEEPS];
+					waveRotations(r, stride, columns, d, p);
+					__m128 y = (d + 1 < columns)
+						? _mm_loadu_ps(x + (d + 1) * ld)
+						: _mm_setzero_ps();
+					if (d + PREFETCH_WAVES < columns) {
+						_mm_prefetch(reinterpret_cast< const char* >(
+							x + (d + PREFETCH_WAVES) * ld), _MM_HINT_T0);
+					}
+					rotateWindowSse2(w7, y, p[0]);
+					rotateWindowSse2(w6, y, p[1]);
+					rotateWindowSse2(w5, y, p[2]);
+					rotateWindowSse2(w4, y, p[3]);
+					rotateWindowSse2(w3, y, p[4]);
+					rotateWindowSse2(w2, y, p[5]);
+					rotateWindowSse2(w1, y, p[6]);
+					rotateWindowSse2(w0, y, p[7]);
+					if (d >= SWEEPS - 1) {
+						_mm_storeu_ps(x + (d - SWEEPS + 1) * ld, y);
+					}
+				}
+				_mm_storeu_ps(x + (columns - 1) * ld, w0);
+			}
+			rotateSweepsScalar(a + k, rows - k, ld, columns, r, stride);
+		}
+
+		/** `RowsFunction` with AVX2 and FMA. */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void rotateRowsAvx2(
+			float* x, float* y, size_t n, float c, float s)
+		{
+			const __m256 vc = _mm256_set1_ps(c);
+			const __m256 vs = _mm256_set1_ps(s);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m256 vx = _mm256_loadu_ps(x + i);
+				__m256 vy = _mm256_loadu_ps(y + i);
+				_mm256_storeu_ps(x + i,
+					_mm256_fmadd_ps(vc, vx, _mm256_mul_ps(vs, vy)));
+				_mm256_storeu_ps(y + i,
+					_mm256_fmsub_ps(vc, vy, _mm256_mul_ps(vs, vx)));
+			}
+			rotateRowsScalar(x + i, y + i, n - i, c, s);
+		}
+
+		/**
+		 * `PairsFunction` with AVX2 and FMA.
+		 *
+		 * Four pairs from consecutive rows share a register.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void rotatePairsAvx2(
+			float* p, size_t n, ptrdiff_t stride, float c, float s)
+		{
+			const __m256 vc = _mm256_set1_ps(c);
+			const __m256 vs = _mm256_set_ps(-s, s, -s, s, -s, s, -s, s);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4, p += 4 * stride) {
+				float* q0 = p + stride;
+				float* q1 = q0 + stride;
+				float* q2 = q1 + stride;
+				__m256 v = _mm256_insertf128_ps(
+					_mm256_castps128_ps256(loadPairs(p, q0)),
+					loadPairs(q1, q2),
+					1);
+				__m256 w = _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1));
+				__m256 r = _mm256_fmadd_ps(vc, v, _mm256_mul_ps(vs, w));
+				storePairs(p, q0, _mm256_castps256_ps128(r));
+				storePairs(q1, q2, _mm256_extractf128_ps(r, 1));
+			}
+			rotatePairsScalar(p, n - i, stride, c, s);
+		}
+
+		/**
+		 * Rotates a column in the window of `rotateSweepsAvx2` and the
+		 * column carried through the wave.
+		 *
+		 * @param[in,out] w
+		 *     Column in the window.
+		 * @param[in,out] y
+		 *     Carried column.
+		 * @param p
+		 *     Cosine and sine of the rotation.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static inline void rotateWindowAvx2(__m256& w,
+											__m256& y,
+											const float* p)
+		{
+			const __m256 vc = _mm256_set1_ps(p[0]);
+			const __m256 vs = _mm256_set1_ps(p[1]);
+			const __m256 x = w;
+			w = _mm256_fmsub_ps(vc, y, _mm256_mul_ps(vs, x));
+			y = _mm256_fmadd_ps(vc, x, _mm256_mul_ps(vs, y));
+		}
+
+		/**
+		 * `SweepsFunction` with AVX2 and FMA.
+		 *
+		 * The window of a strip of 8 rows is held in `w0`, ..., `w7`
+		 * like `w` of `rotateSweepsScalar`.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void rotateSweepsAvx2(float* a,
+									 size_t rows,
+									 ptrdiff_t ld,
+									 int columns,
+									 const float* r,
+									 ptrdiff_t stride)
+		{
+			const int lastWave = columns + SWEEPS - 3;
+			size_t k = 0;
+			for (; k + 8 <= rows; k += 8) {
+				float* x = a + k;
+				__m256 w0 = _mm256_setzero_ps();
+				__m256 w1 = w0;
+				__m256 w2 = w0;
+				__m256 w3 = w0;
+				__m256 w4 = w0;
+				__m256 w5 = w0;
+				__m256 w6 = w0;
+				__m256 w7 = _mm256_loadu_ps(x);
+				for (int d = 0; d <= lastWave; ++d) {
+					const float* p[SWEEPS];
+					waveRotations(r, stride, columns, d, p);
+					__m256 y = (d + 1 < columns)
+						? _mm256_loadu_ps(x + (d + 1) * ld)
+						: _mm256_setzero_ps();
+					if (d + PREFETCH_WAVES < columns) {
+						_mm_prefetch(reinterpret_cast< const char* >(
+							x + (d + PREFETCH_WAVES) * ld), _MM_HINT_T0);
+					}
+					rotateWindowAvx2(w7, y, p[0]);
+					rotateWindowAvx2(w6, y, p[1]);
+					rotateWindowAvx2(w5, y, p[2]);
+					rotateWindowAvx2(w4, y, p[3]);
+					rotateWindowAvx2(w3, y, p[4]);
+					rotateWindowAvx2(w2, y, p[5]);
+					rotateWindowAvx2(w1, y, p[6]);
+					rotateWindowAvx2(w0, y, p[7]);
+					if (d >= SWEEPS - 1) {
+						_mm256_storeu_ps(x + (d - SWEEPS + 1) * ld, y);
+					}
+				}
+				_mm256_storeu_ps(x + (columns - 1) * ld, w0);
+			}
+			rotateSweepsScalar(a + k, rows - k, ld, columns, r, stride);
+		}
+#if SINGULAR_AVX512_SUPPORTED
+		/**
+		 * `RowsFunction` with AVX-512F.
+		 *
+		 * Pairs are rotated by `rotatePairsAvx2` even on AVX-512 CPUs.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void rotateRowsAvx512(
+			float* x, float* y, size_t n, float c, float s)
+		{
+			const __m512 vc = _mm512_set1_ps(c);
+			const __m512 vs = _mm512_set1_ps(s);
+			size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				__m512 vx = _mm512_loadu_ps(x + i);
+				__m512 vy = _mm512_loadu_ps(y + i);
+				_mm512_storeu_ps(x + i,
+					_mm512_fmadd_ps(vc, vx, _mm512_mul_ps(vs, vy)));
+				_mm512_storeu_ps(y + i,
+					_mm512_fmsub_ps(vc, vy, _mm512_mul_ps(vs, vx)));
+			}
+			rotateRowsScalar(x + i, y + i, n - i, c, s);
+		}
+
+		/**
+		 * Rotates a column in the windows of two strips in
+		 * `rotateSweepsAvx512` and the columns carried through the wave.
+		 *
+		 * @param[in,out] w1
+		 *     Column in the window of the first strip.
+		 * @param[in,out] w2
+		 *     Column in the window of the second strip.
+		 * @param[in,out] y1
+		 *     Carried column of the first strip.
+		 * @param[in,out] y2
+		 *     Carried column of the second strip.
+		 * @param p
+		 *     Cosine and sine of the rotation.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static inline void rotateWindowAvx512(__m512& w1,
+											  __m512& w2,
+											  __m512& y1,
+											  __m512& y2,
+											  const float* p)
+		{
+			const __m512 vc = _mm512_set1_ps(p[0]);
+			const __m512 vs = _mm512_set1_ps(p[1]);
+			const __m512 x1 = w1;
+			const __m512 x2 = w2;
+			w1 = _mm512_fmsub_ps(vc, y1, _mm512_mul_ps(vs, x1));
+			w2 = _mm512_fmsub_ps(vc, y2, _mm512_mul_ps(vs, x2));
+			y1 = _mm512_fmadd_ps(vc, x1, _mm512_mul_ps(vs, y1));
+			y2 = _mm512_fmadd_ps(vc, x2, _mm512_mul_ps(vs, y2));
+		}
+
+		/**
+		 * `SweepsFunction` with AVX-512F.
+		 *
+		 * Two strips of 16 rows share every rotation; their windows are
+		 * held in `u0`, ..., `u7` and `v0`, ..., `v7`.
+		 * The rows left over are rotated by `rotateSweepsAvx2`.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void rotateSweepsAvx512(float* a,
+									   size_t rows,
+									   ptrdiff_t ld,
+									   int columns,
+									   const float* r,
+									   ptrdiff_t stride)
+		{
+			const int lastWave = columns + SWEEPS - 3;
+			size_t k = 0;
+			for (; k + 32 <= rows; k += 32) {
+				float* x = a + k;
+				__m512 u0 = _mm512_setzero_ps();
+				__m512 u1 = u0;
+				__m512 u2 = u0;
+				__m512 u3 = u0;
+				__m512 u4 = u0;
+				__m512 u5 = u0;
+				__m512 u6 = u0;
+				__m512 u7 = _mm512_loadu_ps(x);
+				__m512 v0 = u0;
+				__m512 v1 = u0;
+				__m512 v2 = u0;
+				__m512 v3 = u0;
+				__m512 v4 = u0;
+				__m512 v5 = u0;
+				__m512 v6 = u0;
+				__m512 v7 = _mm512_loadu_ps(x + 16);
+				for (int d = 0; d <= lastWave; ++d) {
+					const float* p[SWEEPS];
+					waveRotations(r, stride, columns, d, p);
+					__m512 y1 = _mm512_setzero_ps();
+					__m512 y2 = y1;
+					if (d + 1 < columns) {
+						y1 = _mm512_loadu_ps(x + (d + 1) * ld);
+						y2 = _mm512_loadu_ps(x + (d + 1) * ld + 16);
+					}
+					if (d + PREFETCH_WAVES < columns) {
+						_mm_prefetch(reinterpret_cast< const char* >(
+							x + (d + PREFETCH_WAVES) * ld), _MM_HINT_T0);
+						_mm_prefetch(reinterpret_cast< const char* >(
+							x + (d + PREFETCH_WAVES) * ld + 16), _MM_HINT_T0);
+					}
+					rotateWindowAvx512(u7, v7, y1, y2, p[0]);
+					rotateWindowAvx512(u6, v6, y1, y2, p[1]);
+					rotateWindowAvx512(u5, v5, y1, y2, p[2]);
+					rotateWindowAvx512(u4, v4, y1, y2, p[3]);
+					rotateWindowAvx512(u3, v3, y1, y2, p[4]);
+					rotateWindowAvx512(u2, v2, y1, y2, p[5]);
+					rotateWindowAvx512(u1, v1, y1, y2, p[6]);
+					rotateWindowAvx512(u0, v0, y1, y2, p[7]);
+					if (d >= SWEEPS - 1) {
+						_mm512_storeu_ps(x + (d - SWEEPS + 1) * ld, y1);
+						_mm512_storeu_ps(x + (d - SWEEPS + 1) * ld + 16, y2);
+					}
+				}
+				_mm512_storeu_ps(x + (columns - 1) * ld, u0);
+				_mm512_storeu_ps(x + (columns - 1) * ld + 16, v0);
+			}
+			rotateSweepsAvx2(a + k, rows - k, ld, columns, r, stride);
+		}
+#endif
+#endif
+	};
+
+	/** Kernels that apply a plane rotation to pairs of `double` elements. */
+	typedef BasicRotationKernel< double > RotationKernel;
+
+}
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef _SINGULAR_ROTATION_SEQUENCE_H
+#define _SINGULAR_ROTATION_SEQUENCE_H
+
+#include "singular/MatrixView.h"
+#include "singular/RotationKernel.h"
+#include "singular/Rotator.h"
+#include "singular/singular.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace singular {
+
+	/**
+	 * Sequence of rotations recorded from sweeps over adjacent columns.
+	 *
+	 * Every sweep rotates the columns `i` and `i + 1` for
+	 * `i = lo, ..., hi - 2` in this order, and sweeps are applied in the
+	 * order they are added.
+	 * The range `[lo, hi)` is given by the first sweep; a later sweep
+	 * may cover only part of it, and the rest of the sweep is filled with
+	 * the identity.
+	 * The cosine and sine of the rotation `i` of the sweep `s` are stored
+	 * at `2 * (s * n + i)` and `2 * (s * n + i) + 1` of a given memory
+	 * block.
+	 * So sequences that share a memory block never overlap as long as
+	 * they rotate different columns.
+	 *
+	 * `applyFromRight` applies the sweeps in a wavefront order that
+	 * Van Zee, van de Geijn and Quintana-Ortí describe in "Restructuring
+	 * the Tridiagonal and Bidiagonal QR Algorithms for Performance".
+	 * A full sequence is applied to a column-major matrix by
+	 * `RotationKernel::rotateSweeps`, which loads and stores every element
+	 * once instead of once per sweep.
+	 *
+	 * Does not own the memory block.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	class BasicRotationSequence {
+	public:
+		enum {
+			/** Maximum number of sweeps in a sequence. */
+			MAX_SWEEPS = BasicRotationKernel< T >::SWEEPS,
+
+			/**
+			 * Number of rows of a block that every sweep passes before the
+			 * next block, if rotations are applied one by one.
+			 *
+			 * Columns of a block that a wave touches fit in L1 cache.
+			 */
+			ROWS_PER_BLOCK = 256
+		};
+	private:
+		/** Memory block where rotations are stored. */
+		T* pBlock;
+
+		/** Number of columns in matrices to be rotated. */
+		int n;
+
+		/** Number of sweeps in this sequence. */
+		int numSweeps;
+
+		/** Index of the first column that sweeps rotate. */
+		int lo;
+
+		/** Index next to the last column that sweeps rotate. */
+		int hi;
+	public:
+		/**
+		 * Returns the number of elements in a memory block for a given
+		 * number of columns.
+		 *
+		 * @param n
+		 *     Number of columns in matrices to be rotated.
+		 * @return
+		 *     Number of elements in the memory block.
+		 */
+		static inline int blockSize(int n) {
+			return 2 * MAX_SWEEPS * n;
+		}
+
+		/**
+		 * Starts an empty sequence on a given memory block.
+		 *
+		 * @param pBlock
+		 *     Memory block where rotations are to be stored.
+		 *     Must have at least `blockSize(n)` elements.
+		 * @param n
+		 *     Number of columns in matrices to be rotated.
+		 */
+		BasicRotationSequence(T* pBlock, int n)
+			: pBlock(pBlock), n(n), numSweeps(0), lo(0), hi(0) {}
+
+		/**
+		 * Returns the number of sweeps in this sequence.
+		 *
+		 * @return
+		 *     Number of sweeps.
+		 */
+		inline int size() const {
+			return this->numSweeps;
+		}
+
+		/**
+		 * Returns whether no more sweep can be added.
+		 *
+		 * @return
+		 *     Whether this sequence has `MAX_SWEEPS` sweeps.
+		 */
+		inline bool isFull() const {
+			return this->numSweeps == MAX_SWEEPS;
+		}
+
+		/**
+		 * Returns whether a sweep over a given range of columns can be
+		 * added.
+		 *
+		 * @param lo
+		 *     Index of the first column to be rotated.
+		 * @param hi
+		 *     Index next to the last column to be rotated.
+		 * @return
+		 *     Whether this sequence is not full and is empty or its range
+		 *     contains `[lo, hi)`.
+		 */
+		inline bool accepts(int lo, int hi) const {
+			return this->numSweeps == 0 ||
+				(!this->isFull() && this->lo <= lo && hi <= this->hi);
+		}
+
+		/**
+		 * Adds a sweep that rotates a given range of columns.
+		 *
+		 * Rotations of the sweep are to be given by `record`.
+		 * The behavior is undefined if `!accepts(lo, hi)`.
+		 *
+		 * @param lo
+		 *     Index of the first column to be rotated.
+		 * @param hi
+		 *     Index next to the last column to be rotated.
+		 */
+		void addSweep(int lo, int hi) {
+			assert(this->accepts(lo, hi));
+			assert(0 <= lo && lo < hi && hi <= this->n);
+			if (this->numSweeps == 0) {
+				this->lo = lo;
+				this->hi = hi;
+			}
+			T* p = this->sweep(this->numSweeps);
+			for (int i = this->lo; i < lo; ++i) {
+				p[2 * i] = 1;
+				p[2 * i + 1] = 0;
+			}
+			for (int i = hi - 1; i + 1 < this->hi; ++i) {
+				p[2 * i] = 1;
+				p[2 * i + 1] = 0;
+			}
+			++this->numSweeps;
+		}
+
+		/**
+		 * Records a rotator of the last sweep.
+		 *
+		 * @param r
+		 *     Rotator applied to the columns `i` and `i + 1` from right.
+		 * @param i
+		 *     Index of the first column rotated by `r`.
+		 */
+		inline void record(const BasicRotator< T >& r, int i) {
+			assert(this->numSweeps > 0);
+			T* p = this->sweep(this->numSweeps - 1) + 2 * i;
+			p[0] = r(0, 0);
+			p[1] = r(1, 0);
+		}
+
+		/**
+		 * Removes every sweep.
+		 */
+		inline void clear() {
+			this->numSweeps = 0;
+		}
+
+		/**
+		 * Applies every sweep to a given matrix from right in place.
+		 *
+		 * Works as if `Rotator::applyFromRightInPlace` were applied for
+		 * every rotation in the recorded order.
+		 * A full sequence is applied to a column-major matrix by
+		 * `RotationKernel::rotateSweeps`.
+		 * Otherwise rotations are applied one by one in the wavefront
+		 * order, to blocks of `ROWS_PER_BLOCK` rows.
+		 *
+		 * @param[in,out] m
+		 *     Matrix to be rotated.
+		 *     Must have `n` columns.
+		 */
+		void applyFromRight(BasicMatrixView< T > m) const {
+			if (this->numSweeps == 0 || m.rows() == 0) {
+				return;
+			}
+			if (this->isFull() && m.column(this->lo).stride() == 1) {
+				BasicRotationKernel< T >::best().rotateSweeps(
+					&m(0, this->lo),
+					m.rows(),
+					m.leadingDimension(),
+					this->hi - this->lo,
+					this->sweep(0) + 2 * this->lo,
+					2 * this->n);
+				return;
+			}
+			for (int top = 0; top < m.rows(); top += ROWS_PER_BLOCK) {
+				const int rows = std::min(m.rows() - top,
+										  static_cast< int >(ROWS_PER_BLOCK));
+				this->applyToBlock(BasicMatrixView< T >(&m(top, 0),
+														rows,
+														m.columns(),
+														m.leadingDimension(),
+														m.layout()));
+			}
+		}
+	private:
+		/**
+		 * Returns the rotations of a given sweep.
+		 *
+		 * @param s
+		 *     Index of the sweep.
+		 * @return
+		 *     Rotations of the sweep, indexed by columns.
+		 */
+		inline T* sweep(int s) const {
+			return this->pBlock + 2 * s * this->n;
+		}
+
+		/**
+		 * Applies every sweep to a given block of rows in the wavefront
+		 * order, one rotation at a time.
+		 *
+		 * The rotation `i` of the sweep `s` only has to follow the
+		 * rotations `i - 1` of the sweep `s` and `i + 1` of the sweep
+		 * `s - 1`, so the wave `i + s` is applied after the wave
+		 * `i + s - 1`.
+		 *
+		 * @param[in,out] m
+		 *     Block of rows to be rotated.
+		 */
+		void applyToBlock(BasicMatrixView< T > m) const {
+			const int lastWave = this->hi - 2 + this->numSweeps - 1;
+			for (int wave = this->lo; wave <= lastWave; ++wave) {
+				for (int s = 0; s < this->numSweeps; ++s) {
+					const int i = wave - s;
+					if (i < this->lo || i + 1 >= this->hi) {
+						continue;
+					}
+					const T* p = this->sweep(s) + 2 * i;
+					rotateColumns(m, i, p[0], p[1]);
+				}
+			}
+		}
+
+		/**
+		 * Rotates the columns `i` and `i + 1` of a given matrix like
+		 * `Rotator::applyFromRightInPlace`.
+		 *
+		 * @param[in,out] m
+		 *     Matrix whose columns are to be rotated.
+		 * @param i
+		 *     Index of the first column.
+		 * @param cs
+		 *     Cosine of the rotation.
+		 * @param sn
+		 *     Sine of the rotation.
+		 */
+		static void rotateColumns(BasicMatrixView< T > m, int i, T cs, T sn) {
+			Vector< T > c1 = m.column(i);
+			Vector< T > c2 = m.column(i + 1);
+			if (c1.stride() == 1) {
+				// columns are contiguous in a column-major matrix
+				BasicRotationKernel< T >::best().rotateRows(
+					c1.data(), c2.data(), c1.size(), cs, sn);
+			} else {
+				// columns are interleaved in a row-major matrix
+				BasicRotationKernel< T >::best().rotatePairs(
+					c1.data(), c1.size(), c1.stride(), cs, sn);
+			}
+		}
+	};
+
+	/** Sequence of rotations of `double` elements. */
+	typedef BasicRotationSequence< double > RotationSequence;
+
+}
+
+#endif
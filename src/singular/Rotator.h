@@ -2,6 +2,7 @@
 #define _SINGULAR_ROTATOR_H
 
 #include "singular/Matrix.h"
+#include "singular/RotationKernel.h"
 #include "singular/singular.h"
 
 #include <algorithm>
@@ -13,15 +14,19 @@ namespace singular {
 
 	/**
 	 * Rotator.
+	 *
+	 * @tparam T
+	 *     Type of elements.
 	 */
-	class Rotator {
+	template < typename T >
+	class BasicRotator {
 	private:
 		/**
 		 * 2x2 transformation matrix.
 		 * The element at the ith row and jth column is given by
 		 * `element[i * 2 + j]`.
 		 */
-		double elements[4];
+		T elements[4];
 	public:
 		/**
 		 * Builds a rotator from a given two-element vector.
@@ -45,15 +50,15 @@ namespace singular {
 		 * @param x2
 		 *     Second element in the vector.
 		 */
-		Rotator(double x1, double x2) {
+		BasicRotator(T x1, T x2) {
 			// normalizes by the maximum magnitude
 			// to avoid harmful underflow and overflow
-			double mx = std::max(std::abs(x1), std::abs(x2));
+			T mx = std::max(std::abs(x1), std::abs(x2));
 			x1 /= mx;
 			x2 /= mx;
-			double norm = sqrt(x1 * x1 + x2 * x2);
-			double cs = x1 / norm;
-			double sn = x2 / norm;
+			T norm = std::sqrt(x1 * x1 + x2 * x2);
+			T cs = x1 / norm;
+			T sn = x2 / norm;
 			this->elements[0] = cs;
 			this->elements[1] = -sn;
 			this->elements[2] = sn;
@@ -74,7 +79,7 @@ namespace singular {
 		 * @return
 		 *     Element at the given row and column.
 		 */
-		inline double operator ()(int i, int j) const {
+		inline T operator ()(int i, int j) const {
 			assert(0 <= i && i < 2);
 			assert(0 <= j && j < 2);
 			return this->elements[i * 2 + j];
@@ -115,18 +120,69 @@ namespace singular {
 		 *     Result of this rotation.
 		 */
 		template < int M, int N >
-		Matrix< M, N > applyFromLeftTo(const Matrix< M, N >& rhs, int k) {
-			assert(M >= k + 2);
+		Matrix< M, N > applyFromLeftTo(const Matrix< M, N >& rhs, int k) const
+		{
 			Matrix< M, N > m = rhs.clone();
-			for (int i = 0; i < N; ++i) {
-				double x1 = rhs(k, i);
-				double x2 = rhs(k + 1, i);
-				m(k, i) = this->elements[0] * x1 + this->elements[2] * x2;
-				m(k + 1, i) = this->elements[1] * x1 + this->elements[3] * x2;
-			}
+			this->applyFromLeftInPlace(m, k);
 			return m;
 		}
 
+		/**
+		 * Applies this rotator from the left hand side of a given matrix
+		 * in place.
+		 *
+		 * Works like `applyFromLeftTo` but overwrites the given matrix
+		 * instead of making a new matrix.
+		 * Only the rows `k` and `k + 1` are touched.
+		 * Contiguous rows, and rows interleaved in a column-major matrix are
+		 * rotated by `BasicRotationKernel` for the CPU.
+		 *
+		 * The behavior is undefined if `m.rows() < k + 2`.
+		 *
+		 * @tparam MatrixLike
+		 *     Type of the given matrix.
+		 *     `Matrix` or `MatrixView`.
+		 * @param[in,out] m
+		 *     Matrix to be rotated.
+		 * @param k
+		 *     Top-left row and column index where this rotator is applied.
+		 */
+		template < typename MatrixLike >
+		void applyFromLeftInPlace(MatrixLike& m, int k) const {
+			assert(m.rows() >= k + 2);
+			Vector< T > row1 = m.row(k);
+			Vector< T > row2 = m.row(k + 1);
+			if (row1.stride() == 1 && row2.stride() == 1) {
+				BasicRotationKernel< T >::best().rotateRows(
+					row1.data(),
+					row2.data(),
+					row1.size(),
+					this->elements[0],
+					this->elements[2]);
+				return;
+			}
+			if (row2.data() == row1.data() + 1 &&
+				row1.stride() == row2.stride())
+			{
+				// rows are interleaved in a column-major matrix
+				BasicRotationKernel< T >::best().rotatePairs(
+					row1.data(),
+					row1.size(),
+					row1.stride(),
+					this->elements[0],
+					this->elements[2]);
+				return;
+			}
+			typename Vector< T >::iterator p1 = row1.begin();
+			typename Vector< T >::iterator p2 = row2.begin();
+			for (; p1 != row1.end(); ++p1, ++p2) {
+				T x1 = *p1;
+				T x2 = *p2;
+				*p1 = this->elements[0] * x1 + this->elements[2] * x2;
+				*p2 = this->elements[1] * x1 + this->elements[3] * x2;
+			}
+		}
+
 		/**
 		 * Applies this rotator from the right hand side of a given matrix.
 		 *
@@ -162,19 +218,74 @@ namespace singular {
 		 *     Result of this rotation.
 		 */
 		template < int M, int N >
-		Matrix< M, N > applyFromRightTo(const Matrix< M, N >& lhs, int k) {
-			assert(N >= k + 2);
+		Matrix< M, N > applyFromRightTo(const Matrix< M, N >& lhs, int k) const
+		{
 			Matrix< M, N > m = lhs.clone();
-			for (int i = 0; i < M; ++i) {
-				double x1 = lhs(i, k);
-				double x2 = lhs(i, k + 1);
-				m(i, k) = x1 * this->elements[0] + x2 * this->elements[2];
-				m(i, k + 1) = x1 * this->elements[1] + x2 * this->elements[3];
-			}
+			this->applyFromRightInPlace(m, k);
 			return m;
 		}
+
+		/**
+		 * Applies this rotator from the right hand side of a given matrix
+		 * in place.
+		 *
+		 * Works like `applyFromRightTo` but overwrites the given matrix
+		 * instead of making a new matrix.
+		 * Only the columns `k` and `k + 1` are touched.
+		 * Contiguous columns, and columns interleaved in a row-major matrix
+		 * are rotated by `BasicRotationKernel` for the CPU.
+		 *
+		 * The behavior is undefined if `m.columns() < k + 2`.
+		 *
+		 * @tparam MatrixLike
+		 *     Type of the given matrix.
+		 *     `Matrix` or `MatrixView`.
+		 * @param[in,out] m
+		 *     Matrix to be rotated.
+		 * @param k
+		 *     Top-left row and column index where this rotator is applied.
+		 */
+		template < typename MatrixLike >
+		void applyFromRightInPlace(MatrixLike& m, int k) const {
+			assert(m.columns() >= k + 2);
+			Vector< T > column1 = m.column(k);
+			Vector< T > column2 = m.column(k + 1);
+			if (column1.stride() == 1 && column2.stride() == 1) {
+				// columns are contiguous in a column-major matrix
+				BasicRotationKernel< T >::best().rotateRows(
+					column1.data(),
+					column2.data(),
+					column1.size(),
+					this->elements[0],
+					this->elements[2]);
+				return;
+			}
+			if (column2.data() == column1.data() + 1 &&
+				column1.stride() == column2.stride())
+			{
+				// columns are interleaved in a row-major matrix
+				BasicRotationKernel< T >::best().rotatePairs(
+					column1.data(),
+					column1.size(),
+					column1.stride(),
+					this->elements[0],
+					this->elements[2]);
+				return;
+			}
+			typename Vector< T >::iterator p1 = column1.begin();
+			typename Vector< T >::iterator p2 = column2.begin();
+			for (; p1 != column1.end(); ++p1, ++p2) {
+				T x1 = *p1;
+				T x2 = *p2;
+				*p1 = x1 * this->elements[0] + x2 * this->elements[2];
+				*p2 = x1 * this->elements[1] + x2 * this->elements[3];
+			}
+		}
 	};
 
+	/** Rotator of `double` elements. */
+	typedef BasicRotator< double > Rotator;
+
 }
 
 #endif
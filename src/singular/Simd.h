@@ -0,0 +1,123 @@
+#ifndef _SINGULAR_SIMD_H
+#define _SINGULAR_SIMD_H
+
+#include "singular/singular.h"
+
+#if SINGULAR_SIMD_SUPPORTED
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#endif
+
+/**
+ * Marks a function to be compiled for given instruction sets.
+ *
+ * Lets a function use intrinsics beyond the baseline of the compiler
+ * options.
+ * Such a function must not be called unless `Simd::level` says the CPU
+ * supports the instruction sets.
+ * Visual Studio needs no mark.
+ */
+#if SINGULAR_SIMD_SUPPORTED && !defined(_MSC_VER)
+#define SINGULAR_SIMD_TARGET(isa)	__attribute__((target(isa)))
+#else
+#define SINGULAR_SIMD_TARGET(isa)
+#endif
+
+/**
+ * Whether AVX-512 kernels are available.
+ *
+ * Visual Studio 2017 prior to 15.3 does not have AVX-512 intrinsics.
+ */
+#if SINGULAR_SIMD_SUPPORTED && (!defined(_MSC_VER) || _MSC_VER >= 1911)
+#define SINGULAR_AVX512_SUPPORTED	1
+#else
+#define SINGULAR_AVX512_SUPPORTED	0
+#endif
+
+namespace singular {
+
+	/**
+	 * Level of SIMD instruction sets.
+	 *
+	 * A level includes every level below it.
+	 */
+	enum SimdLevel {
+		/** No SIMD instructions; portable scalar code. */
+		SIMD_NONE,
+		/** SSE2; 2 doubles or 4 floats per instruction. */
+		SIMD_SSE2,
+		/** AVX2 and FMA; 4 doubles or 8 floats per instruction. */
+		SIMD_AVX2,
+		/** AVX-512F; 8 doubles or 16 floats per instruction. */
+		SIMD_AVX512
+	};
+
+	/** Detection of SIMD instruction sets. */
+	struct Simd {
+		/**
+		 * Returns the highest SIMD level supported by the CPU and OS.
+		 *
+		 * The CPU is queried only at the first call.
+		 *
+		 * @return
+		 *     Highest supported SIMD level.
+		 */
+		static SimdLevel level() {
+			static const SimdLevel detected = detectLevel();
+			return detected;
+		}
+
+		/**
+		 * Queries the highest SIMD level supported by the CPU and OS.
+		 *
+		 * Returns `SIMD_NONE` if `SINGULAR_SIMD_SUPPORTED` is 0.
+		 *
+		 * @return
+		 *     Highest supported SIMD level.
+		 */
+		static SimdLevel detectLevel() {
+#if !SINGULAR_SIMD_SUPPORTED
+			return SIMD_NONE;
+#elif defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			const int maxLeaf = info[0];
+			__cpuid(info, 1);
+			const bool fma = (info[2] & (1 << 12)) != 0;
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+			if (!osxsave || !avx || maxLeaf < 7) {
+				return SIMD_SSE2;
+			}
+			// the OS must save YMM (and ZMM) registers
+			const unsigned long long xcr0 = _xgetbv(0);
+			__cpuidex(info, 7, 0);
+			const bool avx2 = (info[1] & (1 << 5)) != 0;
+			const bool avx512f = (info[1] & (1 << 16)) != 0;
+			if (avx512f && (xcr0 & 0xE6) == 0xE6) {
+				return SIMD_AVX512;
+			}
+			if (avx2 && fma && (xcr0 & 0x6) == 0x6) {
+				return SIMD_AVX2;
+			}
+			return SIMD_SSE2;
+#else
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f")) {
+				return SIMD_AVX512;
+			}
+			if (__builtin_cpu_supports("avx2") &&
+				__builtin_cpu_supports("fma"))
+			{
+				return SIMD_AVX2;
+			}
+			return SIMD_SSE2;
+#endif
+		}
+	};
+
+}
+
+#endif
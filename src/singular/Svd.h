@@ -1,18 +1,27 @@
 #ifndef _SINGULAR_SVD_H
 #define _SINGULAR_SVD_H
 
+#include "singular/BatchSvd.h"
+#include "singular/BidiagonalMatrix.h"
 #include "singular/DiagonalMatrix.h"
 #include "singular/Matrix.h"
-#include "singular/Reflector.h"
-#include "singular/Rotator.h"
+#include "singular/MemoryBlock.h"
+#include "singular/SvdKernel.h"
 #include "singular/singular.h"
+#include "singular/Transpose.h"
 
 #include <algorithm>
 #include <cassert>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace singular {
 
+	// Defined later in this file
+	template < int M, int N, typename T = double >
+	class SvdWorkspace;
+
 	/**
 	 * Namespace for singular value decomposition.
 	 *
@@ -20,8 +29,11 @@ namespace singular {
 	 *     Number of rows in an input matrix.
 	 * @tparam N
 	 *     Number of columns in an input matrix.
+	 * @tparam T
+	 *     Type of elements in an input matrix.
+	 *     `double` by default.
 	 */
-	template < int M, int N >
+	template < int M, int N, typename T = double >
 	struct Svd {
 		/**
 		 * Tuple of left singular vectors, singular values and right singular
@@ -29,25 +41,75 @@ namespace singular {
 		 *
 		 * Use `getU`, `getS` and `getV` instead of `std::get` to access items.
 		 */
-		typedef std::tuple< Matrix< M, M >,
-							DiagonalMatrix< M, N >,
-							Matrix< N, N > > USV;
+		typedef std::tuple< Matrix< M, M, T >,
+							DiagonalMatrix< M, N, T >,
+							Matrix< N, N, T > > USV;
 
 		/** Returns the left-singular-vectors from a given `USV` tuple. */
-		static inline const Matrix< M, M >& getU(const USV& usv) {
+		static inline const Matrix< M, M, T >& getU(const USV& usv) {
 			return std::get< 0 >(usv);
 		}
 
 		/** Returns the singular values from a given `USV` tuple. */
-		static inline const DiagonalMatrix< M, N >& getS(const USV& usv) {
+		static inline const DiagonalMatrix< M, N, T >& getS(const USV& usv) {
 			return std::get< 1 >(usv);
 		}
 
 		/** Returns the right-singular-vectors from a given `USV` tuple. */
-		static inline const Matrix< N, N >& getV(const USV& usv) {
+		static inline const Matrix< N, N, T >& getV(const USV& usv) {
 			return std::get< 2 >(usv);
 		}
 
+		/**
+		 * Multiplies a given decomposition back into a matrix.
+		 *
+		 * Equivalent to `getU(usv) * getS(usv) * getV(usv).transpose()`
+		 * but multiplies only singular vectors that meet nonzero singular
+		 * values.
+		 * Zero some of singular values to reconstruct a low-rank
+		 * approximation.
+		 *
+		 * @param usv
+		 *     Decomposition to be multiplied.
+		 * @return
+		 *     \f$\mathbf{U} \mathbf{\Sigma} \mathbf{V}^T\f$.
+		 */
+		static inline Matrix< M, N, T > reconstruct(const USV& usv) {
+			return reconstruct(getU(usv), getS(usv), getV(usv));
+		}
+
+		/**
+		 * Multiplies given singular vectors and singular values into a
+		 * matrix.
+		 *
+		 * Works like `reconstruct(const USV&)`.
+		 * Singular vectors computed with `SVD_THIN` are enough.
+		 *
+		 * @param u
+		 *     Left-singular-vectors.
+		 * @param s
+		 *     Singular values.
+		 * @param v
+		 *     Right-singular-vectors.
+		 * @return
+		 *     \f$\mathbf{U} \mathbf{\Sigma} \mathbf{V}^T\f$.
+		 */
+		static Matrix< M, N, T > reconstruct(const Matrix< M, M, T >& u,
+											 const DiagonalMatrix< M, N, T >& s,
+											 const Matrix< N, N, T >& v)
+		{
+			// singular values followed by work memory of the kernel
+			MemoryBlock< (1 + M + N) * Q + GemmPackingSize< M, N, Q >::VALUE,
+						 T > block;
+			T* ss = block.data();
+			for (int i = 0; i < Q; ++i) {
+				ss[i] = s(i, i);
+			}
+			Matrix< M, N, T > a;
+			SvdKernel::reconstruct(u, ss, v, M, N, Q, &a(0, 0), N, ss + Q);
+			return a;
+		}
+
 		/**
 		 * Decomposes a given matrix into left singular vectors,
 		 * singular values and right singular vectors.
@@ -72,578 +134,508 @@ namespace singular {
 		 * @see getS
 		 * @see getV
 		 */
-		static USV decomposeUSV(const Matrix< M, N >& m) {
-			// makes sure that M >= N
-			// otherwise decomposes the transposed matrix
-			if (M < N) {
-				// A^T = V * S^T * U^T
-				typename Svd< N, M >::USV usvT =
-					Svd< N, M >::decomposeUSV(m.transpose());
-				return std::make_tuple(
-					std::move(std::get< 2 >(usvT)),
-					std::get< 1 >(usvT).transpose(),
-					std::move(std::get< 0 >(usvT)));
-			}
-			const int MAX_ITERATIONS = N * 10;
-			// allocates matrices
-			Matrix< M, M > u = Matrix< M, M >::identity();
-			// Matrix< M, N > s = m.clone();
-			Matrix< N, N > v = Matrix< N, N >::identity();
-			// bidiagonalizes a given matrix
-			BidiagonalMatrix m2 = bidiagonalize(u, m.clone(), v);
-			// repeats Francis iteration
-			int iteration = 0;
-			int n = N;
-			while (n >= 2) {
-				// processes the n-1 x n-1 submatrix
-				// if the current n x n submatrix has converged
-				double bn = m2(n - 1, n - 1);
-				if (bn == 0.0 || std::abs(m2(n - 2, n - 1) / bn) < 1.0e-15) {
-					--n;
-				} else {
-					// aborts if too many iterations
-					++iteration;
-					if (iteration > MAX_ITERATIONS) {
-						break;
-					}
-					doFrancis(u, m2, v, n);
-				}
-			}
-			// copies the diagonal elements
-			// and makes all singular values positive
-			double ss[N];
-			for (int i = 0; i < N; ++i) {
-				if (m2(i, i) < 0) {
-					ss[i] = -m2(i, i);
-					// inverts the sign of the right singular vector
-					Vector< double > vi = v.column(i);
-					std::transform(
-						vi.begin(), vi.end(), vi.begin(),
-						[](double x) {
-							return -x;
-						});
-				} else {
-					ss[i] = m2(i, i);
-				}
-			}
-			// sorts singular values in descending order if necessary
-			int shuffle[M];  // M >= N
-			bool sortNeeded = false;
-			for (int i = 0; i < M; ++i) {
-				shuffle[i] = i;
-				sortNeeded = sortNeeded || (i < N - 1 && ss[i] < ss[i + 1]);
-			}
-			if (sortNeeded) {
-				// shuffles the N (<= M) singular values
-				std::sort(shuffle, shuffle + N, [&ss](int i, int j) {
-					return ss[i] > ss[j];  // descending order
-				});
-				double ss2[M];
-				std::transform(shuffle, shuffle + N, ss2, [&ss](int i) {
-					return ss[i];
-				});
-				return std::make_tuple(u.shuffleColumns(shuffle),
-									   DiagonalMatrix< M, N >(ss2),
-									   v.shuffleColumns(shuffle));
-			} else {
-				return std::make_tuple(std::move(u),
-									   DiagonalMatrix< M, N >(ss),
-									   std::move(v));
-			}
+		static USV decomposeUSV(const Matrix< M, N, T >& m) {
+			SvdWorkspace< M, N, T > ws;
+			decomposeUSV(m, ws);
+			return std::make_tuple(std::move(ws.u),
+								   std::move(ws.s),
+								   std::move(ws.v));
 		}
-	private:
+
 		/**
-		 * M x N bidiagonal matrix.
+		 * Decomposes a given matrix into left singular vectors,
+		 * singular values and right singular vectors on a given workspace.
 		 *
-		 * If `M >= N`, a bidiagonal matrix looks like,
-		 * \f[
-		 * \mathbf{A} = \begin{bmatrix}
-		 *   \beta_1 & \gamma_1 &          &             &              \\
-		 *           & \beta_2  & \gamma_2 &             &              \\
-		 *           &          & \ddots   & \ddots      &              \\
-		 *           &          &          & \beta_{N-1} & \gamma_{N-1} \\
-		 *           &          &          &             & \beta_N
-		 * \end{bmatrix}
-		 * \f]
+		 * Works like `decomposeUSV(const Matrix< M, N, T >&)` but stores the
+		 * results in `ws` instead of allocating new matrices.
+		 * No memory is allocated during the decomposition, so a single
+		 * workspace can be reused to decompose many matrices.
+		 *
+		 * Singular vectors are computed as specified by `jobU` and `jobV`.
+		 *  - `SVD_FULL` computes all of singular vectors.
+		 *  - `SVD_THIN` computes only the first `min(M, N)` singular vectors.
+		 *    The other columns are filled with zeros.
+		 *  - `SVD_NONE` computes no singular vectors.
+		 *    Singular vectors in `ws` are left unchanged.
+		 *
+		 * Skipped singular vectors cost nothing during the decomposition.
+		 * Use `DynamicSvd` to save memory for skipped singular vectors as
+		 * well.
+		 *
+		 * Results of a previous decomposition on `ws` are overwritten.
 		 *
-		 * The behavior is undefined if `M < N`.
+		 * @param m
+		 *     `M` x `N` matrix to be decomposed.
+		 * @param[out] ws
+		 *     Workspace where the decomposition of `m` is to be stored.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 * @see SvdWorkspace::getU
+		 * @see SvdWorkspace::getS
+		 * @see SvdWorkspace::getV
 		 */
-		class BidiagonalMatrix {
-		private:
-			/**
-			 * Memory block for the diagonal elements.
-			 * The number of elements is `2 * N - 1`
-			 *
-			 * The ith diagonal element is given by `pBlock[i * 2]`.
-			 * The ith upper-diagonal element is given by `pBlock[i * 2 + 1]`.
-			 */
-			double* pBlock;
-		public:
-			/**
-			 * Initializes from bidiagonal elements of a given matrix.
-			 *
-			 * **Only bidiagonal elements are taken from `m` whether it is
-			 * bidiagonal or not.**
-			 *
-			 * The behavior is undefined if `M < N`.
-			 *
-			 * @param m
-			 *     Matrix from which bidiagonal elements are to be taken.
-			 */
-			BidiagonalMatrix(const Matrix< M, N >& m) {
-				assert(M >= N);
-				this->pBlock = new double[2 * N - 1];
-				for (int i = 0; i < N; ++i) {
-					this->pBlock[i * 2] = m(i, i);
-					if (i < N - 1) {
-						this->pBlock[i * 2 + 1] = m(i, i + 1);
-					}
-				}
-			}
+		static void decomposeUSV(const Matrix< M, N, T >& m,
+								 SvdWorkspace< M, N, T >& ws,
+								 SvdJob jobU = SVD_FULL,
+								 SvdJob jobV = SVD_FULL)
+		{
+			decomposeUSV(inputView(m), ws, jobU, jobV);
+		}
 
-			/**
-			 * Steals the memory block from a given bidiagonal matrix.
-			 *
-			 * @param[in,out] copyee
-			 *     Bidiagonal matrix from which the memory block is to be
-			 *     stolen.
-			 *     No longer valid after this call.
-			 */
-#if SINGULAR_RVALUE_REFERENCE_SUPPORTED
-			inline BidiagonalMatrix(BidiagonalMatrix&& copyee)
-				: pBlock(copyee.pBlock)
-			{
-				copyee.pBlock = nullptr;
-			}
-#else
-			inline BidiagonalMatrix(const BidiagonalMatrix& copyee)
-				: pBlock(copyee.pBlock)
-			{
-				const_cast< BidiagonalMatrix& >(copyee).pBlock = nullptr;
-			}
-#endif
+		/**
+		 * Decomposes a matrix in a given view on a given workspace.
+		 *
+		 * Works like `decomposeUSV(const Matrix< M, N, T >&, SvdWorkspace&,
+		 * SvdJob, SvdJob)` but reads elements straight from a memory block
+		 * owned by the caller, which may be laid out in either order and
+		 * have padded rows or columns.
+		 *
+		 * The behavior is undefined if `m` is not `M` x `N`.
+		 *
+		 * @param m
+		 *     `M` x `N` matrix to be decomposed.
+		 *     Not modified.
+		 * @param[out] ws
+		 *     Workspace where the decomposition of `m` is to be stored.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 */
+		static void decomposeUSV(const BasicMatrixView< T >& m,
+								 SvdWorkspace< M, N, T >& ws,
+								 SvdJob jobU = SVD_FULL,
+								 SvdJob jobV = SVD_FULL)
+		{
+			assert(m.rows() == M && m.columns() == N);
+			decomposeUSV(
+				m, ws, jobU, jobV, std::integral_constant< bool, (M < N) >());
+		}
 
-			/** Releases the memory block for bidiagonal elements. */
-			inline ~BidiagonalMatrix() {
-				this->releaseBlock();
+		/**
+		 * Decomposes a matrix in a given view into memory blocks owned by
+		 * the caller.
+		 *
+		 * Nothing is copied out of the decomposition; singular vectors are
+		 * computed in place in `u` and `v`.
+		 * Views may be laid out in either order, though column-major ones
+		 * are faster because the decomposition updates columns.
+		 * Only temporary memory blocks for the decomposition are allocated,
+		 * on the heap if they do not fit in `SINGULAR_MAX_INLINE_ELEMENTS`.
+		 * Elements may be of any floating point type.
+		 *
+		 * Singular vectors are computed as specified by `jobU` and `jobV`.
+		 *  - `SVD_FULL` computes all of singular vectors into an `M` x `M`
+		 *    `u` or an `N` x `N` `v`.
+		 *  - `SVD_THIN` computes only the first `min(M, N)` singular vectors
+		 *    into an `M` x `min(M, N)` `u` or an `N` x `min(M, N)` `v`.
+		 *  - `SVD_NONE` computes no singular vectors; `u` or `v` is ignored.
+		 *
+		 * The behavior is undefined,
+		 *  - if `m` is not `M` x `N`,
+		 *  - if `u` or `v` does not match `jobU` or `jobV`,
+		 *  - or if `u` or `v` overlaps `m`
+		 *
+		 * @tparam U
+		 *     Type of elements.
+		 *     Need not be `T`.
+		 * @param m
+		 *     `M` x `N` matrix to be decomposed.
+		 *     Not modified.
+		 * @param[out] u
+		 *     Where left-singular-vectors are to be stored.
+		 * @param[out] s
+		 *     Where singular values are to be stored in descending order.
+		 *     Must have at least `min(M, N)` elements.
+		 * @param[out] v
+		 *     Where right-singular-vectors are to be stored.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 */
+		template < typename U >
+		static void decomposeUSV(const BasicMatrixView< U >& m,
+								 BasicMatrixView< U > u,
+								 U s[],
+								 BasicMatrixView< U > v,
+								 SvdJob jobU = SVD_FULL,
+								 SvdJob jobV = SVD_FULL)
+		{
+			assert(m.rows() == M && m.columns() == N);
+			MemoryBlock< P * Q, U > aBlock;
+			MemoryBlock< 2 * Q - 1, U > bidiagonalBlock;
+			MemoryBlock< SvdWorkSize< P, Q >::VALUE, U > workBlock;
+			SvdKernel::copyColumnMajor(m, aBlock.data());
+			BasicMatrixView< U > a(aBlock.data(), P, Q, COLUMN_MAJOR);
+			BasicBidiagonalMatrix< U > b(bidiagonalBlock.data(), Q);
+			u = SvdKernel::viewFor(u, jobU, M, Q);
+			v = SvdKernel::viewFor(v, jobV, N, Q);
+			if (M >= N) {
+				SvdKernel::decomposeInPlace(
+					u, a, b, v, workBlock.data(), s);
+			} else {
+				// A^T = V * S^T * U^T
+				SvdKernel::decomposeInPlace(
+					v, a, b, u, workBlock.data(), s);
 			}
+		}
 
-			/**
-			 * Returns the element at given row and column.
-			 *
-			 * Values are 0 unless `i == j` or `i == j + 1`.
-			 *
-			 * The behavior is undefined,
-			 *  - if `i < 0` or `i >= M`,
-			 *  - or if `j < 0` or `j >= N`
-			 *
-			 * @param i
-			 *     Index of the row to be obtained.
-			 * @param j
-			 *     Index of the column to be obtained.
-			 * @return
-			 *     Element at the given row and column.
-			 */
-			double operator ()(int i, int j) const {
-				assert(i >= 0 && i < M);
-				assert(j >= 0 && j < N);
-				if (i == j) {
-					return this->pBlock[2 * i];
-				} else if (i + 1 == j) {
-					return this->pBlock[2 * i + 1];
-				} else {
-					return 0.0;
-				}
-			}
+		/**
+		 * Decomposes many matrices in a single call.
+		 *
+		 * Matrices and results are laid out in contiguous memory blocks
+		 * as described in `BatchSvd::decompose`.
+		 * Much faster than decomposing matrices one by one with
+		 * `decomposeUSV` if matrices are small, because several matrices
+		 * are decomposed at once by SIMD instructions and memory is
+		 * allocated only once.
+		 *
+		 * @tparam U
+		 *     Type of elements.
+		 *     Need not be `T`.
+		 * @param count
+		 *     Number of `M` x `N` matrices.
+		 * @param a
+		 *     Matrices to be decomposed.
+		 *     Not modified.
+		 * @param[out] u
+		 *     Where left-singular-vectors are to be stored.
+		 * @param[out] s
+		 *     Where singular values are to be stored in descending order.
+		 * @param[out] v
+		 *     Where right-singular-vectors are to be stored.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 * @param pPool
+		 *     Thread pool on which matrices are decomposed concurrently.
+		 *     Matrices are decomposed on the calling thread if this is 0.
+		 *     Only the tasks of this batch are waited for, so this may be
+		 *     called from a task on `pPool`.
+		 */
+		template < typename U >
+		static void decomposeBatch(int count,
+								   const U a[],
+								   U u[],
+								   U s[],
+								   U v[],
+								   SvdJob jobU = SVD_FULL,
+								   SvdJob jobV = SVD_FULL,
+								   ThreadPool* pPool = 0)
+		{
+			BatchSvd::decompose(M, N, count, a, u, s, v, jobU, jobV, pPool);
+		}
 
-			/**
-			 * Applies a given rotator from right-hand-side of this bidiagonal
-			 * matrix at the first time.
-			 *
-			 * Works like the following,
-			 * \f[
-			 * \begin{bmatrix}
-			 *   * & * &   &   &        \\
-			 *     & * & * &   &        \\
-			 *     &   & * & * &        \\
-			 *     &   &   & * & \ddots \\
-			 *     &   &   &   & \ddots
-			 * \end{bmatrix}
-			 * \begin{bmatrix}
-			 *   \mathbf{Q} &            \\
-			 *              & \mathbf{I}
-			 * \end{bmatrix}
-			 * \to
-			 * \begin{bmatrix}
-			 *   * & * &   &   &        \\
-			 *   + & * & * &   &        \\
-			 *     &   & * & * &        \\
-			 *     &   &   & * & \ddots \\
-			 *     &   &   &   & \ddots
-			 * \end{bmatrix}
-			 * \f]
-			 * where
-			 * \f[
-			 * \begin{array}{ccl}
-			 * \mathbf{Q} & : & 2 \times 2 \text{ rotator} \\
-			 * \mathbf{I} & : & (N-2) \times (N-2) \text{ identity matrix} \\
-			 * +          & : & \text{bulge}
-			 * \end{array}
-			 * \f]
-			 *
-			 * The behavior is undefined if `N < 2`.
-			 *
-			 * @param r
-			 *     Rotator to be applied from right-hand-side of this bidiagonal
-			 *     matrix.
-			 * @return
-			 *     Bulge made at (1, 0).
-			 */
-			double applyFirstRotatorFromRight(const Rotator& r) {
-				double b1 = this->pBlock[0];
-				double g1 = this->pBlock[1];
-				double b2 = this->pBlock[2];
-				double r11 = r(0, 0);
-				double r12 = r(0, 1);
-				double r21 = r(1, 0);
-				double r22 = r(1, 1);
-				this->pBlock[0] = b1 * r11 + g1 * r21;
-				this->pBlock[1] = b1 * r12 + g1 * r22;
-				this->pBlock[2] = b2 * r22;
-				return b2 * r21;
-			}
+		/**
+		 * Computes singular values of a given matrix.
+		 *
+		 * Much faster than `decomposeUSV` because no singular vectors are
+		 * computed, and singular values are computed by dqds instead of
+		 * Francis iterations.
+		 * No memory for singular vectors is allocated.
+		 *
+		 * @param m
+		 *     `M` x `N` matrix whose singular values are to be computed.
+		 * @return
+		 *     Singular values of `m` in descending order.
+		 */
+		static DiagonalMatrix< M, N, T > decomposeS(const Matrix< M, N, T >& m)
+		{
+			MemoryBlock< P * Q, T > aBlock;
+			SvdKernel::copyColumnMajor(inputView(m), aBlock.data());
+			MemoryBlock< 2 * Q - 1, T > bidiagonalBlock;
+			MemoryBlock< SvdWorkSize< P, Q >::VALUE, T > workBlock;
+			MemoryBlock< Q, T > ss;
+			BasicMatrixView< T > a(aBlock.data(), P, Q, COLUMN_MAJOR);
+			BasicBidiagonalMatrix< T > b(bidiagonalBlock.data(), Q);
+			SvdKernel::decomposeInPlace(BasicMatrixView< T >(0, P, 0),
+										a,
+										b,
+										BasicMatrixView< T >(0, Q, 0),
+										workBlock.data(),
+										ss.data());
+			DiagonalMatrix< M, N, T > s;
+			s.fill(ss.data());
+			return s;
+		}
 
-			/**
-			 * Applies a given rotator from right-hand-side of this bidiagonal
-			 * matrix.
-			 *
-			 * Works like the following,
-			 * \f[
-			 * \begin{bmatrix}
-			 *   \ddots & \ddots &   &   &   &        \\
-			 *          & *      & * & + &   &        \\
-			 *          &        & * & * &   &        \\
-			 *          &        &   & * & * &        \\
-			 *          &        &   &   & * & \ddots \\
-			 *          &        &   &   &   & \ddots
-			 * \end{bmatrix}
-			 * \begin{bmatrix}
-			 *   \mathbf{I}_1 &            &              \\
-			 *                & \mathbf{Q} &              \\
-			 *                &            & \mathbf{I}_2
-			 * \end{bmatrix}
-			 * \to
-			 * \begin{bmatrix}
-			 *   \ddots & \ddots &   &   &   &        \\
-			 *          & *      & * &   &   &        \\
-			 *          &        & * & * &   &        \\
-			 *          &        & + & * & * &        \\
-			 *          &        &   &   & * & \ddots \\
-			 *          &        &   &   &   & \ddots
-			 * \end{bmatrix}
-			 * \f]
-			 * where
-			 * \f[
-			 * \begin{array}{ccl}
-			 *   \mathbf{Q}   & : & 2 \times 2 \text{ rotator} \\
-			 *   \mathbf{I}_1 & : & n \times n \text{ identity matrix} \\
-			 *   \mathbf{I}_2 & : & (N-n-2) \times (N-n-2) \text{ identity matrix} \\
-			 *   +            & : & \text{bulge}
-			 * \end{array}
-			 * \f]
-			 *
-			 * The behavior is undefined if `n <= 0` or `n + 1 >= N`.
-			 *
-			 * @param r
-			 *     Rotator to be applied from right-hand-side of this bidiagonal
-			 *     matrix.
-			 * @param n
-			 *     Index of the column where a new bulge is to be made.
-			 * @param bulge
-			 *     Bulge at (n - 1, n + 1).
-			 * @return
-			 *     Bulge made at (n + 1, n).
-			 */
-			double applyRotatorFromRight(
-				const Rotator& r, int n, double bulge)
-			{
-				double* p = this->pBlock + n * 2;
-				double g0 = p[-1];
-				double b1 = p[0];
-				double g1 = p[1];
-				double b2 = p[2];
-				double r11 = r(0, 0);
-				double r12 = r(0, 1);
-				double r21 = r(1, 0);
-				double r22 = r(1, 1);
-				p[-1] = g0 * r11 + bulge * r21;
-				p[0] = b1 * r11 + g1 * r21;
-				p[1] = b1 * r12 + g1 * r22;
-				p[2] = b2 * r22;
-				return b2 * r21;
-			}
+		/**
+		 * Computes singular values of a given matrix on a given workspace.
+		 *
+		 * Works like `decomposeS(const Matrix< M, N, T >&)` but stores the
+		 * results in `ws`.
+		 * Singular vectors in `ws` are left unchanged.
+		 *
+		 * @param m
+		 *     `M` x `N` matrix whose singular values are to be computed.
+		 * @param[out] ws
+		 *     Workspace where singular values are to be stored.
+		 * @see SvdWorkspace::getS
+		 */
+		static void decomposeS(const Matrix< M, N, T >& m,
+							   SvdWorkspace< M, N, T >& ws)
+		{
+			decomposeUSV(m, ws, SVD_NONE, SVD_NONE);
+		}
+	private:
+		enum {
+			/** Number of rows in the matrix actually decomposed. */
+			P = M < N ? N : M,
+			/** Number of columns in the matrix actually decomposed. */
+			Q = M < N ? M : N
+		};
 
-			/**
-			 * Applies a given rotator from left-hand-side of this bidiagonal
-			 * matrix.
-			 *
-			 * Works like the following,
-			 * \f[
-			 * \begin{bmatrix}
-			 *   \mathbf{I}_1 &              &              \\
-			 *                & \mathbf{Q}^T &              \\
-			 *                &              & \mathbf{I}_2
-			 * \end{bmatrix}
-			 * \begin{bmatrix}
-			 *   \ddots & \ddots &   &   &   &        \\
-			 *          & *      & * &   &   &        \\
-			 *          &        & * & * &   &        \\
-			 *          &        & + & * & * &        \\
-			 *          &        &   &   & * & \ddots \\
-			 *          &        &   &   &   & \ddots
-			 * \end{bmatrix}
-			 * \to
-			 * \begin{bmatrix}
-			 *   \ddots & \ddots &   &   &   &        \\
-			 *          & *      & * &   &   &        \\
-			 *          &        & * & * & + &        \\
-			 *          &        &   & * & * &        \\
-			 *          &        &   &   & * & \ddots \\
-			 *          &        &   &   &   & \ddots
-			 * \end{bmatrix}
-			 * \f]
-			 * where
-			 * \f[
-			 * \begin{array}{ccl}
-			 *   \mathbf{Q}   & : & 2 \times 2 \text{ rotator} \\
-			 *   \mathbf{I}_1 & : & n \times n \text{ identity matrix} \\
-			 *   \mathbf{I}_2 & : & (N-n-2) \times (N-n-2) \text{ identity matrix} \\
-			 *   +            & : & \text{bulge}
-			 * \end{array}
-			 * \f]
-			 *
-			 * The behavior is undefined if `n + 1 >= N`.
-			 *
-			 * @param r
-			 *     Rotator to be applied from left-hand-side of this bidiagonal
-			 *     matrix.
-			 * @param n
-			 *     Index of the row where a new bulge is to be made.
-			 * @param bulge
-			 *     Bulge at (n + 1, n).
-			 * @return
-			 *     Bulge made at (n, n + 2).
-			 *     0.0 if `n + 2 >= N`.
-			 */
-			double applyRotatorFromLeft(const Rotator& r, int n, double bulge) {
-				double* p = this->pBlock + n * 2;
-				double b1 = p[0];
-				double g1 = p[1];
-				double b2 = p[2];
-				double r11 = r(0, 0);
-				double r12 = r(0, 1);
-				double r21 = r(1, 0);
-				double r22 = r(1, 1);
-				p[0] = r11 * b1 + r21 * bulge;
-				p[1] = r11 * g1 + r21 * b2;
-				p[2] = r12 * g1 + r22 * b2;
-				double newBulge;
-				if (n < N - 2) {
-					double g2 = p[3];
-					newBulge = r21 * g2;
-					p[3] = r22 * g2;
-				} else {
-					newBulge = 0.0;
-				}
-				return newBulge;
-			}
-		private:
-#if SINGULAR_FUNCTION_DELETION_SUPPORTED
-			/** Simple copy is forbidden. */
-			BidiagonalMatrix(const BidiagonalMatrix& copyee) = delete;
+		/**
+		 * Decomposes a given matrix on a given workspace if `M >= N`.
+		 *
+		 * @param m
+		 *     `M` x `N` matrix to be decomposed.
+		 * @param[out] ws
+		 *     Workspace where the decomposition of `m` is to be stored.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 */
+		static void decomposeUSV(const BasicMatrixView< T >& m,
+								 SvdWorkspace< M, N, T >& ws,
+								 SvdJob jobU,
+								 SvdJob jobV,
+								 std::false_type)
+		{
+			SvdKernel::copyColumnMajor(m, ws.aBlock.data());
+			BasicMatrixView< T > a(ws.aBlock.data(), P, Q, COLUMN_MAJOR);
+			BasicBidiagonalMatrix< T > b(ws.bidiagonalBlock.data(), N);
+			SvdKernel::decomposeInPlace(packedView(ws.u, jobU),
+										a,
+										b,
+										packedView(ws.v, jobV),
+										ws.workBlock.data(),
+										ws.ss.data());
+			toRowMajor(ws.u, jobU);
+			toRowMajor(ws.v, jobV);
+			ws.s.fill(ws.ss.data());
+		}
 
-			/** Simple assignment is forbidden. */
-			void operator =(const BidiagonalMatrix& copyee) = delete;
-#elif SINGULAR_RVALUE_REFERENCE_SUPPORTED
-			/** Simple copy is forbidden. */
-			BidiagonalMatrix(const BidiagonalMatrix& copyee) {}
+		/**
+		 * Decomposes a given matrix on a given workspace if `M < N`.
+		 *
+		 * Decomposes the transposed matrix instead.
+		 *
+		 * @param m
+		 *     `M` x `N` matrix to be decomposed.
+		 * @param[out] ws
+		 *     Workspace where the decomposition of `m` is to be stored.
+		 * @param jobU
+		 *     How much of left-singular-vectors is computed.
+		 * @param jobV
+		 *     How much of right-singular-vectors is computed.
+		 */
+		static void decomposeUSV(const BasicMatrixView< T >& m,
+								 SvdWorkspace< M, N, T >& ws,
+								 SvdJob jobU,
+								 SvdJob jobV,
+								 std::true_type)
+		{
+			// A^T = V * S^T * U^T
+			SvdKernel::copyColumnMajor(m, ws.aBlock.data());
+			BasicMatrixView< T > a(ws.aBlock.data(), P, Q, COLUMN_MAJOR);
+			BasicBidiagonalMatrix< T > b(ws.bidiagonalBlock.data(), M);
+			SvdKernel::decomposeInPlace(packedView(ws.v, jobV),
+										a,
+										b,
+										packedView(ws.u, jobU),
+										ws.workBlock.data(),
+										ws.ss.data());
+			toRowMajor(ws.u, jobU);
+			toRowMajor(ws.v, jobV);
+			ws.s.fill(ws.ss.data());
+		}
 
-			/** Simple assignment is forbidden. */
-			void operator =(const BidiagonalMatrix& copyee) {}
-#endif
+		/**
+		 * Returns a view of a given matrix to be decomposed.
+		 *
+		 * A returned view is only read.
+		 *
+		 * @param m
+		 *     `M` x `N` matrix to be viewed.
+		 * @return
+		 *     Row-major view of `m`.
+		 */
+		static BasicMatrixView< T > inputView(const Matrix< M, N, T >& m) {
+			return BasicMatrixView< T >(const_cast< T* >(m.data()), M, N);
+		}
 
-			/** Releases the memory block for bidiagonal elements. */
-			inline void releaseBlock() {
-				delete[] this->pBlock;
-				this->pBlock = nullptr;
-			}
-		};
-	private:
 		/**
-		 * Bindiagonalizes a given matrix.
+		 * Returns a column-major view of singular vectors to be computed.
 		 *
-		 * `M` must be greater than or equal to `N`.
-		 * The behavior is undefined if `M < N`.
+		 * Singular vectors are computed in the column-major order in the
+		 * memory block of `m`, so that columns updated by reflectors and
+		 * rotators are contiguous.
+		 * `toRowMajor` turns them into the row-major order.
 		 *
-		 * @param[in,out] u
-		 *     Left-singular-vectors to be upated.
-		 * @param[in,out] m
-		 *     Matrix to be bidiagonalized.
-		 * @param[in,out] v
-		 *     Right-singular-vectors to be updated.
+		 * If `job` is `SVD_THIN`, a returned view has only `min(M, N)`
+		 * columns at the beginning of the memory block of `m`.
+		 *
+		 * @tparam L
+		 *     Size of the singular vectors.
+		 * @param m
+		 *     Matrix where singular vectors are to be stored.
+		 * @param job
+		 *     How much of singular vectors is computed.
 		 * @return
-		 *     Bidiagonal matrix built from `m`.
+		 *     View of singular vectors to be computed.
+		 *     Has no columns if `job` is `SVD_NONE`.
 		 */
-		static BidiagonalMatrix bidiagonalize(Matrix< M, M >& u,
-											  Matrix< M, N > m,
-											  Matrix< N, N >& v)
+		template < int L >
+		static BasicMatrixView< T > packedView(Matrix< L, L, T >& m,
+											   SvdJob job)
 		{
-			assert(M >= N);
-			for (int i = 0; i < N; ++i) {
-				// applies a householder transform to the column vector i
-				Reflector< M > rU(m.column(i).slice(i));
-				m = rU.applyFromLeftTo(m);
-				u = rU.applyFromRightTo(u);  // U1^T*U0^T = U0*U1
-				if (i < N - 1) {
-					// applies a householder transform to the row vector i + 1
-					Reflector< N > rV(m.row(i).slice(i + 1));
-					m = rV.applyFromRightTo(m);
-					v = rV.applyFromRightTo(v);
-				}
+			switch (job) {
+			case SVD_NONE:
+				return BasicMatrixView< T >(m.data(), L, 0, COLUMN_MAJOR);
+			case SVD_THIN:
+				return BasicMatrixView< T >(m.data(), L, Q, COLUMN_MAJOR);
+			default:
+				return BasicMatrixView< T >(m.data(), L, L, COLUMN_MAJOR);
 			}
-			return BidiagonalMatrix(m);
 		}
 
 		/**
-		 * Performs a single Francis iteration.
-		 *
-		 * Submatrices other than the top-left `n` x `n` submatrix of `m` are
-		 * regarded as already converged.
+		 * Turns singular vectors computed in a view given by `packedView`
+		 * into the row-major order.
 		 *
-		 * The behavior is undefined,
-		 *  - if `M < N`,
-		 *  - or if `n < 2`
+		 * Does nothing if `job` is `SVD_NONE`.
+		 * Columns that are not computed are filled with zeros.
 		 *
-		 * @param[in,out] u
-		 *     Left-singular-vectors to be updated.
+		 * @tparam L
+		 *     Size of the singular vectors.
 		 * @param[in,out] m
-		 *     Bidiagonalized input matrix where diagonal elements are to be
-		 *     singular values after convergence.
-		 * @param[in,out] v
-		 *     Right-singular-vectors to be updated.
-		 * @param n
-		 *     Size of the submatrix over which the Francis iteration is to be
-		 *     performed.
-		 *     Must be gerater than or equal to 2.
+		 *     Matrix where singular vectors have been computed.
+		 * @param job
+		 *     How much of singular vectors has been computed.
 		 */
-		static void doFrancis(Matrix< M, M >& u,
-							  BidiagonalMatrix& m,
-							  Matrix< N, N >& v,
-							  int n)
-		{
-			assert(M >= N);
-			assert(n >= 2);
-			// calculates the shift
-			double rho = calculateShift(m, n);
-			// applies the first right rotator
-			double b1 = m(0, 0);
-			double g1 = m(0, 1);
-			double mx =
-				std::max(std::abs(rho), std::max(std::abs(b1), std::abs(g1)));
-			rho /= mx;
-			b1 /= mx;
-			g1 /= mx;
-			Rotator r0(b1 * b1 - rho * rho, b1 * g1);
-			double bulge = m.applyFirstRotatorFromRight(r0);
-			v = r0.applyFromRightTo(v, 0);
-			// applies the first left rotator
-			Rotator r1(m(0, 0), bulge);
-			bulge = m.applyRotatorFromLeft(r1, 0, bulge);
-			u = r1.applyFromRightTo(u, 0);  // U1^T*U0^T = U0*U1
-			for (int i = 1; i + 1 < n; ++i) {
-				// calculates (i+1)-th right rotator
-				Rotator rV(m(i - 1, i), bulge);
-				bulge = m.applyRotatorFromRight(rV, i, bulge);
-				v = rV.applyFromRightTo(v, i);
-				// calculates (i+1)-th left rotator
-				Rotator rU(m(i, i), bulge);
-				bulge = m.applyRotatorFromLeft(rU, i, bulge);
-				u = rU.applyFromRightTo(u, i);  // U1^T*U0^T = U0*U1
+		template < int L >
+		static void toRowMajor(Matrix< L, L, T >& m, SvdJob job) {
+			switch (job) {
+			case SVD_NONE:
+				return;
+			case SVD_THIN:
+				std::fill(m.data() + L * Q, m.data() + L * L, 0.0);
+				break;
+			default:
+				break;
 			}
+			Transpose::inPlace(L, m.data(), L);
 		}
+	};
+
+	/**
+	 * Workspace for singular value decomposition.
+	 *
+	 * Owns every memory block needed to decompose an `M` x `N` matrix,
+	 * and results of the last decomposition.
+	 * Memory blocks are allocated only when a workspace is constructed,
+	 * so repeated decompositions on the same workspace allocate nothing.
+	 *
+	 * @tparam M
+	 *     Number of rows in an input matrix.
+	 * @tparam N
+	 *     Number of columns in an input matrix.
+	 * @tparam T
+	 *     Type of elements in an input matrix.
+	 *     `double` by default.
+	 */
+	template < int M, int N, typename T >
+	class SvdWorkspace {
+	private:
+		enum {
+			/** Number of rows in the matrix actually decomposed. */
+			P = M < N ? N : M,
+			/** Number of columns in the matrix actually decomposed. */
+			Q = M < N ? M : N
+		};
+
+		friend struct Svd< M, N, T >;
+
+		/** Left-singular-vectors. */
+		Matrix< M, M, T > u;
+
+		/** Singular values. */
+		DiagonalMatrix< M, N, T > s;
+
+		/** Right-singular-vectors. */
+		Matrix< N, N, T > v;
 
 		/**
-		 * Calculates the shift for a given bidiagonal matrix.
+		 * Memory block for the matrix to be decomposed.
 		 *
-		 * Submatrices other than top-left `n` x `n` submatrix of `m` are
-		 * regarded as already converged.
+		 * Laid out in the column-major order.
+		 * Holds the transposed matrix if `M < N`.
+		 */
+		MemoryBlock< P * Q, T > aBlock;
+
+		/** Memory block for the bidiagonal matrix made from `aBlock`. */
+		MemoryBlock< 2 * Q - 1, T > bidiagonalBlock;
+
+		/** Memory block for reflectors. */
+		MemoryBlock< SvdWorkSize< P, Q >::VALUE, T > workBlock;
+
+		/** Memory block for singular values being computed. */
+		MemoryBlock< Q, T > ss;
+	public:
+		/** Allocates a workspace. */
+		SvdWorkspace() {}
+
+		/**
+		 * Returns the left-singular-vectors from the last decomposition.
 		 *
-		 * The behavior is undefined,
-		 *  - if `M < N`,
-		 *  - or if `n < 2`
+		 * @return
+		 *     Left-singular-vectors.
+		 */
+		inline const Matrix< M, M, T >& getU() const {
+			return this->u;
+		}
+
+		/**
+		 * Returns the singular values from the last decomposition.
 		 *
-		 * @param m
-		 *     Bidiagonal matrix from which a shift is to be calculated.
-		 * @param n
-		 *     Size of the submatrix to be considered. 
 		 * @return
-		 *     Shift for the top-left `n` x `n` submatrix of `m`.
+		 *     Singular values.
 		 */
-		static double calculateShift(const BidiagonalMatrix& m, int n) {
-			assert(M >= N);
-			assert(n >= 2);
-			double b1 = m(n - 2, n - 2);
-			double b2 = m(n - 1, n - 1);
-			double g1 = m(n - 2, n - 1);
-			// solves lambda^4 - d*lambda^2 + e = 0
-			// where
-			//  d = b1^2 + b2^2 + g1^2
-			//  e = b1^2 * b2^2
-			// chooses lambda (rho) closest to b2
-			double rho;
-			double d = b1 * b1 + b2 * b2 + g1 * g1;
-			double e = b1 * b1 * b2 * b2;
-			// lambda^2 = (d +- sqrt(d^2 - 4e)) / 2
-			// so, f = d^2 - 4e must be positive
-			double f = d * d - 4 * e;
-			if (f >= 0) {
-				f = sqrt(f);
-				// lambda = +-sqrt(d +- f)  (d >= 0, f >= 0)
-				// if d > f, both d+f and d-f have real square roots
-				// otherwise considers only d+f
-				if (d > f) {
-					// lets l1 > l2
-					double l1 = sqrt((d + f) * 0.5);
-					double l2 = sqrt((d - f) * 0.5);
-					// if b2 >= 0, chooses a positive shift
-					// otherwise chooses a negative shift
-					if (b2 >= 0) {
-						if (std::abs(b2 - l1) < std::abs(b2 - l2)) {
-							rho = l1;
-						} else {
-							rho = l2;
-						}
-					} else {
-						if (std::abs(b2 + l1) < std::abs(b2 + l2)) {
-							rho = -l1;
-						} else {
-							rho = -l2;
-						}
-					}
-				} else {
-					double l1 = sqrt((d + f) * 0.5);
-					if (std::abs(b2 - l1) <= std::abs(b2 + l1)) {
-						rho = l1;
-					} else {
-						rho = -l1;
-					}
-				}
-			} else {
-				// no solution. chooses b2 as the shift
-				rho = b2;
-			}
-			return rho;
+		inline const DiagonalMatrix< M, N, T >& getS() const {
+			return this->s;
+		}
+
+		/**
+		 * Returns the right-singular-vectors from the last decomposition.
+		 *
+		 * @return
+		 *     Right-singular-vectors.
+		 */
+		inline const Matrix< N, N, T >& getV() const {
+			return this->v;
+		}
+	private:
+#if SINGULAR_FUNCTION_DELETION_SUPPORTED
+		/** Copy constructor is not allowed. */
+		SvdWorkspace(const SvdWorkspace& copyee) = delete;
+
+		/** Copy assignment is not allowed. */
+		SvdWorkspace& operator =(const SvdWorkspace& copyee) = delete;
+#else
+		/** Copy constructor is not allowed. */
+		SvdWorkspace(const SvdWorkspace& copyee) {}
+
+		/** Copy assignment is not allowed. */
+		SvdWorkspace& operator =(const SvdWorkspace& copyee) {
+			return *this;
 		}
+#endif
 	};
 
 }
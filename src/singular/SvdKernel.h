@@ -0,0 +1,1941 @@
+#ifndef _SINGULAR_SVD_KERNEL_H
+#define _SINGULAR_SVD_KERNEL_H
+
+#include "singular/BidiagonalMatrix.h"
+#include "singular/Gemm.h"
+#include "singular/MatrixView.h"
+#include "singular/Reflector.h"
+#include "singular/RotationKernel.h"
+#include "singular/RotationSequence.h"
+#include "singular/Rotator.h"
+#include "singular/ThreadPool.h"
+#include "singular/singular.h"
+#include "singular/Transpose.h"
+#include "singular/VectorKernel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+
+namespace singular {
+
+	/**
+	 * How much of singular vectors is computed.
+	 *
+	 * Works like `JOBU` and `JOBVT` of LAPACK's `dgesvd`.
+	 */
+	enum SvdJob {
+		/** Computes no singular vectors. */
+		SVD_NONE,
+		/** Computes only the first `min(M, N)` singular vectors. */
+		SVD_THIN,
+		/** Computes all of singular vectors. */
+		SVD_FULL
+	};
+
+	/**
+	 * Kernels of singular value decomposition.
+	 *
+	 * Kernels work on views whose dimensions are given at runtime,
+	 * so `Svd` of every size and `DynamicSvd` share the same kernels.
+	 * Kernels allocate no memory; every memory block is given by callers.
+	 * Every kernel is a template on the type of elements `T` which is
+	 * deduced from its arguments.
+	 */
+	struct SvdKernel {
+		/** Maximum number of Francis iterations per row of a block. */
+		static const int MAX_ITERATIONS_PER_ROW = 10;
+
+		/**
+		 * Minimum size of a block that is handed to a thread pool.
+		 *
+		 * Smaller blocks are not worth the overhead of a task.
+		 */
+		static const int MIN_CONCURRENT_BLOCK_SIZE = 16;
+
+		/**
+		 * Minimum number of rows of singular vectors that a thread updates
+		 * when rotations of a sweep are applied concurrently.
+		 *
+		 * Singular vectors that have fewer than twice as many rows are
+		 * rotated as soon as each rotation is calculated.
+		 */
+		static const int MIN_CONCURRENT_ROWS = 64;
+
+		/**
+		 * Minimum size of a bidiagonal matrix whose Francis iterations
+		 * rotate singular vectors in a wavefront order.
+		 *
+		 * Rotations of up to `RotationSequence::MAX_SWEEPS` iterations are
+		 * recorded and then applied by `applyRotations`.
+		 * Smaller singular vectors stay in cache anyway, so they are
+		 * rotated as soon as each rotation is calculated unless their rows
+		 * are rotated concurrently.
+		 */
+		static const int MIN_WAVEFRONT_SIZE = 512;
+
+		/**
+		 * Number of columns in a panel that `bidiagonalize` reduces before
+		 * it updates the rest of the matrix at once.
+		 */
+		static const int BIDIAGONAL_BLOCK_SIZE = 32;
+
+		/**
+		 * Minimum number of columns left to `bidiagonalize` that are reduced
+		 * in panels.
+		 *
+		 * Fewer columns are reduced one at a time, because matrix-matrix
+		 * products of smaller matrices do not pay for forming panels.
+		 */
+		static const int MIN_BLOCKED_SIZE = 128;
+
+		/**
+		 * Returns the number of elements in a memory block that
+		 * `decomposeInPlace` needs for an `M` x `N` matrix.
+		 *
+		 * `SvdWorkSize` gives the same number at compile time.
+		 *
+		 * @param M
+		 *     Number of rows in the matrix to be decomposed.
+		 * @param N
+		 *     Number of columns in the matrix to be decomposed.
+		 * @return
+		 *     Number of elements in the memory block.
+		 */
+		static inline int workSize(int M, int N) {
+			if (usesQr(M, N)) {
+				return std::max(M, workSize(N, N)) + N + 2 * N * N;
+			} else {
+				return std::max(bidiagonalWorkSize(M, N) + 2 * N,
+								rotationWorkSize(M, N));
+			}
+		}
+
+		/**
+		 * Returns the number of elements in a memory block that
+		 * `bidiagonalize` needs for an `M` x `N` matrix.
+		 *
+		 * @param M
+		 *     Number of rows in the matrix to be bidiagonalized.
+		 * @param N
+		 *     Number of columns in the matrix to be bidiagonalized.
+		 * @return
+		 *     Number of elements in the memory block.
+		 */
+		static inline int bidiagonalWorkSize(int M, int N) {
+			if (N > MIN_BLOCKED_SIZE) {
+				return (M + N) * (1 + 2 * BIDIAGONAL_BLOCK_SIZE) +
+					Gemm::MC * M +
+					Gemm::packingSize(Gemm::MC, M, 2 * BIDIAGONAL_BLOCK_SIZE);
+			} else {
+				return M + N;
+			}
+		}
+
+		/**
+		 * Returns the number of elements in a memory block where rotations
+		 * of Francis iterations over an `N` x `N` bidiagonal matrix are
+		 * recorded.
+		 *
+		 * @param M
+		 *     Number of rows in left-singular-vectors.
+		 *     Not less than `N`.
+		 * @param N
+		 *     Size of the bidiagonal matrix.
+		 * @return
+		 *     Number of elements in the memory block.
+		 *     0 if rotations are never recorded.
+		 */
+		static inline int rotationWorkSize(int M, int N) {
+			return (N >= MIN_WAVEFRONT_SIZE || M >= 2 * MIN_CONCURRENT_ROWS)
+				? 2 * RotationSequence::blockSize(N)
+				: 0;
+		}
+
+		/**
+		 * Returns the number of elements in a memory block that
+		 * `reconstruct` needs.
+		 *
+		 * @param M
+		 *     Number of rows in the matrix.
+		 * @param N
+		 *     Number of columns in the matrix.
+		 * @param Q
+		 *     Number of singular values.
+		 * @return
+		 *     Number of elements in the memory block.
+		 */
+		static inline int reconstructWorkSize(int M, int N, int Q) {
+			return (M + N) * Q + Gemm::packingSize(M, N, Q);
+		}
+
+		/**
+		 * Returns whether an `M` x `N` matrix is factorized into `QR` before
+		 * bidiagonalization.
+		 *
+		 * Bidiagonalizing the `N` x `N` `R` instead of the whole matrix pays
+		 * off if `M` is much larger than `N`.
+		 * The crossover `M >= 1.6 N` is the same as LAPACK's `dgesvd`.
+		 *
+		 * @param M
+		 *     Number of rows in the matrix to be decomposed.
+		 * @param N
+		 *     Number of columns in the matrix to be decomposed.
+		 * @return
+		 *     Whether the matrix is factorized into `QR` first.
+		 */
+		static inline bool usesQr(int M, int N) {
+			return M * 5 >= N * 8;
+		}
+
+		/**
+		 * Returns the relative tolerance below which an element is
+		 * negligible.
+		 *
+		 * A few units in the last place of `T`, which is about
+		 * \f$10^{-15}\f$ for `double` and \f$5 \times 10^{-7}\f$ for
+		 * `float`.
+		 * A threshold tighter than the precision of `T` would never be met.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @return
+		 *     Relative tolerance for `T`.
+		 */
+		template < typename T >
+		static inline T tolerance() {
+			return T(4.5) * std::numeric_limits< T >::epsilon();
+		}
+
+		/**
+		 * Returns the part of a given view where singular vectors required
+		 * by a given job are to be stored.
+		 *
+		 * The behavior is undefined,
+		 *  - if `job` is `SVD_FULL` and `m` is not `L` x `L`,
+		 *  - or if `job` is `SVD_THIN` and `m` is not `L` x `Q`
+		 *
+		 * @param m
+		 *     View where singular vectors are to be stored.
+		 *     Ignored if `job` is `SVD_NONE`.
+		 * @param job
+		 *     How much of singular vectors is computed.
+		 * @param L
+		 *     Number of all singular vectors.
+		 * @param Q
+		 *     Number of singular values.
+		 * @return
+		 *     `m`, or an `L` x 0 view if `job` is `SVD_NONE`.
+		 */
+		template < typename T >
+		static BasicMatrixView< T > viewFor(BasicMatrixView< T > m,
+											SvdJob job,
+											int L,
+											int Q)
+		{
+			// Q is only checked, so it is unused if assertions are off
+			static_cast< void >(Q);
+			switch (job) {
+			case SVD_NONE:
+				return BasicMatrixView< T >(0, L, 0);
+			case SVD_THIN:
+				assert(m.rows() == L && m.columns() == Q);
+				return m;
+			default:
+				assert(m.rows() == L && m.columns() == L);
+				return m;
+			}
+		}
+
+		/**
+		 * Copies a given matrix into a column-major memory block to be
+		 * decomposed by `decomposeInPlace`.
+		 *
+		 * Copies the transposed matrix instead if `m` has more columns
+		 * than rows, so that `a` always has at least as many rows as
+		 * columns.
+		 * Either way, whichever of the row-major or column-major order `m`
+		 * has, columns of `m` or rows of `m` are copied in one pass.
+		 *
+		 * @param m
+		 *     Matrix to be copied.
+		 *     Not modified.
+		 * @param[out] a
+		 *     Where the `max(M, N)` x `min(M, N)` column-major matrix is to
+		 *     be stored; `M = m.rows()` and `N = m.columns()`.
+		 *     Must not overlap `m`.
+		 */
+		template < typename T >
+		static void copyColumnMajor(const BasicMatrixView< T >& m, T* a) {
+			const int M = m.rows();
+			const int N = m.columns();
+			const int ld = m.leadingDimension();
+			const bool rowMajor = m.layout() == ROW_MAJOR;
+			if ((M >= N) == rowMajor) {
+				// transposes rows of a tall matrix into columns of `a`,
+				// or columns of a wide matrix into columns of `a`
+				const int R = rowMajor ? M : N;
+				const int C = rowMajor ? N : M;
+				Transpose::copy(R, C, m.data(), ld, a, R);
+			} else {
+				// columns of a tall matrix or rows of a wide matrix are
+				// already columns of `a`
+				const int C = rowMajor ? M : N;
+				const int R = rowMajor ? N : M;
+				for (int j = 0; j < C; ++j) {
+					const T* pSrc = m.data() + j * ld;
+					std::copy(pSrc, pSrc + R, a + j * R);
+				}
+			}
+		}
+
+		/**
+		 * Decomposes a given matrix in place.
+		 *
+		 * Let `M = a.rows()` and `N = a.columns()`.
+		 * Singular values are sorted in descending order.
+		 *
+		 * If `usesQr(M, N)`, `a` is factorized into `QR` first and only
+		 * the `N` x `N` `R` is bidiagonalized (see `decomposeWithQr`).
+		 *
+		 * If neither `u` nor `v` has columns, singular values are computed
+		 * by `computeSingularValues` instead of Francis iterations.
+		 *
+		 * Left-singular-vectors are computed only if `u` has columns.
+		 * If `u` has `N` columns, only the first `N` left-singular-vectors are
+		 * computed.
+		 * Right-singular-vectors are computed only if `v` has columns.
+		 * Rotations and reflections are never accumulated into singular
+		 * vectors that are not computed.
+		 *
+		 * The behavior is undefined,
+		 *  - if `M < N` or `N < 1`,
+		 *  - if `u` is neither `M` x `M`, `M` x `N` nor empty,
+		 *  - if `v` is neither `N` x `N` nor empty,
+		 *  - or if `b.size() != N`
+		 *
+		 * @param[out] u
+		 *     Where left-singular-vectors are to be stored.
+		 * @param[in,out] a
+		 *     Matrix to be decomposed.
+		 *     Destroyed after this call.
+		 * @param[out] b
+		 *     Bidiagonal matrix used during the decomposition.
+		 * @param[out] v
+		 *     Where right-singular-vectors are to be stored.
+		 * @param pBlock
+		 *     Memory block for reflectors.
+		 *     Must have at least `workSize(M, N)` elements.
+		 * @param[out] ss
+		 *     Where singular values are to be stored.
+		 *     Must have at least `N` elements.
+		 * @param pPool
+		 *     Thread pool on which independent blocks of the bidiagonal
+		 *     matrix are iterated concurrently.
+		 *     Rotations of a Francis sweep are also applied to row blocks of
+		 *     large singular vectors concurrently (see `applyRotations`).
+		 *     Blocks are iterated on the calling thread if this is 0.
+		 *     Only the tasks of this decomposition are waited for, and the
+		 *     calling thread runs queued tasks meanwhile, so this may be
+		 *     called from a task on `pPool`.
+		 */
+		template < typename T >
+		static void decomposeInPlace(BasicMatrixView< T > u,
+									 BasicMatrixView< T > a,
+									 BasicBidiagonalMatrix< T >& b,
+									 BasicMatrixView< T > v,
+									 T* pBlock,
+									 T ss[],
+									 ThreadPool* pPool = 0)
+		{
+			const int M = a.rows();
+			const int N = a.columns();
+			assert(M >= N && N >= 1);
+			assert(u.columns() == 0 || u.rows() == M);
+			assert(u.columns() == 0 || u.columns() == N || u.columns() == M);
+			assert(v.columns() == 0 || (v.rows() == N && v.columns() == N));
+			assert(b.size() == N);
+			if (usesQr(M, N)) {
+				decomposeWithQr(u, a, b, v, pBlock, ss, pPool);
+				return;
+			}
+			T* tauQ = pBlock + bidiagonalWorkSize(M, N);
+			T* tauP = tauQ + N;
+			// bidiagonalizes a given matrix
+			// and forms singular vectors from reflectors
+			bidiagonalize(a, b, pBlock, tauQ, tauP);
+			if (u.columns() == 0 && v.columns() == 0) {
+				// no singular vectors; dqds is much faster
+				computeSingularValues(b, pBlock, ss);
+				return;
+			}
+			if (u.columns() > 0) {
+				accumulateLeftReflectors(u, a, tauQ);
+			}
+			if (v.columns() > 0) {
+				accumulateRightReflectors(v, a, tauP);
+			}
+			// repeats Francis iteration over unreduced blocks
+			T bMax = 0.0;
+			for (int i = 0; i < N; ++i) {
+				bMax = std::max(bMax, std::abs(b(i, i)));
+				if (i + 1 < N) {
+					bMax = std::max(bMax, std::abs(b(i, i + 1)));
+				}
+			}
+			const T smallDiagonal = tolerance< T >() * bMax;
+			// reflectors are no longer needed, so pBlock keeps rotations
+			if (pPool != 0) {
+				ThreadPool::TaskGroup blocks(*pPool);
+				iterateBlock(u, b, v, 0, N, smallDiagonal, pBlock, &blocks);
+				blocks.wait();
+			} else {
+				iterateBlock(u, b, v, 0, N, smallDiagonal, pBlock, 0);
+			}
+			// copies the diagonal elements
+			// and makes all singular values positive
+			for (int i = 0; i < N; ++i) {
+				if (b(i, i) < 0) {
+					ss[i] = -b(i, i);
+					// inverts the sign of the right singular vector
+					if (v.columns() > 0) {
+						Vector< T > vi = v.column(i);
+						std::transform(
+							vi.begin(), vi.end(), vi.begin(),
+							[](T x) {
+								return -x;
+							});
+					}
+				} else {
+					ss[i] = b(i, i);
+				}
+			}
+			// sorts singular values in descending order
+			// by swapping columns of singular vectors
+			for (int i = 0; i + 1 < N; ++i) {
+				int iMax = i;
+				for (int j = i + 1; j < N; ++j) {
+					if (ss[j] > ss[iMax]) {
+						iMax = j;
+					}
+				}
+				if (iMax != i) {
+					std::swap(ss[i], ss[iMax]);
+					if (u.columns() > 0) {
+						swapColumns(u, i, iMax);
+					}
+					if (v.columns() > 0) {
+						swapColumns(v, i, iMax);
+					}
+				}
+			}
+		}
+
+		/**
+		 * Decomposes a given tall matrix via its `QR` factorization.
+		 *
+		 * Factorizes \f$\mathbf{A} = \mathbf{Q} \mathbf{R}\f$ with
+		 * Householder reflectors, decomposes the `N` x `N` `R` by
+		 * `decomposeInPlace`, and then forms
+		 * \f$\mathbf{U} = \mathbf{Q} \mathbf{U}_R\f$ only if `u` has
+		 * columns.
+		 * Reflectors of `Q` are kept below the diagonal of `a` in the same
+		 * way as `bidiagonalize`.
+		 *
+		 * Arguments are the same as `decomposeInPlace`.
+		 */
+		template < typename T >
+		static void decomposeWithQr(BasicMatrixView< T > u,
+									BasicMatrixView< T > a,
+									BasicBidiagonalMatrix< T >& b,
+									BasicMatrixView< T > v,
+									T* pBlock,
+									T ss[],
+									ThreadPool* pPool)
+		{
+			const int M = a.rows();
+			const int N = a.columns();
+			T* tauR = pBlock + std::max(M, workSize(N, N));
+			BasicMatrixView< T > r(tauR + N, N, N, a.layout());
+			BasicMatrixView< T > uR(
+				tauR + N + N * N, N, u.columns() > 0 ? N : 0, u.layout());
+			// factorizes A = Q * R
+			// R is not formed yet, so its memory block serves as work space
+			for (int i = 0; i < N; ++i) {
+				BasicDynamicReflector< T > rQ(a.column(i).slice(i), pBlock);
+				applyFromLeftByRows(rQ, a, i, tauR + N);
+				store(rQ, a.column(i).slice(i));
+				tauR[i] = rQ.getGamma();
+			}
+			for (int i = 0; i < N; ++i) {
+				for (int j = 0; j < N; ++j) {
+					r(i, j) = (j >= i) ? a(i, j) : 0.0;
+				}
+			}
+			// decomposes R = U_R * S * V^T
+			decomposeInPlace(uR, r, b, v, pBlock, ss, pPool);
+			// U = Q * diag(U_R, I)
+			if (u.columns() > 0) {
+				for (int i = 0; i < M; ++i) {
+					for (int j = 0; j < u.columns(); ++j) {
+						if (i < N && j < N) {
+							u(i, j) = uR(i, j);
+						} else {
+							u(i, j) = (i == j) ? 1.0 : 0.0;
+						}
+					}
+				}
+				for (int i = N - 1; i >= 0; --i) {
+					a(i, i) = 1.0;
+					applyFromLeftByRows(
+						BasicDynamicReflector< T >::wrap(
+							a.column(i).slice(i), tauR[i]),
+						u,
+						0,
+						pBlock);
+				}
+			}
+		}
+
+		/**
+		 * Applies a given reflector to a given matrix from left in place,
+		 * sweeping the matrix row by row.
+		 *
+		 * Works like `DynamicReflector::applyFromLeftInPlace` but touches
+		 * elements in the order they are laid out, which matters when `m`
+		 * has many more rows than columns.
+		 * A column-major `m` is swept column by column instead, because
+		 * its columns are contiguous.
+		 *
+		 * @param r
+		 *     Reflector to be applied.
+		 * @param[in,out] m
+		 *     Matrix to be transformed.
+		 * @param firstColumn
+		 *     Index of the first column to be transformed.
+		 * @param work
+		 *     Work space.
+		 *     Must have at least `m.columns() - firstColumn` elements.
+		 */
+		template < typename T >
+		static void applyFromLeftByRows(const BasicDynamicReflector< T >& r,
+										BasicMatrixView< T > m,
+										int firstColumn,
+										T work[])
+		{
+			if (m.layout() == COLUMN_MAJOR) {
+				r.applyFromLeftInPlace(m, firstColumn);
+				return;
+			}
+			const Vector< T >& ru = r.getU();
+			const int L = static_cast< int >(ru.size());
+			const int offset = m.rows() - L;
+			const int n = m.columns() - firstColumn;
+			// work = gamma * u^T * m
+			std::fill(work, work + n, 0.0);
+			for (int i = 0; i < L; ++i) {
+				const T x = ru[i];
+				const T* row = &m(offset + i, 0) + firstColumn;
+				for (int j = 0; j < n; ++j) {
+					work[j] += x * row[j];
+				}
+			}
+			const T gamma = r.getGamma();
+			for (int j = 0; j < n; ++j) {
+				work[j] *= gamma;
+			}
+			// H * m = m - u * work
+			for (int i = 0; i < L; ++i) {
+				const T x = ru[i];
+				T* row = &m(offset + i, 0) + firstColumn;
+				for (int j = 0; j < n; ++j) {
+					row[j] -= x * work[j];
+				}
+			}
+		}
+
+		/**
+		 * Multiplies singular vectors and singular values back into a
+		 * matrix.
+		 *
+		 * Computes \f$\mathbf{A} = \mathbf{U} \mathbf{\Sigma} \mathbf{V}^T\f$
+		 * with only the first `Q` columns of `u` and `v`, which are all that
+		 * meet nonzero singular values.
+		 * Singular values that are zero are skipped, so a truncated
+		 * decomposition costs proportionally less.
+		 * The scaled `u` and transposed `v` are multiplied by `Gemm`.
+		 *
+		 * `UMatrix` and `VMatrix` must overload the function-call operator
+		 * `()` which takes a row index `i` and column index `j` and returns
+		 * the element at the ith row and jth column.
+		 *
+		 * @tparam UMatrix
+		 *     Type of the left-singular-vectors.
+		 * @tparam VMatrix
+		 *     Type of the right-singular-vectors.
+		 * @param u
+		 *     Left-singular-vectors.
+		 *     Must have `M` rows and at least `Q` columns.
+		 * @param s
+		 *     Singular values.
+		 *     Must have `Q` elements.
+		 * @param v
+		 *     Right-singular-vectors.
+		 *     Must have `N` rows and at least `Q` columns.
+		 * @param M
+		 *     Number of rows in the matrix.
+		 * @param N
+		 *     Number of columns in the matrix.
+		 * @param Q
+		 *     Number of singular values.
+		 * @param[out] a
+		 *     `M` x `N` row-major matrix to be overwritten.
+		 * @param lda
+		 *     Distance from one row to the next row in `a`.
+		 * @param work
+		 *     Memory block that has at least `reconstructWorkSize(M, N, Q)`
+		 *     elements.
+		 */
+		template < typename T, typename UMatrix, typename VMatrix >
+		static void reconstruct(const UMatrix& u,
+								const T s[],
+								const VMatrix& v,
+								int M,
+								int N,
+								int Q,
+								T* a,
+								ptrdiff_t lda,
+								T* work)
+		{
+			// us = U * S (M x r), vt = V^T (r x N)
+			T* us = work;
+			T* vt = work + M * Q;
+			int r = 0;
+			for (int k = 0; k < Q; ++k) {
+				if (s[k] == 0.0) {
+					continue;
+				}
+				for (int i = 0; i < M; ++i) {
+					us[i * Q + r] = u(i, k) * s[k];
+				}
+				for (int j = 0; j < N; ++j) {
+					vt[r * N + j] = v(j, k);
+				}
+				++r;
+			}
+			Gemm::multiplyBuffered(
+				M, N, r, us, Q, vt, N, a, lda, vt + Q * N);
+		}
+
+		/**
+		 * Overwrites a given matrix with the identity matrix.
+		 *
+		 * @param[out] m
+		 *     Matrix to be overwritten.
+		 */
+		template < typename T >
+		static void makeIdentity(BasicMatrixView< T > m) {
+			for (int i = 0; i < m.rows(); ++i) {
+				for (int j = 0; j < m.columns(); ++j) {
+					m(i, j) = (i == j) ? 1.0 : 0.0;
+				}
+			}
+		}
+
+		/**
+		 * Swaps given two columns in a given matrix.
+		 *
+		 * @param[in,out] m
+		 *     Matrix whose columns are to be swapped.
+		 * @param j1
+		 *     Index of one column to be swapped.
+		 * @param j2
+		 *     Index of the other column to be swapped.
+		 */
+		template < typename T >
+		static void swapColumns(BasicMatrixView< T > m, int j1, int j2) {
+			Vector< T > c1 = m.column(j1);
+			Vector< T > c2 = m.column(j2);
+			std::swap_ranges(c1.begin(), c1.end(), c2.begin());
+		}
+
+		/**
+		 * Bindiagonalizes a given matrix.
+		 *
+		 * Reflectors are not accumulated into singular vectors here.
+		 * Instead, reflectors are kept in `m` and gammas are stored in
+		 * `tauQ` and `tauP` like LAPACK's `dgebrd`.
+		 *  - The u vector of the ith left reflector is stored below the ith
+		 *    diagonal element; its first element 1 is implicit.
+		 *  - The u vector of the ith right reflector is stored right of the
+		 *    ith upper-diagonal element; its first element 1 is implicit.
+		 *
+		 * While more than `MIN_BLOCKED_SIZE` columns are left, columns are
+		 * reduced in panels of `BIDIAGONAL_BLOCK_SIZE` by `reducePanel`,
+		 * and the rest of the matrix is updated by a matrix-matrix product
+		 * per panel (see `updateTrailing`).
+		 * The last columns are reduced one at a time by
+		 * `bidiagonalizeColumns`.
+		 *
+		 * Let `M = m.rows()` and `N = m.columns()`.
+		 * The behavior is undefined if `M < N`.
+		 *
+		 * @param[in,out] m
+		 *     Matrix to be bidiagonalized.
+		 *     Reflectors are stored in it after this call.
+		 * @param[out] b
+		 *     Where the bidiagonal matrix built from `m` is to be stored.
+		 * @param pBlock
+		 *     Memory block for reflectors and panels.
+		 *     Must have at least `bidiagonalWorkSize(M, N)` elements.
+		 * @param[out] tauQ
+		 *     Where gammas of left reflectors are to be stored.
+		 *     Must have at least `N` elements.
+		 * @param[out] tauP
+		 *     Where gammas of right reflectors are to be stored.
+		 *     Must have at least `N` elements.
+		 */
+		template < typename T >
+		static void bidiagonalize(BasicMatrixView< T > m,
+								  BasicBidiagonalMatrix< T >& b,
+								  T* pBlock,
+								  T tauQ[],
+								  T tauP[])
+		{
+			const int M = m.rows();
+			const int N = m.columns();
+			assert(M >= N);
+			// w = [X V] and z = [U Y] of a panel
+			T* w = pBlock + M + N;
+			T* z = w + 2 * BIDIAGONAL_BLOCK_SIZE * M;
+			T* product = z + 2 * BIDIAGONAL_BLOCK_SIZE * N;
+			int first = 0;
+			for (; N - first > MIN_BLOCKED_SIZE;
+				 first += BIDIAGONAL_BLOCK_SIZE)
+			{
+				reducePanel(m, b, first, pBlock, tauQ, tauP, w, z);
+				updateTrailing(m, b, first, w, z, product);
+			}
+			bidiagonalizeColumns(m, first, pBlock, tauQ, tauP);
+			b.fill(m);
+		}
+
+		/**
+		 * Bidiagonalizes the columns of a given matrix from a given column
+		 * one at a time.
+		 *
+		 * Applies each reflector to the rest of the matrix as a rank-1
+		 * update.
+		 * Reflectors and gammas are stored in the same way as
+		 * `bidiagonalize`, which leaves the columns on the left of `first`
+		 * to this function reduced.
+		 *
+		 * @param[in,out] m
+		 *     Matrix to be bidiagonalized.
+		 *     Must have no more columns than rows.
+		 * @param first
+		 *     Index of the first column to be reduced.
+		 *     Rows and columns on the left of it must have been reduced.
+		 * @param pBlock
+		 *     Memory block for reflectors.
+		 *     Must have at least `M + N` elements.
+		 * @param[out] tauQ
+		 *     Where gammas of left reflectors are to be stored.
+		 * @param[out] tauP
+		 *     Where gammas of right reflectors are to be stored.
+		 */
+		template < typename T >
+		static void bidiagonalizeColumns(BasicMatrixView< T > m,
+										 int first,
+										 T* pBlock,
+										 T tauQ[],
+										 T tauP[])
+		{
+			const int M = m.rows();
+			const int N = m.columns();
+			assert(M >= N);
+			for (int i = first; i < N; ++i) {
+				// applies a householder transform to the column vector i
+				// columns on the left of i are already zero below the row i
+				BasicDynamicReflector< T > rU(m.column(i).slice(i), pBlock);
+				rU.applyFromLeftInPlace(m, i);
+				store(rU, m.column(i).slice(i));
+				tauQ[i] = rU.getGamma();
+				if (i < N - 1) {
+					// applies a householder transform to the row vector i + 1
+					// rows above i are already zero right of the column i
+					BasicDynamicReflector< T > rV(
+						m.row(i).slice(i + 1), pBlock + M);
+					rV.applyFromRightInPlace(m, i);
+					store(rV, m.row(i).slice(i + 1));
+					tauP[i] = rV.getGamma();
+				}
+			}
+		}
+
+		/**
+		 * Reduces a panel of columns and rows of a given matrix like
+		 * LAPACK's `dlabrd`.
+		 *
+		 * Reduces the rows and columns `p, ..., p + BIDIAGONAL_BLOCK_SIZE - 1`
+		 * but does not update the rest of the matrix.
+		 * Instead, forms `X` and `Y` such that the rest is updated by
+		 * \f$\mathbf{A} - \mathbf{V} \mathbf{Y}^T - \mathbf{X} \mathbf{U}^T\f$,
+		 * where the columns of \f$\mathbf{V}\f$ and \f$\mathbf{U}\f$ are the
+		 * u vectors of the left and right reflectors of the panel.
+		 * Each column and row of the panel is updated by the previous
+		 * reflectors of the panel just before it is reduced.
+		 *
+		 * Diagonal and upper-diagonal elements of the panel are stored in
+		 * `b`, and `m` keeps the implicit first elements 1 of the u vectors
+		 * in their places until `updateTrailing`.
+		 *
+		 * @param[in,out] m
+		 *     Matrix to be bidiagonalized.
+		 *     Must have more than `p + BIDIAGONAL_BLOCK_SIZE` columns.
+		 * @param[out] b
+		 *     Where the diagonal and upper-diagonal elements of the panel
+		 *     are to be stored.
+		 * @param p
+		 *     Index of the first row and column of the panel.
+		 * @param pBlock
+		 *     Memory block for reflectors.
+		 *     Must have at least `M + N` elements.
+		 * @param[out] tauQ
+		 *     Where gammas of left reflectors are to be stored.
+		 * @param[out] tauP
+		 *     Where gammas of right reflectors are to be stored.
+		 * @param[out] w
+		 *     `M` x `2 * BIDIAGONAL_BLOCK_SIZE` column-major block whose
+		 *     first half is to be filled with `X`.
+		 *     Every row is indexed by the row of `m`.
+		 * @param[out] z
+		 *     `N` x `2 * BIDIAGONAL_BLOCK_SIZE` column-major block whose
+		 *     second half is to be filled with `Y`.
+		 *     Every row is indexed by the column of `m`.
+		 */
+		template < typename T >
+		static void reducePanel(BasicMatrixView< T > m,
+								BasicBidiagonalMatrix< T >& b,
+								int p,
+								T* pBlock,
+								T tauQ[],
+								T tauP[],
+								T* w,
+								T* z)
+		{
+			const int M = m.rows();
+			const int N = m.columns();
+			const int NB = BIDIAGONAL_BLOCK_SIZE;
+			const BasicVectorKernel< T >& kernel =
+				BasicVectorKernel< T >::best();
+			T* x = w;
+			T* y = z + NB * N;
+			for (int j = 0; j < NB; ++j) {
+				const int i = p + j;
+				T* xj = x + j * M;
+				T* yj = y + j * N;
+				// updates the column i
+				// A(i:, i) -= A(i:, p:i) * Y(i, :)^T + X(i:, :) * A(p:i, i)
+				Vector< T > ui = m.column(i).slice(i);
+				for (int l = 0; l < j; ++l) {
+					Vector< T > vl = m.column(p + l).slice(i);
+					kernel.axpy(M - i, -y[l * N + i],
+								vl.data(), vl.stride(),
+								ui.data(), ui.stride());
+					kernel.axpy(M - i, -m(p + l, i),
+								x + l * M + i, 1,
+								ui.data(), ui.stride());
+				}
+				b.diagonal(i) = makeReflector(ui, pBlock, tauQ[i]);
+				// Y(i+1:, j) = tauQ * (A(i:, i+1:)^T * u
+				//     - Y(i+1:, :) * A(i:, p:i)^T * u
+				//     - A(p:i, i+1:)^T * X(i:, :)^T * u)
+				// products with u are kept in the unused rows p:i
+				for (int l = 0; l < j; ++l) {
+					Vector< T > vl = m.column(p + l).slice(i);
+					yj[p + l] = kernel.dot(M - i,
+										   vl.data(), vl.stride(),
+										   ui.data(), ui.stride());
+					xj[p + l] = kernel.dot(M - i,
+										   x + l * M + i, 1,
+										   ui.data(), ui.stride());
+				}
+				for (int c = i + 1; c < N; ++c) {
+					Vector< T > ac = m.column(c).slice(i);
+					T sum = kernel.dot(M - i,
+									   ac.data(), ac.stride(),
+									   ui.data(), ui.stride());
+					for (int l = 0; l < j; ++l) {
+						sum -= y[l * N + c] * yj[p + l] +
+							m(p + l, c) * xj[p + l];
+					}
+					yj[c] = tauQ[i] * sum;
+				}
+				// updates the row i
+				// A(i, i+1:) -= Y(i+1:, :) * A(i, p:i+1)^T
+				//     + A(p:i, i+1:)^T * X(i, :)^T
+				for (int c = i + 1; c < N; ++c) {
+					T sum = 0;
+					for (int l = 0; l <= j; ++l) {
+						sum += y[l * N + c] * m(i, p + l);
+					}
+					for (int l = 0; l < j; ++l) {
+						sum += m(p + l, c) * x[l * M + i];
+					}
+					m(i, c) -= sum;
+				}
+				Vector< T > vi = m.row(i).slice(i + 1);
+				b.upperDiagonal(i) = makeReflector(vi, pBlock + M, tauP[i]);
+				// X(i+1:, j) = tauP * (A(i+1:, i+1:) * v
+				//     - A(i+1:, p:i+1) * Y(i+1:, :)^T * v
+				//     - X(i+1:, :) * A(p:i, i+1:) * v)
+				for (int l = 0; l <= j; ++l) {
+					xj[p + l] = kernel.dot(N - i - 1,
+										   y + l * N + i + 1, 1,
+										   vi.data(), vi.stride());
+				}
+				T* xBelow = xj + i + 1;
+				std::fill(xBelow, xj + M, T(0));
+				for (int c = i + 1; c < N; ++c) {
+					Vector< T > ac = m.column(c).slice(i + 1);
+					kernel.axpy(M - i - 1, m(i, c),
+								ac.data(), ac.stride(),
+								xBelow, 1);
+				}
+				for (int l = 0; l <= j; ++l) {
+					Vector< T > vl = m.column(p + l).slice(i + 1);
+					kernel.axpy(M - i - 1, -xj[p + l],
+								vl.data(), vl.stride(),
+								xBelow, 1);
+				}
+				for (int l = 0; l < j; ++l) {
+					Vector< T > al = m.row(p + l).slice(i + 1);
+					xj[p + l] = kernel.dot(N - i - 1,
+										   al.data(), al.stride(),
+										   vi.data(), vi.stride());
+				}
+				for (int l = 0; l < j; ++l) {
+					kernel.axpy(M - i - 1, -xj[p + l],
+								x + l * M + i + 1, 1,
+								xBelow, 1);
+				}
+				kernel.scale(M - i - 1, tauP[i], xBelow, 1);
+			}
+		}
+
+		/**
+		 * Applies the reflectors of a panel reduced by `reducePanel` to the
+		 * rest of a given matrix.
+		 *
+		 * Computes
+		 * \f$\mathbf{A} - [\mathbf{X} \mathbf{V}] [\mathbf{U} \mathbf{Y}]^T\f$
+		 * with `Gemm` for a block of `Gemm::MC` columns at a time.
+		 * Then puts the diagonal and upper-diagonal elements of the panel
+		 * back in place of the implicit first elements of the u vectors.
+		 *
+		 * @param[in,out] m
+		 *     Matrix to be bidiagonalized.
+		 * @param b
+		 *     Bidiagonal matrix whose elements of the panel are given by
+		 *     `reducePanel`.
+		 * @param p
+		 *     Index of the first row and column of the panel.
+		 * @param w
+		 *     Block given to `reducePanel`.
+		 *     Its second half is overwritten with `V`.
+		 * @param z
+		 *     Block given to `reducePanel`.
+		 *     Its first half is overwritten with `U`.
+		 * @param product
+		 *     Work space.
+		 *     Must have at least
+		 *     `Gemm::MC * M + Gemm::packingSize(Gemm::MC, M, 2 * NB)`
+		 *     elements where `NB = BIDIAGONAL_BLOCK_SIZE`.
+		 *     Operands of products are packed after the first
+		 *     `Gemm::MC * M` elements.
+		 */
+		template < typename T >
+		static void updateTrailing(BasicMatrixView< T > m,
+								   const BasicBidiagonalMatrix< T >& b,
+								   int p,
+								   T* w,
+								   T* z,
+								   T* product)
+		{
+			const int M = m.rows();
+			const int N = m.columns();
+			const int NB = BIDIAGONAL_BLOCK_SIZE;
+			const int k = p + NB;
+			const int R = M - k;
+			T* packing = product + Gemm::MC * M;
+			// gathers V and U next to X and Y
+			for (int l = 0; l < NB; ++l) {
+				T* vl = w + (NB + l) * M;
+				T* ul = z + l * N;
+				for (int i = k; i < M; ++i) {
+					vl[i] = m(i, p + l);
+				}
+				for (int j = k; j < N; ++j) {
+					ul[j] = m(p + l, j);
+				}
+			}
+			for (int i = p; i < k; ++i) {
+				m(i, i) = b(i, i);
+				m(i, i + 1) = b(i, i + 1);
+			}
+			// the transposed product of a block of columns is laid out
+			// like the columns
+			for (int c0 = k; c0 < N; c0 += Gemm::MC) {
+				const int C = (N - c0 < Gemm::MC) ? N - c0 : Gemm::MC;
+				Gemm::multiplyStridedBuffered(C, R, 2 * NB,
+											  z + c0, 1, N,
+											  w + k, M, 1,
+											  product, R,
+											  packing);
+				for (int j = 0; j < C; ++j) {
+					Vector< T > aj = m.column(c0 + j).slice(k);
+					const T* pj = product + j * R;
+					for (int i = 0; i < R; ++i) {
+						aj[i] -= pj[i];
+					}
+				}
+			}
+		}
+
+		/**
+		 * Replaces a given vector with the u vector of the reflector that
+		 * zeroes all but its first element.
+		 *
+		 * The first element of the u vector, which is 1, is also stored.
+		 *
+		 * @param[in,out] v
+		 *     Vector to be reflected.
+		 * @param pBlock
+		 *     Memory block for the reflector.
+		 *     Must have at least `v.size()` elements.
+		 * @param[out] gamma
+		 *     Where the gamma of the reflector is to be stored.
+		 * @return
+		 *     First element of the reflected vector.
+		 */
+		template < typename T >
+		static T makeReflector(Vector< T > v, T* pBlock, T& gamma) {
+			BasicDynamicReflector< T > r(v, pBlock);
+			const Vector< T >& u = r.getU();
+			gamma = r.getGamma();
+			// the first element of H * v
+			const T beta = v[0] - gamma * BasicVectorKernel< T >::best().dot(
+				v.size(), u.data(), u.stride(), v.data(), v.stride());
+			store(r, v);
+			v[0] = 1;
+			return beta;
+		}
+
+		/**
+		 * Forms left-singular-vectors from reflectors stored in a given
+		 * matrix.
+		 *
+		 * Accumulates reflectors backward, so that only the columns of `u`
+		 * to be computed are touched.
+		 * Works like LAPACK's `dorgbr`.
+		 *
+		 * Bidiagonal elements of `m` are destroyed.
+		 *
+		 * @param[out] u
+		 *     Where left-singular-vectors are to be stored.
+		 *     `M` x `M` or `M` x `N`.
+		 * @param[in,out] m
+		 *     Matrix bidiagonalized by `bidiagonalize`.
+		 * @param tauQ
+		 *     Gammas of left reflectors given by `bidiagonalize`.
+		 */
+		template < typename T >
+		static void accumulateLeftReflectors(BasicMatrixView< T > u,
+											 BasicMatrixView< T > m,
+											 const T tauQ[])
+		{
+			makeIdentity(u);
+			for (int i = m.columns() - 1; i >= 0; --i) {
+				// columns on the left of i are not affected yet
+				m(i, i) = 1.0;
+				BasicDynamicReflector< T >::wrap(m.column(i).slice(i), tauQ[i])
+					.applyFromLeftInPlace(u, i);
+			}
+		}
+
+		/**
+		 * Forms right-singular-vectors from reflectors stored in a given
+		 * matrix.
+		 *
+		 * Accumulates reflectors backward like
+		 * `accumulateLeftReflectors`.
+		 *
+		 * Bidiagonal elements of `m` are destroyed.
+		 *
+		 * @param[out] v
+		 *     Where right-singular-vectors are to be stored.
+		 *     `N` x `N`.
+		 * @param[in,out] m
+		 *     Matrix bidiagonalized by `bidiagonalize`.
+		 * @param tauP
+		 *     Gammas of right reflectors given by `bidiagonalize`.
+		 */
+		template < typename T >
+		static void accumulateRightReflectors(BasicMatrixView< T > v,
+											  BasicMatrixView< T > m,
+											  const T tauP[])
+		{
+			makeIdentity(v);
+			for (int i = m.columns() - 2; i >= 0; --i) {
+				// columns on the left of i + 1 are not affected yet
+				m(i, i + 1) = 1.0;
+				BasicDynamicReflector< T >::wrap(m.row(i).slice(i + 1), tauP[i])
+					.applyFromLeftInPlace(v, i + 1);
+			}
+		}
+
+		/**
+		 * Stores the u vector of a given reflector except for its first
+		 * element.
+		 *
+		 * @param r
+		 *     Reflector to be stored.
+		 * @param[out] dst
+		 *     Where the u vector is to be stored.
+		 *     The first element is left untouched.
+		 */
+		template < typename T >
+		static void store(const BasicDynamicReflector< T >& r,
+						  Vector< T > dst)
+		{
+			const Vector< T >& u = r.getU();
+			for (size_t i = 1; i < u.size(); ++i) {
+				dst[i] = u[i];
+			}
+		}
+
+		/**
+		 * Repeats Francis iterations over a given block until it converges.
+		 *
+		 * Negligible elements are zeroed and the lowest unreduced block
+		 * `[lo, hi)` is swept, so converged parts cost nothing.
+		 * If `pBlocks` is given and the part above `lo` is large enough,
+		 * that part is handed to it as another task.
+		 * Those tasks never share rows or columns of `m`, `u` and `v`,
+		 * because the upper-diagonal element between them is 0.
+		 *
+		 * If `m` has at least `MIN_WAVEFRONT_SIZE` rows, or if `pBlocks` is
+		 * given and singular vectors have at least `2 * MIN_CONCURRENT_ROWS`
+		 * rows, rotations of up to `RotationSequence::MAX_SWEEPS` Francis
+		 * iterations are recorded in `rotations` and then applied at once
+		 * by `applyRotations`.
+		 * Recorded rotations are also applied before singular vectors are
+		 * otherwise updated, before the upper part is handed to the pool,
+		 * and before a sweep leaves the columns of the first recorded one.
+		 *
+		 * Gives up after `MAX_ITERATIONS_PER_ROW * (hi - lo)` iterations.
+		 *
+		 * @param[in,out] u
+		 *     Left-singular-vectors to be updated.
+		 *     Not updated if it has no columns.
+		 * @param[in,out] m
+		 *     Bidiagonal matrix to be diagonalized.
+		 * @param[in,out] v
+		 *     Right-singular-vectors to be updated.
+		 *     Not updated if it has no columns.
+		 * @param lo
+		 *     Index of the first row and column of the block.
+		 * @param hi
+		 *     Index next to the last row and column of the block.
+		 * @param smallDiagonal
+		 *     Diagonal elements whose magnitude does not exceed this value
+		 *     are regarded as 0.
+		 * @param rotations
+		 *     Memory block where rotations are recorded.
+		 *     Must have at least `rotationWorkSize(u.rows(), m.size())`
+		 *     elements.
+		 *     Rotations are recorded at the columns they rotate, so blocks
+		 *     iterated concurrently share it without overlapping.
+		 * @param pBlocks
+		 *     Group of tasks to which upper blocks are handed.
+		 *     Its pool also rotates row blocks of singular vectors.
+		 *     Blocks are iterated on the calling thread if this is 0.
+		 */
+		template < typename T >
+		static void iterateBlock(BasicMatrixView< T > u,
+								 BasicBidiagonalMatrix< T >& m,
+								 BasicMatrixView< T > v,
+								 int lo,
+								 int hi,
+								 T smallDiagonal,
+								 T* rotations,
+								 ThreadPool::TaskGroup* pBlocks)
+		{
+			const T TOLERANCE = tolerance< T >();
+			ThreadPool* pPool = (pBlocks != 0) ? &pBlocks->pool() : 0;
+			const int N = m.size();
+			const bool recordsU = u.columns() > 0 &&
+				(N >= MIN_WAVEFRONT_SIZE ||
+				 (pPool != 0 && u.rows() >= 2 * MIN_CONCURRENT_ROWS));
+			const bool recordsV = v.columns() > 0 &&
+				(N >= MIN_WAVEFRONT_SIZE ||
+				 (pPool != 0 && v.rows() >= 2 * MIN_CONCURRENT_ROWS));
+			BasicRotationSequence< T > uSweeps(rotations, N);
+			BasicRotationSequence< T > vSweeps(
+				recordsV
+					? rotations + BasicRotationSequence< T >::blockSize(N)
+					: rotations,
+				N);
+			BasicRotationSequence< T >* pUSweeps = recordsU ? &uSweeps : 0;
+			BasicRotationSequence< T >* pVSweeps = recordsV ? &vSweeps : 0;
+			const int maxIterations = MAX_ITERATIONS_PER_ROW * (hi - lo);
+			int iteration = 0;
+			while (hi - lo >= 2) {
+				// zeroes negligible elements in the unconverged part
+				for (int i = lo; i < hi; ++i) {
+					if (std::abs(m(i, i)) <= smallDiagonal) {
+						m.diagonal(i) = 0.0;
+					}
+				}
+				for (int i = lo; i + 1 < hi; ++i) {
+					T g = std::abs(m(i, i + 1));
+					if (g <= TOLERANCE * (std::abs(m(i, i)) +
+										  std::abs(m(i + 1, i + 1))))
+					{
+						m.upperDiagonal(i) = 0.0;
+					}
+				}
+				// the bottom element has converged if it is isolated
+				if (m(hi - 2, hi - 1) == 0.0) {
+					--hi;
+					continue;
+				}
+				// finds the lowest unreduced block [top, hi)
+				int top = hi - 2;
+				while (top > lo && m(top - 1, top) != 0.0) {
+					--top;
+				}
+				// hands the upper part to another thread
+				if (pBlocks != 0 && top - lo >= MIN_CONCURRENT_BLOCK_SIZE) {
+					// the upper part may have rotations not applied yet
+					applyRotations(u, uSweeps, pPool);
+					applyRotations(v, vSweeps, pPool);
+					const int upperLo = lo;
+					const int upperHi = top;
+					BasicBidiagonalMatrix< T >* pM = &m;
+					pBlocks->submit([=]() {
+						iterateBlock(u,
+									 *pM,
+									 v,
+									 upperLo,
+									 upperHi,
+									 smallDiagonal,
+									 rotations,
+									 pBlocks);
+					});
+					lo = top;
+				}
+				// splits the block at a zero diagonal element
+				if (m(hi - 1, hi - 1) == 0.0) {
+					applyRotations(v, vSweeps, pPool);
+					chaseZeroLastDiagonal(m, v, top, hi);
+					continue;
+				}
+				int k = top;
+				while (k + 1 < hi && m(k, k) != 0.0) {
+					++k;
+				}
+				if (k + 1 < hi) {
+					applyRotations(u, uSweeps, pPool);
+					chaseZeroDiagonal(u, m, k, hi);
+					continue;
+				}
+				// aborts if too many iterations
+				++iteration;
+				if (iteration > maxIterations) {
+					break;
+				}
+				// a sequence only takes sweeps within its first one
+				if (!uSweeps.accepts(top, hi)) {
+					applyRotations(u, uSweeps, pPool);
+				}
+				if (!vSweeps.accepts(top, hi)) {
+					applyRotations(v, vSweeps, pPool);
+				}
+				doFrancis(u, m, v, top, hi, pUSweeps, pVSweeps);
+				if (uSweeps.isFull()) {
+					applyRotations(u, uSweeps, pPool);
+				}
+				if (vSweeps.isFull()) {
+					applyRotations(v, vSweeps, pPool);
+				}
+			}
+			applyRotations(u, uSweeps, pPool);
+			applyRotations(v, vSweeps, pPool);
+		}
+
+		/**
+		 * Performs a single Francis iteration over a given block.
+		 *
+		 * Only the block from the row and column `lo` to `hi - 1` of `m` is
+		 * swept.
+		 * The block must be unreduced; i.e., the upper-diagonal elements at
+		 * (lo - 1, lo) and (hi - 1, hi) must be 0 if they exist.
+		 *
+		 * The behavior is undefined if `lo < 0`, `hi - lo < 2` or
+		 * `hi > m.size()`.
+		 *
+		 * @param[in,out] u
+		 *     Left-singular-vectors to be updated.
+		 *     Not updated if it has no columns.
+		 * @param[in,out] m
+		 *     Bidiagonalized input matrix where diagonal elements are to be
+		 *     singular values after convergence.
+		 * @param[in,out] v
+		 *     Right-singular-vectors to be updated.
+		 *     Not updated if it has no columns.
+		 * @param lo
+		 *     Index of the first row and column of the block.
+		 * @param hi
+		 *     Index next to the last row and column of the block.
+		 * @param[in,out] pUSweeps
+		 *     Sequence to which rotations for `u` are added as a new sweep
+		 *     instead of being applied.
+		 *     Must not be full.
+		 *     `u` is updated in place if this is 0.
+		 * @param[in,out] pVSweeps
+		 *     Sequence to which rotations for `v` are added as a new sweep
+		 *     instead of being applied.
+		 *     Must not be full.
+		 *     `v` is updated in place if this is 0.
+		 */
+		template < typename T >
+		static void doFrancis(BasicMatrixView< T > u,
+							  BasicBidiagonalMatrix< T >& m,
+							  BasicMatrixView< T > v,
+							  int lo,
+							  int hi,
+							  BasicRotationSequence< T >* pUSweeps = 0,
+							  BasicRotationSequence< T >* pVSweeps = 0)
+		{
+			assert(lo >= 0 && hi - lo >= 2 && hi <= m.size());
+			const bool updatesU = u.columns() > 0 && pUSweeps == 0;
+			const bool updatesV = v.columns() > 0 && pVSweeps == 0;
+			if (pUSweeps != 0) {
+				pUSweeps->addSweep(lo, hi);
+			}
+			if (pVSweeps != 0) {
+				pVSweeps->addSweep(lo, hi);
+			}
+			// calculates the shift
+			T rho = calculateShift(m, hi);
+			// applies the first right rotator
+			T b1 = m(lo, lo);
+			T g1 = m(lo, lo + 1);
+			T mx =
+				std::max(std::abs(rho), std::max(std::abs(b1), std::abs(g1)));
+			rho /= mx;
+			b1 /= mx;
+			g1 /= mx;
+			BasicRotator< T > r0(b1 * b1 - rho * rho, b1 * g1);
+			T bulge = m.applyFirstRotatorFromRight(r0, lo);
+			if (updatesV) {
+				r0.applyFromRightInPlace(v, lo);
+			} else if (pVSweeps != 0) {
+				pVSweeps->record(r0, lo);
+			}
+			// applies the first left rotator
+			BasicRotator< T > r1(m(lo, lo), bulge);
+			bulge = m.applyRotatorFromLeft(r1, lo, bulge);
+			if (updatesU) {
+				r1.applyFromRightInPlace(u, lo);  // U1^T*U0^T = U0*U1
+			} else if (pUSweeps != 0) {
+				pUSweeps->record(r1, lo);
+			}
+			for (int i = lo + 1; i + 1 < hi; ++i) {
+				// calculates (i+1)-th right rotator
+				BasicRotator< T > rV(m(i - 1, i), bulge);
+				bulge = m.applyRotatorFromRight(rV, i, bulge);
+				if (updatesV) {
+					rV.applyFromRightInPlace(v, i);
+				} else if (pVSweeps != 0) {
+					pVSweeps->record(rV, i);
+				}
+				// calculates (i+1)-th left rotator
+				BasicRotator< T > rU(m(i, i), bulge);
+				bulge = m.applyRotatorFromLeft(rU, i, bulge);
+				if (updatesU) {
+					rU.applyFromRightInPlace(u, i);  // U1^T*U0^T = U0*U1
+				} else if (pUSweeps != 0) {
+					pUSweeps->record(rU, i);
+				}
+			}
+		}
+
+		/**
+		 * Applies rotations recorded in a given sequence to a given matrix
+		 * from right and clears the sequence.
+		 *
+		 * Every row of `m` is rotated independently of the others.
+		 * So if `pPool` is given, the rows are split into blocks of at
+		 * least `MIN_CONCURRENT_ROWS` rows and every block is rotated
+		 * by the whole sequence on a different thread.
+		 *
+		 * @param[in,out] m
+		 *     Matrix to be rotated.
+		 *     Not rotated if it has no columns.
+		 * @param[in,out] sweeps
+		 *     Rotations recorded by `doFrancis`.
+		 *     Empty after this call.
+		 * @param pPool
+		 *     Thread pool on which row blocks are rotated.
+		 *     All of the rows are rotated on the calling thread if this is
+		 *     0.
+		 *     May be called from a task on `pPool`.
+		 */
+		template < typename T >
+		static void applyRotations(BasicMatrixView< T > m,
+								   BasicRotationSequence< T >& sweeps,
+								   ThreadPool* pPool)
+		{
+			if (sweeps.size() == 0 || m.columns() == 0) {
+				sweeps.clear();
+				return;
+			}
+			const int M = m.rows();
+			const int numBlocks = (pPool != 0)
+				? std::min(pPool->size(), M / MIN_CONCURRENT_ROWS)
+				: 1;
+			if (numBlocks <= 1) {
+				sweeps.applyFromRight(m);
+			} else {
+				const BasicRotationSequence< T >* pSweeps = &sweeps;
+				pPool->runConcurrently(numBlocks, [=](int block) {
+					const int top = M * block / numBlocks;
+					const int bottom = M * (block + 1) / numBlocks;
+					pSweeps->applyFromRight(
+						BasicMatrixView< T >(&m(top, 0),
+											 bottom - top,
+											 m.columns(),
+											 m.leadingDimension(),
+											 m.layout()));
+				});
+			}
+			sweeps.clear();
+		}
+
+		/**
+		 * Chases out the upper-diagonal element in a row whose diagonal
+		 * element is 0.
+		 *
+		 * Applies rotators to the rows `k` and `j` from the left for
+		 * `j = k + 1, ..., hi - 1` so that the row `k` becomes 0.
+		 * The block then splits at `k`.
+		 *
+		 * The behavior is undefined,
+		 *  - if `m(k, k) != 0`,
+		 *  - or if `k < 0` or `k + 1 >= hi` or `hi > m.size()`
+		 *
+		 * @param[in,out] u
+		 *     Left-singular-vectors to be updated.
+		 *     Not updated if it has no columns.
+		 * @param[in,out] m
+		 *     Bidiagonal matrix whose row `k` is to be zeroed.
+		 * @param k
+		 *     Index of the row whose diagonal element is 0.
+		 * @param hi
+		 *     Index next to the last row and column of the block.
+		 */
+		template < typename T >
+		static void chaseZeroDiagonal(BasicMatrixView< T > u,
+									  BasicBidiagonalMatrix< T >& m,
+									  int k,
+									  int hi)
+		{
+			assert(k >= 0 && k + 1 < hi && hi <= m.size());
+			assert(m(k, k) == 0.0);
+			T f = m.upperDiagonal(k);
+			m.upperDiagonal(k) = 0.0;
+			for (int j = k + 1; j < hi && f != 0.0; ++j) {
+				BasicRotator< T > r(m(j, j), f);
+				T cs = r(0, 0);
+				T sn = r(1, 0);
+				m.diagonal(j) = cs * m(j, j) + sn * f;
+				if (j + 1 < hi) {
+					T g = m(j, j + 1);
+					f = -sn * g;
+					m.upperDiagonal(j) = cs * g;
+				}
+				if (u.columns() > 0) {
+					rotateColumns(u, j, k, cs, sn);
+				}
+			}
+		}
+
+		/**
+		 * Chases out the upper-diagonal element above the last diagonal
+		 * element of a block that is 0.
+		 *
+		 * Applies rotators to the columns `j` and `hi - 1` from the right for
+		 * `j = hi - 2, ..., lo` so that the column `hi - 1` becomes 0.
+		 * The block then splits at `hi - 1`.
+		 *
+		 * The behavior is undefined,
+		 *  - if `m(hi - 1, hi - 1) != 0`,
+		 *  - or if `lo < 0` or `lo + 1 >= hi` or `hi > m.size()`
+		 *
+		 * @param[in,out] m
+		 *     Bidiagonal matrix whose column `hi - 1` is to be zeroed.
+		 * @param[in,out] v
+		 *     Right-singular-vectors to be updated.
+		 *     Not updated if it has no columns.
+		 * @param lo
+		 *     Index of the first row and column of the block.
+		 * @param hi
+		 *     Index next to the last row and column of the block.
+		 */
+		template < typename T >
+		static void chaseZeroLastDiagonal(BasicBidiagonalMatrix< T >& m,
+										  BasicMatrixView< T > v,
+										  int lo,
+										  int hi)
+		{
+			assert(lo >= 0 && lo + 1 < hi && hi <= m.size());
+			assert(m(hi - 1, hi - 1) == 0.0);
+			const int last = hi - 1;
+			T f = m.upperDiagonal(last - 1);
+			m.upperDiagonal(last - 1) = 0.0;
+			for (int j = last - 1; j >= lo && f != 0.0; --j) {
+				BasicRotator< T > r(m(j, j), f);
+				T cs = r(0, 0);
+				T sn = r(1, 0);
+				m.diagonal(j) = cs * m(j, j) + sn * f;
+				if (j > lo) {
+					T g = m(j - 1, j);
+					f = -sn * g;
+					m.upperDiagonal(j - 1) = cs * g;
+				}
+				if (v.columns() > 0) {
+					rotateColumns(v, j, last, cs, sn);
+				}
+			}
+		}
+
+		/**
+		 * Rotates given two columns in a given matrix.
+		 *
+		 * Replaces the columns \f$m_{j_1}\f$ and \f$m_{j_2}\f$ with
+		 * \f$c m_{j_1} + s m_{j_2}\f$ and \f$-s m_{j_1} + c m_{j_2}\f$
+		 * respectively.
+		 * Unlike `Rotator`, the columns need not be adjacent.
+		 * Contiguous columns, and adjacent columns of a row-major matrix
+		 * are rotated by `RotationKernel` for the CPU.
+		 *
+		 * @param[in,out] m
+		 *     Matrix whose columns are to be rotated.
+		 * @param j1
+		 *     Index of the first column.
+		 * @param j2
+		 *     Index of the second column.
+		 * @param cs
+		 *     Cosine of the rotation.
+		 * @param sn
+		 *     Sine of the rotation.
+		 */
+		template < typename T >
+		static void rotateColumns(BasicMatrixView< T > m,
+								  int j1,
+								  int j2,
+								  T cs,
+								  T sn)
+		{
+			Vector< T > c1 = m.column(j1);
+			Vector< T > c2 = m.column(j2);
+			if (c1.stride() == 1 && c2.stride() == 1) {
+				BasicRotationKernel< T >::best().rotateRows(
+					c1.data(), c2.data(), c1.size(), cs, sn);
+				return;
+			}
+			if (c2.data() == c1.data() + 1 && c1.stride() == c2.stride()) {
+				BasicRotationKernel< T >::best().rotatePairs(
+					c1.data(), c1.size(), c1.stride(), cs, sn);
+				return;
+			}
+			for (int i = 0; i < m.rows(); ++i) {
+				T x1 = m(i, j1);
+				T x2 = m(i, j2);
+				m(i, j1) = cs * x1 + sn * x2;
+				m(i, j2) = -sn * x1 + cs * x2;
+			}
+		}
+
+		/**
+		 * Calculates the shift for a given bidiagonal matrix.
+		 *
+		 * The shift is calculated from the 2 x 2 submatrix that ends at the
+		 * row and column `n - 1`; i.e., the bottom of the block being swept.
+		 *
+		 * The behavior is undefined if `n < 2` or `n > m.size()`.
+		 *
+		 * @param m
+		 *     Bidiagonal matrix from which a shift is to be calculated.
+		 * @param n
+		 *     Index next to the last row and column of the block.
+		 * @return
+		 *     Shift for the block that ends at the row and column `n - 1`.
+		 */
+		template < typename T >
+		static T calculateShift(const BasicBidiagonalMatrix< T >& m, int n) {
+			assert(n >= 2 && n <= m.size());
+			T b1 = m(n - 2, n - 2);
+			T b2 = m(n - 1, n - 1);
+			T g1 = m(n - 2, n - 1);
+			// solves lambda^4 - d*lambda^2 + e = 0
+			// where
+			//  d = b1^2 + b2^2 + g1^2
+			//  e = b1^2 * b2^2
+			// chooses lambda (rho) closest to b2
+			T rho;
+			T d = b1 * b1 + b2 * b2 + g1 * g1;
+			T e = b1 * b1 * b2 * b2;
+			// lambda^2 = (d +- sqrt(d^2 - 4e)) / 2
+			// so, f = d^2 - 4e must be positive
+			T f = d * d - 4 * e;
+			if (f >= 0) {
+				f = std::sqrt(f);
+				// lambda = +-sqrt(d +- f)  (d >= 0, f >= 0)
+				// if d > f, both d+f and d-f have real square roots
+				// otherwise considers only d+f
+				if (d > f) {
+					// lets l1 > l2
+					T l1 = std::sqrt((d + f) * T(0.5));
+					T l2 = std::sqrt((d - f) * T(0.5));
+					// if b2 >= 0, chooses a positive shift
+					// otherwise chooses a negative shift
+					if (b2 >= 0) {
+						if (std::abs(b2 - l1) < std::abs(b2 - l2)) {
+							rho = l1;
+						} else {
+							rho = l2;
+						}
+					} else {
+						if (std::abs(b2 + l1) < std::abs(b2 + l2)) {
+							rho = -l1;
+						} else {
+							rho = -l2;
+						}
+					}
+				} else {
+					T l1 = std::sqrt((d + f) * T(0.5));
+					if (std::abs(b2 - l1) <= std::abs(b2 + l1)) {
+						rho = l1;
+					} else {
+						rho = -l1;
+					}
+				}
+			} else {
+				// no solution. chooses b2 as the shift
+				rho = b2;
+			}
+			return rho;
+		}
+
+		/**
+		 * Computes singular values of a given bidiagonal matrix.
+		 *
+		 * Uses the differential quotient-difference algorithm with shifts
+		 * (dqds) which computes singular values to high relative accuracy.
+		 * Singular vectors cannot be computed by this algorithm.
+		 *
+		 * Works on squares of elements of `b` in a qd array.
+		 * Shifts are taken from the trailing 2 x 2 block of the qd array,
+		 * and a lower bound of the smallest singular value if they are too
+		 * large.
+		 *
+		 * @param b
+		 *     Bidiagonal matrix whose singular values are to be computed.
+		 * @param pBlock
+		 *     Memory block for qd arrays.
+		 *     Must have at least `4 * b.size()` elements.
+		 * @param[out] ss
+		 *     Where singular values are to be stored in descending order.
+		 *     Must have at least `b.size()` elements.
+		 */
+		template < typename T >
+		static void computeSingularValues(const BasicBidiagonalMatrix< T >& b,
+										  T* pBlock,
+										  T ss[])
+		{
+			const int N = b.size();
+			const T EPSILON = std::numeric_limits< T >::epsilon();
+			const T TOLERANCE2 = (EPSILON * 100) * (EPSILON * 100);
+			const int MAX_ITERATIONS = N * 30;
+			// scales elements so that squares neither overflow nor underflow
+			T scale = 0.0;
+			for (int i = 0; i < N; ++i) {
+				scale = std::max(std::abs(b(i, i)), scale);
+				if (i + 1 < N) {
+					scale = std::max(std::abs(b(i, i + 1)), scale);
+				}
+			}
+			if (scale == 0.0) {
+				std::fill(ss, ss + N, 0.0);
+				return;
+			}
+			// builds the qd array
+			T* q = pBlock;
+			T* e = q + N;
+			T* q2 = e + N;
+			T* e2 = q2 + N;
+			for (int i = 0; i < N; ++i) {
+				T x = b(i, i) / scale;
+				q[i] = x * x;
+				if (i + 1 < N) {
+					x = b(i, i + 1) / scale;
+					e[i] = x * x;
+				}
+			}
+			// squares of singular values are q[i] + sigma after convergence
+			T sigma = 0.0;
+			int iteration = 0;
+			int n = N;
+			while (n > 0) {
+				if (n == 1 || e[n - 2] <= TOLERANCE2 * (sigma + q[n - 1])) {
+					// deflates the last element
+					ss[n - 1] = q[n - 1] + sigma;
+					--n;
+					continue;
+				}
+				// aborts if too many iterations
+				++iteration;
+				if (iteration > MAX_ITERATIONS) {
+					break;
+				}
+				// tries an aggressive shift first
+				// and falls back on safer shifts
+				T tau = calculateQdShift(q, e, n);
+				if (!doDqds(q, e, q2, e2, n, tau)) {
+					tau = calculateQdLowerBound(q, e, n);
+					if (!doDqds(q, e, q2, e2, n, tau)) {
+						// never fails without a shift
+						tau = 0.0;
+						doDqds(q, e, q2, e2, n, tau);
+					}
+				}
+				std::swap(q, q2);
+				std::swap(e, e2);
+				sigma += tau;
+			}
+			// takes unconverged elements as they are if aborted
+			for (int i = 0; i < n; ++i) {
+				ss[i] = q[i] + sigma;
+			}
+			for (int i = 0; i < N; ++i) {
+				ss[i] = std::sqrt(std::max(ss[i], T(0))) * scale;
+			}
+			std::sort(ss, ss + N, std::greater< T >());
+		}
+
+		/**
+		 * Performs a single dqds transform over the top-left `n` elements of
+		 * a given qd array.
+		 *
+		 * Fails if the shift is so large that the transformed qd array would
+		 * have a negative element.
+		 * A transform with no shift never fails.
+		 *
+		 * @param q
+		 *     Diagonal part of the qd array to be transformed.
+		 * @param e
+		 *     Off-diagonal part of the qd array to be transformed.
+		 * @param[out] q2
+		 *     Where the transformed diagonal part is to be stored.
+		 * @param[out] e2
+		 *     Where the transformed off-diagonal part is to be stored.
+		 * @param n
+		 *     Size of the qd array to be transformed.
+		 * @param tau
+		 *     Shift.
+		 * @return
+		 *     Whether the transform has succeeded.
+		 */
+		template < typename T >
+		static bool doDqds(const T q[],
+						   const T e[],
+						   T q2[],
+						   T e2[],
+						   int n,
+						   T tau)
+		{
+			T d = q[0] - tau;
+			if (d < 0.0) {
+				return false;
+			}
+			for (int i = 0; i + 1 < n; ++i) {
+				if (e[i] == 0.0) {
+					// the qd array is split here
+					q2[i] = d;
+					e2[i] = 0.0;
+					d = q[i + 1] - tau;
+				} else {
+					q2[i] = d + e[i];
+					T t = q[i + 1] / q2[i];
+					e2[i] = e[i] * t;
+					d = d * t - tau;
+				}
+				if (d < 0.0) {
+					return false;
+				}
+			}
+			q2[n - 1] = d;
+			return true;
+		}
+
+		/**
+		 * Calculates a shift for the top-left `n` elements of a given qd
+		 * array.
+		 *
+		 * Returns the smaller eigenvalue of the trailing 2 x 2 block of
+		 * \f$\mathbf{B}^T \mathbf{B}\f$ where \f$\mathbf{B}\f$ is the
+		 * bidiagonal matrix that the qd array represents.
+		 * This shift may be too large.
+		 *
+		 * The behavior is undefined if `n < 2`.
+		 *
+		 * @param q
+		 *     Diagonal part of the qd array.
+		 * @param e
+		 *     Off-diagonal part of the qd array.
+		 * @param n
+		 *     Size of the qd array.
+		 * @return
+		 *     Shift.
+		 */
+		template < typename T >
+		static T calculateQdShift(const T q[],
+									   const T e[],
+									   int n)
+		{
+			assert(n >= 2);
+			// [ a  c ]
+			// [ c  b ]
+			T a = q[n - 2] + (n >= 3 ? e[n - 3] : 0.0);
+			T b = q[n - 1] + e[n - 2];
+			T c2 = q[n - 2] * e[n - 2];
+			T h = (a - b) * T(0.5);
+			T r = std::sqrt(h * h + c2);
+			// smaller eigenvalue is b + h - r
+			// b - c^2 / (h + r) avoids cancellation if h >= 0
+			T lambda;
+			if (c2 == 0.0) {
+				lambda = std::min(a, b);
+			} else if (h >= 0.0) {
+				lambda = b - c2 / (h + r);
+			} else {
+				lambda = b + h - r;
+			}
+			return std::max(lambda, T(0));
+		}
+
+		/**
+		 * Calculates a lower bound of the smallest eigenvalue represented by
+		 * the top-left `n` elements of a given qd array.
+		 *
+		 * Uses Johnson's lower bound of the smallest singular value of the
+		 * bidiagonal matrix that the qd array represents.
+		 * A dqds transform with this shift succeeds unless rounding errors
+		 * spoil it.
+		 *
+		 * @param q
+		 *     Diagonal part of the qd array.
+		 * @param e
+		 *     Off-diagonal part of the qd array.
+		 * @param n
+		 *     Size of the qd array.
+		 * @return
+		 *     Lower bound of the smallest eigenvalue.
+		 *     0 if no positive lower bound is found.
+		 */
+		template < typename T >
+		static T calculateQdLowerBound(const T q[],
+											const T e[],
+											int n)
+		{
+			T bound = std::numeric_limits< T >::max();
+			T gPrevious = 0.0;
+			for (int i = 0; i < n; ++i) {
+				T g = (i + 1 < n) ? std::sqrt(e[i]) : 0.0;
+				bound = std::min(
+					std::sqrt(q[i]) - T(0.5) * (gPrevious + g), bound);
+				gPrevious = g;
+			}
+			return bound > 0.0 ? bound * bound : 0.0;
+		}
+	};
+
+	/**
+	 * Number of elements in a memory block that `SvdKernel::decomposeInPlace`
+	 * needs for an `M` x `N` matrix.
+	 *
+	 * Compile-time counterpart of `SvdKernel::workSize`.
+	 *
+	 * @tparam M
+	 *     Number of rows in the matrix to be decomposed.
+	 * @tparam N
+	 *     Number of columns in the matrix to be decomposed.
+	 */
+	template < int M, int N >
+	struct SvdWorkSize {
+		enum {
+			/** Number of elements for rotations of Francis iterations. */
+			ROTATION_VALUE = (N >= SvdKernel::MIN_WAVEFRONT_SIZE ||
+							  M >= 2 * SvdKernel::MIN_CONCURRENT_ROWS)
+				? 4 * RotationSequence::MAX_SWEEPS * N
+				: 0,
+
+			/** Number of elements for rotations of an `N` x `N` matrix. */
+			SQUARE_ROTATION_VALUE = (N >= SvdKernel::MIN_WAVEFRONT_SIZE ||
+									 N >= 2 * SvdKernel::MIN_CONCURRENT_ROWS)
+				? 4 * RotationSequence::MAX_SWEEPS * N
+				: 0,
+
+			/** Number of elements to bidiagonalize the matrix. */
+			BIDIAGONAL_VALUE = (N > SvdKernel::MIN_BLOCKED_SIZE)
+				? (M + N) * (1 + 2 * SvdKernel::BIDIAGONAL_BLOCK_SIZE) +
+					Gemm::MC * M +
+					GemmPackingSize< Gemm::MC, M,
+									 2 * SvdKernel::BIDIAGONAL_BLOCK_SIZE
+									 >::VALUE
+				: M + N,
+
+			/** Number of elements to bidiagonalize an `N` x `N` matrix. */
+			SQUARE_BIDIAGONAL_VALUE = (N > SvdKernel::MIN_BLOCKED_SIZE)
+				? 2 * N * (1 + 2 * SvdKernel::BIDIAGONAL_BLOCK_SIZE) +
+					Gemm::MC * N +
+					GemmPackingSize< Gemm::MC, N,
+									 2 * SvdKernel::BIDIAGONAL_BLOCK_SIZE
+									 >::VALUE
+				: 2 * N,
+
+			/** Number of elements for an `N` x `N` matrix. */
+			SQUARE_VALUE = (SQUARE_BIDIAGONAL_VALUE + 2 * N >
+							SQUARE_ROTATION_VALUE)
+				? SQUARE_BIDIAGONAL_VALUE + 2 * N
+				: SQUARE_ROTATION_VALUE,
+
+			/** Number of elements. */
+			VALUE = (M * 5 >= N * 8)
+				? ((M > SQUARE_VALUE ? M : SQUARE_VALUE) + N + 2 * N * N)
+				: ((BIDIAGONAL_VALUE + 2 * N > ROTATION_VALUE)
+					? BIDIAGONAL_VALUE + 2 * N
+					: ROTATION_VALUE)
+		};
+	};
+
+}
+
+#endif
@@ -0,0 +1,491 @@
+#ifndef _SINGULAR_THREAD_POOL_H
+#define _SINGULAR_THREAD_POOL_H
+
+#include "singular/singular.h"
+
+#include <deque>
+#include <functional>
+#if SINGULAR_THREAD_SUPPORTED
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#endif
+#include <vector>
+
+namespace singular {
+
+	/**
+	 * Fixed number of worker threads that run submitted tasks.
+	 *
+	 * Tasks may submit other tasks to the same pool.
+	 * `wait` blocks until every submitted task including ones submitted by
+	 * tasks has finished.
+	 * `runConcurrently` runs a function for a range of indices and may be
+	 * called from a task, because the calling thread runs queued tasks
+	 * instead of blocking.
+	 * A `TaskGroup` waits only for tasks submitted through it in the same
+	 * way, so it may also be used from a task and by concurrent users of
+	 * the pool.
+	 *
+	 * Tasks are scheduled by work stealing.
+	 * Every worker has its own queue of tasks.
+	 * A task submitted by a task goes to the queue of the worker running
+	 * it, and a task submitted from outside goes to the queues in turn.
+	 * A worker runs the task it has queued last, and steals the task
+	 * queued first by another worker when its own queue is empty.
+	 * So tasks that take very different times keep every worker busy,
+	 * and a task that splits its work in halves hands the largest half to
+	 * an idle worker.
+	 *
+	 * If threads are not supported (`SINGULAR_THREAD_SUPPORTED` is 0),
+	 * tasks are queued and run on the thread that calls `wait`.
+	 */
+	class ThreadPool {
+	private:
+		/** Task to be run. */
+		typedef std::function< void() > Task;
+	public:
+		class TaskGroup;
+	private:
+#if SINGULAR_THREAD_SUPPORTED
+		/** Queue of tasks owned by a worker. */
+		struct WorkerQueue {
+			/** Tasks waiting to be run. */
+			std::deque< Task > tasks;
+
+			/** Guards `tasks`. */
+			std::mutex mutex;
+		};
+
+		/** Queues of workers; the ith queue is owned by the ith worker. */
+		std::vector< std::unique_ptr< WorkerQueue > > queues;
+
+		/** Worker threads. */
+		std::vector< std::thread > workers;
+
+		/** Number of tasks submitted but not finished yet. */
+		std::atomic< int > numPendingTasks;
+
+		/**
+		 * Number of tasks in the queues.
+		 *
+		 * Incremented only with `mutex` locked, so that a worker going to
+		 * sleep never misses a task.
+		 * May be negative for a moment if a task is taken before counted.
+		 */
+		std::atomic< int > numQueuedTasks;
+
+		/** Index of the queue that receives the next task from outside. */
+		std::atomic< unsigned int > nextQueue;
+
+		/** Guards sleeping and waking of workers and `stopping`. */
+		std::mutex mutex;
+
+		/** Notified when a task is submitted or the pool is stopping. */
+		std::condition_variable taskSubmitted;
+
+		/** Notified when all of pending tasks have finished. */
+		std::condition_variable tasksFinished;
+
+		/** Whether the pool is being destroyed. */
+		bool stopping;
+#else
+		/** Tasks waiting for `wait`. */
+		std::deque< Task > tasks;
+#endif
+	public:
+		/**
+		 * Starts a given number of worker threads.
+		 *
+		 * @param numThreads
+		 *     Number of worker threads.
+		 *     The number of hardware threads is used if this is less than 1.
+		 */
+		explicit ThreadPool(int numThreads = 0) {
+#if SINGULAR_THREAD_SUPPORTED
+			this->numPendingTasks = 0;
+			this->numQueuedTasks = 0;
+			this->nextQueue = 0;
+			this->stopping = false;
+			if (numThreads < 1) {
+				numThreads = static_cast< int >(
+					std::thread::hardware_concurrency());
+				if (numThreads < 1) {
+					numThreads = 1;
+				}
+			}
+			this->queues.reserve(numThreads);
+			for (int i = 0; i < numThreads; ++i) {
+				this->queues.push_back(
+					std::unique_ptr< WorkerQueue >(new WorkerQueue()));
+			}
+			this->workers.reserve(numThreads);
+			for (int i = 0; i < numThreads; ++i) {
+				this->workers.push_back(
+					std::thread(&ThreadPool::runWorker, this, i));
+			}
+#endif
+		}
+
+		/**
+		 * Stops worker threads.
+		 *
+		 * Tasks that have not started yet are discarded.
+		 */
+		~ThreadPool() {
+#if SINGULAR_THREAD_SUPPORTED
+			{
+				std::lock_guard< std::mutex > lock(this->mutex);
+				this->stopping = true;
+			}
+			this->taskSubmitted.notify_all();
+			for (size_t i = 0; i < this->workers.size(); ++i) {
+				this->workers[i].join();
+			}
+#endif
+		}
+
+		/**
+		 * Returns the number of worker threads.
+		 *
+		 * @return
+		 *     Number of worker threads.
+		 *     1 if threads are not supported.
+		 */
+		inline int size() const {
+#if SINGULAR_THREAD_SUPPORTED
+			return static_cast< int >(this->workers.size());
+#else
+			return 1;
+#endif
+		}
+
+		/**
+		 * Submits a given task.
+		 *
+		 * The task runs on one of worker threads.
+		 *
+		 * @param task
+		 *     Task to be run.
+		 *     Must not throw.
+		 */
+		void submit(const Task& task) {
+#if SINGULAR_THREAD_SUPPORTED
+			++this->numPendingTasks;
+			int index = this->currentWorker();
+			if (index < 0) {
+				index = static_cast< int >(
+					this->nextQueue++ % this->queues.size());
+			}
+			WorkerQueue& queue = *this->queues[index];
+			{
+				std::lock_guard< std::mutex > lock(queue.mutex);
+				queue.tasks.push_back(task);
+			}
+			{
+				std::lock_guard< std::mutex > lock(this->mutex);
+				++this->numQueuedTasks;
+			}
+			this->taskSubmitted.notify_one();
+#else
+			this->tasks.push_back(task);
+#endif
+		}
+
+		/**
+		 * Runs a given function for every index in `[0, count)`
+		 * concurrently and returns when all of them have finished.
+		 *
+		 * The calling thread runs the index 0 itself and then runs queued
+		 * tasks while others are still running, so this may be called
+		 * from a task unlike `wait`.
+		 *
+		 * @param count
+		 *     Number of indices.
+		 * @param body
+		 *     Function to be run for every index.
+		 *     Must not throw.
+		 */
+		void runConcurrently(int count,
+							 const std::function< void(int) >& body)
+		{
+#if SINGULAR_THREAD_SUPPORTED
+			if (count < 1) {
+				return;
+			}
+			std::atomic< int > numRemaining(count - 1);
+			for (int i = 1; i < count; ++i) {
+				this->submit([&body, &numRemaining, i]() {
+					body(i);
+					--numRemaining;
+				});
+			}
+			body(0);
+			this->runTasksUntilZero(numRemaining);
+#else
+			for (int i = 0; i < count; ++i) {
+				body(i);
+			}
+#endif
+		}
+
+		/**
+		 * Waits until every submitted task has finished.
+		 *
+		 * Must not be called from a task.
+		 */
+		void wait() {
+#if SINGULAR_THREAD_SUPPORTED
+			std::unique_lock< std::mutex > lock(this->mutex);
+			while (this->numPendingTasks > 0) {
+				this->tasksFinished.wait(lock);
+			}
+#else
+			while (!this->tasks.empty()) {
+				Task task = this->tasks.front();
+				this->tasks.pop_front();
+				task();
+			}
+#endif
+		}
+	private:
+#if SINGULAR_THREAD_SUPPORTED
+		/**
+		 * Returns the index of the worker running the calling thread.
+		 *
+		 * @return
+		 *     Index of the worker.
+		 *     -1 if the calling thread is not a worker of this pool.
+		 */
+		int currentWorker() const {
+			const std::thread::id id = std::this_thread::get_id();
+			for (size_t i = 0; i < this->workers.size(); ++i) {
+				if (this->workers[i].get_id() == id) {
+					return static_cast< int >(i);
+				}
+			}
+			return -1;
+		}
+
+		/**
+		 * Takes a task for a given worker.
+		 *
+		 * Takes the last task in the queue of the worker, or steals the
+		 * first task in the queue of another worker.
+		 *
+		 * @param index
+		 *     Index of the worker.
+		 *     -1 if the calling thread is not a worker, which only steals.
+		 * @param[out] task
+		 *     Where the taken task is to be stored.
+		 * @return
+		 *     Whether a task has been taken.
+		 */
+		bool takeTask(int index, Task& task) {
+			const int n = static_cast< int >(this->queues.size());
+			if (index >= 0) {
+				WorkerQueue& own = *this->queues[index];
+				std::lock_guard< std::mutex > lock(own.mutex);
+				if (!own.tasks.empty()) {
+					task = own.tasks.back();
+					own.tasks.pop_back();
+					return true;
+				}
+			}
+			const int numVictims = index >= 0 ? n - 1 : n;
+			for (int i = 1; i <= numVictims; ++i) {
+				WorkerQueue& victim = *this->queues[(index + i) % n];
+				std::lock_guard< std::mutex > lock(victim.mutex);
+				if (!victim.tasks.empty()) {
+					task = victim.tasks.front();
+					victim.tasks.pop_front();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * Runs queued tasks until a given counter becomes 0.
+		 *
+		 * Yields if no task is queued.
+		 *
+		 * @param counter
+		 *     Counter decremented by other threads.
+		 */
+		void runTasksUntilZero(const std::atomic< int >& counter) {
+			const int index = this->currentWorker();
+			while (counter > 0) {
+				Task task;
+				if (this->takeTask(index, task)) {
+					this->runTask(task);
+				} else {
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		/**
+		 * Runs a given task taken from a queue.
+		 *
+		 * @param task
+		 *     Task taken by `takeTask`.
+		 */
+		void runTask(const Task& task) {
+			--this->numQueuedTasks;
+			task();
+			if (--this->numPendingTasks == 0) {
+				std::lock_guard< std::mutex > lock(this->mutex);
+				this->tasksFinished.notify_all();
+			}
+		}
+
+		/**
+		 * Runs tasks until the pool stops.
+		 *
+		 * @param index
+		 *     Index of the worker.
+		 */
+		void runWorker(int index) {
+			for (;;) {
+				Task task;
+				if (this->takeTask(index, task)) {
+					this->runTask(task);
+					continue;
+				}
+				std::unique_lock< std::mutex > lock(this->mutex);
+				while (!this->stopping && this->numQueuedTasks <= 0) {
+					this->taskSubmitted.wait(lock);
+				}
+				if (this->stopping) {
+					return;
+				}
+			}
+		}
+#endif
+
+#if SINGULAR_FUNCTION_DELETION_SUPPORTED
+		/** Copy constructor is not allowed. */
+		ThreadPool(const ThreadPool& copyee) = delete;
+
+		/** Copy assignment is not allowed. */
+		ThreadPool& operator =(const ThreadPool& copyee) = delete;
+#else
+		/** Copy constructor is not allowed. */
+		ThreadPool(const ThreadPool& copyee) {}
+
+		/** Copy assignment is not allowed. */
+		ThreadPool& operator =(const ThreadPool& copyee) {
+			return *this;
+		}
+#endif
+	};
+
+	/**
+	 * Set of tasks submitted to a thread pool and waited for together.
+	 *
+	 * Unlike `ThreadPool::wait`, `wait` returns when the tasks submitted
+	 * through this group, including ones they submit through this group,
+	 * have finished, regardless of other tasks on the pool.
+	 * The waiting thread runs queued tasks meanwhile, so a group may be
+	 * waited for from a task.
+	 *
+	 * If threads are not supported, `wait` runs every queued task of the
+	 * pool.
+	 */
+	class ThreadPool::TaskGroup {
+	private:
+		/** Thread pool that runs tasks. */
+		ThreadPool& tasksPool;
+#if SINGULAR_THREAD_SUPPORTED
+		/** Number of tasks submitted but not finished yet. */
+		std::atomic< int > numPendingTasks;
+#endif
+	public:
+		/**
+		 * Initializes an empty group of tasks on a given thread pool.
+		 *
+		 * @param pool
+		 *     Thread pool that runs tasks.
+		 *     Must be valid while this group is used.
+		 */
+		explicit TaskGroup(ThreadPool& pool) : tasksPool(pool) {
+#if SINGULAR_THREAD_SUPPORTED
+			this->numPendingTasks = 0;
+#endif
+		}
+
+		/**
+		 * Waits for the remaining tasks.
+		 */
+		~TaskGroup() {
+			this->wait();
+		}
+
+		/**
+		 * Returns the thread pool that runs tasks.
+		 *
+		 * @return
+		 *     Thread pool that runs tasks.
+		 */
+		inline ThreadPool& pool() const {
+			return this->tasksPool;
+		}
+
+		/**
+		 * Submits a given task to the pool as a member of this group.
+		 *
+		 * May be called from a task of this group.
+		 *
+		 * @param task
+		 *     Task to be run.
+		 *     Must not throw.
+		 */
+		void submit(const Task& task) {
+#if SINGULAR_THREAD_SUPPORTED
+			++this->numPendingTasks;
+			std::atomic< int >* pNumPendingTasks = &this->numPendingTasks;
+			this->tasksPool.submit([task, pNumPendingTasks]() {
+				task();
+				--*pNumPendingTasks;
+			});
+#else
+			this->tasksPool.submit(task);
+#endif
+		}
+
+		/**
+		 * Waits until every task of this group has finished.
+		 *
+		 * Runs queued tasks of the pool while waiting.
+		 */
+		void wait() {
+#if SINGULAR_THREAD_SUPPORTED
+			this->tasksPool.runTasksUntilZero(this->numPendingTasks);
+#else
+			this->tasksPool.wait();
+#endif
+		}
+	private:
+#if SINGULAR_FUNCTION_DELETION_SUPPORTED
+		/** Copy constructor is not allowed. */
+		TaskGroup(const TaskGroup& copyee) = delete;
+
+		/** Copy assignment is not allowed. */
+		TaskGroup& operator =(const TaskGroup& copyee) = delete;
+#else
+		/** Copy constructor is not allowed. */
+		TaskGroup(const TaskGroup& copyee) : tasksPool(copyee.tasksPool) {}
+
+		/** Copy assignment is not allowed. */
+		TaskGroup& operator =(const TaskGroup& copyee) {
+			return *this;
+		}
+#endif
+	};
+
+}
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef _SINGULAR_TRANSPOSE_H
+#define _SINGULAR_TRANSPOSE_H
+
+#include "singular/singular.h"
+
+#include <cstddef>
+#include <utility>
+
+namespace singular {
+
+	/**
+	 * Cache-oblivious transposition of row-major matrices.
+	 *
+	 * A matrix is recursively split at the middle of its longer side until
+	 * both sides are no longer than `BLOCK_SIZE`.
+	 * Then every block is small enough that its source rows and destination
+	 * rows stay in the L1 cache while it is transposed, whatever the size
+	 * of caches is.
+	 */
+	struct Transpose {
+		/** Maximum number of rows and columns transposed by a plain loop. */
+		static const int BLOCK_SIZE = 8;
+
+		/**
+		 * Writes the transposition of a given matrix into another matrix.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @param M
+		 *     Number of rows in `a`.
+		 *     Number of columns in `b`.
+		 * @param N
+		 *     Number of columns in `a`.
+		 *     Number of rows in `b`.
+		 * @param a
+		 *     `M` x `N` matrix to be transposed.
+		 * @param lda
+		 *     Distance from one row to the next row in `a`.
+		 * @param[out] b
+		 *     `N` x `M` matrix where the transposition of `a` is to be
+		 *     written.
+		 *     Must not overlap `a`.
+		 * @param ldb
+		 *     Distance from one row to the next row in `b`.
+		 */
+		template < typename T >
+		static void copy(int M,
+						 int N,
+						 const T* a,
+						 ptrdiff_t lda,
+						 T* b,
+						 ptrdiff_t ldb)
+		{
+			if (M <= BLOCK_SIZE && N <= BLOCK_SIZE) {
+				copyPlain(M, N, a, lda, b, ldb);
+			} else if (M >= N) {
+				const int half = M / 2;
+				copy(half, N, a, lda, b, ldb);
+				copy(M - half, N, a + half * lda, lda, b + half, ldb);
+			} else {
+				const int half = N / 2;
+				copy(M, half, a, lda, b, ldb);
+				copy(M, N - half, a + half, lda, b + half * ldb, ldb);
+			}
+		}
+
+		/**
+		 * Writes the transposition of a given matrix into another matrix
+		 * with a plain loop.
+		 *
+		 * Parameters are the same as `copy`.
+		 */
+		template < typename T >
+		static void copyPlain(int M,
+							  int N,
+							  const T* a,
+							  ptrdiff_t lda,
+							  T* b,
+							  ptrdiff_t ldb)
+		{
+			for (int i = 0; i < M; ++i) {
+				const T* pA = a + i * lda;
+				T* pB = b + i;
+				for (int j = 0; j < N; ++j) {
+					*pB = pA[j];
+					pB += ldb;
+				}
+			}
+		}
+
+		/**
+		 * Transposes a given square matrix in place.
+		 *
+		 * The diagonal blocks are transposed in place, and the blocks
+		 * above the diagonal are swapped with the transpositions of the
+		 * blocks below the diagonal.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @param N
+		 *     Number of rows and columns in `a`.
+		 * @param[in,out] a
+		 *     `N` x `N` matrix to be transposed.
+		 * @param lda
+		 *     Distance from one row to the next row in `a`.
+		 */
+		template < typename T >
+		static void inPlace(int N, T* a, ptrdiff_t lda) {
+			if (N <= BLOCK_SIZE) {
+				for (int i = 0; i < N; ++i) {
+					for (int j = i + 1; j < N; ++j) {
+						std::swap(a[i * lda + j], a[j * lda + i]);
+					}
+				}
+				return;
+			}
+			const int half = N / 2;
+			inPlace(half, a, lda);
+			inPlace(N - half, a + half * lda + half, lda);
+			swap(half, N - half, a + half, a + half * lda, lda);
+		}
+	private:
+		/**
+		 * Swaps a given matrix with the transposition of another matrix.
+		 *
+		 * @tparam T
+		 *     Type of elements.
+		 * @param M
+		 *     Number of rows in `a`.
+		 *     Number of columns in `b`.
+		 * @param N
+		 *     Number of columns in `a`.
+		 *     Number of rows in `b`.
+		 * @param[in,out] a
+		 *     `M` x `N` matrix to be swapped.
+		 * @param[in,out] b
+		 *     `N` x `M` matrix to be swapped.
+		 *     Must not overlap `a`.
+		 * @param ld
+		 *     Distance from one row to the next row in `a` and `b`.
+		 */
+		template < typename T >
+		static void swap(int M, int N, T* a, T* b, ptrdiff_t ld) {
+			if (M <= BLOCK_SIZE && N <= BLOCK_SIZE) {
+				for (int i = 0; i < M; ++i) {
+					for (int j = 0; j < N; ++j) {
+						std::swap(a[i * ld + j], b[j * ld + i]);
+					}
+				}
+			} else if (M >= N) {
+				const int half = M / 2;
+				swap(half, N, a, b, ld);
+				swap(M - half, N, a + half * ld, b + half, ld);
+			} else {
+				const int half = N / 2;
+				swap(M, half, a, b, ld);
+				swap(M, N - half, a + half, b + half * ld, ld);
+			}
+		}
+	};
+
+}
+
+#endif
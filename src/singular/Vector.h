@@ -211,6 +211,26 @@ namespace singular {
 			return this->len;
 		}
 
+		/**
+		 * Returns the pointer to the first element in this vector.
+		 *
+		 * @return
+		 *     Pointer to the first element.
+		 */
+		inline T* data() const {
+			return this->pBlock;
+		}
+
+		/**
+		 * Returns the distance from one element to the next element.
+		 *
+		 * @return
+		 *     Distance between adjacent elements.
+		 */
+		inline ptrdiff_t stride() const {
+			return this->delta;
+		}
+
 		/**
 		 * Returns the element at a given index in this vector.
 		 *
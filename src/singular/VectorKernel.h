@@ -0,0 +1,961 @@
+#ifndef _SINGULAR_VECTOR_KERNEL_H
+#define _SINGULAR_VECTOR_KERNEL_H
+
+#include "singular/Simd.h"
+#include "singular/singular.h"
+
+#include <cstddef>
+
+namespace singular {
+
+	/**
+	 * Kernels of level 1 vector operations.
+	 *
+	 * Vectors are given by a pointer to the first element and the distance
+	 * from one element to the next element like BLAS.
+	 * Every kernel has a fast path for contiguous vectors and a strided
+	 * path for the others; e.g., a column of a row-major matrix.
+	 *
+	 * There is a set of kernels for every `SimdLevel`.
+	 * `best` picks the set for the CPU at runtime.
+	 * Only `double` and `float` have SIMD kernels; the other types are
+	 * processed by portable kernels at every level.
+	 *
+	 * @tparam T
+	 *     Type of elements.
+	 */
+	template < typename T >
+	struct BasicVectorKernel {
+		/**
+		 * Kernel that computes the dot product of two vectors.
+		 *
+		 * @param n
+		 *     Number of elements in each vector.
+		 * @param x
+		 *     First vector.
+		 * @param incX
+		 *     Distance between adjacent elements in `x`.
+		 * @param y
+		 *     Second vector.
+		 * @param incY
+		 *     Distance between adjacent elements in `y`.
+		 * @return
+		 *     \f$\mathbf{x}^T \mathbf{y}\f$.
+		 */
+		typedef T (*DotFunction)(
+			size_t n, const T* x, ptrdiff_t incX, const T* y, ptrdiff_t incY);
+
+		/**
+		 * Kernel that computes \f$\mathbf{y} \gets a \mathbf{x} + \mathbf{y}\f$.
+		 *
+		 * @param n
+		 *     Number of elements in each vector.
+		 * @param a
+		 *     Scalar multiplied to `x`.
+		 * @param x
+		 *     Vector to be added.
+		 * @param incX
+		 *     Distance between adjacent elements in `x`.
+		 * @param[in,out] y
+		 *     Vector to which `a * x` is added.
+		 *     Must not overlap `x`.
+		 * @param incY
+		 *     Distance between adjacent elements in `y`.
+		 */
+		typedef void (*AxpyFunction)(
+			size_t n, T a, const T* x, ptrdiff_t incX, T* y, ptrdiff_t incY);
+
+		/**
+		 * Kernel that computes \f$\mathbf{x} \gets a \mathbf{x}\f$.
+		 *
+		 * @param n
+		 *     Number of elements in the vector.
+		 * @param a
+		 *     Scalar multiplied to `x`.
+		 * @param[in,out] x
+		 *     Vector to be scaled.
+		 * @param incX
+		 *     Distance between adjacent elements in `x`.
+		 */
+		typedef void (*ScaleFunction)(size_t n, T a, T* x, ptrdiff_t incX);
+
+		/** Computes a dot product. */
+		DotFunction dot;
+
+		/** Adds a scaled vector. */
+		AxpyFunction axpy;
+
+		/** Scales a vector. */
+		ScaleFunction scale;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicVectorKernel& best() {
+			static const BasicVectorKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The level is ignored because there are no SIMD kernels for this
+		 * type of elements.
+		 *
+		 * @return
+		 *     Portable kernels.
+		 */
+		static const BasicVectorKernel& get(SimdLevel) {
+			static const BasicVectorKernel SCALAR_KERNEL = {
+				&dotScalar, &axpyScalar, &scaleScalar
+			};
+			return SCALAR_KERNEL;
+		}
+
+		/** Portable `DotFunction`. */
+		static T dotScalar(
+			size_t n, const T* x, ptrdiff_t incX, const T* y, ptrdiff_t incY)
+		{
+			T sum = T(0);
+			for (size_t i = 0; i < n; ++i, x += incX, y += incY) {
+				sum += *x * *y;
+			}
+			return sum;
+		}
+
+		/** Portable `AxpyFunction`. */
+		static void axpyScalar(
+			size_t n, T a, const T* x, ptrdiff_t incX, T* y, ptrdiff_t incY)
+		{
+			for (size_t i = 0; i < n; ++i, x += incX, y += incY) {
+				*y += a * *x;
+			}
+		}
+
+		/** Portable `ScaleFunction`. */
+		static void scaleScalar(size_t n, T a, T* x, ptrdiff_t incX)
+		{
+			for (size_t i = 0; i < n; ++i, x += incX) {
+				*x *= a;
+			}
+		}
+	};
+
+	/**
+	 * Kernels of level 1 vector operations on `double` elements.
+	 *
+	 * Strided paths load elements in pairs with SSE2 at every level,
+	 * because gathering them measured slower.
+	 */
+	template <>
+	struct BasicVectorKernel< double > {
+		/**
+		 * Kernel that computes the dot product of two vectors.
+		 *
+		 * @param n
+		 *     Number of elements in each vector.
+		 * @param x
+		 *     First vector.
+		 * @param incX
+		 *     Distance between adjacent elements in `x`.
+		 * @param y
+		 *     Second vector.
+		 * @param incY
+		 *     Distance between adjacent elements in `y`.
+		 * @return
+		 *     \f$\mathbf{x}^T \mathbf{y}\f$.
+		 */
+		typedef double (*DotFunction)(size_t n,
+									  const double* x,
+									  ptrdiff_t incX,
+									  const double* y,
+									  ptrdiff_t incY);
+
+		/**
+		 * Kernel that computes \f$\mathbf{y} \gets a \mathbf{x} + \mathbf{y}\f$.
+		 *
+		 * @param n
+		 *     Number of elements in each vector.
+		 * @param a
+		 *     Scalar multiplied to `x`.
+		 * @param x
+		 *     Vector to be added.
+		 * @param incX
+		 *     Distance between adjacent elements in `x`.
+		 * @param[in,out] y
+		 *     Vector to which `a * x` is added.
+		 *     Must not overlap `x`.
+		 * @param incY
+		 *     Distance between adjacent elements in `y`.
+		 */
+		typedef void (*AxpyFunction)(size_t n,
+									 double a,
+									 const double* x,
+									 ptrdiff_t incX,
+									 double* y,
+									 ptrdiff_t incY);
+
+		/**
+		 * Kernel that computes \f$\mathbf{x} \gets a \mathbf{x}\f$.
+		 *
+		 * @param n
+		 *     Number of elements in the vector.
+		 * @param a
+		 *     Scalar multiplied to `x`.
+		 * @param[in,out] x
+		 *     Vector to be scaled.
+		 * @param incX
+		 *     Distance between adjacent elements in `x`.
+		 */
+		typedef void (*ScaleFunction)(size_t n,
+									  double a,
+									  double* x,
+									  ptrdiff_t incX);
+
+		/** Computes a dot product. */
+		DotFunction dot;
+
+		/** Adds a scaled vector. */
+		AxpyFunction axpy;
+
+		/** Scales a vector. */
+		ScaleFunction scale;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicVectorKernel& best() {
+			static const BasicVectorKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The behavior is undefined if the CPU does not support `level`.
+		 * Levels not compiled in fall back to the highest compiled level
+		 * below them.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 * @return
+		 *     Kernels for `level`.
+		 */
+		static const BasicVectorKernel& get(SimdLevel level) {
+			static const BasicVectorKernel SCALAR_KERNEL = {
+				&dotScalar, &axpyScalar, &scaleScalar
+			};
+#if SINGULAR_SIMD_SUPPORTED
+			static const BasicVectorKernel SSE2_KERNEL = {
+				&dotSse2, &axpySse2, &scaleSse2
+			};
+			static const BasicVectorKernel AVX2_KERNEL = {
+				&dotAvx2, &axpyAvx2, &scaleAvx2
+			};
+#if SINGULAR_AVX512_SUPPORTED
+			static const BasicVectorKernel AVX512_KERNEL = {
+				&dotAvx512, &axpyAvx512, &scaleAvx512
+			};
+#endif
+			switch (level) {
+#if SINGULAR_AVX512_SUPPORTED
+			case SIMD_AVX512:
+				return AVX512_KERNEL;
+#else
+			case SIMD_AVX512:
+#endif
+			case SIMD_AVX2:
+				return AVX2_KERNEL;
+			case SIMD_SSE2:
+				return SSE2_KERNEL;
+			default:
+				return SCALAR_KERNEL;
+			}
+#else
+			return SCALAR_KERNEL;
+#endif
+		}
+
+		/** Portable `DotFunction`. */
+		static double dotScalar(size_t n,
+								const double* x,
+								ptrdiff_t incX,
+								const double* y,
+								ptrdiff_t incY)
+		{
+			double sum = 0.0;
+			for (size_t i = 0; i < n; ++i, x += incX, y += incY) {
+				sum += *x * *y;
+			}
+			return sum;
+		}
+
+		/** Portable `AxpyFunction`. */
+		static void axpyScalar(size_t n,
+							   double a,
+							   const double* x,
+							   ptrdiff_t incX,
+							   double* y,
+							   ptrdiff_t incY)
+		{
+			for (size_t i = 0; i < n; ++i, x += incX, y += incY) {
+				*y += a * *x;
+			}
+		}
+
+		/** Portable `ScaleFunction`. */
+		static void scaleScalar(size_t n, double a, double* x, ptrdiff_t incX)
+		{
+			for (size_t i = 0; i < n; ++i, x += incX) {
+				*x *= a;
+			}
+		}
+#if SINGULAR_SIMD_SUPPORTED
+		/** `DotFunction` with SSE2. */
+		SINGULAR_SIMD_TARGET("sse2")
+		static double dotSse2(size_t n,
+							  const double* x,
+							  ptrdiff_t incX,
+							  const double* y,
+							  ptrdiff_t incY)
+		{
+			__m128d sum0 = _mm_setzero_pd();
+			__m128d sum1 = _mm_setzero_pd();
+			size_t i = 0;
+			if (incX == 1 && incY == 1) {
+				for (; i + 4 <= n; i += 4) {
+					sum0 = _mm_add_pd(sum0, _mm_mul_pd(
+						_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+					sum1 = _mm_add_pd(sum1, _mm_mul_pd(
+						_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+				}
+			} else {
+				for (; i + 2 <= n; i += 2) {
+					__m128d vx = _mm_loadh_pd(
+						_mm_load_sd(x + i * incX), x + (i + 1) * incX);
+					__m128d vy = _mm_loadh_pd(
+						_mm_load_sd(y + i * incY), y + (i + 1) * incY);
+					sum0 = _mm_add_pd(sum0, _mm_mul_pd(vx, vy));
+				}
+			}
+			sum0 = _mm_add_pd(sum0, sum1);
+			double sum = _mm_cvtsd_f64(_mm_add_sd(
+				sum0, _mm_unpackhi_pd(sum0, sum0)));
+			return sum + dotScalar(n - i, x + i * incX, incX, y + i * incY, incY);
+		}
+
+		/** `AxpyFunction` with SSE2. */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void axpySse2(size_t n,
+							 double a,
+							 const double* x,
+							 ptrdiff_t incX,
+							 double* y,
+							 ptrdiff_t incY)
+		{
+			const __m128d va = _mm_set1_pd(a);
+			size_t i = 0;
+			if (incX == 1 && incY == 1) {
+				for (; i + 2 <= n; i += 2) {
+					_mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i),
+						_mm_mul_pd(va, _mm_loadu_pd(x + i))));
+				}
+			} else {
+				for (; i + 2 <= n; i += 2) {
+					double* y0 = y + i * incY;
+					double* y1 = y0 + incY;
+					__m128d vx = _mm_loadh_pd(
+						_mm_load_sd(x + i * incX), x + (i + 1) * incX);
+					__m128d vy = _mm_loadh_pd(_mm_load_sd(y0), y1);
+					vy = _mm_add_pd(vy, _mm_mul_pd(va, vx));
+					_mm_storel_pd(y0, vy);
+					_mm_storeh_pd(y1, vy);
+				}
+			}
+			axpyScalar(n - i, a, x + i * incX, incX, y + i * incY, incY);
+		}
+
+		/** `ScaleFunction` with SSE2. */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void scaleSse2(size_t n, double a, double* x, ptrdiff_t incX) {
+			const __m128d va = _mm_set1_pd(a);
+			size_t i = 0;
+			if (incX == 1) {
+				for (; i + 2 <= n; i += 2) {
+					_mm_storeu_pd(x + i, _mm_mul_pd(va, _mm_loadu_pd(x + i)));
+				}
+			}
+			scaleScalar(n - i, a, x + i * incX, incX);
+		}
+
+		/**
+		 * `DotFunction` with AVX2 and FMA.
+		 *
+		 * Strided vectors take the SSE2 path, because gathering elements
+		 * is slower than loading them in pairs.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static double dotAvx2(size_t n,
+							  const double* x,
+							  ptrdiff_t incX,
+							  const double* y,
+							  ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				return dotSse2(n, x, incX, y, incY);
+			}
+			__m256d sum0 = _mm256_setzero_pd();
+			__m256d sum1 = _mm256_setzero_pd();
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				sum0 = _mm256_fmadd_pd(
+					_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+				sum1 = _mm256_fmadd_pd(
+					_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), sum1);
+			}
+			for (; i + 4 <= n; i += 4) {
+				sum0 = _mm256_fmadd_pd(
+					_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+			}
+			sum0 = _mm256_add_pd(sum0, sum1);
+			__m128d half = _mm_add_pd(
+				_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+			double sum = _mm_cvtsd_f64(_mm_add_sd(
+				half, _mm_unpackhi_pd(half, half)));
+			return sum + dotScalar(n - i, x + i, 1, y + i, 1);
+		}
+
+		/**
+		 * `AxpyFunction` with AVX2 and FMA.
+		 *
+		 * Strided vectors take the SSE2 path.
+		 */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void axpyAvx2(size_t n,
+							 double a,
+							 const double* x,
+							 ptrdiff_t incX,
+							 double* y,
+							 ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				axpySse2(n, a, x, incX, y, incY);
+				return;
+			}
+			const __m256d va = _mm256_set1_pd(a);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				_mm256_storeu_pd(y + i, _mm256_fmadd_pd(
+					va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+			}
+			axpyScalar(n - i, a, x + i, 1, y + i, 1);
+		}
+
+		/** `ScaleFunction` with AVX2. */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void scaleAvx2(size_t n, double a, double* x, ptrdiff_t incX) {
+			if (incX != 1) {
+				scaleScalar(n, a, x, incX);
+				return;
+			}
+			const __m256d va = _mm256_set1_pd(a);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				_mm256_storeu_pd(
+					x + i, _mm256_mul_pd(va, _mm256_loadu_pd(x + i)));
+			}
+			scaleScalar(n - i, a, x + i, 1);
+		}
+#if SINGULAR_AVX512_SUPPORTED
+		/**
+		 * `DotFunction` with AVX-512F.
+		 *
+		 * Remaining elements are processed with a mask.
+		 * Strided vectors take the SSE2 path.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static double dotAvx512(size_t n,
+								const double* x,
+								ptrdiff_t incX,
+								const double* y,
+								ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				return dotSse2(n, x, incX, y, incY);
+			}
+			__m512d sum = _mm512_setzero_pd();
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				sum = _mm512_fmadd_pd(
+					_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum);
+			}
+			if (i < n) {
+				const __mmask8 mask = tailMask(n - i);
+				sum = _mm512_fmadd_pd(
+					_mm512_maskz_loadu_pd(mask, x + i),
+					_mm512_maskz_loadu_pd(mask, y + i),
+					sum);
+			}
+			return _mm512_reduce_add_pd(sum);
+		}
+
+		/**
+		 * `AxpyFunction` with AVX-512F.
+		 *
+		 * Remaining elements are processed with a mask.
+		 * Strided vectors take the SSE2 path.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void axpyAvx512(size_t n,
+							   double a,
+							   const double* x,
+							   ptrdiff_t incX,
+							   double* y,
+							   ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				axpySse2(n, a, x, incX, y, incY);
+				return;
+			}
+			const __m512d va = _mm512_set1_pd(a);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				_mm512_storeu_pd(y + i, _mm512_fmadd_pd(
+					va, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+			}
+			if (i < n) {
+				const __mmask8 mask = tailMask(n - i);
+				_mm512_mask_storeu_pd(y + i, mask, _mm512_fmadd_pd(
+					va,
+					_mm512_maskz_loadu_pd(mask, x + i),
+					_mm512_maskz_loadu_pd(mask, y + i)));
+			}
+		}
+
+		/** `ScaleFunction` with AVX-512F. */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void scaleAvx512(size_t n, double a, double* x, ptrdiff_t incX)
+		{
+			if (incX != 1) {
+				scaleScalar(n, a, x, incX);
+				return;
+			}
+			const __m512d va = _mm512_set1_pd(a);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				_mm512_storeu_pd(
+					x + i, _mm512_mul_pd(va, _mm512_loadu_pd(x + i)));
+			}
+			if (i < n) {
+				const __mmask8 mask = tailMask(n - i);
+				_mm512_mask_storeu_pd(x + i, mask,
+					_mm512_mul_pd(va, _mm512_maskz_loadu_pd(mask, x + i)));
+			}
+		}
+
+		/**
+		 * Returns a mask that selects the first given number of lanes.
+		 *
+		 * @param n
+		 *     Number of lanes to be selected.
+		 *     Must be less than 8.
+		 * @return
+		 *     Mask of the first `n` lanes.
+		 */
+		static inline __mmask8 tailMask(size_t n) {
+			return static_cast< __mmask8 >((1u << n) - 1u);
+		}
+#endif
+#endif
+	};
+
+	/**
+	 * Kernels of level 1 vector operations on `float` elements.
+	 *
+	 * Works like `BasicVectorKernel< double >` but a register holds twice
+	 * as many elements.
+	 * Strided vectors take the portable path at every level.
+	 */
+	template <>
+	struct BasicVectorKernel< float > {
+		/** Kernel that computes the dot product of two vectors. */
+		typedef float (*DotFunction)(size_t n,
+									 const float* x,
+									 ptrdiff_t incX,
+									 const float* y,
+									 ptrdiff_t incY);
+
+		/** Kernel that adds a scaled vector. */
+		typedef void (*AxpyFunction)(size_t n,
+									 float a,
+									 const float* x,
+									 ptrdiff_t incX,
+									 float* y,
+									 ptrdiff_t incY);
+
+		/** Kernel that computes \f$\mathbf{x} \gets a \mathbf{x}\f$. */
+		typedef void (*ScaleFunction)(size_t n,
+									  float a,
+									  float* x,
+									  ptrdiff_t incX);
+
+		/** Computes a dot product. */
+		DotFunction dot;
+
+		/** Adds a scaled vector. */
+		AxpyFunction axpy;
+
+		/** Scales a vector. */
+		ScaleFunction scale;
+
+		/**
+		 * Returns the kernels for the CPU running this program.
+		 *
+		 * @return
+		 *     Kernels for `Simd::level()`.
+		 */
+		static const BasicVectorKernel& best() {
+			static const BasicVectorKernel& kernel = get(Simd::level());
+			return kernel;
+		}
+
+		/**
+		 * Returns the kernels for a given SIMD level.
+		 *
+		 * The behavior is undefined if the CPU does not support `level`.
+		 * Levels not compiled in fall back to the highest compiled level
+		 * below them.
+		 *
+		 * @param level
+		 *     SIMD level of the kernels.
+		 * @return
+		 *     Kernels for `level`.
+		 */
+		static const BasicVectorKernel& get(SimdLevel level) {
+			static const BasicVectorKernel SCALAR_KERNEL = {
+				&dotScalar, &axpyScalar, &scaleScalar
+			};
+#if SINGULAR_SIMD_SUPPORTED
+			static const BasicVectorKernel SSE2_KERNEL = {
+				&dotSse2, &axpySse2, &scaleSse2
+			};
+			static const BasicVectorKernel AVX2_KERNEL = {
+				&dotAvx2, &axpyAvx2, &scaleAvx2
+			};
+#if SINGULAR_AVX512_SUPPORTED
+			static const BasicVectorKernel AVX512_KERNEL = {
+				&dotAvx512, &axpyAvx512, &scaleAvx512
+			};
+#endif
+			switch (level) {
+#if SINGULAR_AVX512_SUPPORTED
+			case SIMD_AVX512:
+				return AVX512_KERNEL;
+#else
+			case SIMD_AVX512:
+#endif
+			case SIMD_AVX2:
+				return AVX2_KERNEL;
+			case SIMD_SSE2:
+				return SSE2_KERNEL;
+			default:
+				return SCALAR_KERNEL;
+			}
+#else
+			return SCALAR_KERNEL;
+#endif
+		}
+
+		/** Portable `DotFunction`. */
+		static float dotScalar(size_t n,
+							   const float* x,
+							   ptrdiff_t incX,
+							   const float* y,
+							   ptrdiff_t incY)
+		{
+			float sum = 0.0f;
+			for (size_t i = 0; i < n; ++i, x += incX, y += incY) {
+				sum += *x * *y;
+			}
+			return sum;
+		}
+
+		/** Portable `AxpyFunction`. */
+		static void axpyScalar(size_t n,
+							   float a,
+							   const float* x,
+							   ptrdiff_t incX,
+							   float* y,
+							   ptrdiff_t incY)
+		{
+			for (size_t i = 0; i < n; ++i, x += incX, y += incY) {
+				*y += a * *x;
+			}
+		}
+
+		/** Portable `ScaleFunction`. */
+		static void scaleScalar(size_t n, float a, float* x, ptrdiff_t incX) {
+			for (size_t i = 0; i < n; ++i, x += incX) {
+				*x *= a;
+			}
+		}
+#if SINGULAR_SIMD_SUPPORTED
+		/** `DotFunction` with SSE2. */
+		SINGULAR_SIMD_TARGET("sse2")
+		static float dotSse2(size_t n,
+							 const float* x,
+							 ptrdiff_t incX,
+							 const float* y,
+							 ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				return dotScalar(n, x, incX, y, incY);
+			}
+			__m128 sum0 = _mm_setzero_ps();
+			__m128 sum1 = _mm_setzero_ps();
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				sum0 = _mm_add_ps(sum0, _mm_mul_ps(
+					_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+				sum1 = _mm_add_ps(sum1, _mm_mul_ps(
+					_mm_loadu_ps(x + i + 4), _mm_loadu_ps(y + i + 4)));
+			}
+			for (; i + 4 <= n; i += 4) {
+				sum0 = _mm_add_ps(sum0, _mm_mul_ps(
+					_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+			}
+			return horizontalSum(_mm_add_ps(sum0, sum1)) +
+				dotScalar(n - i, x + i, 1, y + i, 1);
+		}
+
+		/** `AxpyFunction` with SSE2. */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void axpySse2(size_t n,
+							 float a,
+							 const float* x,
+							 ptrdiff_t incX,
+							 float* y,
+							 ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				axpyScalar(n, a, x, incX, y, incY);
+				return;
+			}
+			const __m128 va = _mm_set1_ps(a);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i),
+					_mm_mul_ps(va, _mm_loadu_ps(x + i))));
+			}
+			axpyScalar(n - i, a, x + i, 1, y + i, 1);
+		}
+
+		/** `ScaleFunction` with SSE2. */
+		SINGULAR_SIMD_TARGET("sse2")
+		static void scaleSse2(size_t n, float a, float* x, ptrdiff_t incX) {
+			if (incX != 1) {
+				scaleScalar(n, a, x, incX);
+				return;
+			}
+			const __m128 va = _mm_set1_ps(a);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				_mm_storeu_ps(x + i, _mm_mul_ps(va, _mm_loadu_ps(x + i)));
+			}
+			scaleScalar(n - i, a, x + i, 1);
+		}
+
+		/** `DotFunction` with AVX2 and FMA. */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static float dotAvx2(size_t n,
+							 const float* x,
+							 ptrdiff_t incX,
+							 const float* y,
+							 ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				return dotScalar(n, x, incX, y, incY);
+			}
+			__m256 sum0 = _mm256_setzero_ps();
+			__m256 sum1 = _mm256_setzero_ps();
+			size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				sum0 = _mm256_fmadd_ps(
+					_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+				sum1 = _mm256_fmadd_ps(
+					_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), sum1);
+			}
+			for (; i + 8 <= n; i += 8) {
+				sum0 = _mm256_fmadd_ps(
+					_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+			}
+			sum0 = _mm256_add_ps(sum0, sum1);
+			__m128 half = _mm_add_ps(
+				_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+			return horizontalSum(half) + dotScalar(n - i, x + i, 1, y + i, 1);
+		}
+
+		/** `AxpyFunction` with AVX2 and FMA. */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void axpyAvx2(size_t n,
+							 float a,
+							 const float* x,
+							 ptrdiff_t incX,
+							 float* y,
+							 ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				axpyScalar(n, a, x, incX, y, incY);
+				return;
+			}
+			const __m256 va = _mm256_set1_ps(a);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				_mm256_storeu_ps(y + i, _mm256_fmadd_ps(
+					va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+			}
+			axpyScalar(n - i, a, x + i, 1, y + i, 1);
+		}
+
+		/** `ScaleFunction` with AVX2. */
+		SINGULAR_SIMD_TARGET("avx2,fma")
+		static void scaleAvx2(size_t n, float a, float* x, ptrdiff_t incX) {
+			if (incX != 1) {
+				scaleScalar(n, a, x, incX);
+				return;
+			}
+			const __m256 va = _mm256_set1_ps(a);
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				_mm256_storeu_ps(
+					x + i, _mm256_mul_ps(va, _mm256_loadu_ps(x + i)));
+			}
+			scaleScalar(n - i, a, x + i, 1);
+		}
+
+		/**
+		 * Returns the sum of the lanes in a given register.
+		 *
+		 * @param v
+		 *     Register whose lanes are to be summed up.
+		 * @return
+		 *     Sum of the four lanes.
+		 */
+		SINGULAR_SIMD_TARGET("sse2")
+		static inline float horizontalSum(__m128 v) {
+			v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+			v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+			return _mm_cvtss_f32(v);
+		}
+#if SINGULAR_AVX512_SUPPORTED
+		/**
+		 * `DotFunction` with AVX-512F.
+		 *
+		 * Remaining elements are processed with a mask.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static float dotAvx512(size_t n,
+							   const float* x,
+							   ptrdiff_t incX,
+							   const float* y,
+							   ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				return dotScalar(n, x, incX, y, incY);
+			}
+			__m512 sum = _mm512_setzero_ps();
+			size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				sum = _mm512_fmadd_ps(
+					_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum);
+			}
+			if (i < n) {
+				const __mmask16 mask = tailMask(n - i);
+				sum = _mm512_fmadd_ps(
+					_mm512_maskz_loadu_ps(mask, x + i),
+					_mm512_maskz_loadu_ps(mask, y + i),
+					sum);
+			}
+			return _mm512_reduce_add_ps(sum);
+		}
+
+		/**
+		 * `AxpyFunction` with AVX-512F.
+		 *
+		 * Remaining elements are processed with a mask.
+		 */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void axpyAvx512(size_t n,
+							   float a,
+							   const float* x,
+							   ptrdiff_t incX,
+							   float* y,
+							   ptrdiff_t incY)
+		{
+			if (incX != 1 || incY != 1) {
+				axpyScalar(n, a, x, incX, y, incY);
+				return;
+			}
+			const __m512 va = _mm512_set1_ps(a);
+			size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				_mm512_storeu_ps(y + i, _mm512_fmadd_ps(
+					va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+			}
+			if (i < n) {
+				const __mmask16 mask = tailMask(n - i);
+				_mm512_mask_storeu_ps(y + i, mask, _mm512_fmadd_ps(
+					va,
+					_mm512_maskz_loadu_ps(mask, x + i),
+					_mm512_maskz_loadu_ps(mask, y + i)));
+			}
+		}
+
+		/** `ScaleFunction` with AVX-512F. */
+		SINGULAR_SIMD_TARGET("avx512f")
+		static void scaleAvx512(size_t n, float a, float* x, ptrdiff_t incX) {
+			if (incX != 1) {
+				scaleScalar(n, a, x, incX);
+				return;
+			}
+			const __m512 va = _mm512_set1_ps(a);
+			size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				_mm512_storeu_ps(
+					x + i, _mm512_mul_ps(va, _mm512_loadu_ps(x + i)));
+			}
+			if (i < n) {
+				const __mmask16 mask = tailMask(n - i);
+				_mm512_mask_storeu_ps(x + i, mask,
+					_mm512_mul_ps(va, _mm512_maskz_loadu_ps(mask, x + i)));
+			}
+		}
+
+		/**
+		 * Returns a mask that selects the first given number of lanes.
+		 *
+		 * @param n
+		 *     Number of lanes to be selected.
+		 *     Must be less than 16.
+		 * @return
+		 *     Mask of the first `n` lanes.
+		 */
+		static inline __mmask16 tailMask(size_t n) {
+			return static_cast< __mmask16 >((1u << n) - 1u);
+		}
+#endif
+#endif
+	};
+
+	/** Kernels of level 1 vector operations on `double` elements. */
+	typedef BasicVectorKernel< double > VectorKernel;
+
+}
+
+#endif
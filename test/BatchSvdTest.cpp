@@ -0,0 +1,380 @@
+#include "singular/BatchKernel.h"
+#include "singular/BatchSvd.h"
+#include "singular/Simd.h"
+#include "singular/Svd.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * Fills a given array with pseudo random numbers in [-1, 1).
+ *
+ * @tparam T
+ *     Type of elements.
+ * @param[out] values
+ *     Array to be filled.
+ * @param seed
+ *     Seed of the pseudo random numbers.
+ */
+template < typename T >
+static void fillRandom(std::vector< T >& values, unsigned int seed) {
+	for (size_t i = 0; i < values.size(); ++i) {
+		seed = seed * 1103515245u + 12345u;
+		values[i] = static_cast< T >((seed >> 8) % 65536) / 32768 - 1;
+	}
+}
+
+/**
+ * Expects that given columns are orthonormal.
+ *
+ * @param m
+ *     Row-major matrix whose columns are to be tested.
+ * @param rows
+ *     Number of rows.
+ * @param columns
+ *     Number of columns.
+ * @param error
+ *     Tolerance.
+ */
+template < typename T >
+static void expectOrthonormalColumns(const T* m,
+									 int rows,
+									 int columns,
+									 T error)
+{
+	for (int j1 = 0; j1 < columns; ++j1) {
+		for (int j2 = j1; j2 < columns; ++j2) {
+			T dot = 0;
+			for (int i = 0; i < rows; ++i) {
+				dot += m[i * columns + j1] * m[i * columns + j2];
+			}
+			EXPECT_NEAR(j1 == j2 ? 1 : 0, dot, error)
+				<< "columns " << j1 << " and " << j2;
+		}
+	}
+}
+
+/**
+ * Decomposes random matrices in a batch and verifies every result.
+ *
+ * Checks that singular values are in descending order, singular vectors
+ * are orthonormal and the matrices are reconstructed.
+ *
+ * @param M
+ *     Number of rows in each matrix.
+ * @param N
+ *     Number of columns in each matrix.
+ * @param count
+ *     Number of matrices.
+ * @param job
+ *     How much of singular vectors is computed.
+ * @param error
+ *     Tolerance.
+ */
+template < typename T >
+static void expectBatchDecomposes(int M,
+								  int N,
+								  int count,
+								  singular::SvdJob job,
+								  T error)
+{
+	const int Q = std::min(M, N);
+	const int uColumns = job == singular::SVD_FULL ? M : Q;
+	const int vColumns = job == singular::SVD_FULL ? N : Q;
+	std::vector< T > a(count * M * N);
+	fillRandom(a, M * 100 + N);
+	std::vector< T > u(count * M * uColumns);
+	std::vector< T > s(count * Q);
+	std::vector< T > v(count * N * vColumns);
+	singular::BatchSvd::decompose(
+		M, N, count, a.data(), u.data(), s.data(), v.data(), job, job);
+	for (int k = 0; k < count; ++k) {
+		const T* ak = &a[k * M * N];
+		const T* uk = &u[k * M * uColumns];
+		const T* sk = &s[k * Q];
+		const T* vk = &v[k * N * vColumns];
+		for (int i = 0; i + 1 < Q; ++i) {
+			EXPECT_GE(sk[i], sk[i + 1]);
+		}
+		expectOrthonormalColumns(uk, M, uColumns, error);
+		expectOrthonormalColumns(vk, N, vColumns, error);
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < N; ++j) {
+				T x = 0;
+				for (int l = 0; l < Q; ++l) {
+					x += uk[i * uColumns + l] * sk[l] * vk[j * vColumns + l];
+				}
+				EXPECT_NEAR(ak[i * N + j], x, error)
+					<< "matrix " << k << " at (" << i << ", " << j << ")";
+			}
+		}
+	}
+}
+
+TEST(BatchSvdTest, Every_supported_level_should_orthogonalize_like_scalar) {
+	typedef singular::BatchKernel Kernel;
+	const int L = Kernel::LANES;
+	const int M = 7;
+	const int N = 3;
+	std::vector< double > x0(M * L);
+	std::vector< double > y0(M * L);
+	std::vector< double > w0(2 * N * L);
+	fillRandom(x0, 1);
+	fillRandom(y0, 2);
+	fillRandom(w0, 3);
+	// a lane that is already orthogonal must not be rotated
+	for (int i = 0; i < M; ++i) {
+		x0[i * L] = (i == 0) ? 1.0 : 0.0;
+		y0[i * L] = (i == 1) ? 1.0 : 0.0;
+	}
+	std::vector< double > xRef(x0);
+	std::vector< double > yRef(y0);
+	std::vector< double > wRef(w0);
+	EXPECT_TRUE(Kernel::get(singular::SIMD_NONE).orthogonalize(
+		xRef.data(), yRef.data(), M,
+		wRef.data(), wRef.data() + N * L, N, 1.0e-15));
+	for (int i = 0; i < M; ++i) {
+		EXPECT_EQ(x0[i * L], xRef[i * L]);
+		EXPECT_EQ(y0[i * L], yRef[i * L]);
+	}
+	for (int l = 1; l < L; ++l) {
+		double dot = 0.0;
+		for (int i = 0; i < M; ++i) {
+			dot += xRef[i * L + l] * yRef[i * L + l];
+		}
+		EXPECT_NEAR(0.0, dot, 1.0e-15) << "lane " << l;
+	}
+	for (int level = singular::SIMD_SSE2;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		std::vector< double > x(x0);
+		std::vector< double > y(y0);
+		std::vector< double > w(w0);
+		Kernel::get(static_cast< singular::SimdLevel >(level))
+			.orthogonalize(x.data(), y.data(), M,
+						   w.data(), w.data() + N * L, N, 1.0e-15);
+		for (int i = 0; i < M * L; ++i) {
+			EXPECT_NEAR(xRef[i], x[i], 1.0e-14) << "level " << level;
+			EXPECT_NEAR(yRef[i], y[i], 1.0e-14) << "level " << level;
+		}
+		for (int i = 0; i < 2 * N * L; ++i) {
+			EXPECT_NEAR(wRef[i], w[i], 1.0e-14) << "level " << level;
+		}
+	}
+}
+
+TEST(BatchSvdTest, Every_supported_level_should_orthogonalize_floats_like_scalar) {
+	typedef singular::BasicBatchKernel< float > Kernel;
+	const int L = Kernel::LANES;
+	const int M = 5;
+	std::vector< float > x0(M * L);
+	std::vector< float > y0(M * L);
+	fillRandom(x0, 4);
+	fillRandom(y0, 5);
+	std::vector< float > xRef(x0);
+	std::vector< float > yRef(y0);
+	Kernel::get(singular::SIMD_NONE).orthogonalize(
+		xRef.data(), yRef.data(), M, xRef.data(), yRef.data(), 0, 1.0e-6f);
+	for (int level = singular::SIMD_SSE2;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		std::vector< float > x(x0);
+		std::vector< float > y(y0);
+		Kernel::get(static_cast< singular::SimdLevel >(level))
+			.orthogonalize(x.data(), y.data(), M, x.data(), y.data(), 0,
+						   1.0e-6f);
+		for (int i = 0; i < M * L; ++i) {
+			EXPECT_NEAR(xRef[i], x[i], 1.0e-5f) << "level " << level;
+			EXPECT_NEAR(yRef[i], y[i], 1.0e-5f) << "level " << level;
+		}
+	}
+}
+
+TEST(BatchSvdTest, Batch_should_decompose_square_matrices) {
+	expectBatchDecomposes< double >(3, 3, 19, singular::SVD_FULL, 1.0e-13);
+	expectBatchDecomposes< double >(16, 16, 9, singular::SVD_FULL, 1.0e-13);
+}
+
+TEST(BatchSvdTest, Batch_should_decompose_tall_and_wide_matrices) {
+	expectBatchDecomposes< double >(7, 4, 10, singular::SVD_FULL, 1.0e-13);
+	expectBatchDecomposes< double >(4, 7, 10, singular::SVD_FULL, 1.0e-13);
+	expectBatchDecomposes< double >(7, 4, 10, singular::SVD_THIN, 1.0e-13);
+	expectBatchDecomposes< double >(4, 7, 10, singular::SVD_THIN, 1.0e-13);
+}
+
+TEST(BatchSvdTest, Batch_should_decompose_float_matrices) {
+	expectBatchDecomposes< float >(6, 6, 21, singular::SVD_FULL, 1.0e-5f);
+	expectBatchDecomposes< float >(3, 5, 17, singular::SVD_FULL, 1.0e-5f);
+}
+
+TEST(BatchSvdTest, Batch_should_give_the_same_singular_values_as_Svd) {
+	const int M = 5;
+	const int N = 4;
+	const int COUNT = 11;
+	typedef singular::Svd< M, N > Svd;
+	std::vector< double > a(COUNT * M * N);
+	fillRandom(a, 7);
+	std::vector< double > s(COUNT * N);
+	double* const NO_VECTORS = 0;
+	Svd::decomposeBatch(COUNT, a.data(), NO_VECTORS, s.data(), NO_VECTORS,
+						singular::SVD_NONE, singular::SVD_NONE);
+	for (int k = 0; k < COUNT; ++k) {
+		singular::Matrix< M, N > m;
+		m.fill(&a[k * M * N]);
+		const singular::DiagonalMatrix< M, N > ref = Svd::decomposeS(m);
+		for (int i = 0; i < N; ++i) {
+			EXPECT_NEAR(ref(i, i), s[k * N + i], 1.0e-13)
+				<< "matrix " << k;
+		}
+	}
+}
+
+TEST(BatchSvdTest, Batch_should_complete_singular_vectors_of_rank_deficient_matrices) {
+	const int M = 4;
+	const int N = 3;
+	const int COUNT = 2;
+	// the first matrix has rank 1 and the second one is zero
+	const double DATA[] = {
+		1.0, 2.0, 3.0,
+		2.0, 4.0, 6.0,
+		-1.0, -2.0, -3.0,
+		0.5, 1.0, 1.5,
+		0.0, 0.0, 0.0,
+		0.0, 0.0, 0.0,
+		0.0, 0.0, 0.0,
+		0.0, 0.0, 0.0
+	};
+	double u[COUNT * M * M];
+	double s[COUNT * N];
+	double v[COUNT * N * N];
+	singular::Svd< M, N >::decomposeBatch(COUNT, DATA, u, s, v);
+	EXPECT_NEAR(std::sqrt(6.25 * 14.0), s[0], 1.0e-13);
+	EXPECT_NEAR(0.0, s[1], 1.0e-13);
+	EXPECT_NEAR(0.0, s[2], 1.0e-13);
+	for (int i = 0; i < N; ++i) {
+		EXPECT_EQ(0.0, s[N + i]);
+	}
+	for (int k = 0; k < COUNT; ++k) {
+		expectOrthonormalColumns(u + k * M * M, M, M, 1.0e-13);
+		expectOrthonormalColumns(v + k * N * N, N, N, 1.0e-13);
+	}
+}
+
+TEST(BatchSvdTest, Batch_should_complete_singular_vectors_of_constant_matrices) {
+	// leftover columns are rounding errors of order 1e-308
+	const int M = 16;
+	const int N = 9;
+	const int COUNT = 3;
+	std::vector< double > a(COUNT * M * N, 1.0);
+	std::vector< double > u(COUNT * M * M);
+	std::vector< double > s(COUNT * N);
+	std::vector< double > v(COUNT * N * N);
+	singular::Svd< M, N >::decomposeBatch(
+		COUNT, a.data(), u.data(), s.data(), v.data());
+	for (int k = 0; k < COUNT; ++k) {
+		EXPECT_NEAR(12.0, s[k * N], 1.0e-13) << "matrix " << k;
+		for (int i = 1; i < N; ++i) {
+			EXPECT_NEAR(0.0, s[k * N + i], 1.0e-13) << "matrix " << k;
+		}
+		expectOrthonormalColumns(&u[k * M * M], M, M, 1.0e-13);
+		expectOrthonormalColumns(&v[k * N * N], N, N, 1.0e-13);
+	}
+}
+
+TEST(BatchSvdTest, Thread_pool_should_give_the_same_results_as_calling_thread) {
+	const int M = 6;
+	const int N = 5;
+	const int COUNT = 1000;
+	typedef singular::Svd< M, N > Svd;
+	std::vector< double > a(COUNT * M * N);
+	fillRandom(a, 11);
+	std::vector< double > u(COUNT * M * M);
+	std::vector< double > s(COUNT * N);
+	std::vector< double > v(COUNT * N * N);
+	Svd::decomposeBatch(COUNT, a.data(), u.data(), s.data(), v.data());
+	singular::ThreadPool pool(4);
+	std::vector< double > uPool(COUNT * M * M);
+	std::vector< double > sPool(COUNT * N);
+	std::vector< double > vPool(COUNT * N * N);
+	Svd::decomposeBatch(COUNT,
+						a.data(),
+						uPool.data(),
+						sPool.data(),
+						vPool.data(),
+						singular::SVD_FULL,
+						singular::SVD_FULL,
+						&pool);
+	// every matrix is decomposed by the same instructions on any thread
+	EXPECT_TRUE(u == uPool);
+	EXPECT_TRUE(s == sPool);
+	EXPECT_TRUE(v == vPool);
+}
+
+TEST(BatchSvdTest, Batches_sharing_thread_pool_can_run_from_its_tasks) {
+	const int M = 6;
+	const int N = 5;
+	const int COUNT = 200;
+	const int NUM_BATCHES = 4;
+	typedef singular::Svd< M, N > Svd;
+	std::vector< double > a(COUNT * M * N);
+	fillRandom(a, 17);
+	std::vector< double > u(COUNT * M * M);
+	std::vector< double > s(COUNT * N);
+	std::vector< double > v(COUNT * N * N);
+	Svd::decomposeBatch(COUNT, a.data(), u.data(), s.data(), v.data());
+	// more batches than workers, so every worker waits for one
+	singular::ThreadPool pool(2);
+	std::vector< std::vector< double > > ss(
+		NUM_BATCHES, std::vector< double >(COUNT * N));
+	for (int b = 0; b < NUM_BATCHES; ++b) {
+		double* pS = ss[b].data();
+		pool.submit([&pool, &a, pS]() {
+			Svd::decomposeBatch(COUNT,
+								a.data(),
+								static_cast< double* >(0),
+								pS,
+								static_cast< double* >(0),
+								singular::SVD_NONE,
+								singular::SVD_NONE,
+								&pool);
+		});
+	}
+	pool.wait();
+	for (int b = 0; b < NUM_BATCHES; ++b) {
+		EXPECT_TRUE(s == ss[b]) << "batch " << b;
+	}
+}
+
+TEST(BatchSvdTest, Batch_should_decompose_matrices_of_extreme_magnitudes) {
+	const int M = 5;
+	const int N = 4;
+	const int COUNT = 3;
+	// the same matrix scaled by 1, 1e200 and 1e-200
+	const double SCALES[] = { 1.0, 1.0e200, 1.0e-200 };
+	std::vector< double > a0(M * N);
+	fillRandom(a0, 13);
+	std::vector< double > a(COUNT * M * N);
+	for (int k = 0; k < COUNT; ++k) {
+		for (int i = 0; i < M * N; ++i) {
+			a[k * M * N + i] = a0[i] * SCALES[k];
+		}
+	}
+	std::vector< double > u(COUNT * M * M);
+	std::vector< double > s(COUNT * N);
+	std::vector< double > v(COUNT * N * N);
+	singular::Svd< M, N >::decomposeBatch(
+		COUNT, a.data(), u.data(), s.data(), v.data());
+	for (int k = 1; k < COUNT; ++k) {
+		for (int i = 0; i < N; ++i) {
+			EXPECT_NEAR(s[i], s[k * N + i] / SCALES[k], s[i] * 1.0e-13)
+				<< "matrix " << k;
+		}
+		expectOrthonormalColumns(&u[k * M * M], M, M, 1.0e-13);
+		expectOrthonormalColumns(&v[k * N * N], N, N, 1.0e-13);
+	}
+}
@@ -247,6 +247,28 @@ TEST(DiagonalMatrixTest, Product_of_4x3_Matrix_and_3x4_DiagonalMatrix_should_be_
 	EXPECT_NEAR(0.0, p(3, 3), ROUNDED_ERROR);
 }
 
+TEST(DiagonalMatrixTest, Product_of_4x3_DiagonalMatrix_and_3x2_Matrix_should_have_zero_last_row) {
+	const double DIAGONAL[] = {
+		2.0, -1.0, 0.5
+	};
+	const double DATA[] = {
+		1.0, 2.0,
+		3.0, 4.0,
+		5.0, 6.0
+	};
+	singular::DiagonalMatrix< 4, 3 > m1(DIAGONAL);
+	singular::Matrix< 3, 2 > m2 = singular::Matrix< 3, 2 >::filledWith(DATA);
+	singular::Matrix< 4, 2 > p = m1 * m2;
+	EXPECT_EQ(2.0, p(0, 0));
+	EXPECT_EQ(4.0, p(0, 1));
+	EXPECT_EQ(-3.0, p(1, 0));
+	EXPECT_EQ(-4.0, p(1, 1));
+	EXPECT_EQ(2.5, p(2, 0));
+	EXPECT_EQ(3.0, p(2, 1));
+	EXPECT_EQ(0.0, p(3, 0));
+	EXPECT_EQ(0.0, p(3, 1));
+}
+
 TEST(DiagonalMatrixTest, Product_of_3x3_DiagonalMatrix_and_3x3_DiagonalMatrix_should_be_3x3_Matrix) {
 	const double ROUNDED_ERROR = 1.0e-14;
 	const int M1 = 3;
@@ -272,3 +294,18 @@ TEST(DiagonalMatrixTest, Product_of_3x3_DiagonalMatrix_and_3x3_DiagonalMatrix_sh
 	EXPECT_NEAR(0.0, p(2, 1), ROUNDED_ERROR);
 	EXPECT_NEAR(-3.2 * 0.2, p(2, 2), ROUNDED_ERROR);
 }
+
+TEST(DiagonalMatrixTest, Diagonal_elements_can_be_filled_with_given_values) {
+	const double DATA[] = { 3.0, -1.5, 2.0 };
+	singular::DiagonalMatrix< 3, 4 > m;
+	m.fill(DATA);
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			if (i == j) {
+				EXPECT_EQ(DATA[i], m(i, j));
+			} else {
+				EXPECT_EQ(0.0, m(i, j));
+			}
+		}
+	}
+}
@@ -0,0 +1,270 @@
+#include "singular/DynamicMatrix.h"
+
+#include "gtest/gtest.h"
+
+TEST(DynamicMatrixTest, Default_matrix_should_be_empty) {
+	singular::DynamicMatrix m;
+	EXPECT_EQ(0, m.rows());
+	EXPECT_EQ(0, m.columns());
+}
+
+TEST(DynamicMatrixTest, 3x4_matrix_should_initially_be_filled_with_zeros) {
+	const int M = 3;
+	const int N = 4;
+	singular::DynamicMatrix m(M, N);
+	EXPECT_EQ(M, m.rows());
+	EXPECT_EQ(N, m.columns());
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_EQ(0.0, m(i, j));
+		}
+	}
+}
+
+TEST(DynamicMatrixTest, 2x3_identity_matrix_can_be_created) {
+	singular::DynamicMatrix eye = singular::DynamicMatrix::identity(2, 3);
+	EXPECT_EQ(2, eye.rows());
+	EXPECT_EQ(3, eye.columns());
+	EXPECT_EQ(1.0, eye(0, 0));
+	EXPECT_EQ(0.0, eye(0, 1));
+	EXPECT_EQ(0.0, eye(0, 2));
+	EXPECT_EQ(0.0, eye(1, 0));
+	EXPECT_EQ(1.0, eye(1, 1));
+	EXPECT_EQ(0.0, eye(1, 2));
+}
+
+TEST(DynamicMatrixTest, 3x2_matrix_filled_with_values_can_be_created) {
+	const double DATA[] = {
+		1.0, 2.0,
+		3.0, 4.0,
+		5.0, 6.0
+	};
+	singular::DynamicMatrix m = singular::DynamicMatrix::filledWith(3, 2, DATA);
+	EXPECT_EQ(1.0, m(0, 0));
+	EXPECT_EQ(2.0, m(0, 1));
+	EXPECT_EQ(3.0, m(1, 0));
+	EXPECT_EQ(4.0, m(1, 1));
+	EXPECT_EQ(5.0, m(2, 0));
+	EXPECT_EQ(6.0, m(2, 1));
+}
+
+TEST(DynamicMatrixTest, Clone_should_not_share_elements) {
+	const double DATA[] = {
+		1.0, 2.0,
+		3.0, 4.0
+	};
+	singular::DynamicMatrix m = singular::DynamicMatrix::filledWith(2, 2, DATA);
+	singular::DynamicMatrix m2 = m.clone();
+	m2(0, 0) = -1.0;
+	EXPECT_EQ(1.0, m(0, 0));
+	EXPECT_EQ(-1.0, m2(0, 0));
+	EXPECT_EQ(2.0, m2(0, 1));
+	EXPECT_EQ(3.0, m2(1, 0));
+	EXPECT_EQ(4.0, m2(1, 1));
+}
+
+TEST(DynamicMatrixTest, Moved_matrix_should_become_empty) {
+	singular::DynamicMatrix m(2, 3);
+	m(1, 2) = 5.0;
+	singular::DynamicMatrix m2(std::move(m));
+	EXPECT_EQ(0, m.rows());
+	EXPECT_EQ(0, m.columns());
+	EXPECT_EQ(2, m2.rows());
+	EXPECT_EQ(3, m2.columns());
+	EXPECT_EQ(5.0, m2(1, 2));
+}
+
+TEST(DynamicMatrixTest, Changes_on_rows_and_columns_should_be_reflected_to_matrix) {
+	singular::DynamicMatrix m(2, 3);
+	singular::Vector< double > row = m.row(1);
+	row[2] = 1.5;
+	singular::Vector< double > column = m.column(0);
+	column[1] = -2.5;
+	EXPECT_EQ(3u, row.size());
+	EXPECT_EQ(2u, column.size());
+	EXPECT_EQ(1.5, m(1, 2));
+	EXPECT_EQ(-2.5, m(1, 0));
+}
+
+TEST(DynamicMatrixTest, Changes_on_view_should_be_reflected_to_matrix) {
+	singular::DynamicMatrix m(3, 2);
+	singular::MatrixView view = m.view();
+	EXPECT_EQ(3, view.rows());
+	EXPECT_EQ(2, view.columns());
+	view(2, 1) = 4.0;
+	view.column(0)[1] = 7.0;
+	EXPECT_EQ(4.0, m(2, 1));
+	EXPECT_EQ(7.0, m(1, 0));
+}
+
+TEST(DynamicMatrixTest, Product_of_2x3_matrix_and_3x2_matrix_should_be_2x2_matrix) {
+	const double LHS[] = {
+		1.0, 2.0, 3.0,
+		4.0, 5.0, 6.0
+	};
+	const double RHS[] = {
+		7.0, 8.0,
+		9.0, 10.0,
+		11.0, 12.0
+	};
+	singular::DynamicMatrix lhs =
+		singular::DynamicMatrix::filledWith(2, 3, LHS);
+	singular::DynamicMatrix rhs =
+		singular::DynamicMatrix::filledWith(3, 2, RHS);
+	singular::DynamicMatrix product = lhs * rhs;
+	EXPECT_EQ(2, product.rows());
+	EXPECT_EQ(2, product.columns());
+	EXPECT_EQ(58.0, product(0, 0));
+	EXPECT_EQ(64.0, product(0, 1));
+	EXPECT_EQ(139.0, product(1, 0));
+	EXPECT_EQ(154.0, product(1, 1));
+}
+
+TEST(DynamicMatrixTest, Product_on_thread_pool_should_equal_product) {
+	singular::DynamicMatrix lhs(200, 150);
+	singular::DynamicMatrix rhs(150, 180);
+	for (int i = 0; i < 200; ++i) {
+		for (int j = 0; j < 150; ++j) {
+			lhs(i, j) = (i * 7 + j * 3) % 11 - 5.0;
+		}
+	}
+	for (int i = 0; i < 150; ++i) {
+		for (int j = 0; j < 180; ++j) {
+			rhs(i, j) = (i * 5 + j * 2) % 13 - 6.0;
+		}
+	}
+	singular::ThreadPool pool(3);
+	singular::DynamicMatrix product = lhs.multiply(rhs, pool);
+	singular::DynamicMatrix ref = lhs * rhs;
+	EXPECT_EQ(200, product.rows());
+	EXPECT_EQ(180, product.columns());
+	for (int i = 0; i < 200; ++i) {
+		for (int j = 0; j < 180; ++j) {
+			double x = 0.0;
+			for (int k = 0; k < 150; ++k) {
+				x += lhs(i, k) * rhs(k, j);
+			}
+			ASSERT_EQ(x, product(i, j));
+			ASSERT_EQ(x, ref(i, j));
+		}
+	}
+}
+
+TEST(DynamicMatrixTest, Transposition_of_2x3_matrix_should_be_3x2_matrix) {
+	const double DATA[] = {
+		1.0, 2.0, 3.0,
+		4.0, 5.0, 6.0
+	};
+	singular::DynamicMatrix m = singular::DynamicMatrix::filledWith(2, 3, DATA);
+	singular::DynamicMatrix t = m.transpose();
+	EXPECT_EQ(3, t.rows());
+	EXPECT_EQ(2, t.columns());
+	for (int i = 0; i < 2; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			EXPECT_EQ(m(i, j), t(j, i));
+		}
+	}
+}
+
+TEST(DynamicMatrixTest, Square_matrix_can_be_transposed_in_place) {
+	singular::DynamicMatrix m(40, 40);
+	for (int i = 0; i < 40; ++i) {
+		for (int j = 0; j < 40; ++j) {
+			m(i, j) = i * 40.0 + j;
+		}
+	}
+	m.transposeInPlace();
+	for (int i = 0; i < 40; ++i) {
+		for (int j = 0; j < 40; ++j) {
+			ASSERT_EQ(j * 40.0 + i, m(i, j));
+		}
+	}
+}
+
+TEST(DynamicMatrixTest, Column_major_view_should_have_contiguous_columns) {
+	double block[6] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+	singular::MatrixView view(block, 2, 3, singular::COLUMN_MAJOR);
+	EXPECT_EQ(singular::COLUMN_MAJOR, view.layout());
+	EXPECT_EQ(1.0, view(0, 0));
+	EXPECT_EQ(2.0, view(1, 0));
+	EXPECT_EQ(3.0, view(0, 1));
+	EXPECT_EQ(6.0, view(1, 2));
+	EXPECT_EQ(1, view.column(1).stride());
+	EXPECT_EQ(4.0, view.column(1)[1]);
+	EXPECT_EQ(2, view.row(1).stride());
+	EXPECT_EQ(4.0, view.row(1)[1]);
+}
+
+TEST(DynamicMatrixTest, Matrix_should_be_aligned) {
+	singular::DynamicMatrix m(3, 5);
+	const size_t address = reinterpret_cast< size_t >(m.data());
+	EXPECT_EQ(0u, address % SINGULAR_ALIGNMENT);
+	EXPECT_EQ(5, m.leadingDimension());
+}
+
+TEST(DynamicMatrixTest, Padded_leading_dimension_should_break_powers_of_two) {
+	const int UNIT = SINGULAR_ALIGNMENT / sizeof(double);
+	EXPECT_EQ(0, singular::DynamicMatrix::paddedLeadingDimension(0));
+	EXPECT_EQ(UNIT, singular::DynamicMatrix::paddedLeadingDimension(1));
+	EXPECT_EQ(3 * UNIT, singular::DynamicMatrix::paddedLeadingDimension(
+		2 * UNIT));
+	EXPECT_EQ(65 * UNIT, singular::DynamicMatrix::paddedLeadingDimension(
+		64 * UNIT));
+	EXPECT_EQ(65 * UNIT, singular::DynamicMatrix::paddedLeadingDimension(
+		64 * UNIT - 1));
+}
+
+TEST(DynamicMatrixTest, Padded_matrix_should_behave_like_packed_matrix) {
+	const int M = 5;
+	const int N = 64;
+	double values[M * N];
+	for (int i = 0; i < M * N; ++i) {
+		values[i] = i * 0.25 - 7.0;
+	}
+	singular::DynamicMatrix packed =
+		singular::DynamicMatrix::filledWith(M, N, values);
+	singular::DynamicMatrix padded = singular::DynamicMatrix::padded(M, N);
+	EXPECT_LT(N, padded.leadingDimension());
+	for (int i = 0; i < M; ++i) {
+		const size_t address =
+			reinterpret_cast< size_t >(&padded(i, 0));
+		ASSERT_EQ(0u, address % SINGULAR_ALIGNMENT);
+	}
+	padded.fill(values);
+	singular::DynamicMatrix clone = padded.clone();
+	EXPECT_EQ(padded.leadingDimension(), clone.leadingDimension());
+	singular::MatrixView view = padded.view();
+	EXPECT_EQ(padded.leadingDimension(), view.leadingDimension());
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			ASSERT_EQ(packed(i, j), padded(i, j));
+			ASSERT_EQ(packed(i, j), clone(i, j));
+			ASSERT_EQ(packed(i, j), view(i, j));
+			ASSERT_EQ(packed(i, j), padded.row(i)[j]);
+			ASSERT_EQ(packed(i, j), padded.column(j)[i]);
+		}
+	}
+	singular::DynamicMatrix t = padded.transpose();
+	singular::DynamicMatrix product = padded * t;
+	singular::DynamicMatrix expected = packed * packed.transpose();
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < M; ++j) {
+			ASSERT_EQ(expected(i, j), product(i, j));
+		}
+	}
+}
+
+TEST(DynamicMatrixTest, Padded_square_matrix_can_be_transposed_in_place) {
+	singular::DynamicMatrix m = singular::DynamicMatrix::padded(16, 16);
+	for (int i = 0; i < 16; ++i) {
+		for (int j = 0; j < 16; ++j) {
+			m(i, j) = i * 16.0 + j;
+		}
+	}
+	m.transposeInPlace();
+	for (int i = 0; i < 16; ++i) {
+		for (int j = 0; j < 16; ++j) {
+			ASSERT_EQ(j * 16.0 + i, m(i, j));
+		}
+	}
+}
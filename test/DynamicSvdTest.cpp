@@ -0,0 +1,826 @@
+#include "singular/DynamicSvd.h"
+#include "singular/Svd.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+/**
+ * Multiplies U, S and V^T from a given decomposition.
+ *
+ * @param svd
+ *     Decomposition to be multiplied.
+ * @return
+ *     U * S * V^T.
+ */
+static singular::DynamicMatrix multiplyUSV(const singular::DynamicSvd& svd) {
+	const singular::DynamicMatrix& u = svd.getU();
+	const std::vector< double >& s = svd.getS();
+	singular::DynamicMatrix us(u.rows(), svd.getV().columns());
+	for (int i = 0; i < us.rows(); ++i) {
+		for (size_t j = 0; j < s.size(); ++j) {
+			us(i, j) = u(i, j) * s[j];
+		}
+	}
+	return us * svd.getV().transpose();
+}
+
+/**
+ * Expects columns of a given matrix are orthonormal.
+ *
+ * @param m
+ *     Matrix to be tested.
+ */
+static void expectOrthonormal(const singular::DynamicMatrix& m) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	singular::DynamicMatrix eye = m.transpose() * m;
+	for (int i = 0; i < eye.rows(); ++i) {
+		for (int j = 0; j < eye.columns(); ++j) {
+			EXPECT_NEAR(i == j ? 1.0 : 0.0, eye(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+/** Fixture for SVD on a 5x4 matrix of runtime dimensions. */
+class DynamicSvdOn5x4MatrixTest : public ::testing::Test {
+protected:
+	/** Number of rows in the input matrix. */
+	static const int M = 5;
+
+	/** Number of columns in the input matrix. */
+	static const int N = 4;
+
+	/** Input matrix. */
+	singular::DynamicMatrix m;
+
+	/** SVD engine. */
+	singular::DynamicSvd svd;
+
+	/** Builds a matrix and performs SVD on it. */
+	virtual void SetUp() {
+		const double DATA[] = {
+			1.0, 2.0, 3.0, 4.0,
+			5.0, 6.0, 7.0, 8.0,
+			4.0, 8.0, 3.0, 5.0,
+			6.0, 7.0, 2.0, 1.0,
+			9.0, 1.0, 3.0, 6.0
+		};
+		this->m = singular::DynamicMatrix::filledWith(M, N, DATA);
+		this->svd.decomposeUSV(this->m);
+	}
+};
+
+TEST_F(DynamicSvdOn5x4MatrixTest, Singular_vectors_should_be_orthonormal) {
+	EXPECT_EQ(5, this->svd.getU().rows());
+	EXPECT_EQ(4, this->svd.getV().rows());
+	expectOrthonormal(this->svd.getU());
+	expectOrthonormal(this->svd.getV());
+}
+
+TEST_F(DynamicSvdOn5x4MatrixTest, Multiplication_of_USV_should_be_input_matrix) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	singular::DynamicMatrix m2 = multiplyUSV(this->svd);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(this->m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST_F(DynamicSvdOn5x4MatrixTest, 4_positive_singular_values_should_be_produced) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	const std::vector< double >& s = this->svd.getS();
+	ASSERT_EQ(4u, s.size());
+	EXPECT_NEAR(21.3113428837071, s[0], ROUNDED_ERROR * 10);
+	EXPECT_NEAR(6.71730295404777, s[1], ROUNDED_ERROR);
+	EXPECT_NEAR(5.77467474261999, s[2], ROUNDED_ERROR);
+	EXPECT_NEAR(1.53545990945876, s[3], ROUNDED_ERROR);
+}
+
+TEST_F(DynamicSvdOn5x4MatrixTest, Results_should_be_the_same_as_Svd) {
+	singular::Matrix< M, N > m2;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			m2(i, j) = this->m(i, j);
+		}
+	}
+	singular::Svd< M, N >::USV usv = singular::Svd< M, N >::decomposeUSV(m2);
+	const singular::Matrix< M, M >& u = singular::Svd< M, N >::getU(usv);
+	const singular::DiagonalMatrix< M, N >& s =
+		singular::Svd< M, N >::getS(usv);
+	const singular::Matrix< N, N >& v = singular::Svd< M, N >::getV(usv);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < M; ++j) {
+			EXPECT_EQ(u(i, j), this->svd.getU()(i, j));
+		}
+	}
+	for (int i = 0; i < N; ++i) {
+		EXPECT_EQ(s(i, i), this->svd.getS()[i]);
+		for (int j = 0; j < N; ++j) {
+			EXPECT_EQ(v(i, j), this->svd.getV()(i, j));
+		}
+	}
+}
+
+TEST_F(DynamicSvdOn5x4MatrixTest, Engine_can_decompose_matrices_of_different_shapes) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const double DATA[] = {
+		3.5, -0.4, 2.7, 1.5, 5.0,
+		-2.0, 9.2, 1.1, 0.5, 3.8,
+		4.9, 5.5, 4.7, -2.9, 6.0
+	};
+	singular::DynamicMatrix m2 = singular::DynamicMatrix::filledWith(3, 5, DATA);
+	this->svd.decomposeUSV(m2);
+	EXPECT_EQ(3, this->svd.getU().rows());
+	EXPECT_EQ(5, this->svd.getV().rows());
+	EXPECT_EQ(3u, this->svd.getS().size());
+	expectOrthonormal(this->svd.getU());
+	expectOrthonormal(this->svd.getV());
+	singular::DynamicMatrix m3 = multiplyUSV(this->svd);
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 5; ++j) {
+			EXPECT_NEAR(m2(i, j), m3(i, j), ROUNDED_ERROR);
+		}
+	}
+	for (size_t i = 0; i + 1 < this->svd.getS().size(); ++i) {
+		EXPECT_GE(this->svd.getS()[i], this->svd.getS()[i + 1]);
+	}
+}
+
+TEST_F(DynamicSvdOn5x4MatrixTest, Thin_left_singular_vectors_should_be_5x4) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	singular::DynamicSvd thin;
+	thin.decomposeUSV(this->m, singular::SVD_THIN, singular::SVD_FULL);
+	EXPECT_EQ(5, thin.getU().rows());
+	EXPECT_EQ(4, thin.getU().columns());
+	expectOrthonormal(thin.getU());
+	singular::DynamicMatrix m2 = multiplyUSV(thin);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(this->m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST_F(DynamicSvdOn5x4MatrixTest, Reconstruction_from_thin_singular_vectors_should_be_input_matrix) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	singular::DynamicSvd thin;
+	thin.decomposeUSV(this->m, singular::SVD_THIN, singular::SVD_THIN);
+	singular::DynamicMatrix m2 = thin.reconstruct();
+	ASSERT_EQ(5, m2.rows());
+	ASSERT_EQ(4, m2.columns());
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(this->m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST_F(DynamicSvdOn5x4MatrixTest, Reconstruction_should_reuse_given_matrix) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	singular::DynamicMatrix m2(5, 4);
+	const double* pBlock = m2.data();
+	this->svd.reconstruct(m2);
+	EXPECT_EQ(pBlock, m2.data());
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(this->m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST(DynamicSvdTest, Reconstruction_should_keep_padding_of_given_matrix) {
+	// the larger shape goes through blocked products
+	const int SHAPES[][2] = { { 7, 5 }, { 70, 61 } };
+	for (int k = 0; k < 2; ++k) {
+		const int M = SHAPES[k][0];
+		const int N = SHAPES[k][1];
+		singular::DynamicMatrix m(M, N);
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < N; ++j) {
+				m(i, j) = ((i * 7 + j * 3) % 17) - 8.0;
+			}
+		}
+		singular::DynamicSvd svd;
+		svd.decomposeUSV(m);
+		singular::DynamicMatrix m2 = singular::DynamicMatrix::padded(M, N);
+		ASSERT_LT(N, m2.leadingDimension());
+		const double* pBlock = m2.data();
+		svd.reconstruct(m2);
+		EXPECT_EQ(pBlock, m2.data());
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < N; ++j) {
+				EXPECT_NEAR(m(i, j), m2(i, j), 1.0e-12) << M << "x" << N;
+			}
+		}
+	}
+}
+
+TEST_F(DynamicSvdOn5x4MatrixTest, Skipped_singular_vectors_should_be_empty) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	singular::DynamicSvd none;
+	none.decomposeUSV(this->m, singular::SVD_NONE, singular::SVD_NONE);
+	EXPECT_EQ(0, none.getU().rows());
+	EXPECT_EQ(0, none.getU().columns());
+	EXPECT_EQ(0, none.getV().rows());
+	EXPECT_EQ(0, none.getV().columns());
+	ASSERT_EQ(4u, none.getS().size());
+	for (int i = 0; i < 4; ++i) {
+		// values only path uses dqds; compares relatively
+		EXPECT_NEAR(this->svd.getS()[i], none.getS()[i],
+					this->svd.getS()[i] * ROUNDED_ERROR);
+	}
+}
+
+TEST(DynamicSvdTest, Thin_right_singular_vectors_of_3x5_matrix_should_be_5x3) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const double DATA[] = {
+		3.5, -0.4, 2.7, 1.5, 5.0,
+		-2.0, 9.2, 1.1, 0.5, 3.8,
+		4.9, 5.5, 4.7, -2.9, 6.0
+	};
+	singular::DynamicMatrix m = singular::DynamicMatrix::filledWith(3, 5, DATA);
+	singular::DynamicSvd svd;
+	svd.decomposeUSV(m, singular::SVD_THIN, singular::SVD_THIN);
+	EXPECT_EQ(3, svd.getU().rows());
+	EXPECT_EQ(3, svd.getU().columns());
+	EXPECT_EQ(5, svd.getV().rows());
+	EXPECT_EQ(3, svd.getV().columns());
+	expectOrthonormal(svd.getU());
+	expectOrthonormal(svd.getV());
+	singular::DynamicMatrix m2 = multiplyUSV(svd);
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 5; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST(DynamicSvdTest, Large_matrix_can_be_decomposed) {
+	const double ROUNDED_ERROR = 1.0e-11;
+	const int M = 120;
+	const int N = 80;
+	// fills with pseudo random numbers in [-1, 1)
+	singular::DynamicMatrix m(M, N);
+	unsigned int seed = 12345;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			seed = seed * 1103515245u + 12345u;
+			m(i, j) = static_cast< double >((seed >> 8) % 65536) / 32768.0
+				- 1.0;
+		}
+	}
+	singular::DynamicSvd svd;
+	svd.decomposeUSV(m);
+	expectOrthonormal(svd.getU());
+	expectOrthonormal(svd.getV());
+	singular::DynamicMatrix m2 = multiplyUSV(svd);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST(DynamicSvdTest, Singular_values_only_should_match_USV_on_large_matrix) {
+	const int M = 90;
+	const int N = 70;
+	singular::DynamicMatrix m(M, N);
+	unsigned int seed = 54321;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			seed = seed * 1103515245u + 12345u;
+			m(i, j) = static_cast< double >((seed >> 8) % 65536) / 32768.0
+				- 1.0;
+		}
+	}
+	singular::DynamicSvd usv;
+	usv.decomposeUSV(m);
+	singular::DynamicSvd s;
+	s.decomposeS(m);
+	EXPECT_EQ(0, s.getU().rows());
+	EXPECT_EQ(0, s.getV().rows());
+	ASSERT_EQ(usv.getS().size(), s.getS().size());
+	for (size_t i = 0; i < s.getS().size(); ++i) {
+		EXPECT_NEAR(usv.getS()[i], s.getS()[i], usv.getS()[i] * 1.0e-12);
+	}
+}
+
+TEST(DynamicSvdTest, Block_diagonal_matrix_should_split_into_blocks) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const double DATA1[] = {
+		4.0, 1.0, -2.0,
+		2.0, 6.0, 1.0,
+		-1.0, 3.0, 5.0
+	};
+	const double DATA2[] = {
+		0.5, 7.0,
+		-3.0, 2.0
+	};
+	singular::DynamicMatrix m1 = singular::DynamicMatrix::filledWith(3, 3, DATA1);
+	singular::DynamicMatrix m2 = singular::DynamicMatrix::filledWith(2, 2, DATA2);
+	singular::DynamicMatrix m(5, 5);
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			m(i, j) = m1(i, j);
+		}
+	}
+	for (int i = 0; i < 2; ++i) {
+		for (int j = 0; j < 2; ++j) {
+			m(i + 3, j + 3) = m2(i, j);
+		}
+	}
+	singular::DynamicSvd svd;
+	svd.decomposeUSV(m);
+	expectOrthonormal(svd.getU());
+	expectOrthonormal(svd.getV());
+	singular::DynamicMatrix m3 = multiplyUSV(svd);
+	for (int i = 0; i < 5; ++i) {
+		for (int j = 0; j < 5; ++j) {
+			EXPECT_NEAR(m(i, j), m3(i, j), ROUNDED_ERROR);
+		}
+	}
+	// singular values are the union of those of blocks
+	std::vector< double > expected;
+	singular::DynamicSvd svd1;
+	svd1.decomposeS(m1);
+	expected.insert(expected.end(), svd1.getS().begin(), svd1.getS().end());
+	svd1.decomposeS(m2);
+	expected.insert(expected.end(), svd1.getS().begin(), svd1.getS().end());
+	std::sort(expected.begin(), expected.end(), std::greater< double >());
+	for (int i = 0; i < 5; ++i) {
+		EXPECT_NEAR(expected[i], svd.getS()[i], ROUNDED_ERROR);
+	}
+}
+
+TEST(DynamicSvdTest, Zero_diagonal_elements_should_be_chased_out) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	// bidiagonal with zeros at an interior and the last diagonal element
+	const double DATA[] = {
+		1.0, 1.0, 0.0, 0.0, 0.0,
+		0.0, 0.0, 1.0, 0.0, 0.0,
+		0.0, 0.0, 2.0, 1.0, 0.0,
+		0.0, 0.0, 0.0, 3.0, 1.0,
+		0.0, 0.0, 0.0, 0.0, 0.0
+	};
+	singular::DynamicMatrix m = singular::DynamicMatrix::filledWith(5, 5, DATA);
+	singular::DynamicSvd svd;
+	svd.decomposeUSV(m);
+	expectOrthonormal(svd.getU());
+	expectOrthonormal(svd.getV());
+	singular::DynamicMatrix m2 = multiplyUSV(svd);
+	for (int i = 0; i < 5; ++i) {
+		for (int j = 0; j < 5; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+	singular::DynamicSvd s;
+	s.decomposeS(m);
+	for (int i = 0; i < 5; ++i) {
+		EXPECT_NEAR(s.getS()[i], svd.getS()[i], ROUNDED_ERROR);
+	}
+	// the first two columns are the same
+	EXPECT_NEAR(0.0, svd.getS()[4], ROUNDED_ERROR);
+}
+
+TEST(DynamicSvdTest, Rank_deficient_large_matrix_can_be_decomposed) {
+	const double ROUNDED_ERROR = 1.0e-11;
+	const int M = 200;
+	const int N = 150;
+	// rank 2
+	singular::DynamicMatrix m(M, N);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			m(i, j) = (i + 1) * 0.01 + (j + 1) * 0.02 * (i % 3);
+		}
+	}
+	singular::DynamicSvd svd;
+	svd.decomposeUSV(m);
+	expectOrthonormal(svd.getU());
+	expectOrthonormal(svd.getV());
+	singular::DynamicMatrix m2 = multiplyUSV(svd);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+	for (int i = 2; i < N; ++i) {
+		EXPECT_NEAR(0.0, svd.getS()[i], svd.getS()[0] * 1.0e-13);
+	}
+}
+
+TEST(DynamicSvdTest, Split_blocks_can_be_iterated_on_thread_pool) {
+	const double ROUNDED_ERROR = 1.0e-12;
+	const int NUM_BLOCKS = 4;
+	const int BLOCK_SIZE = 30;
+	const int M = NUM_BLOCKS * BLOCK_SIZE;
+	// block diagonal matrix whose bidiagonal form splits into 4 blocks
+	singular::DynamicMatrix m(M, M);
+	unsigned int seed = 2468;
+	for (int k = 0; k < NUM_BLOCKS; ++k) {
+		for (int i = 0; i < BLOCK_SIZE; ++i) {
+			for (int j = 0; j < BLOCK_SIZE; ++j) {
+				seed = seed * 1103515245u + 12345u;
+				m(k * BLOCK_SIZE + i, k * BLOCK_SIZE + j) =
+					static_cast< double >((seed >> 8) % 65536) / 32768.0
+					- 1.0;
+			}
+		}
+	}
+	singular::DynamicSvd serial;
+	serial.decomposeUSV(m);
+	singular::ThreadPool pool(4);
+	singular::DynamicSvd svd(pool);
+	svd.decomposeUSV(m);
+	expectOrthonormal(svd.getU());
+	expectOrthonormal(svd.getV());
+	singular::DynamicMatrix m2 = multiplyUSV(svd);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < M; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+	for (int i = 0; i < M; ++i) {
+		EXPECT_NEAR(serial.getS()[i], svd.getS()[i], ROUNDED_ERROR);
+	}
+}
+
+TEST(DynamicSvdTest, Decompositions_sharing_thread_pool_can_run_from_its_tasks) {
+	const double ROUNDED_ERROR = 1.0e-12;
+	const int NUM_BLOCKS = 4;
+	const int BLOCK_SIZE = 30;
+	const int M = NUM_BLOCKS * BLOCK_SIZE;
+	const int NUM_DECOMPOSITIONS = 4;
+	// block diagonal matrix whose bidiagonal form splits into 4 blocks
+	singular::DynamicMatrix m(M, M);
+	unsigned int seed = 1234;
+	for (int k = 0; k < NUM_BLOCKS; ++k) {
+		for (int i = 0; i < BLOCK_SIZE; ++i) {
+			for (int j = 0; j < BLOCK_SIZE; ++j) {
+				seed = seed * 1103515245u + 12345u;
+				m(k * BLOCK_SIZE + i, k * BLOCK_SIZE + j) =
+					static_cast< double >((seed >> 8) % 65536) / 32768.0
+					- 1.0;
+			}
+		}
+	}
+	singular::DynamicSvd serial;
+	serial.decomposeUSV(m);
+	// more decompositions than workers, so every worker waits for one
+	singular::ThreadPool pool(2);
+	std::vector< std::vector< double > > ss(NUM_DECOMPOSITIONS);
+	for (int d = 0; d < NUM_DECOMPOSITIONS; ++d) {
+		std::vector< double >* pS = &ss[d];
+		pool.submit([&pool, &m, pS]() {
+			singular::DynamicSvd svd(pool);
+			svd.decomposeUSV(m);
+			*pS = svd.getS();
+		});
+	}
+	pool.wait();
+	for (int d = 0; d < NUM_DECOMPOSITIONS; ++d) {
+		ASSERT_EQ(static_cast< size_t >(M), ss[d].size());
+		for (int i = 0; i < M; ++i) {
+			EXPECT_NEAR(serial.getS()[i], ss[d][i], ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST(DynamicSvdTest, Rotations_can_be_applied_to_row_blocks_on_thread_pool) {
+	const double ROUNDED_ERROR = 1.0e-11;
+	// at least twice as many rows as a thread takes
+	const int M = 2 * singular::SvdKernel::MIN_CONCURRENT_ROWS + 30;
+	const int N = M - 20;
+	singular::DynamicMatrix m(M, N);
+	unsigned int seed = 1357;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			seed = seed * 1103515245u + 12345u;
+			m(i, j) = static_cast< double >((seed >> 8) % 65536) / 32768.0
+				- 1.0;
+		}
+	}
+	singular::DynamicSvd serial;
+	serial.decomposeUSV(m);
+	singular::ThreadPool pool(3);
+	singular::DynamicSvd svd(pool);
+	svd.decomposeUSV(m);
+	expectOrthonormal(svd.getU());
+	expectOrthonormal(svd.getV());
+	singular::DynamicMatrix m2 = multiplyUSV(svd);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+	for (int i = 0; i < N; ++i) {
+		EXPECT_NEAR(serial.getS()[i], svd.getS()[i], ROUNDED_ERROR);
+	}
+}
+
+TEST(DynamicSvdTest, Blocked_bidiagonalization_should_match_column_by_column) {
+	typedef singular::SvdKernel Kernel;
+	// a few panels and a remainder reduced column by column
+	const int N = Kernel::MIN_BLOCKED_SIZE +
+		2 * Kernel::BIDIAGONAL_BLOCK_SIZE + 5;
+	const int M = N + 11;
+	std::vector< double > a(M * N);
+	unsigned int seed = 2468;
+	for (size_t i = 0; i < a.size(); ++i) {
+		seed = seed * 1103515245u + 12345u;
+		a[i] = static_cast< double >((seed >> 8) % 65536) / 32768.0 - 1.0;
+	}
+	// both orders of summation differ by rounding errors that grow with
+	// the size and norm of the matrix
+	double norm = 0.0;
+	for (size_t i = 0; i < a.size(); ++i) {
+		norm += a[i] * a[i];
+	}
+	const double ROUNDED_ERROR =
+		N * std::numeric_limits< double >::epsilon() * std::sqrt(norm);
+	std::vector< double > aRef(a);
+	std::vector< double > work(Kernel::bidiagonalWorkSize(M, N));
+	std::vector< double > tau(4 * N);
+	std::vector< double > bBlock(2 * N);
+	singular::MatrixView m(a.data(), M, N, singular::COLUMN_MAJOR);
+	singular::BidiagonalMatrix b(bBlock.data(), N);
+	Kernel::bidiagonalize(
+		m, b, work.data(), tau.data(), tau.data() + N);
+	singular::MatrixView mRef(aRef.data(), M, N, singular::COLUMN_MAJOR);
+	Kernel::bidiagonalizeColumns(
+		mRef, 0, work.data(), tau.data() + 2 * N, tau.data() + 3 * N);
+	for (int i = 0; i < N; ++i) {
+		EXPECT_NEAR(mRef(i, i), b(i, i), ROUNDED_ERROR) << "row " << i;
+		if (i + 1 < N) {
+			EXPECT_NEAR(mRef(i, i + 1), b(i, i + 1), ROUNDED_ERROR)
+				<< "row " << i;
+		}
+	}
+	// reflectors are stored in the same places
+	for (int i = 0; i < M * N; ++i) {
+		EXPECT_NEAR(aRef[i], a[i], ROUNDED_ERROR);
+	}
+	for (int i = 0; i + 1 < N; ++i) {
+		EXPECT_NEAR(tau[2 * N + i], tau[i], ROUNDED_ERROR);
+		EXPECT_NEAR(tau[3 * N + i], tau[N + i], ROUNDED_ERROR);
+	}
+}
+
+TEST(DynamicSvdTest, Tall_matrix_should_be_decomposed_via_QR) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const int M = 100;
+	const int N = 8;
+	ASSERT_TRUE(singular::SvdKernel::usesQr(M, N));
+	singular::DynamicMatrix m(M, N);
+	unsigned int seed = 13579;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			seed = seed * 1103515245u + 12345u;
+			m(i, j) = static_cast< double >((seed >> 8) % 65536) / 32768.0
+				- 1.0;
+		}
+	}
+	singular::DynamicSvd svd;
+	// full U
+	svd.decomposeUSV(m);
+	EXPECT_EQ(M, svd.getU().columns());
+	expectOrthonormal(svd.getU());
+	expectOrthonormal(svd.getV());
+	singular::DynamicMatrix m2 = multiplyUSV(svd);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+	// thin U
+	std::vector< double > s = svd.getS();
+	svd.decomposeUSV(m, singular::SVD_THIN, singular::SVD_FULL);
+	EXPECT_EQ(N, svd.getU().columns());
+	expectOrthonormal(svd.getU());
+	m2 = multiplyUSV(svd);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+	// singular values only
+	svd.decomposeS(m);
+	for (int i = 0; i < N; ++i) {
+		EXPECT_NEAR(s[i], svd.getS()[i], ROUNDED_ERROR);
+	}
+}
+
+TEST(DynamicSvdTest, Zero_padded_rows_should_not_change_singular_values) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const double DATA[] = {
+		1.0, 2.0, 3.0,
+		4.0, -5.0, 6.0,
+		7.0, 8.0, -9.0
+	};
+	singular::DynamicMatrix b = singular::DynamicMatrix::filledWith(3, 3, DATA);
+	singular::DynamicMatrix m(12, 3);
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			m(i + 4, j) = b(i, j);
+		}
+	}
+	singular::DynamicSvd svdB;
+	svdB.decomposeUSV(b);
+	singular::DynamicSvd svd;
+	svd.decomposeUSV(m);
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_NEAR(svdB.getS()[i], svd.getS()[i], ROUNDED_ERROR);
+	}
+	expectOrthonormal(svd.getU());
+	singular::DynamicMatrix m2 = multiplyUSV(svd);
+	for (int i = 0; i < 12; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST(DynamicSvdTest, Padded_matrix_should_give_the_same_results_as_packed) {
+	const int SHAPES[][2] = { { 40, 24 }, { 24, 40 } };
+	for (int k = 0; k < 2; ++k) {
+		const int M = SHAPES[k][0];
+		const int N = SHAPES[k][1];
+		singular::DynamicMatrix packed(M, N);
+		singular::DynamicMatrix padded = singular::DynamicMatrix::padded(M, N);
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < N; ++j) {
+				packed(i, j) = padded(i, j) = std::sin(i * 0.7 + j * 1.3);
+			}
+		}
+		singular::DynamicSvd svd;
+		svd.decomposeUSV(packed);
+		const std::vector< double > s = svd.getS();
+		const singular::DynamicMatrix u = svd.getU().clone();
+		const singular::DynamicMatrix v = svd.getV().clone();
+		svd.decomposeUSV(padded);
+		for (int i = 0; i < static_cast< int >(s.size()); ++i) {
+			ASSERT_EQ(s[i], svd.getS()[i]);
+		}
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < M; ++j) {
+				ASSERT_EQ(u(i, j), svd.getU()(i, j));
+			}
+		}
+		for (int i = 0; i < N; ++i) {
+			for (int j = 0; j < N; ++j) {
+				ASSERT_EQ(v(i, j), svd.getV()(i, j));
+			}
+		}
+	}
+}
+
+TEST(DynamicSvdTest, Decomposition_into_caller_buffers_should_equal_results) {
+	const int SHAPES[][2] = { { 30, 20 }, { 20, 30 }, { 90, 20 } };
+	for (int k = 0; k < 3; ++k) {
+		const int M = SHAPES[k][0];
+		const int N = SHAPES[k][1];
+		const int Q = M < N ? M : N;
+		// column-major input with padded columns
+		const int LDA = M + 3;
+		std::vector< double > a(LDA * N);
+		singular::DynamicMatrix m(M, N);
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < N; ++j) {
+				m(i, j) = a[j * LDA + i] = std::cos(i * 1.1 - j * 0.3);
+			}
+		}
+		singular::DynamicSvd svd;
+		svd.decomposeUSV(m, singular::SVD_THIN, singular::SVD_FULL);
+		std::vector< double > u(M * Q);
+		std::vector< double > s(Q);
+		std::vector< double > v(N * N);
+		singular::DynamicSvd engine;
+		engine.decomposeUSV(
+			singular::MatrixView(a.data(), M, N, LDA, singular::COLUMN_MAJOR),
+			singular::MatrixView(u.data(), M, Q, singular::COLUMN_MAJOR),
+			s.data(),
+			singular::MatrixView(v.data(), N, N, singular::COLUMN_MAJOR),
+			singular::SVD_THIN,
+			singular::SVD_FULL);
+		for (int i = 0; i < Q; ++i) {
+			ASSERT_EQ(svd.getS()[i], s[i]);
+		}
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < Q; ++j) {
+				ASSERT_EQ(svd.getU()(i, j), u[j * M + i]);
+			}
+		}
+		for (int i = 0; i < N; ++i) {
+			for (int j = 0; j < N; ++j) {
+				ASSERT_EQ(svd.getV()(i, j), v[j * N + i]);
+			}
+		}
+		// the engine keeps no results of its own
+		EXPECT_EQ(0u, engine.getS().size());
+	}
+}
+
+TEST(DynamicSvdTest, View_can_be_decomposed_without_copying_into_matrix) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const int M = 6;
+	const int N = 4;
+	// row-major input with padded rows
+	double a[M * 5];
+	singular::DynamicMatrix m(M, N);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			m(i, j) = a[i * 5 + j] = (i + 1.0) / (j + 2.0);
+		}
+	}
+	singular::DynamicSvd svd;
+	svd.decomposeUSV(m);
+	const std::vector< double > s = svd.getS();
+	svd.decomposeS(singular::MatrixView(a, M, N, 5));
+	for (int i = 0; i < N; ++i) {
+		EXPECT_NEAR(s[i], svd.getS()[i], ROUNDED_ERROR);
+	}
+	EXPECT_EQ(0, svd.getU().columns());
+}
+
+/**
+ * Expects a decomposition in a given precision reproduces a random matrix
+ * and agrees with the decomposition in `double`.
+ *
+ * @tparam T
+ *     Type of elements.
+ * @param M
+ *     Number of rows.
+ * @param N
+ *     Number of columns.
+ * @param roundedError
+ *     Tolerance for elements of reconstructed and orthonormal matrices.
+ */
+template < typename T >
+static void expectDecomposesIn(int M, int N, T roundedError) {
+	singular::BasicDynamicMatrix< T > m(M, N);
+	singular::DynamicMatrix reference(M, N);
+	unsigned int seed = 24680;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			seed = seed * 1103515245u + 12345u;
+			m(i, j) = static_cast< T >((seed >> 8) % 65536) / 32768 - 1;
+			reference(i, j) = m(i, j);
+		}
+	}
+	singular::BasicDynamicSvd< T > svd;
+	svd.decomposeUSV(m, singular::SVD_THIN, singular::SVD_THIN);
+	singular::DynamicSvd svdRef;
+	svdRef.decomposeS(reference);
+	const int Q = M < N ? M : N;
+	ASSERT_EQ(static_cast< size_t >(Q), svd.getS().size());
+	for (int i = 0; i < Q; ++i) {
+		EXPECT_NEAR(svdRef.getS()[i], svd.getS()[i], roundedError * N)
+			<< "M " << M << " N " << N;
+	}
+	const singular::BasicDynamicMatrix< T >& u = svd.getU();
+	const singular::BasicDynamicMatrix< T >& v = svd.getV();
+	for (int i = 0; i < Q; ++i) {
+		for (int j = 0; j < Q; ++j) {
+			T uu = 0;
+			T vv = 0;
+			for (int k = 0; k < M; ++k) {
+				uu += u(k, i) * u(k, j);
+			}
+			for (int k = 0; k < N; ++k) {
+				vv += v(k, i) * v(k, j);
+			}
+			EXPECT_NEAR(i == j ? 1 : 0, uu, roundedError);
+			EXPECT_NEAR(i == j ? 1 : 0, vv, roundedError);
+		}
+	}
+	singular::BasicDynamicMatrix< T > m2 = svd.reconstruct();
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), roundedError)
+				<< "M " << M << " N " << N;
+		}
+	}
+}
+
+TEST(DynamicSvdTest, Float_matrices_can_be_decomposed) {
+	expectDecomposesIn< float >(60, 40, 1.0e-4f);
+	// factorized into QR first
+	expectDecomposesIn< float >(100, 30, 1.0e-4f);
+	expectDecomposesIn< float >(30, 50, 1.0e-4f);
+}
+
+TEST(DynamicSvdTest, Long_double_matrices_can_be_decomposed) {
+	expectDecomposesIn< long double >(60, 40, 1.0e-13L);
+	expectDecomposesIn< long double >(30, 50, 1.0e-13L);
+}
+
+TEST(DynamicSvdTest, Convergence_tolerance_should_suit_precision) {
+	EXPECT_NEAR(1.0e-15, singular::SvdKernel::tolerance< double >(), 1.0e-17);
+	EXPECT_GT(singular::SvdKernel::tolerance< float >(),
+			  std::numeric_limits< float >::epsilon());
+	EXPECT_LT(singular::SvdKernel::tolerance< float >(), 1.0e-6f);
+}
@@ -0,0 +1,264 @@
+#include "singular/Gemm.h"
+#include "singular/Simd.h"
+#include "singular/ThreadPool.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+/**
+ * Fills a given array with pseudo random numbers in [-1, 1).
+ *
+ * @param[out] values
+ *     Array to be filled.
+ * @param seed
+ *     Seed of the pseudo random numbers.
+ */
+static void fillRandom(std::vector< double >& values, unsigned int seed) {
+	for (size_t i = 0; i < values.size(); ++i) {
+		seed = seed * 1103515245u + 12345u;
+		values[i] = static_cast< double >((seed >> 8) % 65536) / 32768.0 - 1.0;
+	}
+}
+
+/**
+ * Multiplies an `M` x `K` matrix and a `K` x `N` matrix with every
+ * supported kernel and compares the products with the plain loop.
+ *
+ * @tparam T
+ *     Type of elements.
+ */
+template < typename T >
+static void expectProductsLikePlain(int M, int N, int K, T tolerance) {
+	std::vector< double > a0(M * K);
+	std::vector< double > b0(K * N);
+	fillRandom(a0, 1);
+	fillRandom(b0, 2);
+	std::vector< T > a(a0.begin(), a0.end());
+	std::vector< T > b(b0.begin(), b0.end());
+	std::vector< T > ref(M * N);
+	singular::Gemm::multiplyPlain(
+		M, N, K, a.data(), K, b.data(), N, ref.data(), N);
+	for (int level = singular::SIMD_NONE;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		std::vector< T > c(M * N, T(-1));
+		singular::Gemm::multiplyWith(
+			singular::BasicGemmKernel< T >::get(
+				static_cast< singular::SimdLevel >(level)),
+			M, N, K, a.data(), K, b.data(), N, c.data(), N);
+		for (int i = 0; i < M * N; ++i) {
+			ASSERT_NEAR(ref[i], c[i], tolerance)
+				<< "level " << level << " element " << i;
+		}
+	}
+}
+
+TEST(GemmTest, Plain_product_of_2x3_and_3x2_matrices_should_be_2x2_matrix) {
+	const double a[] = {
+		1.0, 2.0, 3.0,
+		4.0, 5.0, 6.0
+	};
+	const double b[] = {
+		7.0, 8.0,
+		9.0, 10.0,
+		11.0, 12.0
+	};
+	double c[4];
+	singular::Gemm::multiplyPlain(2, 2, 3, a, 3, b, 2, c, 2);
+	EXPECT_EQ(58.0, c[0]);
+	EXPECT_EQ(64.0, c[1]);
+	EXPECT_EQ(139.0, c[2]);
+	EXPECT_EQ(154.0, c[3]);
+}
+
+TEST(GemmTest, Blocked_product_should_equal_plain_product_on_edge_tiles) {
+	// dimensions are not multiples of any tile or block
+	expectProductsLikePlain(101, 67, 45, 1.0e-12);
+}
+
+TEST(GemmTest, Blocked_product_should_accumulate_over_blocks_of_K) {
+	// K spans 2 blocks and N spans 2 blocks
+	expectProductsLikePlain(50, 530, 300, 1.0e-12);
+}
+
+TEST(GemmTest, Blocked_float_product_should_equal_plain_product) {
+	expectProductsLikePlain(101, 67, 45, 1.0e-4f);
+	expectProductsLikePlain(50, 530, 300, 1.0e-4f);
+}
+
+TEST(GemmTest, Product_with_empty_inner_dimension_should_be_zeros) {
+	std::vector< double > c(6, -1.0);
+	singular::Gemm::multiply(2, 3, 0, 0, 0, 0, 3, c.data(), 3);
+	for (size_t i = 0; i < c.size(); ++i) {
+		EXPECT_EQ(0.0, c[i]);
+	}
+}
+
+TEST(GemmTest, Product_on_thread_pool_should_equal_serial_product) {
+	const int M = 300;
+	const int N = 200;
+	const int K = 150;
+	std::vector< double > a(M * K);
+	std::vector< double > b(K * N);
+	fillRandom(a, 3);
+	fillRandom(b, 4);
+	std::vector< double > ref(M * N);
+	singular::Gemm::multiply(
+		M, N, K, a.data(), K, b.data(), N, ref.data(), N);
+	singular::ThreadPool pool(4);
+	std::vector< double > c(M * N);
+	singular::Gemm::multiply(
+		M, N, K, a.data(), K, b.data(), N, c.data(), N, &pool);
+	for (int i = 0; i < M * N; ++i) {
+		ASSERT_EQ(ref[i], c[i]) << "element " << i;
+	}
+}
+
+TEST(GemmTest, Float_product_on_thread_pool_should_equal_serial_product) {
+	const int M = 300;
+	const int N = 200;
+	const int K = 150;
+	std::vector< double > a0(M * K);
+	std::vector< double > b0(K * N);
+	fillRandom(a0, 7);
+	fillRandom(b0, 8);
+	std::vector< float > a(a0.begin(), a0.end());
+	std::vector< float > b(b0.begin(), b0.end());
+	std::vector< float > ref(M * N);
+	singular::Gemm::multiply(
+		M, N, K, a.data(), K, b.data(), N, ref.data(), N);
+	singular::ThreadPool pool(4);
+	std::vector< float > c(M * N);
+	singular::Gemm::multiply(
+		M, N, K, a.data(), K, b.data(), N, c.data(), N, &pool);
+	for (int i = 0; i < M * N; ++i) {
+		ASSERT_EQ(ref[i], c[i]) << "element " << i;
+	}
+}
+
+TEST(GemmTest, Products_on_thread_pool_can_be_computed_from_its_tasks) {
+	const int M = 300;
+	const int N = 200;
+	const int K = 150;
+	const int NUM_PRODUCTS = 4;
+	std::vector< double > a(M * K);
+	std::vector< double > b(K * N);
+	fillRandom(a, 9);
+	fillRandom(b, 10);
+	std::vector< double > ref(M * N);
+	singular::Gemm::multiply(
+		M, N, K, a.data(), K, b.data(), N, ref.data(), N);
+	std::vector< float > aF(a.begin(), a.end());
+	std::vector< float > bF(b.begin(), b.end());
+	std::vector< float > refF(M * N);
+	singular::Gemm::multiply(
+		M, N, K, aF.data(), K, bF.data(), N, refF.data(), N);
+	// more products than workers, so every worker waits for one
+	singular::ThreadPool pool(2);
+	std::vector< std::vector< double > > cs(
+		NUM_PRODUCTS, std::vector< double >(M * N));
+	std::vector< std::vector< float > > csF(
+		NUM_PRODUCTS, std::vector< float >(M * N));
+	for (int p = 0; p < NUM_PRODUCTS; ++p) {
+		double* c = cs[p].data();
+		float* cF = csF[p].data();
+		pool.submit([&pool, &a, &b, &aF, &bF, c, cF]() {
+			singular::Gemm::multiply(
+				M, N, K, a.data(), K, b.data(), N, c, N, &pool);
+			singular::Gemm::multiply(
+				M, N, K, aF.data(), K, bF.data(), N, cF, N, &pool);
+		});
+	}
+	pool.wait();
+	for (int p = 0; p < NUM_PRODUCTS; ++p) {
+		EXPECT_TRUE(ref == cs[p]) << "product " << p;
+		EXPECT_TRUE(refF == csF[p]) << "product " << p;
+	}
+}
+
+TEST(GemmTest, Product_should_respect_leading_dimensions) {
+	// multiplies the top-left 40x40 parts of 40x50 and 50x60 matrices
+	std::vector< double > a(40 * 50);
+	std::vector< double > b(50 * 60);
+	fillRandom(a, 5);
+	fillRandom(b, 6);
+	std::vector< double > ref(40 * 40);
+	for (int i = 0; i < 40; ++i) {
+		for (int j = 0; j < 40; ++j) {
+			double x = 0.0;
+			for (int k = 0; k < 40; ++k) {
+				x += a[i * 50 + k] * b[k * 60 + j];
+			}
+			ref[i * 40 + j] = x;
+		}
+	}
+	std::vector< double > c(40 * 70, 7.0);
+	singular::Gemm::multiply(
+		40, 40, 40, a.data(), 50, b.data(), 60, c.data(), 70);
+	for (int i = 0; i < 40; ++i) {
+		for (int j = 0; j < 40; ++j) {
+			ASSERT_NEAR(ref[i * 40 + j], c[i * 70 + j], 1.0e-12);
+		}
+		for (int j = 40; j < 70; ++j) {
+			ASSERT_EQ(7.0, c[i * 70 + j]);
+		}
+	}
+}
+
+TEST(GemmTest, Strided_product_should_read_transposed_operands) {
+	// multiplies A^T and B^T where A is 60x70 and B is 80x60
+	const int M = 70;
+	const int N = 80;
+	const int K = 60;
+	std::vector< double > a(K * M);
+	std::vector< double > b(N * K);
+	fillRandom(a, 7);
+	fillRandom(b, 8);
+	std::vector< double > aT(M * K);
+	std::vector< double > bT(K * N);
+	for (int i = 0; i < M; ++i) {
+		for (int k = 0; k < K; ++k) {
+			aT[i * K + k] = a[k * M + i];
+		}
+	}
+	for (int k = 0; k < K; ++k) {
+		for (int j = 0; j < N; ++j) {
+			bT[k * N + j] = b[j * K + k];
+		}
+	}
+	std::vector< double > ref(M * N);
+	singular::Gemm::multiplyPlain(
+		M, N, K, aT.data(), K, bT.data(), N, ref.data(), N);
+	std::vector< double > c(M * N);
+	singular::Gemm::multiplyStrided(
+		M, N, K, a.data(), 1, M, b.data(), 1, K, c.data(), N);
+	for (int i = 0; i < M * N; ++i) {
+		ASSERT_NEAR(ref[i], c[i], 1.0e-12) << "element " << i;
+	}
+}
+
+TEST(GemmTest, Buffered_product_should_equal_allocating_product) {
+	// edge tiles in every direction and more than one block of K
+	const int M = 101;
+	const int N = 83;
+	const int K = 300;
+	std::vector< double > a(M * K);
+	std::vector< double > b(K * N);
+	fillRandom(a, 9);
+	fillRandom(b, 10);
+	std::vector< double > ref(M * N);
+	singular::Gemm::multiply(
+		M, N, K, a.data(), K, b.data(), N, ref.data(), N);
+	// the work block is exactly as large as required
+	std::vector< double > work(singular::Gemm::packingSize(M, N, K));
+	std::vector< double > c(M * N);
+	singular::Gemm::multiplyBuffered(
+		M, N, K, a.data(), K, b.data(), N, c.data(), N, work.data());
+	for (int i = 0; i < M * N; ++i) {
+		ASSERT_EQ(ref[i], c[i]) << "element " << i;
+	}
+	EXPECT_EQ(int(singular::GemmPackingSize< M, N, K >::VALUE),
+			  singular::Gemm::packingSize(M, N, K));
+}
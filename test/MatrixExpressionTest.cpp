@@ -0,0 +1,236 @@
+#include "singular/DiagonalMatrix.h"
+#include "singular/Matrix.h"
+
+#include "gtest/gtest.h"
+
+#include <type_traits>
+
+namespace {
+
+	const double DATA_2X3[] = {
+		1.0, 2.0, 3.0,
+		4.0, 5.0, 6.0
+	};
+
+	const double DATA_3X2[] = {
+		7.0, 8.0,
+		9.0, 10.0,
+		11.0, 12.0
+	};
+
+}
+
+TEST(MatrixExpressionTest, Transposition_should_refer_to_operand) {
+	singular::Matrix< 2, 3 > m;
+	m.fill(DATA_2X3);
+	singular::TransposeExpression< singular::Matrix< 2, 3 > > t =
+		m.transpose();
+	m(1, 2) = -6.0;
+	EXPECT_EQ(-6.0, t(2, 1));
+	EXPECT_EQ(2.0, t(1, 0));
+}
+
+TEST(MatrixExpressionTest, Double_transposition_should_be_evaluated_into_a_copy) {
+	singular::Matrix< 2, 3 > m;
+	m.fill(DATA_2X3);
+	singular::Matrix< 2, 3 > m2 = m.transpose().transpose();
+	singular::Matrix< 2, 3 > m3 = 2.0 * m.transpose().transpose();
+	m(0, 0) = -1.0;
+	for (int i = 0; i < 2; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			EXPECT_EQ(DATA_2X3[i * 3 + j], m2(i, j));
+			EXPECT_EQ(2.0 * DATA_2X3[i * 3 + j], m3(i, j));
+		}
+	}
+}
+
+TEST(MatrixExpressionTest, Scaled_matrix_should_be_evaluated_on_assignment) {
+	singular::Matrix< 2, 3 > m;
+	m.fill(DATA_2X3);
+	singular::Matrix< 2, 3 > m2 = 2.0 * m;
+	singular::Matrix< 2, 3 > m3 = m * -0.5;
+	for (int i = 0; i < 2; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			EXPECT_EQ(2.0 * m(i, j), m2(i, j));
+			EXPECT_EQ(-0.5 * m(i, j), m3(i, j));
+		}
+	}
+}
+
+TEST(MatrixExpressionTest, Product_of_transpositions_should_be_transposition_of_product) {
+	singular::Matrix< 2, 3 > lhs;
+	lhs.fill(DATA_2X3);
+	singular::Matrix< 3, 2 > rhs;
+	rhs.fill(DATA_3X2);
+	// (lhs * rhs)^T = rhs^T * lhs^T
+	singular::Matrix< 2, 2 > product = rhs.transpose() * lhs.transpose();
+	EXPECT_EQ(58.0, product(0, 0));
+	EXPECT_EQ(139.0, product(0, 1));
+	EXPECT_EQ(64.0, product(1, 0));
+	EXPECT_EQ(154.0, product(1, 1));
+}
+
+TEST(MatrixExpressionTest, Scalings_in_product_should_be_multiplied) {
+	singular::Matrix< 2, 3 > lhs;
+	lhs.fill(DATA_2X3);
+	singular::Matrix< 3, 2 > rhs;
+	rhs.fill(DATA_3X2);
+	singular::Matrix< 2, 2 > product = (2.0 * lhs) * (rhs * 0.5);
+	EXPECT_EQ(58.0, product(0, 0));
+	EXPECT_EQ(64.0, product(0, 1));
+	EXPECT_EQ(139.0, product(1, 0));
+	EXPECT_EQ(154.0, product(1, 1));
+}
+
+TEST(MatrixExpressionTest, Chained_product_with_diagonal_matrix_should_equal_step_by_step_product) {
+	singular::Matrix< 2, 3 > u;
+	u.fill(DATA_2X3);
+	const double S[] = { 2.0, -1.0 };
+	singular::DiagonalMatrix< 3, 2 > s(S);
+	singular::Matrix< 2, 2 > v;
+	v.fill(DATA_3X2);
+	// U * S * V^T
+	singular::Matrix< 2, 2 > product = u * s * v.transpose();
+	singular::Matrix< 2, 2 > us = u * s;
+	singular::Matrix< 2, 2 > vT = v.transpose();
+	for (int i = 0; i < 2; ++i) {
+		for (int j = 0; j < 2; ++j) {
+			double x = 0.0;
+			for (int k = 0; k < 2; ++k) {
+				x += us(i, k) * vT(k, j);
+			}
+			EXPECT_EQ(x, product(i, j));
+		}
+	}
+	EXPECT_EQ(2.0 * 7.0 - 2.0 * 8.0, product(0, 0));
+	EXPECT_EQ(2.0 * 9.0 - 2.0 * 10.0, product(0, 1));
+}
+
+TEST(MatrixExpressionTest, Stored_expression_should_outlive_nested_temporaries) {
+	singular::Matrix< 2, 3 > lhs;
+	lhs.fill(DATA_2X3);
+	singular::Matrix< 2, 3 > rhs;
+	rhs.fill(DATA_2X3);
+	// the transposition and the product are temporaries
+	auto product = lhs * rhs.transpose();
+	auto scaled = 0.5 * (lhs * rhs.transpose());
+	singular::Matrix< 2, 2 > m = product;
+	singular::Matrix< 2, 2 > m2 = scaled;
+	EXPECT_EQ(14.0, m(0, 0));
+	EXPECT_EQ(32.0, m(0, 1));
+	EXPECT_EQ(32.0, m(1, 0));
+	EXPECT_EQ(77.0, m(1, 1));
+	for (int i = 0; i < 2; ++i) {
+		for (int j = 0; j < 2; ++j) {
+			EXPECT_EQ(0.5 * m(i, j), m2(i, j));
+		}
+	}
+}
+
+TEST(MatrixExpressionTest, Product_of_diagonal_matrices_should_be_evaluated_right_away) {
+	const double S1[] = { 2.0, 3.0 };
+	const double S2[] = { -1.0, 4.0 };
+	singular::DiagonalMatrix< 2, 3 > s1(S1);
+	singular::DiagonalMatrix< 3, 2 > s2(S2);
+	static_assert(std::is_same< decltype(s1 * s2),
+								singular::Matrix< 2, 2 > >::value,
+				  "product of diagonal matrices should be a Matrix");
+	singular::Matrix< 2, 2 > product = s1 * s2;
+	EXPECT_EQ(-2.0, product(0, 0));
+	EXPECT_EQ(0.0, product(0, 1));
+	EXPECT_EQ(0.0, product(1, 0));
+	EXPECT_EQ(12.0, product(1, 1));
+	singular::Matrix< 2, 3 > m;
+	m.fill(DATA_2X3);
+	singular::Matrix< 2, 2 > product2 =
+		singular::Matrix< 2, 2 >::multiply(m, s2);
+	EXPECT_EQ(-1.0, product2(0, 0));
+	EXPECT_EQ(8.0, product2(0, 1));
+	EXPECT_EQ(-4.0, product2(1, 0));
+	EXPECT_EQ(20.0, product2(1, 1));
+}
+
+TEST(MatrixExpressionTest, Assignment_should_allow_aliasing) {
+	const double DATA[] = {
+		1.0, 2.0,
+		3.0, 4.0
+	};
+	singular::Matrix< 2, 2 > m;
+	m.fill(DATA);
+	m = m * m.transpose();
+	EXPECT_EQ(5.0, m(0, 0));
+	EXPECT_EQ(11.0, m(0, 1));
+	EXPECT_EQ(11.0, m(1, 0));
+	EXPECT_EQ(25.0, m(1, 1));
+}
+
+TEST(MatrixExpressionTest, Large_product_of_transpositions_should_equal_plain_product) {
+	// large enough to go through blocks of Gemm
+	singular::Matrix< 70, 60 > a;
+	singular::Matrix< 50, 70 > b;
+	for (int i = 0; i < 70; ++i) {
+		for (int j = 0; j < 60; ++j) {
+			a(i, j) = (i * 7 + j * 3) % 11 - 5.0;
+		}
+		for (int j = 0; j < 50; ++j) {
+			b(j, i) = (i * 5 + j * 2) % 13 - 6.0;
+		}
+	}
+	singular::Matrix< 60, 50 > product = a.transpose() * b.transpose();
+	for (int i = 0; i < 60; ++i) {
+		for (int j = 0; j < 50; ++j) {
+			double x = 0.0;
+			for (int k = 0; k < 70; ++k) {
+				x += a(k, i) * b(j, k);
+			}
+			ASSERT_EQ(x, product(i, j));
+		}
+	}
+}
+
+TEST(MatrixExpressionTest, Float_expressions_should_be_evaluated_in_float) {
+	const float DATA[] = {
+		1.0f, 2.0f, 3.0f,
+		4.0f, 5.0f, 6.0f
+	};
+	const float S[] = { -1.0f, 4.0f };
+	singular::Matrix< 2, 3, float > m;
+	m.fill(DATA);
+	singular::DiagonalMatrix< 3, 2, float > s(S);
+	static_assert(std::is_same< decltype(m * s)::Element, float >::value,
+				  "product of float matrices should have float elements");
+	singular::Matrix< 2, 2, float > product = 2.0f * m * s;
+	EXPECT_EQ(-2.0f, product(0, 0));
+	EXPECT_EQ(16.0f, product(0, 1));
+	EXPECT_EQ(-8.0f, product(1, 0));
+	EXPECT_EQ(40.0f, product(1, 1));
+	singular::Matrix< 3, 3, float > gram = m.transpose() * m;
+	EXPECT_EQ(17.0f, gram(0, 0));
+	EXPECT_EQ(22.0f, gram(0, 1));
+	EXPECT_EQ(45.0f, gram(2, 2));
+}
+
+TEST(MatrixExpressionTest, Large_float_product_of_transpositions_should_equal_plain_product) {
+	// large enough to go through blocks of Gemm
+	singular::Matrix< 70, 60, float > a;
+	singular::Matrix< 50, 70, float > b;
+	for (int i = 0; i < 70; ++i) {
+		for (int j = 0; j < 60; ++j) {
+			a(i, j) = (i * 7 + j * 3) % 11 - 5.0f;
+		}
+		for (int j = 0; j < 50; ++j) {
+			b(j, i) = (i * 5 + j * 2) % 13 - 6.0f;
+		}
+	}
+	singular::Matrix< 60, 50, float > product =
+		a.transpose() * b.transpose();
+	for (int i = 0; i < 60; ++i) {
+		for (int j = 0; j < 50; ++j) {
+			float x = 0.0f;
+			for (int k = 0; k < 70; ++k) {
+				x += a(k, i) * b(j, k);
+			}
+			ASSERT_EQ(x, product(i, j));
+		}
+	}
+}
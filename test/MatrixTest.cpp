@@ -658,6 +658,21 @@ TEST(MatrixTest, Transposition_of_2x3_matrix_should_be_3x2_matrix) {
 	EXPECT_EQ(-6.0, mT(2, 1));
 }
 
+TEST(MatrixTest, 3x3_matrix_can_be_transposed_in_place) {
+	const double DATA[] = {
+		1.0, 2.0, 3.0,
+		4.0, 5.0, 6.0,
+		7.0, 8.0, 9.0
+	};
+	singular::Matrix< 3, 3 > m = singular::Matrix< 3, 3 >::filledWith(DATA);
+	m.transposeInPlace();
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			EXPECT_EQ(DATA[j * 3 + i], m(i, j));
+		}
+	}
+}
+
 TEST(MatrixTest, Rows_of_3x3_matrix_can_be_shuffled) {
 	const int M = 3;
 	const int N = 3;
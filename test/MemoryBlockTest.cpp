@@ -0,0 +1,52 @@
+#include "singular/MemoryBlock.h"
+
+#include "gtest/gtest.h"
+
+#include <new>
+#include <utility>
+
+TEST(MemoryBlockTest, Small_MemoryBlock_should_store_elements_inline) {
+	singular::MemoryBlock< 4 > block;
+	const double* pBegin = reinterpret_cast< const double* >(&block);
+	EXPECT_EQ(pBegin, block.data());
+	EXPECT_EQ(sizeof(double) * 4, sizeof(block));
+}
+
+TEST(MemoryBlockTest, Large_MemoryBlock_should_allocate_elements_on_heap) {
+	const int SIZE = SINGULAR_MAX_INLINE_ELEMENTS + 1;
+	singular::MemoryBlock< SIZE > block;
+	EXPECT_EQ(sizeof(double*), sizeof(block));
+}
+
+TEST(MemoryBlockTest, Moved_inline_MemoryBlock_should_have_the_same_elements) {
+	singular::MemoryBlock< 3 > block;
+	block.data()[0] = 1.0;
+	block.data()[1] = 2.0;
+	block.data()[2] = 3.0;
+	singular::MemoryBlock< 3 > block2(std::move(block));
+	EXPECT_EQ(1.0, block2.data()[0]);
+	EXPECT_EQ(2.0, block2.data()[1]);
+	EXPECT_EQ(3.0, block2.data()[2]);
+}
+
+TEST(MemoryBlockTest, Moved_heap_MemoryBlock_should_steal_elements) {
+	const int SIZE = SINGULAR_MAX_INLINE_ELEMENTS + 1;
+	singular::MemoryBlock< SIZE > block;
+	double* pBlock = block.data();
+	singular::MemoryBlock< SIZE > block2(std::move(block));
+	EXPECT_EQ(pBlock, block2.data());
+	EXPECT_EQ(0, block.data());
+}
+
+TEST(MemoryBlockTest, Heap_MemoryBlock_should_be_aligned) {
+	const int SIZE = SINGULAR_MAX_INLINE_ELEMENTS + 1;
+	singular::MemoryBlock< SIZE > block;
+	const size_t address = reinterpret_cast< size_t >(block.data());
+	EXPECT_EQ(0u, address % SINGULAR_ALIGNMENT);
+}
+
+TEST(MemoryBlockTest, Too_large_aligned_allocation_should_throw_bad_alloc) {
+	singular::AlignedAllocator< double > allocator;
+	EXPECT_THROW(allocator.allocate(allocator.max_size() + 1),
+				 std::bad_alloc);
+}
@@ -86,7 +86,9 @@ TEST(ReflectorTest, 4x4_Reflector_can_transform_a_5x4_matrix_from_left) {
 		2.0, 1.0,  2.0,  2.0,
 		3.0, 1.0,  0.5, -3.0,
 		4.0, 1.0, -2.0,  1.5,
-		5.0, 1.0,  3.0,  2.0
+		5.0, 1.0,  3.0,  2.0,
+		// keeps the end of the strided column inside the array
+		0.0, 0.0,  0.0,  0.0
 	};
 	singular::Matrix< 5, 4 > m = singular::Matrix< 5, 4 >::filledWith(DATA);
 	singular::Reflector< 5 >
@@ -148,3 +150,77 @@ TEST(ReflectorTest, 3x3_Reflector_can_transform_a_5x4_matrix_from_right) {
 	EXPECT_NEAR(0.666666666666667, m2(4, 2), ROUNDED_ERROR);
 	EXPECT_NEAR(-0.333333333333333, m2(4, 3), ROUNDED_ERROR);
 }
+
+TEST(ReflectorTest, 4x4_Reflector_can_transform_trailing_columns_of_a_5x4_matrix_from_left_in_place) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	const double DATA[] = {
+		1.0, 2.0,  3.0,  4.0,
+		2.0, 1.0,  2.0,  2.0,
+		3.0, 1.0,  0.5, -3.0,
+		4.0, 1.0, -2.0,  1.5,
+		5.0, 1.0,  3.0,  2.0,
+		// keeps the end of the strided column inside the array
+		0.0, 0.0,  0.0,  0.0
+	};
+	singular::Matrix< 5, 4 > m = singular::Matrix< 5, 4 >::filledWith(DATA);
+	singular::Reflector< 5 >
+		h(singular::Vector< const double >(DATA + 5, 4, 4));
+	h.applyFromLeftInPlace(m, 1);
+	// the column 0 should be untouched
+	EXPECT_EQ(1.0, m(0, 0));
+	EXPECT_EQ(2.0, m(1, 0));
+	EXPECT_EQ(3.0, m(2, 0));
+	EXPECT_EQ(4.0, m(3, 0));
+	EXPECT_EQ(5.0, m(4, 0));
+	EXPECT_NEAR(2.0, m(0, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(3.0, m(0, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(4.0, m(0, 3), ROUNDED_ERROR);
+	EXPECT_NEAR(-2.0, m(1, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(-1.75, m(1, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(-1.25, m(1, 3), ROUNDED_ERROR);
+	EXPECT_NEAR(0.0, m(2, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(-0.75, m(2, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(-4.083333333333333, m(2, 3), ROUNDED_ERROR);
+	EXPECT_NEAR(0.0, m(3, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(-3.25, m(3, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(0.416666666666667, m(3, 3), ROUNDED_ERROR);
+	EXPECT_NEAR(0.0, m(4, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(1.75, m(4, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(0.916666666666667, m(4, 3), ROUNDED_ERROR);
+}
+
+TEST(ReflectorTest, 3x3_Reflector_can_transform_trailing_rows_of_a_5x4_matrix_from_right_in_place) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	const double DATA[] = {
+		1.0, 2.0,  3.0,  4.0,
+		2.0, 1.0,  2.0,  2.0,
+		3.0, 1.0,  0.5, -3.0,
+		4.0, 1.0, -2.0,  1.5,
+		5.0, 1.0,  3.0,  2.0
+	};
+	singular::Matrix< 5, 4 > m = singular::Matrix< 5, 4 >::filledWith(DATA);
+	singular::Reflector< 4 >
+		h(singular::Vector< const double >(DATA + 5, 3, 1));
+	h.applyFromRightInPlace(m, 1);
+	// the row 0 should be untouched
+	EXPECT_EQ(1.0, m(0, 0));
+	EXPECT_EQ(2.0, m(0, 1));
+	EXPECT_EQ(3.0, m(0, 2));
+	EXPECT_EQ(4.0, m(0, 3));
+	EXPECT_NEAR(2.0, m(1, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(-3.0, m(1, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(0.0, m(1, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(0.0, m(1, 3), ROUNDED_ERROR);
+	EXPECT_NEAR(3.0, m(2, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(1.333333333333333, m(2, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(0.666666666666667, m(2, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(-2.833333333333333, m(2, 3), ROUNDED_ERROR);
+	EXPECT_NEAR(4.0, m(3, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(0, m(3, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(-2.5, m(3, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(1.0, m(3, 3), ROUNDED_ERROR);
+	EXPECT_NEAR(5.0, m(4, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(-3.666666666666667, m(4, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(0.666666666666667, m(4, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(-0.333333333333333, m(4, 3), ROUNDED_ERROR);
+}
@@ -0,0 +1,259 @@
+#include "singular/RotationKernel.h"
+#include "singular/Simd.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+/**
+ * Fills a given array with pseudo random numbers in [-1, 1).
+ *
+ * @tparam T
+ *     Type of elements.
+ * @param[out] values
+ *     Array to be filled.
+ * @param seed
+ *     Seed of the pseudo random numbers.
+ */
+template < typename T >
+static void fillRandom(std::vector< T >& values, unsigned int seed) {
+	for (size_t i = 0; i < values.size(); ++i) {
+		seed = seed * 1103515245u + 12345u;
+		values[i] = static_cast< T >((seed >> 8) % 65536) / 32768 - 1;
+	}
+}
+
+TEST(RotationKernelTest, Detected_SIMD_level_should_be_consistent) {
+	EXPECT_EQ(singular::Simd::detectLevel(), singular::Simd::level());
+#if SINGULAR_SIMD_SUPPORTED
+	EXPECT_GE(singular::Simd::level(), singular::SIMD_SSE2);
+#else
+	EXPECT_EQ(singular::SIMD_NONE, singular::Simd::level());
+#endif
+}
+
+TEST(RotationKernelTest, Scalar_rotateRows_should_rotate_pairs) {
+	double x[] = { 1.0, 0.0, 3.0 };
+	double y[] = { 0.0, 1.0, 4.0 };
+	const double c = 0.6;
+	const double s = 0.8;
+	singular::RotationKernel::get(singular::SIMD_NONE)
+		.rotateRows(x, y, 3, c, s);
+	EXPECT_DOUBLE_EQ(0.6, x[0]);
+	EXPECT_DOUBLE_EQ(-0.8, y[0]);
+	EXPECT_DOUBLE_EQ(0.8, x[1]);
+	EXPECT_DOUBLE_EQ(0.6, y[1]);
+	EXPECT_DOUBLE_EQ(5.0, x[2]);
+	EXPECT_NEAR(0.0, y[2], 1.0e-15);
+}
+
+TEST(RotationKernelTest, Every_supported_level_should_rotate_rows_like_scalar) {
+	// odd size to exercise remainders
+	const size_t N = 37;
+	const double c = std::cos(0.3);
+	const double s = std::sin(0.3);
+	std::vector< double > x0(N);
+	std::vector< double > y0(N);
+	fillRandom(x0, 1);
+	fillRandom(y0, 2);
+	std::vector< double > xRef(x0);
+	std::vector< double > yRef(y0);
+	singular::RotationKernel::get(singular::SIMD_NONE)
+		.rotateRows(xRef.data(), yRef.data(), N, c, s);
+	for (int level = singular::SIMD_SSE2;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		std::vector< double > x(x0);
+		std::vector< double > y(y0);
+		singular::RotationKernel::get(
+			static_cast< singular::SimdLevel >(level))
+			.rotateRows(x.data(), y.data(), N, c, s);
+		for (size_t i = 0; i < N; ++i) {
+			EXPECT_NEAR(xRef[i], x[i], 1.0e-15) << "level " << level;
+			EXPECT_NEAR(yRef[i], y[i], 1.0e-15) << "level " << level;
+		}
+	}
+}
+
+TEST(RotationKernelTest, Every_supported_level_should_rotate_pairs_like_scalar) {
+	// 11 rows x 5 columns; rotates columns 2 and 3
+	const size_t ROWS = 11;
+	const ptrdiff_t COLUMNS = 5;
+	const double c = std::cos(-1.2);
+	const double s = std::sin(-1.2);
+	std::vector< double > m0(ROWS * COLUMNS);
+	fillRandom(m0, 3);
+	std::vector< double > ref(m0);
+	singular::RotationKernel::get(singular::SIMD_NONE)
+		.rotatePairs(ref.data() + 2, ROWS, COLUMNS, c, s);
+	for (int level = singular::SIMD_SSE2;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		std::vector< double > m(m0);
+		singular::RotationKernel::get(
+			static_cast< singular::SimdLevel >(level))
+			.rotatePairs(m.data() + 2, ROWS, COLUMNS, c, s);
+		for (size_t i = 0; i < m.size(); ++i) {
+			EXPECT_NEAR(ref[i], m[i], 1.0e-15) << "level " << level;
+		}
+	}
+}
+
+TEST(RotationKernelTest, Every_supported_level_should_rotate_float_rows_like_scalar) {
+	// odd size to exercise remainders of every register width
+	const size_t N = 45;
+	const float c = std::cos(0.3f);
+	const float s = std::sin(0.3f);
+	std::vector< float > x0(N);
+	std::vector< float > y0(N);
+	fillRandom(x0, 1);
+	fillRandom(y0, 2);
+	std::vector< float > xRef(x0);
+	std::vector< float > yRef(y0);
+	singular::BasicRotationKernel< float >::get(singular::SIMD_NONE)
+		.rotateRows(xRef.data(), yRef.data(), N, c, s);
+	for (int level = singular::SIMD_SSE2;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		std::vector< float > x(x0);
+		std::vector< float > y(y0);
+		singular::BasicRotationKernel< float >::get(
+			static_cast< singular::SimdLevel >(level))
+			.rotateRows(x.data(), y.data(), N, c, s);
+		for (size_t i = 0; i < N; ++i) {
+			EXPECT_NEAR(xRef[i], x[i], 1.0e-6f) << "level " << level;
+			EXPECT_NEAR(yRef[i], y[i], 1.0e-6f) << "level " << level;
+		}
+	}
+}
+
+TEST(RotationKernelTest, Every_supported_level_should_rotate_float_pairs_like_scalar) {
+	// 11 rows to exercise remainders of two and four pairs
+	const size_t ROWS = 11;
+	const ptrdiff_t COLUMNS = 5;
+	const float c = std::cos(-1.2f);
+	const float s = std::sin(-1.2f);
+	std::vector< float > m0(ROWS * COLUMNS);
+	fillRandom(m0, 3);
+	std::vector< float > ref(m0);
+	singular::BasicRotationKernel< float >::get(singular::SIMD_NONE)
+		.rotatePairs(ref.data() + 2, ROWS, COLUMNS, c, s);
+	for (int level = singular::SIMD_SSE2;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		std::vector< float > m(m0);
+		singular::BasicRotationKernel< float >::get(
+			static_cast< singular::SimdLevel >(level))
+			.rotatePairs(m.data() + 2, ROWS, COLUMNS, c, s);
+		for (size_t i = 0; i < m.size(); ++i) {
+			EXPECT_NEAR(ref[i], m[i], 1.0e-6f) << "level " << level;
+		}
+	}
+}
+
+TEST(RotationKernelTest, Scalar_rotateSweeps_should_apply_sweeps_one_by_one) {
+	typedef singular::RotationKernel Kernel;
+	const int SWEEPS = Kernel::SWEEPS;
+	const size_t ROWS = 5;
+	const ptrdiff_t LD = 7;
+	const int COLUMNS = 11;
+	const ptrdiff_t STRIDE = 2 * COLUMNS + 4;
+	std::vector< double > a(LD * COLUMNS);
+	std::vector< double > angles(SWEEPS * STRIDE);
+	fillRandom(a, 1);
+	fillRandom(angles, 2);
+	std::vector< double > r(SWEEPS * STRIDE);
+	for (int s = 0; s < SWEEPS; ++s) {
+		for (int i = 0; i + 1 < COLUMNS; ++i) {
+			r[s * STRIDE + 2 * i] = std::cos(angles[s * STRIDE + 2 * i]);
+			r[s * STRIDE + 2 * i + 1] = std::sin(angles[s * STRIDE + 2 * i]);
+		}
+	}
+	std::vector< double > ref(a);
+	const Kernel& kernel = Kernel::get(singular::SIMD_NONE);
+	for (int s = 0; s < SWEEPS; ++s) {
+		for (int i = 0; i + 1 < COLUMNS; ++i) {
+			kernel.rotateRows(&ref[i * LD],
+							  &ref[(i + 1) * LD],
+							  ROWS,
+							  r[s * STRIDE + 2 * i],
+							  r[s * STRIDE + 2 * i + 1]);
+		}
+	}
+	kernel.rotateSweeps(a.data(), ROWS, LD, COLUMNS, r.data(), STRIDE);
+	for (size_t i = 0; i < a.size(); ++i) {
+		EXPECT_NEAR(ref[i], a[i], 1.0e-14);
+	}
+}
+
+TEST(RotationKernelTest, Every_supported_level_should_rotate_sweeps_like_scalar) {
+	typedef singular::RotationKernel Kernel;
+	const int SWEEPS = Kernel::SWEEPS;
+	// odd sizes to exercise remainders and waves at the edges
+	const size_t ROWS = 45;
+	const ptrdiff_t LD = 47;
+	const int COLUMNS = 13;
+	const ptrdiff_t STRIDE = 2 * COLUMNS;
+	std::vector< double > a0(LD * COLUMNS);
+	std::vector< double > r(SWEEPS * STRIDE);
+	fillRandom(a0, 3);
+	fillRandom(r, 4);
+	std::vector< double > ref(a0);
+	Kernel::get(singular::SIMD_NONE).rotateSweeps(
+		ref.data(), ROWS, LD, COLUMNS, r.data(), STRIDE);
+	for (int level = singular::SIMD_SSE2;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		std::vector< double > a(a0);
+		Kernel::get(static_cast< singular::SimdLevel >(level))
+			.rotateSweeps(a.data(), ROWS, LD, COLUMNS, r.data(), STRIDE);
+		for (size_t i = 0; i < a.size(); ++i) {
+			EXPECT_NEAR(ref[i], a[i], 1.0e-14) << "level " << level;
+		}
+	}
+}
+
+TEST(RotationKernelTest, Every_supported_level_should_rotate_float_sweeps_like_scalar) {
+	typedef singular::BasicRotationKernel< float > Kernel;
+	const int SWEEPS = Kernel::SWEEPS;
+	const size_t ROWS = 77;
+	const ptrdiff_t LD = 80;
+	const int COLUMNS = 10;
+	const ptrdiff_t STRIDE = 2 * COLUMNS;
+	std::vector< float > a0(LD * COLUMNS);
+	std::vector< float > r(SWEEPS * STRIDE);
+	fillRandom(a0, 5);
+	fillRandom(r, 6);
+	std::vector< float > ref(a0);
+	Kernel::get(singular::SIMD_NONE).rotateSweeps(
+		ref.data(), ROWS, LD, COLUMNS, r.data(), STRIDE);
+	for (int level = singular::SIMD_SSE2;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		std::vector< float > a(a0);
+		Kernel::get(static_cast< singular::SimdLevel >(level))
+			.rotateSweeps(a.data(), ROWS, LD, COLUMNS, r.data(), STRIDE);
+		for (size_t i = 0; i < a.size(); ++i) {
+			EXPECT_NEAR(ref[i], a[i], 1.0e-5f) << "level " << level;
+		}
+	}
+}
+
+TEST(RotationKernelTest, Long_double_kernels_should_be_portable_at_every_level) {
+	typedef singular::BasicRotationKernel< long double > Kernel;
+	long double x[] = { 1.0L, 3.0L };
+	long double y[] = { 0.0L, 4.0L };
+	Kernel::best().rotateRows(x, y, 2, 0.6L, 0.8L);
+	EXPECT_EQ(&Kernel::get(singular::SIMD_NONE), &Kernel::best());
+	EXPECT_NEAR(0.6L, x[0], 1.0e-18L);
+	EXPECT_NEAR(-0.8L, y[0], 1.0e-18L);
+	EXPECT_NEAR(5.0L, x[1], 1.0e-18L);
+	EXPECT_NEAR(0.0L, y[1], 1.0e-18L);
+}
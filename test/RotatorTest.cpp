@@ -115,3 +115,88 @@ TEST(RotatorTest, Rotator_can_transform_4x3_matrix_from_right) {
 	EXPECT_NEAR(7.554175916040862, m2(3, 1), ROUNDED_ERROR);
 	EXPECT_NEAR(-4.993438317382943, m2(3, 2), ROUNDED_ERROR);
 }
+
+TEST(RotatorTest, Rotator_can_transform_4x3_matrix_from_left_in_place) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	const int M = 4;
+	const int N = 3;
+	const double DATA[] = {
+		1, 3, 8,
+		2, 6, 5,
+		4, 2, 7,
+		8, 9, 1
+	};
+	singular::Matrix< M, N > m = singular::Matrix< M, N >::filledWith(DATA);
+	singular::Rotator r(6, 2);
+	r.applyFromLeftInPlace(m, 1);
+	EXPECT_NEAR(1, m(0, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(3, m(0, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(8, m(0, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(3.162277660168379, m(1, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(6.324555320336759, m(1, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(6.957010852370435, m(1, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(3.162277660168379, m(2, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(0, m(2, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(5.059644256269407, m(2, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(8, m(3, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(9, m(3, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(1, m(3, 2), ROUNDED_ERROR);
+}
+
+TEST(RotatorTest, Rotator_can_transform_4x3_matrix_from_right_in_place) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	const int M = 4;
+	const int N = 3;
+	const double DATA[] = {
+		1, 3, 8,
+		2, 6, 5,
+		4, 2, 7,
+		8, 9, 1
+	};
+	singular::Matrix< M, N > m = singular::Matrix< M, N >::filledWith(DATA);
+	singular::Rotator r(6, 5);
+	r.applyFromRightInPlace(m, 1);
+	EXPECT_NEAR(1, m(0, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(7.426139036107967, m(0, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(4.225217037785567, m(0, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(2, m(1, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(7.810249675906654, m(1, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(0, m(1, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(4, m(2, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(6.017733356846111, m(2, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(4.097180157852671, m(2, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(8, m(3, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(7.554175916040862, m(3, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(-4.993438317382943, m(3, 2), ROUNDED_ERROR);
+}
+
+TEST(RotatorTest, Rotator_can_transform_column_major_4x3_matrix_in_place) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	const int M = 4;
+	const int N = 3;
+	const double DATA[] = {
+		1, 3, 8,
+		2, 6, 5,
+		4, 2, 7,
+		8, 9, 1
+	};
+	singular::Matrix< M, N > m = singular::Matrix< M, N >::filledWith(DATA);
+	// the same elements laid out in the column-major order
+	double block[M * N];
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			block[j * M + i] = DATA[i * N + j];
+		}
+	}
+	singular::MatrixView view(block, M, N, singular::COLUMN_MAJOR);
+	singular::Rotator r(6, 5);
+	r.applyFromLeftInPlace(m, 1);
+	r.applyFromLeftInPlace(view, 1);
+	r.applyFromRightInPlace(m, 1);
+	r.applyFromRightInPlace(view, 1);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(m(i, j), view(i, j), ROUNDED_ERROR);
+		}
+	}
+}
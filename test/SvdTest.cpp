@@ -79,6 +79,37 @@ TEST_F(SvdOn5x4MatrixTest, Multiplication_of_USV_should_be_input_matrix) {
 	}
 }
 
+TEST_F(SvdOn5x4MatrixTest, Reconstruction_should_be_input_matrix) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const singular::Matrix< M, N > m2 =
+		singular::Svd< M, N >::reconstruct(this->usv);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(this->m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST_F(SvdOn5x4MatrixTest, Reconstruction_with_truncated_singular_values_should_be_low_rank_approximation) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const singular::Matrix< M, M >& u = singular::Svd< M, N >::getU(this->usv);
+	const singular::DiagonalMatrix< M, N >& s =
+		singular::Svd< M, N >::getS(this->usv);
+	const singular::Matrix< N, N >& v = singular::Svd< M, N >::getV(this->usv);
+	// keeps the 2 largest singular values
+	const double TRUNCATED[] = { s(0, 0), s(1, 1), 0.0, 0.0 };
+	const singular::DiagonalMatrix< M, N > s2(TRUNCATED);
+	const singular::Matrix< M, N > m2 =
+		singular::Svd< M, N >::reconstruct(u, s2, v);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			const double ref = u(i, 0) * s(0, 0) * v(j, 0)
+				+ u(i, 1) * s(1, 1) * v(j, 1);
+			EXPECT_NEAR(ref, m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
 TEST_F(SvdOn5x4MatrixTest, 4_positive_singular_values_should_be_produced) {
 	const double ROUNDED_ERROR = 1.0e-14;
 	const singular::DiagonalMatrix< M, N >& s =
@@ -165,6 +196,17 @@ TEST_F(SvdOn4x5MatrixTest, Multiplication_of_USV_should_be_input_matrix) {
 	}
 }
 
+TEST_F(SvdOn4x5MatrixTest, Reconstruction_should_be_input_matrix) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const singular::Matrix< M, N > m2 =
+		singular::Svd< M, N >::reconstruct(this->usv);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(this->m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
 TEST_F(SvdOn4x5MatrixTest, 4_positive_singular_values_should_be_produced) {
 	// reference values were calculated at the following site
 	// http://www.bluebit.gr/matrix-calculator/
@@ -252,6 +294,17 @@ TEST_F(SvdOn3x3Rank2MatrixTest, Multiplication_of_USV_should_be_input_matrix) {
 	}
 }
 
+TEST_F(SvdOn3x3Rank2MatrixTest, Reconstruction_should_be_input_matrix) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	const singular::Matrix< M, N > m2 =
+		singular::Svd< M, N >::reconstruct(this->usv);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(this->m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
 TEST_F(SvdOn3x3Rank2MatrixTest, 2_positive_and_1_zero_singular_values_should_be_produced) {
 	const double ROUNDED_ERROR = 1.0e-14;
 	const singular::DiagonalMatrix< M, N >& s =
@@ -600,3 +653,91 @@ TEST_F(SvdOn5x4ZerosTest, Singular_values_should_be_zeros) {
 		EXPECT_NEAR(0.0, s(i, i), ROUNDED_ERROR);
 	}
 }
+
+TEST(SvdDecomposeSTest, Singular_values_of_5x4_matrix_should_be_produced) {
+	const int M = 5;
+	const int N = 4;
+	const double ROUNDED_ERROR = 1.0e-14;
+	const double DATA[] = {
+		1.0, 2.0, 3.0, 4.0,
+		5.0, 6.0, 7.0, 8.0,
+		4.0, 8.0, 3.0, 5.0,
+		6.0, 7.0, 2.0, 1.0,
+		9.0, 1.0, 3.0, 6.0
+	};
+	singular::Matrix< M, N > m = singular::Matrix< M, N >::filledWith(DATA);
+	singular::DiagonalMatrix< M, N > s = singular::Svd< M, N >::decomposeS(m);
+	EXPECT_NEAR(21.3113428837071, s(0, 0), ROUNDED_ERROR * 10);
+	EXPECT_NEAR(6.71730295404777, s(1, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(5.77467474261999, s(2, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(1.53545990945876, s(3, 3), ROUNDED_ERROR);
+}
+
+TEST(SvdDecomposeSTest, Singular_values_of_4x5_matrix_should_be_the_same_as_USV) {
+	const int M = 4;
+	const int N = 5;
+	const double ROUNDED_ERROR = 1.0e-13;
+	const double DATA[] = {
+		3.5, -0.4, 2.7, 1.5, 5.0,
+		-2.0, 9.2, 1.1, 0.5, 3.8,
+		4.9, 5.5, 4.7, -2.9, 6.0,
+		8.2, 1.3, 5.4, 2.6, -1.0
+	};
+	singular::Matrix< M, N > m = singular::Matrix< M, N >::filledWith(DATA);
+	singular::DiagonalMatrix< M, N > s = singular::Svd< M, N >::decomposeS(m);
+	singular::Svd< M, N >::USV usv = singular::Svd< M, N >::decomposeUSV(m);
+	const singular::DiagonalMatrix< M, N >& s2 =
+		singular::Svd< M, N >::getS(usv);
+	for (int i = 0; i < M; ++i) {
+		EXPECT_NEAR(s2(i, i), s(i, i), ROUNDED_ERROR);
+	}
+}
+
+TEST(SvdDecomposeSTest, Zero_singular_value_of_3x3_rank_2_matrix_should_be_produced) {
+	const int M = 3;
+	const int N = 3;
+	const double ROUNDED_ERROR = 1.0e-14;
+	const double DATA[] = {
+		1.0,  1.0, 3.0,
+		2.0, -5.0, 4.0,
+		1.0,  1.0, 3.0
+	};
+	singular::Matrix< M, N > m = singular::Matrix< M, N >::filledWith(DATA);
+	singular::DiagonalMatrix< M, N > s = singular::Svd< M, N >::decomposeS(m);
+	EXPECT_NEAR(7.11714246017378, s(0, 0), ROUNDED_ERROR);
+	EXPECT_NEAR(4.04305369758943, s(1, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(0.0, s(2, 2), ROUNDED_ERROR);
+}
+
+TEST(SvdDecomposeSTest, Singular_values_of_zero_matrix_should_be_zeros) {
+	const int M = 5;
+	const int N = 4;
+	singular::Matrix< M, N > m;
+	singular::DiagonalMatrix< M, N > s = singular::Svd< M, N >::decomposeS(m);
+	for (int i = 0; i < N; ++i) {
+		EXPECT_EQ(0.0, s(i, i));
+	}
+}
+
+TEST(SvdDecomposeSTest, Singular_value_of_1x1_matrix_should_be_its_magnitude) {
+	const double DATA[] = { -3.0 };
+	singular::Matrix< 1, 1 > m = singular::Matrix< 1, 1 >::filledWith(DATA);
+	singular::DiagonalMatrix< 1, 1 > s = singular::Svd< 1, 1 >::decomposeS(m);
+	EXPECT_DOUBLE_EQ(3.0, s(0, 0));
+}
+
+TEST(SvdDecomposeSTest, Tiny_singular_values_should_have_high_relative_accuracy) {
+	const int M = 3;
+	const int N = 3;
+	// diag(1, 1e-10, 1e-20) rotated by a permutation
+	const double DATA[] = {
+		0.0, 1.0e-10, 0.0,
+		1.0, 0.0, 0.0,
+		0.0, 0.0, 1.0e-20
+	};
+	singular::Matrix< M, N > m = singular::Matrix< M, N >::filledWith(DATA);
+	singular::DiagonalMatrix< M, N > s = singular::Svd< M, N >::decomposeS(m);
+	EXPECT_DOUBLE_EQ(1.0, s(0, 0));
+	EXPECT_DOUBLE_EQ(1.0e-10, s(1, 1));
+	EXPECT_DOUBLE_EQ(1.0e-20, s(2, 2));
+}
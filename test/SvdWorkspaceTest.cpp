@@ -0,0 +1,510 @@
+#include "singular/DynamicSvd.h"
+#include "singular/Svd.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <new>
+
+/** Number of memory allocations made by the global `operator new`. */
+static int numAllocations = 0;
+
+// GCC mistakes `free` inlined from a replaced `operator delete` for a
+// mismatch with `operator new`, so replaced operators stay out of line
+#if defined(__GNUC__)
+#define ALLOCATION_FUNCTION	__attribute__((noinline))
+#else
+#define ALLOCATION_FUNCTION
+#endif
+
+/** Counts memory allocations. */
+ALLOCATION_FUNCTION
+void* operator new(std::size_t size) {
+	++numAllocations;
+	void* p = std::malloc(size > 0 ? size : 1);
+	if (p == 0) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+/** Releases memory allocated by the counting `operator new`. */
+ALLOCATION_FUNCTION
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+/** Sized counterpart of the replaced `operator delete`. */
+ALLOCATION_FUNCTION
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+#if defined(__cpp_aligned_new)
+/** Counts memory allocations of over-aligned types. */
+ALLOCATION_FUNCTION
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	++numAllocations;
+	const std::size_t a = static_cast< std::size_t >(alignment);
+	// aligned_alloc needs a multiple of the alignment
+	void* p = std::aligned_alloc(a, (size + a - 1) / a * a);
+	if (p == 0) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+/** Releases memory allocated by the aligned counting `operator new`. */
+ALLOCATION_FUNCTION
+void operator delete(void* p, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+/** Sized counterpart of the aligned `operator delete`. */
+ALLOCATION_FUNCTION
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+	std::free(p);
+}
+#endif
+
+/** Fixture for SVD on a 5x4 matrix with a workspace. */
+class SvdWorkspaceOn5x4MatrixTest : public ::testing::Test {
+protected:
+	/** Number of rows in the input matrix. */
+	static const int M = 5;
+
+	/** Number of columns in the input matrix. */
+	static const int N = 4;
+
+	/** Input matrix. */
+	singular::Matrix< M, N > m;
+
+	/** Workspace for SVD. */
+	singular::SvdWorkspace< M, N > ws;
+
+	/** Builds an input matrix. */
+	virtual void SetUp() {
+		const double DATA[] = {
+			1.0, 2.0, 3.0, 4.0,
+			5.0, 6.0, 7.0, 8.0,
+			4.0, 8.0, 3.0, 5.0,
+			6.0, 7.0, 2.0, 1.0,
+			9.0, 1.0, 3.0, 6.0
+		};
+		this->m.fill(DATA);
+	}
+};
+
+TEST_F(SvdWorkspaceOn5x4MatrixTest, Workspace_should_hold_the_same_results_as_USV) {
+	singular::Svd< M, N >::USV usv = singular::Svd< M, N >::decomposeUSV(m);
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	const singular::Matrix< M, M >& u = singular::Svd< M, N >::getU(usv);
+	const singular::DiagonalMatrix< M, N >& s =
+		singular::Svd< M, N >::getS(usv);
+	const singular::Matrix< N, N >& v = singular::Svd< M, N >::getV(usv);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < M; ++j) {
+			EXPECT_EQ(u(i, j), this->ws.getU()(i, j));
+		}
+	}
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_EQ(s(i, j), this->ws.getS()(i, j));
+		}
+	}
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_EQ(v(i, j), this->ws.getV()(i, j));
+		}
+	}
+}
+
+TEST_F(SvdWorkspaceOn5x4MatrixTest, Decomposition_on_a_workspace_should_allocate_nothing) {
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	int count = numAllocations;
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	EXPECT_EQ(count, numAllocations);
+}
+
+TEST_F(SvdWorkspaceOn5x4MatrixTest, Workspace_can_be_reused) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	singular::Svd< M, N >::decomposeUSV(singular::Matrix< M, N >(), this->ws);
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	EXPECT_NEAR(21.3113428837071, this->ws.getS()(0, 0), ROUNDED_ERROR * 10);
+	EXPECT_NEAR(6.71730295404777, this->ws.getS()(1, 1), ROUNDED_ERROR);
+	EXPECT_NEAR(5.77467474261999, this->ws.getS()(2, 2), ROUNDED_ERROR);
+	EXPECT_NEAR(1.53545990945876, this->ws.getS()(3, 3), ROUNDED_ERROR);
+}
+
+TEST_F(SvdWorkspaceOn5x4MatrixTest, Thin_left_singular_vectors_should_be_the_first_4_columns) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	singular::SvdWorkspace< M, N > thin;
+	singular::Svd< M, N >::decomposeUSV(
+		this->m, thin, singular::SVD_THIN, singular::SVD_FULL);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(this->ws.getU()(i, j), thin.getU()(i, j),
+						ROUNDED_ERROR);
+		}
+		EXPECT_EQ(0.0, thin.getU()(i, N));
+	}
+}
+
+TEST_F(SvdWorkspaceOn5x4MatrixTest, Skipped_singular_vectors_should_be_left_unchanged) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	singular::SvdWorkspace< M, N > none;
+	singular::Svd< M, N >::decomposeUSV(
+		this->m, none, singular::SVD_NONE, singular::SVD_NONE);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < M; ++j) {
+			EXPECT_EQ(0.0, none.getU()(i, j));
+		}
+	}
+	for (int i = 0; i < N; ++i) {
+		// values only path uses dqds; compares relatively
+		EXPECT_NEAR(this->ws.getS()(i, i), none.getS()(i, i),
+					this->ws.getS()(i, i) * ROUNDED_ERROR);
+		for (int j = 0; j < N; ++j) {
+			EXPECT_EQ(0.0, none.getV()(i, j));
+		}
+	}
+}
+
+/** Fixture for SVD on a 4x5 matrix with a workspace. */
+class SvdWorkspaceOn4x5MatrixTest : public ::testing::Test {
+protected:
+	/** Number of rows in the input matrix. */
+	static const int M = 4;
+
+	/** Number of columns in the input matrix. */
+	static const int N = 5;
+
+	/** Input matrix. */
+	singular::Matrix< M, N > m;
+
+	/** Workspace for SVD. */
+	singular::SvdWorkspace< M, N > ws;
+
+	/** Builds an input matrix. */
+	virtual void SetUp() {
+		const double DATA[] = {
+			3.5, -0.4, 2.7, 1.5, 5.0,
+			-2.0, 9.2, 1.1, 0.5, 3.8,
+			4.9, 5.5, 4.7, -2.9, 6.0,
+			8.2, 1.3, 5.4, 2.6, -1.0
+		};
+		this->m.fill(DATA);
+	}
+};
+
+TEST_F(SvdWorkspaceOn4x5MatrixTest, Multiplication_of_USV_should_be_input_matrix) {
+	const double ROUNDED_ERROR = 1.0e-13;
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	singular::Matrix< M, N > m2 =
+		this->ws.getU() * this->ws.getS() * this->ws.getV().transpose();
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(this->m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST_F(SvdWorkspaceOn4x5MatrixTest, Decomposition_on_a_workspace_should_allocate_nothing) {
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	int count = numAllocations;
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	EXPECT_EQ(count, numAllocations);
+}
+
+TEST_F(SvdWorkspaceOn4x5MatrixTest, Thin_right_singular_vectors_should_be_the_first_4_columns) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	singular::SvdWorkspace< M, N > thin;
+	singular::Svd< M, N >::decomposeUSV(
+		this->m, thin, singular::SVD_FULL, singular::SVD_THIN);
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < M; ++j) {
+			EXPECT_NEAR(this->ws.getV()(i, j), thin.getV()(i, j),
+						ROUNDED_ERROR);
+		}
+		EXPECT_EQ(0.0, thin.getV()(i, M));
+	}
+}
+
+TEST(SvdWorkspaceAllocationTest, Heap_memory_blocks_should_be_counted) {
+	int count = numAllocations;
+	singular::MemoryBlock< SINGULAR_MAX_INLINE_ELEMENTS + 1 > block;
+	EXPECT_EQ(count + 1, numAllocations);
+}
+
+TEST(SvdWorkspaceAllocationTest, Decomposition_on_a_heap_workspace_should_allocate_nothing) {
+	const int M = 24;
+	const int N = 20;
+	singular::Matrix< M, N > m;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			m(i, j) = ((i * 7 + j * 3) % 17) - 8.0;
+		}
+	}
+	singular::SvdWorkspace< M, N > ws;
+	singular::Svd< M, N >::decomposeUSV(m, ws);
+	int count = numAllocations;
+	singular::Svd< M, N >::decomposeUSV(m, ws);
+	EXPECT_EQ(count, numAllocations);
+}
+
+TEST(SvdWorkspaceAllocationTest, Blocked_bidiagonalization_on_a_workspace_should_allocate_nothing) {
+	// more than MIN_BLOCKED_SIZE columns are reduced in panels
+	const int M = 130;
+	const int N = 129;
+	singular::Matrix< M, N > m;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			m(i, j) = ((i * 7 + j * 3) % 17) - 8.0 + 0.01 * i * j;
+		}
+	}
+	singular::SvdWorkspace< M, N > ws;
+	singular::Svd< M, N >::decomposeUSV(m, ws);
+	int count = numAllocations;
+	singular::Svd< M, N >::decomposeUSV(m, ws);
+	EXPECT_EQ(count, numAllocations);
+}
+
+TEST(SvdWorkspaceAllocationTest, Reused_DynamicSvd_should_allocate_nothing_for_blocked_bidiagonalization) {
+	const int SHAPES[][2] = { { 130, 129 }, { 200, 150 }, { 300, 200 } };
+	for (int k = 0; k < 3; ++k) {
+		const int M = SHAPES[k][0];
+		const int N = SHAPES[k][1];
+		singular::DynamicMatrix m(M, N);
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < N; ++j) {
+				m(i, j) = ((i * 7 + j * 3) % 17) - 8.0 + 0.01 * i * j;
+			}
+		}
+		singular::DynamicSvd svd;
+		svd.decomposeUSV(m);
+		int count = numAllocations;
+		svd.decomposeUSV(m);
+		EXPECT_EQ(count, numAllocations) << M << "x" << N;
+	}
+}
+
+TEST(SvdWorkspaceAllocationTest, Reconstruction_into_a_reused_matrix_should_allocate_nothing) {
+	// large enough for blocked products
+	const int M = 70;
+	const int N = 60;
+	singular::DynamicMatrix m(M, N);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			m(i, j) = ((i * 7 + j * 3) % 17) - 8.0;
+		}
+	}
+	singular::DynamicSvd svd;
+	svd.decomposeUSV(m);
+	singular::DynamicMatrix m2;
+	svd.reconstruct(m2);
+	int count = numAllocations;
+	svd.reconstruct(m2);
+	EXPECT_EQ(count, numAllocations);
+	const double ROUNDED_ERROR = 1.0e-12;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST(SvdOnSmallMatrixTest, Decomposition_of_a_small_matrix_should_allocate_nothing) {
+	const int M = 4;
+	const int N = 3;
+	const double DATA[] = {
+		1.0, 2.0, 3.0,
+		5.0, 6.0, 7.0,
+		4.0, 8.0, 3.0,
+		6.0, 7.0, 2.0
+	};
+	singular::Matrix< M, N > m = singular::Matrix< M, N >::filledWith(DATA);
+	int count = numAllocations;
+	singular::Svd< M, N >::USV usv = singular::Svd< M, N >::decomposeUSV(m);
+	EXPECT_EQ(count, numAllocations);
+	// makes sure that the decomposition has been done
+	const double ROUNDED_ERROR = 1.0e-13;
+	singular::Matrix< M, N > m2 =
+		singular::Svd< M, N >::getU(usv)
+		* singular::Svd< M, N >::getS(usv)
+		* singular::Svd< M, N >::getV(usv).transpose();
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST(SvdOnSmallMatrixTest, Multiplying_small_decomposition_back_should_allocate_nothing) {
+	const int M = 4;
+	const int N = 3;
+	const double DATA[] = {
+		1.0, 2.0, 3.0,
+		5.0, 6.0, 7.0,
+		4.0, 8.0, 3.0,
+		6.0, 7.0, 2.0
+	};
+	singular::Matrix< M, N > m = singular::Matrix< M, N >::filledWith(DATA);
+	singular::Svd< M, N >::USV usv = singular::Svd< M, N >::decomposeUSV(m);
+	int count = numAllocations;
+	// (U * S) is materialized before it is multiplied by V^T
+	singular::Matrix< M, N > m2 =
+		(singular::Svd< M, N >::getU(usv)
+		 * singular::Svd< M, N >::getS(usv))
+		* (2.0 * singular::Svd< M, N >::getV(usv)).transpose();
+	EXPECT_EQ(count, numAllocations);
+	const double ROUNDED_ERROR = 1.0e-13;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(2.0 * m(i, j), m2(i, j), ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST_F(SvdWorkspaceOn5x4MatrixTest, Decomposition_into_column_major_views_should_equal_workspace) {
+	// column-major input and outputs with padded columns
+	const int LD = 7;
+	double a[LD * N];
+	double u[LD * M];
+	double s[N];
+	double v[LD * N];
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			a[j * LD + i] = this->m(i, j);
+		}
+	}
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	singular::Svd< M, N >::decomposeUSV(
+		singular::MatrixView(a, M, N, LD, singular::COLUMN_MAJOR),
+		singular::MatrixView(u, M, M, LD, singular::COLUMN_MAJOR),
+		s,
+		singular::MatrixView(v, N, N, LD, singular::COLUMN_MAJOR));
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < M; ++j) {
+			EXPECT_EQ(this->ws.getU()(i, j), u[j * LD + i]);
+		}
+	}
+	for (int i = 0; i < N; ++i) {
+		EXPECT_EQ(this->ws.getS()(i, i), s[i]);
+		for (int j = 0; j < N; ++j) {
+			EXPECT_EQ(this->ws.getV()(i, j), v[j * LD + i]);
+		}
+	}
+}
+
+TEST_F(SvdWorkspaceOn5x4MatrixTest, Decomposition_into_views_should_allocate_nothing) {
+	double u[M * N];
+	double s[N];
+	double v[N * N];
+	singular::MatrixView a = this->m.view();
+	int count = numAllocations;
+	singular::Svd< M, N >::decomposeUSV(
+		a,
+		singular::MatrixView(u, M, N),
+		s,
+		singular::MatrixView(v, N, N),
+		singular::SVD_THIN,
+		singular::SVD_FULL);
+	EXPECT_EQ(count, numAllocations);
+}
+
+TEST_F(SvdWorkspaceOn4x5MatrixTest, Decomposition_into_row_major_views_should_equal_workspace) {
+	const double ROUNDED_ERROR = 1.0e-14;
+	// row-major outputs with padded rows; thin right singular vectors
+	const int LD = 6;
+	double u[M * LD];
+	double s[M];
+	double v[N * LD];
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	singular::Svd< M, N >::decomposeUSV(
+		this->m.view(),
+		singular::MatrixView(u, M, M, LD),
+		s,
+		singular::MatrixView(v, N, M, LD),
+		singular::SVD_FULL,
+		singular::SVD_THIN);
+	for (int i = 0; i < M; ++i) {
+		EXPECT_NEAR(this->ws.getS()(i, i), s[i], ROUNDED_ERROR * 100);
+		for (int j = 0; j < M; ++j) {
+			EXPECT_NEAR(this->ws.getU()(i, j), u[i * LD + j], ROUNDED_ERROR);
+		}
+	}
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < M; ++j) {
+			EXPECT_NEAR(this->ws.getV()(i, j), v[i * LD + j], ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST_F(SvdWorkspaceOn5x4MatrixTest, Float_views_should_be_decomposed_without_allocation) {
+	const float ROUNDED_ERROR = 1.0e-5f;
+	float a[M * N];
+	float u[M * M];
+	float s[N];
+	float v[N * N];
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			a[i * N + j] = static_cast< float >(this->m(i, j));
+		}
+	}
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	int count = numAllocations;
+	singular::Svd< M, N >::decomposeUSV(
+		singular::BasicMatrixView< float >(a, M, N),
+		singular::BasicMatrixView< float >(u, M, M, singular::COLUMN_MAJOR),
+		s,
+		singular::BasicMatrixView< float >(v, N, N, singular::COLUMN_MAJOR));
+	EXPECT_EQ(count, numAllocations);
+	for (int i = 0; i < N; ++i) {
+		EXPECT_NEAR(this->ws.getS()(i, i), s[i], s[0] * ROUNDED_ERROR);
+	}
+	// U^T * A * V = S
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < N; ++j) {
+			float x = 0.0f;
+			for (int k = 0; k < M; ++k) {
+				for (int l = 0; l < N; ++l) {
+					x += u[i * M + k] * a[k * N + l] * v[j * N + l];
+				}
+			}
+			EXPECT_NEAR(i == j ? s[i] : 0.0f, x, s[0] * ROUNDED_ERROR);
+		}
+	}
+}
+
+TEST_F(SvdWorkspaceOn5x4MatrixTest, Float_matrix_should_be_decomposed_on_a_float_workspace_without_allocation) {
+	const float ROUNDED_ERROR = 1.0e-5f;
+	singular::Matrix< M, N, float > a;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			a(i, j) = static_cast< float >(this->m(i, j));
+		}
+	}
+	singular::Svd< M, N >::decomposeUSV(this->m, this->ws);
+	singular::SvdWorkspace< M, N, float > fws;
+	singular::Svd< M, N, float >::decomposeUSV(a, fws);
+	int count = numAllocations;
+	singular::Svd< M, N, float >::decomposeUSV(a, fws);
+	EXPECT_EQ(count, numAllocations);
+	const float s0 = fws.getS()(0, 0);
+	for (int i = 0; i < N; ++i) {
+		EXPECT_NEAR(this->ws.getS()(i, i), fws.getS()(i, i),
+					s0 * ROUNDED_ERROR);
+	}
+	singular::Svd< M, N, float >::USV usv =
+		singular::Svd< M, N, float >::decomposeUSV(a);
+	singular::Matrix< M, N, float > a2 =
+		singular::Svd< M, N, float >::reconstruct(usv);
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			EXPECT_NEAR(a(i, j), a2(i, j), s0 * ROUNDED_ERROR);
+		}
+	}
+}
@@ -0,0 +1,140 @@
+#include "singular/ThreadPool.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#if SINGULAR_THREAD_SUPPORTED
+#include <thread>
+#endif
+
+TEST(ThreadPoolTest, ThreadPool_should_have_given_number_of_threads) {
+	singular::ThreadPool pool(3);
+#if SINGULAR_THREAD_SUPPORTED
+	EXPECT_EQ(3, pool.size());
+#else
+	EXPECT_EQ(1, pool.size());
+#endif
+}
+
+TEST(ThreadPoolTest, ThreadPool_should_have_at_least_one_thread_by_default) {
+	singular::ThreadPool pool;
+	EXPECT_GE(pool.size(), 1);
+}
+
+TEST(ThreadPoolTest, wait_should_wait_for_all_submitted_tasks) {
+	singular::ThreadPool pool(4);
+	std::atomic< int > count(0);
+	for (int i = 0; i < 100; ++i) {
+		pool.submit([&count]() {
+			++count;
+		});
+	}
+	pool.wait();
+	EXPECT_EQ(100, count.load());
+}
+
+TEST(ThreadPoolTest, wait_should_wait_for_tasks_submitted_by_tasks) {
+	singular::ThreadPool pool(2);
+	std::atomic< int > count(0);
+	for (int i = 0; i < 10; ++i) {
+		pool.submit([&pool, &count]() {
+			for (int j = 0; j < 10; ++j) {
+				pool.submit([&count]() {
+					++count;
+				});
+			}
+			++count;
+		});
+	}
+	pool.wait();
+	EXPECT_EQ(110, count.load());
+}
+
+TEST(ThreadPoolTest, wait_should_return_immediately_if_no_task_is_submitted) {
+	singular::ThreadPool pool(2);
+	pool.wait();
+	SUCCEED();
+}
+
+TEST(ThreadPoolTest, Tasks_queued_by_a_busy_worker_should_be_stolen) {
+	singular::ThreadPool pool(2);
+	std::atomic< bool > stolen(false);
+	pool.submit([&pool, &stolen]() {
+		// queued on this worker, so only another worker can run it
+		pool.submit([&stolen]() {
+			stolen = true;
+		});
+#if SINGULAR_THREAD_SUPPORTED
+		while (!stolen) {
+			std::this_thread::yield();
+		}
+#endif
+	});
+	pool.wait();
+	EXPECT_TRUE(stolen.load());
+}
+
+TEST(ThreadPoolTest, runConcurrently_should_run_every_index_once) {
+	singular::ThreadPool pool(3);
+	std::atomic< int > counts[10];
+	for (int i = 0; i < 10; ++i) {
+		counts[i] = 0;
+	}
+	pool.runConcurrently(10, [&counts](int i) {
+		++counts[i];
+	});
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_EQ(1, counts[i].load()) << "index " << i;
+	}
+}
+
+TEST(ThreadPoolTest, runConcurrently_can_be_called_from_tasks) {
+	// more tasks than workers, so every worker waits in runConcurrently
+	singular::ThreadPool pool(2);
+	std::atomic< int > count(0);
+	for (int i = 0; i < 8; ++i) {
+		pool.submit([&pool, &count]() {
+			pool.runConcurrently(4, [&count](int) {
+				++count;
+			});
+		});
+	}
+	pool.wait();
+	EXPECT_EQ(32, count.load());
+}
+
+TEST(ThreadPoolTest, TaskGroup_should_wait_for_tasks_submitted_through_it) {
+	singular::ThreadPool pool(3);
+	std::atomic< int > count(0);
+	singular::ThreadPool::TaskGroup group(pool);
+	for (int i = 0; i < 10; ++i) {
+		group.submit([&group, &count]() {
+			for (int j = 0; j < 10; ++j) {
+				group.submit([&count]() {
+					++count;
+				});
+			}
+		});
+	}
+	group.wait();
+	EXPECT_EQ(100, count.load());
+}
+
+TEST(ThreadPoolTest, TaskGroup_can_be_waited_for_from_tasks) {
+	// more tasks than workers, so every worker waits for its group
+	singular::ThreadPool pool(2);
+	std::atomic< int > count(0);
+	for (int i = 0; i < 8; ++i) {
+		pool.submit([&pool, &count]() {
+			singular::ThreadPool::TaskGroup group(pool);
+			for (int j = 0; j < 4; ++j) {
+				group.submit([&count]() {
+					++count;
+				});
+			}
+			group.wait();
+		});
+	}
+	pool.wait();
+	EXPECT_EQ(32, count.load());
+}
@@ -0,0 +1,75 @@
+#include "singular/Transpose.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+/**
+ * Fills a given array with distinct values.
+ *
+ * @param[out] values
+ *     Array to be filled.
+ */
+static void fillDistinct(std::vector< double >& values) {
+	for (size_t i = 0; i < values.size(); ++i) {
+		values[i] = static_cast< double >(i) * 0.5 - 3.0;
+	}
+}
+
+TEST(TransposeTest, Copy_of_2x3_matrix_should_be_3x2_matrix) {
+	const double a[] = {
+		1.0, 2.0, 3.0,
+		4.0, 5.0, 6.0
+	};
+	double b[6];
+	singular::Transpose::copy(2, 3, a, 3, b, 2);
+	EXPECT_EQ(1.0, b[0]);
+	EXPECT_EQ(4.0, b[1]);
+	EXPECT_EQ(2.0, b[2]);
+	EXPECT_EQ(5.0, b[3]);
+	EXPECT_EQ(3.0, b[4]);
+	EXPECT_EQ(6.0, b[5]);
+}
+
+TEST(TransposeTest, Copy_should_equal_plain_copy_over_many_blocks) {
+	// dimensions are not multiples of the block size
+	const int M = 157;
+	const int N = 70;
+	std::vector< double > a(M * N);
+	fillDistinct(a);
+	std::vector< double > ref(N * M);
+	singular::Transpose::copyPlain(M, N, a.data(), N, ref.data(), M);
+	std::vector< double > b(N * M);
+	singular::Transpose::copy(M, N, a.data(), N, b.data(), M);
+	for (int i = 0; i < M * N; ++i) {
+		ASSERT_EQ(ref[i], b[i]) << "element " << i;
+	}
+}
+
+TEST(TransposeTest, Copy_should_respect_leading_dimensions) {
+	// transposes the top-left 40x50 part of a 40x60 matrix into 50x70
+	std::vector< double > a(40 * 60);
+	fillDistinct(a);
+	std::vector< double > b(50 * 70, 7.0);
+	singular::Transpose::copy(40, 50, a.data(), 60, b.data(), 70);
+	for (int i = 0; i < 50; ++i) {
+		for (int j = 0; j < 40; ++j) {
+			ASSERT_EQ(a[j * 60 + i], b[i * 70 + j]);
+		}
+		for (int j = 40; j < 70; ++j) {
+			ASSERT_EQ(7.0, b[i * 70 + j]);
+		}
+	}
+}
+
+TEST(TransposeTest, In_place_transposition_should_equal_copy) {
+	const int N = 101;
+	std::vector< double > a(N * N);
+	fillDistinct(a);
+	std::vector< double > ref(N * N);
+	singular::Transpose::copy(N, N, a.data(), N, ref.data(), N);
+	singular::Transpose::inPlace(N, a.data(), N);
+	for (int i = 0; i < N * N; ++i) {
+		ASSERT_EQ(ref[i], a[i]) << "element " << i;
+	}
+}
@@ -0,0 +1,155 @@
+#include "singular/Simd.h"
+#include "singular/VectorKernel.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+/**
+ * Fills a given array with pseudo random numbers in [-1, 1).
+ *
+ * @tparam T
+ *     Type of elements.
+ * @param[out] values
+ *     Array to be filled.
+ * @param seed
+ *     Seed of the pseudo random numbers.
+ */
+template < typename T >
+static void fillRandom(std::vector< T >& values, unsigned int seed) {
+	for (size_t i = 0; i < values.size(); ++i) {
+		seed = seed * 1103515245u + 12345u;
+		values[i] = static_cast< T >((seed >> 8) % 65536) / 32768 - 1;
+	}
+}
+
+/** Strides tested; 1 is the contiguous case. */
+static const ptrdiff_t STRIDES[] = { 1, 3 };
+
+TEST(VectorKernelTest, Scalar_kernels_should_compute_level_1_operations) {
+	const singular::VectorKernel& kernel =
+		singular::VectorKernel::get(singular::SIMD_NONE);
+	double x[] = { 1.0, 2.0, 3.0 };
+	double y[] = { 4.0, -5.0, 6.0 };
+	EXPECT_EQ(12.0, kernel.dot(3, x, 1, y, 1));
+	kernel.axpy(3, 2.0, x, 1, y, 1);
+	EXPECT_EQ(6.0, y[0]);
+	EXPECT_EQ(-1.0, y[1]);
+	EXPECT_EQ(12.0, y[2]);
+	kernel.scale(2, -0.5, x, 2);
+	EXPECT_EQ(-0.5, x[0]);
+	EXPECT_EQ(2.0, x[1]);
+	EXPECT_EQ(-1.5, x[2]);
+}
+
+TEST(VectorKernelTest, Every_supported_level_should_compute_dot_like_scalar) {
+	// odd size to exercise remainders
+	const size_t N = 43;
+	for (int si = 0; si < 2; ++si) {
+		const ptrdiff_t inc = STRIDES[si];
+		std::vector< double > x(N * inc);
+		std::vector< double > y(N * inc);
+		fillRandom(x, 1);
+		fillRandom(y, 2);
+		const double ref = singular::VectorKernel::get(singular::SIMD_NONE)
+			.dot(N, x.data(), inc, y.data(), inc);
+		for (int level = singular::SIMD_SSE2;
+			 level <= singular::Simd::level();
+			 ++level)
+		{
+			const double d = singular::VectorKernel::get(
+				static_cast< singular::SimdLevel >(level))
+				.dot(N, x.data(), inc, y.data(), inc);
+			EXPECT_NEAR(ref, d, 1.0e-13)
+				<< "level " << level << " stride " << inc;
+		}
+	}
+}
+
+TEST(VectorKernelTest, Every_supported_level_should_compute_axpy_like_scalar) {
+	const size_t N = 43;
+	for (int si = 0; si < 2; ++si) {
+		const ptrdiff_t inc = STRIDES[si];
+		std::vector< double > x(N);
+		std::vector< double > y0(N * inc);
+		fillRandom(x, 3);
+		fillRandom(y0, 4);
+		std::vector< double > ref(y0);
+		singular::VectorKernel::get(singular::SIMD_NONE)
+			.axpy(N, -0.75, x.data(), 1, ref.data(), inc);
+		for (int level = singular::SIMD_SSE2;
+			 level <= singular::Simd::level();
+			 ++level)
+		{
+			std::vector< double > y(y0);
+			singular::VectorKernel::get(
+				static_cast< singular::SimdLevel >(level))
+				.axpy(N, -0.75, x.data(), 1, y.data(), inc);
+			for (size_t i = 0; i < y.size(); ++i) {
+				EXPECT_NEAR(ref[i], y[i], 1.0e-15)
+					<< "level " << level << " stride " << inc;
+			}
+		}
+	}
+}
+
+TEST(VectorKernelTest, Every_supported_level_should_scale_like_scalar) {
+	const size_t N = 43;
+	for (int si = 0; si < 2; ++si) {
+		const ptrdiff_t inc = STRIDES[si];
+		std::vector< double > x0(N * inc);
+		fillRandom(x0, 5);
+		std::vector< double > ref(x0);
+		singular::VectorKernel::get(singular::SIMD_NONE)
+			.scale(N, 3.5, ref.data(), inc);
+		for (int level = singular::SIMD_SSE2;
+			 level <= singular::Simd::level();
+			 ++level)
+		{
+			std::vector< double > x(x0);
+			singular::VectorKernel::get(
+				static_cast< singular::SimdLevel >(level))
+				.scale(N, 3.5, x.data(), inc);
+			for (size_t i = 0; i < x.size(); ++i) {
+				EXPECT_EQ(ref[i], x[i])
+					<< "level " << level << " stride " << inc;
+			}
+		}
+	}
+}
+
+TEST(VectorKernelTest, Every_supported_level_should_compute_float_operations_like_scalar) {
+	// longer than a register of 16 floats and not a multiple of it
+	const size_t N = 45;
+	typedef singular::BasicVectorKernel< float > Kernel;
+	const Kernel& scalar = Kernel::get(singular::SIMD_NONE);
+	for (int si = 0; si < 2; ++si) {
+		const ptrdiff_t inc = STRIDES[si];
+		std::vector< float > x(N * inc);
+		std::vector< float > y0(N * inc);
+		fillRandom(x, 6);
+		fillRandom(y0, 7);
+		const float dotRef = scalar.dot(N, x.data(), inc, y0.data(), inc);
+		std::vector< float > ref(y0);
+		scalar.axpy(N, -0.75f, x.data(), inc, ref.data(), inc);
+		scalar.scale(N, 3.5f, ref.data(), inc);
+		for (int level = singular::SIMD_SSE2;
+			 level <= singular::Simd::level();
+			 ++level)
+		{
+			const Kernel& kernel =
+				Kernel::get(static_cast< singular::SimdLevel >(level));
+			EXPECT_NEAR(dotRef,
+						kernel.dot(N, x.data(), inc, y0.data(), inc),
+						1.0e-4f)
+				<< "level " << level << " stride " << inc;
+			std::vector< float > y(y0);
+			kernel.axpy(N, -0.75f, x.data(), inc, y.data(), inc);
+			kernel.scale(N, 3.5f, y.data(), inc);
+			for (size_t i = 0; i < y.size(); ++i) {
+				EXPECT_NEAR(ref[i], y[i], 1.0e-5f)
+					<< "level " << level << " stride " << inc;
+			}
+		}
+	}
+}
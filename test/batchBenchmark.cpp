@@ -0,0 +1,146 @@
+#include "singular/singular.h"
+#include "singular/BatchSvd.h"
+#include "singular/Simd.h"
+#include "singular/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#if SINGULAR_THREAD_SUPPORTED
+#include <thread>
+#endif
+
+/** Sizes of square matrices to be decomposed. */
+static const int SIZES[] = { 3, 8, 16 };
+
+/** Default number of 16x16 matrices decomposed per thread. */
+static const int DEFAULT_MATRICES_PER_THREAD = 2000;
+
+/** Number of measurements of which the fastest is taken. */
+static const int NUM_TRIALS = 3;
+
+/**
+ * Measures the throughput of batched decomposition on a given number of
+ * threads.
+ *
+ * The number of matrices grows with the number of threads, so every
+ * thread has the same amount of work as long as it scales.
+ *
+ * @param size
+ *     Number of rows and columns in each matrix.
+ * @param numThreads
+ *     Number of threads.
+ *     Matrices are decomposed on the calling thread if this is 1.
+ * @param matricesPerThread
+ *     Number of matrices per thread.
+ * @return
+ *     Number of matrices decomposed per second.
+ */
+static double measureThroughput(int size,
+								int numThreads,
+								int matricesPerThread)
+{
+	const int count = matricesPerThread * numThreads;
+	std::default_random_engine rnd(size);
+	std::uniform_real_distribution< double > dist(-10.0, 10.0);
+	std::vector< double > a(count * size * size);
+	for (size_t i = 0; i < a.size(); ++i) {
+		a[i] = dist(rnd);
+	}
+	std::vector< double > u(count * size * size);
+	std::vector< double > s(count * size);
+	std::vector< double > v(count * size * size);
+	singular::ThreadPool pool(numThreads);
+	singular::ThreadPool* pPool = numThreads > 1 ? &pool : 0;
+	double best = 0.0;
+	for (int trial = 0; trial < NUM_TRIALS; ++trial) {
+		std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+		singular::BatchSvd::decompose(size,
+									  size,
+									  count,
+									  a.data(),
+									  u.data(),
+									  s.data(),
+									  v.data(),
+									  singular::SVD_FULL,
+									  singular::SVD_FULL,
+									  pPool);
+		std::chrono::duration< double > elapsed =
+			std::chrono::steady_clock::now() - start;
+		best = std::max(best, count / elapsed.count());
+	}
+	return best;
+}
+
+/**
+ * Runs a benchmark of batched decomposition on 1, 2, 4, ... threads.
+ *
+ * Prints the throughput per thread and the efficiency relative to a
+ * single thread, which stays near 100% if decomposition scales linearly.
+ *
+ * @param argv
+ *     `argv[1]` is an optional maximum number of threads.
+ *     The number of hardware threads by default.
+ *     `argv[2]` is an optional number of 16x16 matrices per thread.
+ *     Smaller matrices are scaled up by the number of elements.
+ */
+int main(int argc, char** argv) {
+#if SINGULAR_THREAD_SUPPORTED
+	int maxThreads = static_cast< int >(std::thread::hardware_concurrency());
+#else
+	int maxThreads = 1;
+#endif
+	maxThreads = std::max(maxThreads, 1);
+	int matricesPerThread = DEFAULT_MATRICES_PER_THREAD;
+	if (argc >= 2) {
+		maxThreads = atoi(argv[1]);
+		if (maxThreads <= 0) {
+			std::cerr << "number of threads must be a positive integer"
+				<< " but " << argv[1];
+			return 1;
+		}
+	}
+	if (argc >= 3) {
+		matricesPerThread = atoi(argv[2]);
+		if (matricesPerThread <= 0) {
+			std::cerr << "number of matrices must be a positive integer"
+				<< " but " << argv[2];
+			return 1;
+		}
+	}
+	std::cout << "singular version: " << SINGULAR_VERSION << std::endl;
+	std::cout << "SIMD level: " << singular::Simd::level() << std::endl;
+	std::cout << "max # of threads: " << maxThreads << std::endl;
+	std::cout << std::endl;
+	std::vector< int > threadCounts;
+	for (int t = 1; t < maxThreads; t *= 2) {
+		threadCounts.push_back(t);
+	}
+	threadCounts.push_back(maxThreads);
+	for (size_t i = 0; i < sizeof(SIZES) / sizeof(SIZES[0]); ++i) {
+		const int size = SIZES[i];
+		const int perThread = matricesPerThread * (16 * 16) / (size * size);
+		std::cout << size << "x" << size << " matrices" << std::endl;
+		double singleThread = 0.0;
+		for (size_t j = 0; j < threadCounts.size(); ++j) {
+			const int numThreads = threadCounts[j];
+			const double throughput =
+				measureThroughput(size, numThreads, perThread);
+			if (numThreads == 1) {
+				singleThread = throughput;
+			}
+			const double perCore = throughput / numThreads;
+			std::cout << numThreads
+				<< (numThreads == 1 ? " thread: " : " threads: ")
+				<< throughput << " matrices/s, "
+				<< perCore << " matrices/s per thread, efficiency "
+				<< (100.0 * perCore / singleThread) << "%" << std::endl;
+		}
+		std::cout << std::endl;
+	}
+	return 0;
+}
@@ -1,5 +1,11 @@
 #include "singular/singular.h"
+#include "singular/DynamicSvd.h"
+#include "singular/Gemm.h"
+#include "singular/Simd.h"
 #include "singular/Svd.h"
+#include "singular/ThreadPool.h"
+#include "singular/Transpose.h"
+#include "singular/VectorKernel.h"
 
 #ifdef ENABLE_ARMADILLO
 #include "armadillo"
@@ -99,6 +105,70 @@ struct SingularSvd {
 	}
 };
 
+/** Singular-values-only configuration for singular. */
+struct SingularValuesSvd {
+	/** Type for singular values. */
+	typedef singular::DiagonalMatrix< M, N > SMatrix;
+
+	/** Last computed singular values. */
+	SMatrix s;
+
+	/**
+	 * Computes singular values of given elements.
+	 *
+	 * @param elements
+	 *     Elements of the M x N matrix whose singular values are computed.
+	 */
+	void operator ()(const double elements[]) {
+		singular::Matrix< M, N > m;
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < N; ++j) {
+				m(i, j) = elements[i * N + j];
+			}
+		}
+		this->s = singular::Svd< M, N >::decomposeS(m);
+	}
+
+	/** Returns the last computed singular values. */
+	inline const SMatrix& getS() const {
+		return this->s;
+	}
+};
+
+/**
+ * SVD configuration for singular on matrices of runtime dimensions.
+ *
+ * @tparam T
+ *     Type of elements.
+ *     Elements are rounded to `T` before decomposition.
+ */
+template < typename T >
+struct SingularDynamicSvd {
+	/** Input matrix. Reused over iterations. */
+	singular::BasicDynamicMatrix< T > m;
+
+	/** SVD engine. Reused over iterations. */
+	singular::BasicDynamicSvd< T > svd;
+
+	/** Initializes an input matrix. */
+	SingularDynamicSvd() : m(M, N) {}
+
+	/**
+	 * Performs singular value decomposition over given elements.
+	 *
+	 * @param elements
+	 *     Elements of the M x N matrix to be decomposed.
+	 */
+	void operator ()(const double elements[]) {
+		for (int i = 0; i < M; ++i) {
+			for (int j = 0; j < N; ++j) {
+				this->m(i, j) = static_cast< T >(elements[i * N + j]);
+			}
+		}
+		this->svd.decomposeUSV(this->m);
+	}
+};
+
 #ifdef ENABLE_EIGEN
 /** SVD configuration for Eigen. */
 struct EigenSvd {
@@ -290,6 +360,342 @@ struct Benchmark {
 	}
 };
 
+/**
+ * A benchmark function for vector kernels used by reflectors.
+ *
+ * Repeats a dot product and an axpy over a column of an M x N row-major
+ * matrix like `Reflector::applyFromLeftInPlace` does.
+ */
+struct VectorKernelBenchmark {
+	/** Kernels to be evaluated. */
+	const singular::VectorKernel& kernel;
+
+	/** Distance between adjacent elements. */
+	ptrdiff_t stride;
+
+	/** Number of repetitions. */
+	int numRepetitions;
+
+	/** Reflector's u vector. */
+	std::vector< double > u;
+
+	/** Matrix to which the kernels are applied. */
+	mutable std::vector< double > m;
+
+	/**
+	 * Configures a benchmark.
+	 *
+	 * @param kernel
+	 *     Kernels to be evaluated.
+	 * @param stride
+	 *     Distance between adjacent elements in the column.
+	 *     1 evaluates the contiguous case.
+	 * @param numRepetitions
+	 *     Number of repetitions.
+	 */
+	VectorKernelBenchmark(const singular::VectorKernel& kernel,
+						  ptrdiff_t stride,
+						  int numRepetitions)
+		: kernel(kernel),
+		  stride(stride),
+		  numRepetitions(numRepetitions),
+		  u(M, 1.0 / M),
+		  m(M * stride, 1.0) {}
+
+	/** Runs the kernels several times. */
+	void operator ()() const {
+		double g = 0.0;
+		for (int n = 0; n < this->numRepetitions; ++n) {
+			g = 1.0e-3 * this->kernel.dot(
+				M, this->u.data(), 1, this->m.data(), this->stride);
+			this->kernel.axpy(
+				M, -g, this->u.data(), 1, this->m.data(), this->stride);
+		}
+	}
+
+	/** Returns the number of floating point operations in a run. */
+	double countFlops() const {
+		return 4.0 * M * this->numRepetitions;
+	}
+};
+
+/**
+ * A benchmark function for matrix multiplication.
+ *
+ * Multiplies square matrices with `Gemm`.
+ */
+struct GemmBenchmark {
+	/** Number of rows and columns in each matrix. */
+	int size;
+
+	/** Number of repetitions. */
+	int numRepetitions;
+
+	/** Whether the plain loop is evaluated instead of blocks. */
+	bool plain;
+
+	/** Thread pool on which products are computed. May be 0. */
+	singular::ThreadPool* pPool;
+
+	/** Left-hand-side matrix. */
+	std::vector< double > a;
+
+	/** Right-hand-side matrix. */
+	std::vector< double > b;
+
+	/** Product. */
+	mutable std::vector< double > c;
+
+	/**
+	 * Configures a benchmark.
+	 *
+	 * @param size
+	 *     Number of rows and columns in each matrix.
+	 * @param numRepetitions
+	 *     Number of repetitions.
+	 * @param plain
+	 *     Whether the plain loop is evaluated instead of blocks.
+	 * @param pPool
+	 *     Thread pool on which products are computed. May be 0.
+	 */
+	GemmBenchmark(int size,
+				  int numRepetitions,
+				  bool plain,
+				  singular::ThreadPool* pPool)
+		: size(size),
+		  numRepetitions(numRepetitions),
+		  plain(plain),
+		  pPool(pPool),
+		  a(size * size, 0.5),
+		  b(size * size, 0.25),
+		  c(size * size) {}
+
+	/** Runs the multiplication several times. */
+	void operator ()() const {
+		const int n = this->size;
+		for (int r = 0; r < this->numRepetitions; ++r) {
+			if (this->plain) {
+				singular::Gemm::multiplyPlain(
+					n, n, n, this->a.data(), n, this->b.data(), n,
+					this->c.data(), n);
+			} else {
+				singular::Gemm::multiply(
+					n, n, n, this->a.data(), n, this->b.data(), n,
+					this->c.data(), n, this->pPool);
+			}
+		}
+	}
+
+	/** Returns the number of floating point operations in a run. */
+	double countFlops() const {
+		return 2.0 * this->size * this->size * this->size
+			* this->numRepetitions;
+	}
+};
+
+/**
+ * A benchmark function for transposition.
+ *
+ * Transposes a square matrix with `Transpose`.
+ */
+struct TransposeBenchmark {
+	/** Ways to transpose. */
+	enum Method {
+		/** Row-wise plain loop. */
+		PLAIN,
+		/** Cache-oblivious blocks. */
+		BLOCKED,
+		/** Cache-oblivious blocks in place. */
+		IN_PLACE
+	};
+
+	/** Number of rows and columns in the matrix. */
+	int size;
+
+	/** Number of repetitions. */
+	int numRepetitions;
+
+	/** Way to transpose. */
+	Method method;
+
+	/** Matrix to be transposed. */
+	mutable std::vector< double > a;
+
+	/** Transposition. */
+	mutable std::vector< double > b;
+
+	/**
+	 * Configures a benchmark.
+	 *
+	 * @param size
+	 *     Number of rows and columns in the matrix.
+	 * @param numRepetitions
+	 *     Number of repetitions.
+	 * @param method
+	 *     Way to transpose.
+	 */
+	TransposeBenchmark(int size, int numRepetitions, Method method)
+		: size(size),
+		  numRepetitions(numRepetitions),
+		  method(method),
+		  a(size * size, 0.5),
+		  b(size * size) {}
+
+	/** Runs the transposition several times. */
+	void operator ()() const {
+		const int n = this->size;
+		for (int r = 0; r < this->numRepetitions; ++r) {
+			switch (this->method) {
+			case PLAIN:
+				singular::Transpose::copyPlain(
+					n, n, this->a.data(), n, this->b.data(), n);
+				break;
+			case BLOCKED:
+				singular::Transpose::copy(
+					n, n, this->a.data(), n, this->b.data(), n);
+				break;
+			case IN_PLACE:
+				singular::Transpose::inPlace(n, this->a.data(), n);
+				break;
+			}
+		}
+	}
+
+	/** Returns the number of bytes read and written in a run. */
+	double countBytes() const {
+		return 2.0 * sizeof(double) * this->size * this->size
+			* this->numRepetitions;
+	}
+};
+
+/**
+ * A benchmark function for decomposition of many small matrices.
+ *
+ * Decomposes matrices either in a batch with `Svd::decomposeBatch` or one
+ * by one with `Svd::decomposeUSV` on a workspace.
+ *
+ * @tparam S
+ *     Number of rows and columns in each matrix.
+ */
+template < int S >
+struct BatchBenchmark {
+	/** Number of matrices. */
+	int count;
+
+	/** Whether matrices are decomposed in a batch. */
+	bool batched;
+
+	/** Matrices to be decomposed. */
+	std::vector< double > a;
+
+	/** Left-singular-vectors. */
+	mutable std::vector< double > u;
+
+	/** Singular values. */
+	mutable std::vector< double > s;
+
+	/** Right-singular-vectors. */
+	mutable std::vector< double > v;
+
+	/**
+	 * Configures a benchmark.
+	 *
+	 * @param count
+	 *     Number of matrices.
+	 * @param batched
+	 *     Whether matrices are decomposed in a batch.
+	 * @param seed
+	 *     Seed for the random number generator.
+	 */
+	BatchBenchmark(int count, bool batched, unsigned int seed)
+		: count(count),
+		  batched(batched),
+		  a(count * S * S),
+		  u(count * S * S),
+		  s(count * S),
+		  v(count * S * S)
+	{
+		std::default_random_engine rnd(seed);
+		std::uniform_real_distribution< double > dist(MIN_VALUE, MAX_VALUE);
+		for (size_t i = 0; i < this->a.size(); ++i) {
+			this->a[i] = dist(rnd);
+		}
+	}
+
+	/** Decomposes every matrix. */
+	void operator ()() const {
+		typedef singular::Svd< S, S > Svd;
+		if (this->batched) {
+			Svd::decomposeBatch(this->count,
+								this->a.data(),
+								this->u.data(),
+								this->s.data(),
+								this->v.data());
+			return;
+		}
+		singular::SvdWorkspace< S, S > ws;
+		singular::Matrix< S, S > m;
+		for (int k = 0; k < this->count; ++k) {
+			m.fill(&this->a[k * S * S]);
+			Svd::decomposeUSV(m, ws);
+			this->s[k * S] = ws.getS()(0, 0);
+		}
+	}
+};
+
+/**
+ * A benchmark function for reconstruction of a matrix from its SVD.
+ *
+ * Evaluates either of `U * S * V^T` with operators or the fused
+ * `Svd::reconstruct`.
+ */
+struct ReconstructionBenchmark {
+	/** Decomposition to be reconstructed. */
+	const singular::Svd< M, N >::USV& usv;
+
+	/** Whether the fused reconstruction is evaluated. */
+	bool fused;
+
+	/** Number of repetitions. */
+	int numRepetitions;
+
+	/** Sum of reconstructed elements not to be optimized away. */
+	mutable double checksum;
+
+	/**
+	 * Configures a benchmark.
+	 *
+	 * @param usv
+	 *     Decomposition to be reconstructed.
+	 * @param fused
+	 *     Whether the fused reconstruction is evaluated.
+	 * @param numRepetitions
+	 *     Number of repetitions.
+	 */
+	ReconstructionBenchmark(const singular::Svd< M, N >::USV& usv,
+							bool fused,
+							int numRepetitions)
+		: usv(usv),
+		  fused(fused),
+		  numRepetitions(numRepetitions),
+		  checksum(0.0) {}
+
+	/** Reconstructs the matrix several times. */
+	void operator ()() const {
+		typedef singular::Svd< M, N > Svd;
+		for (int n = 0; n < this->numRepetitions; ++n) {
+			if (this->fused) {
+				this->checksum += Svd::reconstruct(this->usv)(0, 0);
+			} else {
+				singular::Matrix< M, N > a = Svd::getU(this->usv)
+					* Svd::getS(this->usv)
+					* Svd::getV(this->usv).transpose();
+				this->checksum += a(0, 0);
+			}
+		}
+	}
+};
+
 /** Stopwatch to evaluate an algorithm. */
 class Stopwatch {
 private:
@@ -335,14 +741,21 @@ public:
 
 	/** Prints the statistics on the standard output. */
 	void printStatistics() const {
-		double sum = 0.0;
 		for (size_t i = 0; i < this->lapTimes.size(); ++i) {
 			std::cout << "lap time[" << i << "]: "
 				<< this->lapTimes[i] << " seconds" << std::endl;
-			sum += this->lapTimes[i];
 		}
 		std::cout << "mean lap time: "
-			<< (sum / this->lapTimes.size()) << " seconds" << std::endl;
+			<< this->getMeanLapTime() << " seconds" << std::endl;
+	}
+
+	/** Returns the mean of measured lap times. */
+	double getMeanLapTime() const {
+		double sum = 0.0;
+		for (size_t i = 0; i < this->lapTimes.size(); ++i) {
+			sum += this->lapTimes[i];
+		}
+		return sum / this->lapTimes.size();
 	}
 private:
 	/** Starts measuring time. */
@@ -587,6 +1000,9 @@ public:
  */
 bool verifyResults(int numIterations, unsigned int seed) {
 	SvdVerifier< SingularSvd > singularVerifier;
+	SingularValuesSvd singularValues;
+	int numSingularValueDiscrepancies = 0;
+	double singularValueErrorSum = 0.0;
 #ifdef ENABLE_EIGEN
 	SvdVerifier< EigenSvd > eigenVerifier;
 #endif
@@ -601,6 +1017,21 @@ bool verifyResults(int numIterations, unsigned int seed) {
 			return dist(rnd);
 		});
 		singularVerifier.verify(elements);
+		// compares singular values only results with USV results
+		{
+			singularValues(elements);
+			const SingularSvd::SMatrix ref =
+				singularVerifier.getAlgorithm().getS();
+			for (int i = 0; i < std::min(M, N); ++i) {
+				double s = singularValues.getS()(i, i);
+				double mx = std::max(std::abs(s), std::abs(ref(i, i)));
+				double e = std::abs(s - ref(i, i));
+				singularValueErrorSum += e;
+				if (e / mx >= ROUNDED_ERROR) {
+					++numSingularValueDiscrepancies;
+				}
+			}
+		}
 #ifdef ENABLE_EIGEN
 		eigenVerifier.verify(elements);
 		eigenVerifier.compareSingularValues(
@@ -616,6 +1047,14 @@ bool verifyResults(int numIterations, unsigned int seed) {
 	std::cout << "singular" << std::endl;
 	singularVerifier.printStatistics();
 	std::cout << std::endl;
+	std::cout << "singular (values only)" << std::endl;
+	std::cout
+		<< "# of singular value discrepancies: "
+		<< numSingularValueDiscrepancies
+		<< "  mean error: "
+		<< (singularValueErrorSum / (std::min(M, N) * numIterations))
+		<< std::endl;
+	std::cout << std::endl;
 #ifdef ENABLE_EIGEN
 	std::cout << "Eigen" << std::endl;
 	eigenVerifier.printStatistics();
@@ -626,7 +1065,172 @@ bool verifyResults(int numIterations, unsigned int seed) {
 	armadilloVerifier.printStatistics();
 	std::cout << std::endl;
 #endif
-	return singularVerifier.isVerified();
+	return singularVerifier.isVerified()
+		&& numSingularValueDiscrepancies == 0;
+}
+
+/**
+ * Measures vector kernels for every SIMD level the CPU supports.
+ *
+ * @param numIterations
+ *     Number of the iterations.
+ */
+void measureVectorKernels(int numIterations) {
+	static const char* LEVEL_NAMES[] = { "scalar", "SSE2", "AVX2", "AVX-512" };
+	std::cout << "vector kernels (dot + axpy over " << M << " elements)"
+		<< std::endl;
+	const int numRepetitions = numIterations * 1000;
+	for (int level = singular::SIMD_NONE;
+		 level <= singular::Simd::level();
+		 ++level)
+	{
+		const singular::VectorKernel& kernel =
+			singular::VectorKernel::get(
+				static_cast< singular::SimdLevel >(level));
+		for (ptrdiff_t stride = 1; stride <= N; stride += N - 1) {
+			VectorKernelBenchmark benchmark(kernel, stride, numRepetitions);
+			Stopwatch watch;
+			watch.measure(benchmark);
+			std::cout << LEVEL_NAMES[level]
+				<< (stride == 1 ? " contiguous: " : " strided: ")
+				<< (benchmark.countFlops() / watch.getMeanLapTime() * 1.0e-9)
+				<< " GFLOP/s" << std::endl;
+		}
+	}
+	std::cout << std::endl;
+}
+
+/**
+ * Measures matrix multiplication of several sizes.
+ *
+ * @param numIterations
+ *     Number of the iterations.
+ */
+void measureGemm(int numIterations) {
+	static const int SIZES[] = { 60, 256, 512 };
+	singular::ThreadPool pool;
+	std::cout << "matrix multiplication (" << pool.size() << " threads)"
+		<< std::endl;
+	for (size_t i = 0; i < sizeof(SIZES) / sizeof(SIZES[0]); ++i) {
+		const int size = SIZES[i];
+		const int numRepetitions = std::max(
+			1, numIterations * (64 * 64 * 64) / (size * size * size));
+		GemmBenchmark plain(size, numRepetitions, true, 0);
+		GemmBenchmark blocked(size, numRepetitions, false, 0);
+		GemmBenchmark threaded(size, numRepetitions, false, &pool);
+		Stopwatch plainWatch;
+		Stopwatch blockedWatch;
+		Stopwatch threadedWatch;
+		plainWatch.measure(plain);
+		blockedWatch.measure(blocked);
+		threadedWatch.measure(threaded);
+		std::cout << size << "x" << size
+			<< " plain: "
+			<< (plain.countFlops() / plainWatch.getMeanLapTime() * 1.0e-9)
+			<< " GFLOP/s, blocked: "
+			<< (blocked.countFlops() / blockedWatch.getMeanLapTime() * 1.0e-9)
+			<< " GFLOP/s, threaded: "
+			<< (threaded.countFlops() / threadedWatch.getMeanLapTime()
+				* 1.0e-9)
+			<< " GFLOP/s" << std::endl;
+	}
+	std::cout << std::endl;
+}
+
+/**
+ * Measures transposition of several sizes.
+ *
+ * @param numIterations
+ *     Number of the iterations.
+ */
+void measureTranspose(int numIterations) {
+	static const int SIZES[] = { 60, 512, 2048 };
+	std::cout << "transposition" << std::endl;
+	for (size_t i = 0; i < sizeof(SIZES) / sizeof(SIZES[0]); ++i) {
+		const int size = SIZES[i];
+		const int numRepetitions = std::max(
+			1, numIterations * (256 * 256) / (size * size));
+		TransposeBenchmark plain(
+			size, numRepetitions, TransposeBenchmark::PLAIN);
+		TransposeBenchmark blocked(
+			size, numRepetitions, TransposeBenchmark::BLOCKED);
+		TransposeBenchmark inPlace(
+			size, numRepetitions, TransposeBenchmark::IN_PLACE);
+		Stopwatch plainWatch;
+		Stopwatch blockedWatch;
+		Stopwatch inPlaceWatch;
+		plainWatch.measure(plain);
+		blockedWatch.measure(blocked);
+		inPlaceWatch.measure(inPlace);
+		std::cout << size << "x" << size
+			<< " plain: "
+			<< (plain.countBytes() / plainWatch.getMeanLapTime() * 1.0e-9)
+			<< " GB/s, blocked: "
+			<< (blocked.countBytes() / blockedWatch.getMeanLapTime() * 1.0e-9)
+			<< " GB/s, in place: "
+			<< (inPlace.countBytes() / inPlaceWatch.getMeanLapTime() * 1.0e-9)
+			<< " GB/s" << std::endl;
+	}
+	std::cout << std::endl;
+}
+
+/**
+ * Measures decomposition of many small matrices of a given size.
+ *
+ * @tparam S
+ *     Number of rows and columns in each matrix.
+ * @param numIterations
+ *     Number of the iterations.
+ * @param seed
+ *     Seed for the random number generator.
+ */
+template < int S >
+void measureBatch(int numIterations, unsigned int seed) {
+	const int count = std::max(1, numIterations * 20000 / (S * S));
+	BatchBenchmark< S > oneByOne(count, false, seed);
+	BatchBenchmark< S > batched(count, true, seed);
+	Stopwatch oneByOneWatch;
+	Stopwatch batchedWatch;
+	oneByOneWatch.measure(oneByOne);
+	batchedWatch.measure(batched);
+	std::cout << S << "x" << S
+		<< " one by one: "
+		<< (count / oneByOneWatch.getMeanLapTime())
+		<< " matrices/s, batched: "
+		<< (count / batchedWatch.getMeanLapTime())
+		<< " matrices/s" << std::endl;
+}
+
+/**
+ * Measures reconstruction of a matrix from its SVD.
+ *
+ * @param numIterations
+ *     Number of the iterations.
+ * @param seed
+ *     Seed for the random number generator.
+ */
+void measureReconstruction(int numIterations, unsigned int seed) {
+	std::default_random_engine rnd(seed);
+	std::uniform_real_distribution< double > dist(MIN_VALUE, MAX_VALUE);
+	singular::Matrix< M, N > m;
+	for (int i = 0; i < M; ++i) {
+		for (int j = 0; j < N; ++j) {
+			m(i, j) = dist(rnd);
+		}
+	}
+	singular::Svd< M, N >::USV usv = singular::Svd< M, N >::decomposeUSV(m);
+	ReconstructionBenchmark operators(usv, false, numIterations * 10);
+	ReconstructionBenchmark fused(usv, true, numIterations * 10);
+	Stopwatch operatorsWatch;
+	Stopwatch fusedWatch;
+	operatorsWatch.measure(operators);
+	fusedWatch.measure(fused);
+	std::cout << "reconstruction (U * S * V^T)" << std::endl;
+	std::cout << "operators: " << operatorsWatch.getMeanLapTime()
+		<< " seconds" << std::endl;
+	std::cout << "Svd::reconstruct: " << fusedWatch.getMeanLapTime()
+		<< " seconds" << std::endl;
+	std::cout << std::endl;
 }
 
 /**
@@ -653,6 +1257,7 @@ int main(int argc, char** argv) {
 	std::cout << "min value: " << MIN_VALUE << std::endl;
 	std::cout << "max value: " << MAX_VALUE << std::endl;
 	std::cout << "singular version: " << SINGULAR_VERSION << std::endl;
+	std::cout << "SIMD level: " << singular::Simd::level() << std::endl;
 #ifdef ENABLE_EIGEN
 	std::cout << "Eigen version: "
 		<< EIGEN_WORLD_VERSION << "."
@@ -674,9 +1279,28 @@ int main(int argc, char** argv) {
 #endif
 	// verifies the results
 	bool verified = verifyResults(numIterations, seed);
+	// measures kernels
+	measureVectorKernels(numIterations);
+	measureGemm(numIterations);
+	measureTranspose(numIterations);
+	std::cout << "batched decomposition" << std::endl;
+	measureBatch< 3 >(numIterations, seed);
+	measureBatch< 8 >(numIterations, seed);
+	measureBatch< 16 >(numIterations, seed);
+	std::cout << std::endl;
+	measureReconstruction(numIterations, seed);
 	// runs benchmarks
 	Benchmark< SingularSvd > singularBenchmark(numIterations, seed);
 	Stopwatch singularWatch;
+	Benchmark< SingularValuesSvd > singularValuesBenchmark(
+		numIterations, seed);
+	Stopwatch singularValuesWatch;
+	Benchmark< SingularDynamicSvd< double > > singularDoubleBenchmark(
+		numIterations, seed);
+	Stopwatch singularDoubleWatch;
+	Benchmark< SingularDynamicSvd< float > > singularFloatBenchmark(
+		numIterations, seed);
+	Stopwatch singularFloatWatch;
 #ifdef ENABLE_EIGEN
 	Benchmark< EigenSvd > eigenBenchmark(numIterations, seed);
 	Stopwatch eigenWatch;
@@ -688,6 +1312,9 @@ int main(int argc, char** argv) {
 	std::cout << "measuring processing time ..." << std::endl;
 	// round 1
 	std::cout << "round 1" << std::endl;
+	singularValuesWatch.measure(singularValuesBenchmark);
+	singularDoubleWatch.measure(singularDoubleBenchmark);
+	singularFloatWatch.measure(singularFloatBenchmark);
 	singularWatch.measure(singularBenchmark);
 #ifdef ENABLE_EIGEN
 	eigenWatch.measure(eigenBenchmark);
@@ -697,6 +1324,9 @@ int main(int argc, char** argv) {
 #endif
 	// round 2
 	std::cout << "round 2" << std::endl;
+	singularValuesWatch.measure(singularValuesBenchmark);
+	singularDoubleWatch.measure(singularDoubleBenchmark);
+	singularFloatWatch.measure(singularFloatBenchmark);
 	singularWatch.measure(singularBenchmark);
 #ifdef ENABLE_ARMADILLO
 	armadilloWatch.measure(armadilloBenchmark);
@@ -706,6 +1336,9 @@ int main(int argc, char** argv) {
 #endif
 	// round 3
 	std::cout << "round 3" << std::endl;
+	singularValuesWatch.measure(singularValuesBenchmark);
+	singularDoubleWatch.measure(singularDoubleBenchmark);
+	singularFloatWatch.measure(singularFloatBenchmark);
 #ifdef ENABLE_EIGEN
 	eigenWatch.measure(eigenBenchmark);
 #endif
@@ -715,6 +1348,9 @@ int main(int argc, char** argv) {
 #endif
 	// round 4
 	std::cout << "round 4" << std::endl;
+	singularValuesWatch.measure(singularValuesBenchmark);
+	singularDoubleWatch.measure(singularDoubleBenchmark);
+	singularFloatWatch.measure(singularFloatBenchmark);
 #ifdef ENABLE_EIGEN
 	eigenWatch.measure(eigenBenchmark);
 #endif
@@ -724,6 +1360,9 @@ int main(int argc, char** argv) {
 	singularWatch.measure(singularBenchmark);
 	// round 5
 	std::cout << "round 5" << std::endl;
+	singularValuesWatch.measure(singularValuesBenchmark);
+	singularDoubleWatch.measure(singularDoubleBenchmark);
+	singularFloatWatch.measure(singularFloatBenchmark);
 #ifdef ENABLE_ARMADILLO
 	armadilloWatch.measure(armadilloBenchmark);
 #endif
@@ -733,6 +1372,9 @@ int main(int argc, char** argv) {
 	singularWatch.measure(singularBenchmark);
 	// round 6
 	std::cout << "round 6" << std::endl;
+	singularValuesWatch.measure(singularValuesBenchmark);
+	singularDoubleWatch.measure(singularDoubleBenchmark);
+	singularFloatWatch.measure(singularFloatBenchmark);
 #ifdef ENABLE_ARMADILLO
 	armadilloWatch.measure(armadilloBenchmark);
 #endif
@@ -745,6 +1387,15 @@ int main(int argc, char** argv) {
 	std::cout << "singular: " << std::endl;
 	singularWatch.printStatistics();
 	std::cout << std::endl;
+	std::cout << "singular (values only): " << std::endl;
+	singularValuesWatch.printStatistics();
+	std::cout << std::endl;
+	std::cout << "singular (runtime dimensions, double): " << std::endl;
+	singularDoubleWatch.printStatistics();
+	std::cout << std::endl;
+	std::cout << "singular (runtime dimensions, float): " << std::endl;
+	singularFloatWatch.printStatistics();
+	std::cout << std::endl;
 #ifdef ENABLE_EIGEN
 	std::cout << "Eigen: " << std::endl;
 	eigenWatch.printStatistics();